@@ -117,6 +117,23 @@ endif()
 
 find_package(ViennaCL)
 
+# check for mmap used by the binary input streams
+include(CheckIncludeFile)
+check_include_file(sys/mman.h HAVE_SYS_MMAN_H)
+
+# check for compression libraries used by the binary streams
+foreach(_lib ZSTD LZ4)
+  string(TOLOWER ${_lib} _name)
+  find_path(${_lib}_INCLUDE_DIR NAMES "${_name}.h" PATHS ${${_lib}_ROOT} PATH_SUFFIXES "include")
+  find_library(${_lib}_LIBRARY NAMES ${_name} PATHS ${${_lib}_ROOT} PATH_SUFFIXES "lib" "lib64")
+  mark_as_advanced(${_lib}_INCLUDE_DIR ${_lib}_LIBRARY)
+  if(${_lib}_INCLUDE_DIR AND ${_lib}_LIBRARY)
+    set(HAVE_${_lib} 1)
+    dune_register_package_flags(INCLUDE_DIRS ${${_lib}_INCLUDE_DIR}
+                                LIBRARIES ${${_lib}_LIBRARY})
+  endif()
+endforeach()
+
 ####### abbreviations
 include(FemShort)
 
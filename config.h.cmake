@@ -31,6 +31,15 @@
 /* Define if we have sionlib */
 #cmakedefine HAVE_SIONLIB 1
 
+/* Define if we have sys/mman.h (mmap) */
+#cmakedefine HAVE_SYS_MMAN_H 1
+
+/* Define if we have zstd */
+#cmakedefine HAVE_ZSTD 1
+
+/* Define if we have lz4 */
+#cmakedefine HAVE_LZ4 1
+
 /* Define if we have PETSc */
 #cmakedefine HAVE_PETSC ENABLE_PETSC
 
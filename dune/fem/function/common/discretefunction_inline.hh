@@ -2,6 +2,7 @@
 #define DUNE_FEM_DISCRETEFUNCTION_INLINE_HH
 
 #include <fstream>
+#include <type_traits>
 
 #include <dune/geometry/referenceelements.hh>
 
@@ -18,6 +19,63 @@ namespace Dune
   namespace Fem
   {
 
+    namespace __DiscreteFunction
+    {
+
+      // dof vectors storing all dofs contiguously as doubles
+      template< class DofVector, class = void >
+      struct HasContiguousDoubleDofs
+        : public std::false_type
+      {};
+
+      template< class DofVector >
+      struct HasContiguousDoubleDofs< DofVector, std::enable_if_t< std::is_same< std::decay_t< decltype( *std::declval< DofVector & >().data() ) >, double >::value > >
+        : public std::true_type
+      {};
+
+      // read all dofs in one go, e.g., directly from a mapped file
+      template< class DiscreteFunction, class StreamTraits >
+      inline void readDofs ( DiscreteFunction &df, InStreamInterface< StreamTraits > &in, std::true_type )
+      {
+        readDoubles( in, df.dofVector().data(), df.size() );
+      }
+
+      template< class DiscreteFunction, class StreamTraits >
+      inline void readDofs ( DiscreteFunction &df, InStreamInterface< StreamTraits > &in, std::false_type )
+      {
+        typedef typename DiscreteFunction::DiscreteFunctionSpaceType::LocalBlockIndices LocalBlockIndices;
+
+        const auto &blockMapper = df.space().blockMapper();
+        for( std::size_t i = 0; i < std::size_t( blockMapper.size() ); ++i )
+        {
+          auto &&block = df.dofVector()[ i ];
+          Hybrid::forEach( LocalBlockIndices(), [ &in, &block ] ( auto j ) { in >> block[ j ]; } );
+        }
+      }
+
+      template< class DiscreteFunction, class StreamTraits >
+      inline void writeDofs ( const DiscreteFunction &df, OutStreamInterface< StreamTraits > &out, std::true_type )
+      {
+        writeDoubles( out, df.dofVector().data(), df.size() );
+      }
+
+      template< class DiscreteFunction, class StreamTraits >
+      inline void writeDofs ( const DiscreteFunction &df, OutStreamInterface< StreamTraits > &out, std::false_type )
+      {
+        typedef typename DiscreteFunction::DiscreteFunctionSpaceType::LocalBlockIndices LocalBlockIndices;
+
+        const auto &blockMapper = df.space().blockMapper();
+        for( std::size_t i = 0; i < std::size_t( blockMapper.size() ); ++i )
+        {
+          const auto block = df.dofVector()[ i ];
+          Hybrid::forEach( LocalBlockIndices(), [ &out, &block ] ( auto j ) { out << block[ j ]; } );
+        }
+      }
+
+    } // namespace __DiscreteFunction
+
+
+
     // DiscreteFunctionDefault
     // -----------------------
 
@@ -238,17 +296,8 @@ namespace Dune
       if( BaseType::size() != static_cast< int >( this->space().size() ) )
         DUNE_THROW( InvalidStateException, "Trying to read discrete function in uncompressed state." );
 
-      // read all dofs
-      typedef typename DiscreteFunctionSpaceType::BlockMapperType BlockMapperType;
-      typedef typename DiscreteFunctionSpaceType::LocalBlockIndices LocalBlockIndices;
-      typedef typename BlockMapperType::SizeType SizeType;
-
-      const BlockMapperType &blockMapper = this->space().blockMapper();
-      for( SizeType i = 0; i < blockMapper.size(); ++i )
-      {
-        auto &&block = this->dofVector()[ i ];
-        Hybrid::forEach( LocalBlockIndices(), [ &in, &block ] ( auto j ) { in >> block[ j ]; } );
-      }
+      // read all dofs (in one go for contiguous dof storage)
+      __DiscreteFunction::readDofs( asImp(), in, __DiscreteFunction::HasContiguousDoubleDofs< DofVectorType >() );
     }
 
 
@@ -275,17 +324,8 @@ namespace Dune
       const int32_t mysize = BaseType::size();
       out << mysize;
 
-      // write all dofs
-      typedef typename DiscreteFunctionSpaceType::BlockMapperType BlockMapperType;
-      typedef typename DiscreteFunctionSpaceType::LocalBlockIndices LocalBlockIndices;
-      typedef typename BlockMapperType::SizeType SizeType;
-
-      const BlockMapperType &blockMapper = this->space().blockMapper();
-      for( SizeType i = 0; i < blockMapper.size(); ++i )
-      {
-        const auto block = this->dofVector()[ i ];
-        Hybrid::forEach( LocalBlockIndices(), [ &out, &block ] ( auto j ) { out << block[ j ]; } );
-      }
+      // write all dofs (in one go for contiguous dof storage)
+      __DiscreteFunction::writeDofs( asImp(), out, __DiscreteFunction::HasContiguousDoubleDofs< DofVectorType >() );
     }
 
 
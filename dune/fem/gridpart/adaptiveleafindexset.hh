@@ -5,7 +5,9 @@
 #include <cstddef>
 
 #include <algorithm>
+#include <limits>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <type_traits>
 
@@ -15,6 +17,8 @@
 #include <dune/fem/gridpart/common/gridpart.hh>
 #include <dune/fem/gridpart/common/persistentindexset.hh>
 #include <dune/fem/io/file/iointerface.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/misc/spacefillingcurve.hh>
 #include <dune/fem/version.hh>
 
 namespace Dune
@@ -316,6 +320,9 @@ namespace Dune
       //! flag is tru if set is in compressed status
       mutable bool compressed_;
 
+      //! if true, elements are renumbered along a space filling curve on compress
+      const bool sfcRenumbering_;
+
     protected:
       using BaseType::grid_;
       using BaseType::dofManager_;
@@ -357,6 +364,7 @@ namespace Dune
         , gridPart_( gridPart )
         , sequence_( dofManager_.sequence() )
         , compressed_(true) // at start the set is compressed
+        , sfcRenumbering_( !CartesianNonAdaptiveGrid && Parameter::getValue< bool >( "fem.indexset.sfcrenumbering", false ) )
       {
         // codim 0 is used by default
         codimUsed_[ 0 ] = true;
@@ -749,6 +757,9 @@ namespace Dune
       //! mark all indices of interest
       void setupIndexSet ();
 
+      // renumber elements along a space filling curve (after compress)
+      bool renumberElements ();
+
       // give all entities that lie below the old entities new numbers
       // here we need the hierarchic iterator because for example for some
       // grid more the one level of new elements can be created during adaption
@@ -857,6 +868,10 @@ namespace Dune
           haveToCopy |= codimLeafSet( codim ).compress();
       }
 
+      // improve locality of the element ordering
+      if( sfcRenumbering_ )
+        haveToCopy |= renumberElements();
+
       // now status is compressed
       compressed_ = true;
       // update sequence number
@@ -1051,6 +1066,56 @@ namespace Dune
       }
     }
 
+    template< class TraitsImp >
+    inline bool
+    AdaptiveIndexSetBase< TraitsImp >::renumberElements ()
+    {
+      typedef typename GridElementType::Geometry::GlobalCoordinate GlobalCoordinateType;
+      typedef MortonOrder< typename GlobalCoordinateType::value_type, GlobalCoordinateType::dimension > MortonOrderType;
+
+      CodimIndexSetType &codimSet = codimLeafSet( 0 );
+      const IndexType size = codimSet.size();
+
+      std::vector< GlobalCoordinateType > centers;
+      std::vector< std::tuple< bool, typename MortonOrderType::KeyType, IndexType > > order;
+      centers.reserve( size );
+      order.reserve( size );
+
+      GlobalCoordinateType lower( std::numeric_limits< typename GlobalCoordinateType::value_type >::max() );
+      GlobalCoordinateType upper( std::numeric_limits< typename GlobalCoordinateType::value_type >::lowest() );
+      typedef typename GridPartType
+        ::template Codim< 0 > :: template Partition< pitype > :: IteratorType  Iterator;
+
+      const Iterator end = gridPart_.template end< 0, pitype >();
+      for( Iterator it = gridPart_.template begin< 0, pitype >(); it != end; ++it )
+      {
+        const GridElementType &gridElement = gridEntity( *it );
+        centers.push_back( gridElement.geometry().center() );
+        order.emplace_back( gridElement.partitionType() != InteriorEntity, 0, codimSet.index( gridElement ) );
+        for( int i = 0; i < GlobalCoordinateType::dimension; ++i )
+        {
+          lower[ i ] = std::min( lower[ i ], centers.back()[ i ] );
+          upper[ i ] = std::max( upper[ i ], centers.back()[ i ] );
+        }
+      }
+
+      // renumbering requires exactly one index per element
+      if( IndexType( order.size() ) != size )
+        return false;
+
+      // sort interior elements first, then by their position on the curve
+      const MortonOrderType mortonOrder( lower, upper );
+      for( std::size_t i = 0; i < order.size(); ++i )
+        std::get< 1 >( order[ i ] ) = mortonOrder( centers[ i ] );
+      std::sort( order.begin(), order.end() );
+
+      std::vector< IndexType > permutation( size );
+      for( IndexType i = 0; i < size; ++i )
+        permutation[ std::get< 2 >( order[ i ] ) ] = i;
+
+      return codimSet.renumber( permutation );
+    }
+
     template< class TraitsImp >
     template< PartitionIteratorType pt >
     inline void
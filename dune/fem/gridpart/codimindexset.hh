@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <set>
+#include <vector>
 
 #include <dune/grid/utility/persistentcontainer.hh>
 #include <dune/grid/utility/persistentcontainervector.hh>
@@ -278,6 +279,74 @@ namespace Dune
         return haveToCopy;
       }
 
+      /** \brief renumber the indices directly after compress
+       *
+       *  The index \c i is replaced by \c permutation[ i ]. The lists of old
+       *  and new indices are replaced by the combined data movement of
+       *  compress and renumbering, so that the dof manager moves every dof
+       *  only once. Note that, unlike after compress, the old indices may
+       *  coincide with new indices.
+       *
+       *  \returns true, if at least one dof has to be moved
+       */
+      bool renumber ( const std::vector< IndexType > &permutation )
+      {
+        const IndexType size = indexState_.size();
+        assert( IndexType( permutation.size() ) == size );
+
+        // position of the data of each index before compress; only used
+        // indices and the holes filled by compress carry data, while new
+        // (ghost) indices were created after the dofs were resized
+        std::vector< IndexType > source( size );
+        std::vector< bool > hasData( size );
+        for( IndexType index = 0; index < size; ++index )
+        {
+          source[ index ] = index;
+          hasData[ index ] = (indexState_[ index ] == USED);
+        }
+        for( IndexType hole = 0; hole < numberHoles_; ++hole )
+        {
+          source[ newIdx_[ hole ] ] = oldIdx_[ hole ];
+          hasData[ newIdx_[ hole ] ] = true;
+        }
+
+        // combined data movement (skip indices without data)
+        oldIdx_.resize( size );
+        newIdx_.resize( size );
+        IndexType holes = 0;
+        for( IndexType index = 0; index < size; ++index )
+        {
+          if( hasData[ index ] && (source[ index ] != permutation[ index ]) )
+          {
+            oldIdx_[ holes ] = source[ index ];
+            newIdx_[ holes ] = permutation[ index ];
+            ++holes;
+          }
+        }
+        oldIdx_.resize( holes );
+        newIdx_.resize( holes );
+        numberHoles_ = holes;
+
+        // permute index states
+        std::vector< INDEXSTATE > state( indexState_.begin(), indexState_.end() );
+        for( IndexType index = 0; index < size; ++index )
+          indexState_[ permutation[ index ] ] = state[ index ];
+
+        // renumber entities
+        typedef typename IndexContainerType::Iterator Iterator;
+        const Iterator end = leafIndex_.end();
+        for( Iterator it = leafIndex_.begin(); it != end; ++it )
+        {
+          if( *it != invalidIndex() )
+            *it = permutation[ *it ];
+        }
+
+#ifndef NDEBUG
+        checkConsecutive();
+#endif
+        return (holes > 0);
+      }
+
       //! return how much extra memory is needed for restriction
       IndexType additionalSizeEstimate () const { return indexState_.size(); }
 
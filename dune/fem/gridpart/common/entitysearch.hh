@@ -1,7 +1,10 @@
 #ifndef DUNE_FEM_GRIDPART_ENTITYSEARCH_HH
 #define DUNE_FEM_GRIDPART_ENTITYSEARCH_HH
 
+#include <cstddef>
+
 #include <type_traits>
+#include <vector>
 
 #include <dune/geometry/referenceelements.hh>
 
@@ -10,6 +13,8 @@
 #include <dune/grid/utility/hierarchicsearch.hh>
 
 #include <dune/fem/gridpart/common/capabilities.hh>
+#include <dune/fem/gridpart/common/entitysearchtree.hh>
+#include <dune/fem/misc/threads/parallelfor.hh>
 
 namespace Dune
 {
@@ -17,6 +22,41 @@ namespace Dune
   namespace Fem
   {
 
+    namespace Impl
+    {
+
+      // findEntities
+      // ------------
+
+      // thread parallel location of a batch of points; find( x, entity ) locates a single point
+      template< class Find, class Entity, class GlobalCoordinate >
+      inline void findEntities ( const Find &find, const std::vector< GlobalCoordinate > &points,
+                                 std::vector< Entity > &entities, std::vector< char > &found )
+      {
+        entities.resize( points.size() );
+        found.resize( points.size() );
+        parallelFor( 0, points.size(), 16, [ &find, &points, &entities, &found ] ( std::size_t i ) {
+            found[ i ] = find( points[ i ], entities[ i ] );
+          } );
+      }
+
+      template< class Entity, class Find, class GlobalCoordinate >
+      inline std::vector< Entity > findEntities ( const Find &find, const std::vector< GlobalCoordinate > &points )
+      {
+        std::vector< Entity > entities;
+        std::vector< char > found;
+        findEntities( find, points, entities, found );
+        for( std::size_t i = 0; i < points.size(); ++i )
+        {
+          if( !found[ i ] )
+            DUNE_THROW( GridError, "Coordinate " << points[ i ] << " is outside the grid." );
+        }
+        return entities;
+      }
+
+    } // namespace Impl
+
+
     // DefaultEntitySearch
     // -------------------
 
@@ -44,28 +84,106 @@ namespace Dune
       typedef typename GeometryType::GlobalCoordinate GlobalCoordinateType;
 
       explicit DefaultEntitySearch ( const GridPartType &gridPart )
-      : gridPart_( gridPart )
+      : gridPart_( gridPart ), tree_( gridPart )
       {}
 
+      /** \brief locate a point
+       *
+       *  \note If x lies on the boundary of several entities, the first of
+       *        them in the iteration order of the grid part is returned.
+       */
       EntityType operator() ( const GlobalCoordinateType &x ) const
+      {
+        EntityType entity;
+        if( !find( x, entity ) )
+          DUNE_THROW( GridError, "Coordinate " << x << " is outside the grid." );
+        return entity;
+      }
+
+      /** \brief locate a point without throwing
+       *
+       *  \returns \b true, if an entity containing x was found
+       */
+      bool find ( const GlobalCoordinateType &x, EntityType &entity ) const
       {
         const auto end = gridPart_.template end< codimension, partition >();
         for( auto it = gridPart_.template begin< codimension, partition >(); it != end; ++it )
         {
-          const auto& entity = *it;
-          const auto geo = entity.geometry();
+          const auto& candidate = *it;
+          const auto geo = candidate.geometry();
           const auto z = geo.local( x );
           if( (mydimension < dimensionworld) && ((geo.global( z ) - x).two_norm() > 1e-8 ) )
             continue;
 
           if( ReferenceElements< ctype, mydimension >::general( geo.type() ).checkInside( z ) )
-            return entity;
+          {
+            entity = candidate;
+            return true;
+          }
         }
-        DUNE_THROW( GridError, "Coordinate " << x << " is outside the grid." );
+        return false;
+      }
+
+      /** \brief locate a batch of points (thread parallel)
+       *
+       *  \param[in]   points  global coordinates of the points
+       *  \param[out]  found   found[ i ] is nonzero, if points[ i ] was found
+       *
+       *  \returns entities containing the points (undefined if not found)
+       */
+      std::vector< EntityType > findEntities ( const std::vector< GlobalCoordinateType > &points, std::vector< char > &found ) const
+      {
+        update();
+        std::vector< EntityType > entities;
+        Impl::findEntities( batchFind(), points, entities, found );
+        return entities;
       }
 
+      /** \brief locate a batch of points (thread parallel)
+       *
+       *  \note This method throws a GridError, if a point is outside the grid.
+       */
+      std::vector< EntityType > findEntities ( const std::vector< GlobalCoordinateType > &points ) const
+      {
+        update();
+        return Impl::findEntities< EntityType >( batchFind(), points );
+      }
+
+      /** \brief build the search tree (for codimension 0)
+       *
+       *  The tree is only used by the batched searches. It is built by the
+       *  first of them and rebuilt only after the sequence of the grid part
+       *  changed, i.e., a change of the geometry alone is not detected.
+       */
+      void update () const { update( std::integral_constant< bool, codimension == 0 >() ); }
+
     private:
+      // batches of points are located in the search tree for codimension 0
+      auto batchFind () const { return batchFind( std::integral_constant< bool, codimension == 0 >() ); }
+
+      auto batchFind ( std::true_type ) const
+      {
+        return [ this ] ( const GlobalCoordinateType &x, EntityType &entity ) {
+            const std::size_t i = tree_.find( x );
+            if( i == TreeType::noElement )
+              return false;
+            entity = tree_.element( i );
+            return true;
+          };
+      }
+
+      auto batchFind ( std::false_type ) const
+      {
+        return [ this ] ( const GlobalCoordinateType &x, EntityType &entity ) { return find( x, entity ); };
+      }
+
+      void update ( std::true_type ) const { tree_.update(); }
+      void update ( std::false_type ) const {}
+
+      typedef EntitySearchTree< GridPartType, partition > TreeType;
+
       const GridPartType &gridPart_;
+      mutable TreeType tree_;
     };
 
 
@@ -108,7 +226,8 @@ namespace Dune
       typedef typename GeometryType::GlobalCoordinate GlobalCoordinateType;
 
       explicit GridEntitySearch ( const GridPartType &gridPart )
-      : hierarchicSearch_( gridPart.grid(), gridPart.indexSet() )
+      : hierarchicSearch_( gridPart.grid(), gridPart.indexSet() ),
+        tree_( gridPart )
       {}
 
       EntityType operator() ( const GlobalCoordinateType &x ) const
@@ -116,8 +235,76 @@ namespace Dune
         return hierarchicSearch_.template findEntity< partition >( x );
       }
 
+      /** \brief locate a point without throwing
+       *
+       *  \returns \b true, if an entity containing x was found
+       */
+      bool find ( const GlobalCoordinateType &x, EntityType &entity ) const
+      {
+        try
+        {
+          entity = hierarchicSearch_.template findEntity< partition >( x );
+          return true;
+        }
+        catch( const GridError & )
+        {
+          return false;
+        }
+      }
+
+      /** \brief locate a batch of points in the search tree (thread parallel)
+       *
+       *  \param[in]   points  global coordinates of the points
+       *  \param[out]  found   found[ i ] is nonzero, if points[ i ] was found
+       *
+       *  \returns entities containing the points (undefined if not found)
+       *
+       *  \note If a point lies on the boundary of several elements, the first
+       *        of them in the iteration order of the grid part is returned,
+       *        while the HierarchicSearch may return another one.
+       */
+      std::vector< EntityType > findEntities ( const std::vector< GlobalCoordinateType > &points, std::vector< char > &found ) const
+      {
+        update();
+        std::vector< EntityType > entities;
+        Impl::findEntities( batchFind(), points, entities, found );
+        return entities;
+      }
+
+      /** \brief locate a batch of points in the search tree (thread parallel)
+       *
+       *  \note This method throws a GridError, if a point is outside the grid.
+       */
+      std::vector< EntityType > findEntities ( const std::vector< GlobalCoordinateType > &points ) const
+      {
+        update();
+        return Impl::findEntities< EntityType >( batchFind(), points );
+      }
+
+      /** \brief build the search tree
+       *
+       *  The tree is only used by the batched searches. It is built by the
+       *  first of them and rebuilt only after the sequence of the grid part
+       *  changed, i.e., a change of the geometry alone is not detected.
+       */
+      void update () const { tree_.update(); }
+
     private:
+      auto batchFind () const
+      {
+        return [ this ] ( const GlobalCoordinateType &x, EntityType &entity ) {
+            const std::size_t i = tree_.find( x );
+            if( i == TreeType::noElement )
+              return false;
+            entity = tree_.element( i );
+            return true;
+          };
+      }
+
+      typedef EntitySearchTree< GridPartType, partition > TreeType;
+
       Dune::HierarchicSearch< typename GridPartType::GridType, typename GridPartType::IndexSetType > hierarchicSearch_;
+      mutable TreeType tree_;
     };
 
 
@@ -0,0 +1,320 @@
+#ifndef DUNE_FEM_GRIDPART_COMMON_ENTITYSEARCHTREE_HH
+#define DUNE_FEM_GRIDPART_COMMON_ENTITYSEARCHTREE_HH
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/gridenums.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // EntitySearchTree
+    // ----------------
+
+    /** \brief bounding volume hierarchy over the elements of a grid part
+     *
+     *  The tree stores an axis aligned bounding box for each element of the
+     *  given partition and recursively splits the elements at the median of
+     *  their box centers along the direction of largest extent. Locating a
+     *  point only tests the few elements whose boxes contain the point,
+     *  instead of descending from every macro element (HierarchicSearch) or
+     *  scanning all elements.
+     *
+     *  The tree is rebuilt by update() only if the sequence of the grid part
+     *  (i.e., of the DofManager) changed. The bounding boxes are computed from
+     *  the element corners. They are enlarged by 1e-8 times their diameter
+     *  (but at least by 1e-8) for affine geometries, so points on the element
+     *  boundary accepted by checkInside are not missed, and by 10% of their
+     *  diameter for non-affine geometries.
+     *
+     *  If a point lies on the boundary of several elements, find returns the
+     *  first of them in the iteration order of the grid part, i.e., the same
+     *  element as a linear search.
+     *
+     *  \note find may be called concurrently by several threads, update may
+     *        not.
+     */
+    template< class GridPart, PartitionIteratorType partition = All_Partition >
+    class EntitySearchTree
+    {
+      typedef EntitySearchTree< GridPart, partition > ThisType;
+
+    public:
+      typedef GridPart GridPartType;
+
+      typedef typename GridPartType::ctype ctype;
+      static const int dimension = GridPartType::dimension;
+      static const int dimensionworld = GridPartType::dimensionworld;
+
+      typedef typename GridPartType::template Codim< 0 >::EntityType ElementType;
+      typedef typename GridPartType::template Codim< 0 >::EntitySeedType ElementSeedType;
+
+      typedef typename ElementType::Geometry::GlobalCoordinate GlobalCoordinateType;
+      typedef typename ElementType::Geometry::LocalCoordinate LocalCoordinateType;
+
+      //! return value of find for points outside the grid part
+      static const std::size_t noElement = std::numeric_limits< std::size_t >::max();
+
+    private:
+      struct Box
+      {
+        Box ()
+        {
+          std::fill( lower.begin(), lower.end(), std::numeric_limits< ctype >::max() );
+          std::fill( upper.begin(), upper.end(), std::numeric_limits< ctype >::lowest() );
+        }
+
+        void extend ( const GlobalCoordinateType &x )
+        {
+          for( int k = 0; k < dimensionworld; ++k )
+          {
+            lower[ k ] = std::min( lower[ k ], x[ k ] );
+            upper[ k ] = std::max( upper[ k ], x[ k ] );
+          }
+        }
+
+        void extend ( const Box &other )
+        {
+          extend( other.lower );
+          extend( other.upper );
+        }
+
+        void enlarge ( ctype margin )
+        {
+          for( int k = 0; k < dimensionworld; ++k )
+          {
+            lower[ k ] -= margin;
+            upper[ k ] += margin;
+          }
+        }
+
+        bool contains ( const GlobalCoordinateType &x ) const
+        {
+          for( int k = 0; k < dimensionworld; ++k )
+          {
+            if( (x[ k ] < lower[ k ]) || (x[ k ] > upper[ k ]) )
+              return false;
+          }
+          return true;
+        }
+
+        GlobalCoordinateType center () const
+        {
+          GlobalCoordinateType c( lower );
+          c += upper;
+          c *= ctype( 1 ) / ctype( 2 );
+          return c;
+        }
+
+        GlobalCoordinateType lower, upper;
+      };
+
+      struct Node
+      {
+        Box box;
+        std::size_t begin = 0, end = 0;
+        // index of the first child (the second one follows); 0 for leaves
+        std::size_t child = 0;
+      };
+
+      static const std::size_t leafSize = 4;
+
+    public:
+      explicit EntitySearchTree ( const GridPartType &gridPart )
+        : gridPart_( gridPart )
+      {}
+
+      //! rebuild the tree if the grid part changed since the last update
+      void update ()
+      {
+        if( !valid() )
+          build();
+      }
+
+      //! return true, if the tree is up to date with the grid part
+      bool valid () const { return (sequence_ == gridPart_.sequence()); }
+
+      //! sequence of the grid part the tree was built for
+      int sequence () const { return sequence_; }
+
+      //! number of elements in the tree
+      std::size_t size () const { return seeds_.size(); }
+
+      /** \brief locate a point
+       *
+       *  \param[in]   x      global coordinate of the point
+       *  \param[out]  local  local coordinate of x in the element found
+       *
+       *  \returns number of the element containing x (or noElement)
+       */
+      std::size_t find ( const GlobalCoordinateType &x, LocalCoordinateType &local ) const
+      {
+        assert( valid() );
+        std::size_t result = noElement;
+        if( nodes_.empty() )
+          return result;
+
+        // median splits keep the depth (and the stack) logarithmic in the number of elements
+        std::array< std::size_t, 2*std::numeric_limits< std::size_t >::digits > stack;
+        std::size_t top = 0;
+        stack[ top++ ] = 0;
+        while( top > 0 )
+        {
+          const Node &node = nodes_[ stack[ --top ] ];
+          if( !node.box.contains( x ) )
+            continue;
+
+          if( node.child > 0 )
+          {
+            stack[ top++ ] = node.child + 1;
+            stack[ top++ ] = node.child;
+            continue;
+          }
+
+          // all leaves containing x are visited to return the first element in iteration order
+          for( std::size_t i = node.begin; i < node.end; ++i )
+          {
+            if( (result != noElement) && (order_[ i ] > order_[ result ]) )
+              continue;
+            LocalCoordinateType y;
+            if( boxes_[ i ].contains( x ) && contains( element( i ), x, y ) )
+            {
+              result = i;
+              local = y;
+            }
+          }
+        }
+        return result;
+      }
+
+      //! locate a point, returning the number of the element containing x (or noElement)
+      std::size_t find ( const GlobalCoordinateType &x ) const
+      {
+        LocalCoordinateType local;
+        return find( x, local );
+      }
+
+      //! element with given number
+      ElementType element ( std::size_t i ) const { assert( i < size() ); return gridPart_.entity( seeds_[ i ] ); }
+
+      //! seed of the element with given number
+      const ElementSeedType &seed ( std::size_t i ) const { assert( i < size() ); return seeds_[ i ]; }
+
+      const GridPartType &gridPart () const { return gridPart_; }
+
+    protected:
+      static bool contains ( const ElementType &element, const GlobalCoordinateType &x, LocalCoordinateType &local )
+      {
+        const auto geometry = element.geometry();
+        local = geometry.local( x );
+        if( (dimension < dimensionworld) && ((geometry.global( local ) - x).two_norm() > 1e-8) )
+          return false;
+        return ReferenceElements< ctype, dimension >::general( geometry.type() ).checkInside( local );
+      }
+
+      void build ()
+      {
+        std::vector< ElementSeedType > seeds;
+        std::vector< Box > boxes;
+        const auto end = gridPart_.template end< 0, partition >();
+        for( auto it = gridPart_.template begin< 0, partition >(); it != end; ++it )
+        {
+          const ElementType &element = *it;
+          const auto geometry = element.geometry();
+
+          Box box;
+          for( int i = 0; i < geometry.corners(); ++i )
+            box.extend( geometry.corner( i ) );
+          const ctype diameter = (box.upper - box.lower).two_norm();
+          box.enlarge( geometry.affine() ? std::max( ctype( 1e-8 )*diameter, ctype( 1e-8 ) ) : ctype( 0.1 )*diameter );
+
+          seeds.push_back( element.seed() );
+          boxes.push_back( box );
+        }
+
+        const std::size_t n = seeds.size();
+        std::vector< std::size_t > permutation( n );
+        std::iota( permutation.begin(), permutation.end(), std::size_t( 0 ) );
+        std::vector< GlobalCoordinateType > centers( n );
+        for( std::size_t i = 0; i < n; ++i )
+          centers[ i ] = boxes[ i ].center();
+
+        nodes_.clear();
+        if( n > 0 )
+        {
+          nodes_.reserve( 2*(n / leafSize) + 1 );
+          nodes_.emplace_back();
+          split( 0, 0, n, boxes, centers, permutation );
+        }
+
+        // store elements in leaf order
+        seeds_.resize( n );
+        boxes_.resize( n );
+        order_ = permutation;
+        for( std::size_t i = 0; i < n; ++i )
+        {
+          seeds_[ i ] = seeds[ permutation[ i ] ];
+          boxes_[ i ] = boxes[ permutation[ i ] ];
+        }
+
+        sequence_ = gridPart_.sequence();
+      }
+
+      void split ( std::size_t node, std::size_t begin, std::size_t end, const std::vector< Box > &boxes,
+                   const std::vector< GlobalCoordinateType > &centers, std::vector< std::size_t > &permutation )
+      {
+        // note: nodes_ might be reallocated below, so do not keep references
+        Box box, centerBox;
+        for( std::size_t i = begin; i < end; ++i )
+        {
+          box.extend( boxes[ permutation[ i ] ] );
+          centerBox.extend( centers[ permutation[ i ] ] );
+        }
+        nodes_[ node ].box = box;
+        nodes_[ node ].begin = begin;
+        nodes_[ node ].end = end;
+        if( end - begin <= leafSize )
+          return;
+
+        const GlobalCoordinateType extent = centerBox.upper - centerBox.lower;
+        const int axis = std::max_element( extent.begin(), extent.end() ) - extent.begin();
+        if( extent[ axis ] <= 0 )
+          return;
+
+        const std::size_t middle = begin + (end - begin) / 2;
+        std::nth_element( permutation.begin() + begin, permutation.begin() + middle, permutation.begin() + end,
+                          [ &centers, axis ] ( std::size_t a, std::size_t b ) { return (centers[ a ][ axis ] < centers[ b ][ axis ]); } );
+
+        const std::size_t child = nodes_.size();
+        nodes_[ node ].child = child;
+        nodes_.resize( child + 2 );
+        split( child, begin, middle, boxes, centers, permutation );
+        split( child+1, middle, end, boxes, centers, permutation );
+      }
+
+      const GridPartType &gridPart_;
+      int sequence_ = -1;
+
+      std::vector< Node > nodes_;
+      std::vector< ElementSeedType > seeds_;
+      std::vector< Box > boxes_;
+      // position of the elements in the iteration order of the grid part
+      std::vector< std::size_t > order_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_GRIDPART_COMMON_ENTITYSEARCHTREE_HH
@@ -0,0 +1,237 @@
+#ifndef DUNE_FEM_GRIDPART_COMMON_INTERSECTIONTABLE_HH
+#define DUNE_FEM_GRIDPART_COMMON_INTERSECTIONTABLE_HH
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/fem/gridpart/common/capabilities.hh>
+#include <dune/fem/storage/singletonlist.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // IntersectionTable
+    // -----------------
+
+    /** \brief cached intersection topology and geometry of a grid part
+     *
+     *  Walking the intersections of a grid part constructs intersection
+     *  objects, outside entities and geometries, which is expensive on some
+     *  grids (e.g., ALUGrid). The intersection table stores for each element
+     *  (addressed by its index in the grid part's index set) the following
+     *  data of its intersections in contiguous arrays:
+     *  - index of the outside element (noNeighbor for boundary intersections),
+     *  - local face numbers in the inside and outside element,
+     *  - twists with respect to the inside and outside element,
+     *  - neighbor, boundary and conformity flags,
+     *  - unit outer normal and integration element in the face center.
+     *
+     *  Only the elements visited by the grid part's codimension 0 iterator
+     *  (e.g., not the ghost elements of an interior partition) are contained
+     *  in the table; for all other indices (including holes of the index set)
+     *  begin() equals end() and element() must not be called.
+     *
+     *  The table is rebuilt by update() only if the sequence of the grid part
+     *  (i.e., of the DofManager) changed. Normal and integration element are
+     *  exact for affine faces only.
+     *
+     *  A table shared by all users of a grid part is obtained by
+     *  \code
+     *  auto &table = IntersectionTable< GridPart >::ProviderType::getObject( &gridPart );
+     *  table.update();
+     *  ...
+     *  IntersectionTable< GridPart >::ProviderType::removeObject( table );
+     *  \endcode
+     */
+    template< class GridPart >
+    class IntersectionTable
+    {
+      typedef IntersectionTable< GridPart > ThisType;
+
+    public:
+      typedef GridPart GridPartType;
+
+      typedef typename GridPartType::ctype ctype;
+      static const int dimensionworld = GridPartType::dimensionworld;
+
+      typedef FieldVector< ctype, dimensionworld > NormalType;
+
+      typedef typename GridPartType::template Codim< 0 >::EntityType ElementType;
+      typedef typename GridPartType::template Codim< 0 >::EntitySeedType ElementSeedType;
+
+      typedef typename GridPartType::TwistUtilityType TwistUtilityType;
+
+      //! type of singleton provider (one table per grid part)
+      typedef SingletonList< const GridPartType *, ThisType > ProviderType;
+
+      //! outside index of boundary intersections
+      static const std::size_t noNeighbor = std::numeric_limits< std::size_t >::max();
+
+    private:
+      enum Flags : unsigned char { neighborFlag = 1, boundaryFlag = 2, conformingFlag = 4 };
+
+    public:
+      explicit IntersectionTable ( const GridPartType &gridPart )
+        : gridPart_( gridPart )
+      {}
+
+      explicit IntersectionTable ( const GridPartType *gridPart )
+        : IntersectionTable( *gridPart )
+      {}
+
+      IntersectionTable ( const ThisType & ) = delete;
+      ThisType &operator= ( const ThisType & ) = delete;
+
+      //! rebuild the table if the grid part changed since the last update
+      void update ()
+      {
+        if( sequence_ != gridPart_.sequence() )
+          build();
+      }
+
+      //! sequence of the grid part the table was built for
+      int sequence () const { return sequence_; }
+
+      //! number of elements (size of the codimension 0 index set)
+      std::size_t size () const { return seeds_.size(); }
+
+      //! number of intersections stored in the table
+      std::size_t numIntersections () const { return outside_.size(); }
+
+      //! number of the first intersection of an element
+      std::size_t begin ( std::size_t element ) const { assert( element < size() ); return begin_[ element ]; }
+      //! number of the last intersection of an element plus one
+      std::size_t end ( std::size_t element ) const { assert( element < size() ); return end_[ element ]; }
+
+      //! return true if the element with given index is contained in the table
+      bool contains ( std::size_t element ) const { assert( element < size() ); return contained_[ element ]; }
+
+      //! element with given index (only valid for contained elements)
+      ElementType element ( std::size_t element ) const { assert( contains( element ) ); return gridPart_.entity( seeds_[ element ] ); }
+
+      //! index of the inside element of an intersection
+      std::size_t inside ( std::size_t i ) const { return inside_[ i ]; }
+      //! index of the outside element of an intersection (noNeighbor if there is none)
+      std::size_t outside ( std::size_t i ) const { return outside_[ i ]; }
+
+      int indexInInside ( std::size_t i ) const { return indexInInside_[ i ]; }
+      int indexInOutside ( std::size_t i ) const { return indexInOutside_[ i ]; }
+
+      int twistInInside ( std::size_t i ) const { return twistInInside_[ i ]; }
+      int twistInOutside ( std::size_t i ) const { return twistInOutside_[ i ]; }
+
+      bool neighbor ( std::size_t i ) const { return (flags_[ i ] & neighborFlag); }
+      bool boundary ( std::size_t i ) const { return (flags_[ i ] & boundaryFlag); }
+      bool conforming ( std::size_t i ) const { return (flags_[ i ] & conformingFlag); }
+
+      //! unit outer normal in the center of the intersection
+      const NormalType &unitOuterNormal ( std::size_t i ) const { return normal_[ i ]; }
+      //! integration element in the center of the intersection
+      ctype integrationElement ( std::size_t i ) const { return integrationElement_[ i ]; }
+
+      //! contiguous array of outside indices (see outside)
+      const std::vector< std::size_t > &outsides () const { return outside_; }
+      //! contiguous array of unit outer normals (see unitOuterNormal)
+      const std::vector< NormalType > &unitOuterNormals () const { return normal_; }
+      //! contiguous array of integration elements (see integrationElement)
+      const std::vector< ctype > &integrationElements () const { return integrationElement_; }
+
+      const GridPartType &gridPart () const { return gridPart_; }
+
+    protected:
+      void build ()
+      {
+        const auto &indexSet = gridPart_.indexSet();
+        const std::size_t numElements = indexSet.size( 0 );
+
+        seeds_.resize( numElements );
+        contained_.assign( numElements, 0 );
+        begin_.assign( numElements, 0 );
+        end_.assign( numElements, 0 );
+
+        inside_.clear();
+        outside_.clear();
+        indexInInside_.clear();
+        indexInOutside_.clear();
+        twistInInside_.clear();
+        twistInOutside_.clear();
+        flags_.clear();
+        normal_.clear();
+        integrationElement_.clear();
+
+        for( const ElementType &element : elements( gridPart_ ) )
+        {
+          const std::size_t index = indexSet.index( element );
+          seeds_[ index ] = element.seed();
+          contained_[ index ] = 1;
+          begin_[ index ] = outside_.size();
+
+          for( const auto &intersection : intersections( gridPart_, element ) )
+          {
+            unsigned char flags = 0;
+            std::size_t outside = noNeighbor;
+            int indexInOutside = -1, twistInOutside = 0;
+            if( intersection.neighbor() )
+            {
+              flags |= neighborFlag;
+              outside = indexSet.index( intersection.outside() );
+              indexInOutside = intersection.indexInOutside();
+              twistInOutside = TwistUtilityType::twistInNeighbor( gridPart_.grid(), intersection );
+            }
+            if( intersection.boundary() )
+              flags |= boundaryFlag;
+            if( GridPartCapabilities::isConforming< GridPartType >::v || intersection.conforming() )
+              flags |= conformingFlag;
+
+            const auto geometry = intersection.geometry();
+            const auto &refFace = ReferenceElements< ctype, GridPartType::dimension-1 >::general( geometry.type() );
+            const auto &center = refFace.position( 0, 0 );
+
+            inside_.push_back( index );
+            outside_.push_back( outside );
+            indexInInside_.push_back( intersection.indexInInside() );
+            indexInOutside_.push_back( indexInOutside );
+            twistInInside_.push_back( TwistUtilityType::twistInSelf( gridPart_.grid(), intersection ) );
+            twistInOutside_.push_back( twistInOutside );
+            flags_.push_back( flags );
+            normal_.push_back( intersection.unitOuterNormal( center ) );
+            integrationElement_.push_back( geometry.integrationElement( center ) );
+          }
+
+          end_[ index ] = outside_.size();
+        }
+
+        sequence_ = gridPart_.sequence();
+      }
+
+      const GridPartType &gridPart_;
+      int sequence_ = -1;
+
+      std::vector< ElementSeedType > seeds_;
+      std::vector< char > contained_;
+      std::vector< std::size_t > begin_, end_;
+
+      std::vector< std::size_t > inside_, outside_;
+      std::vector< int > indexInInside_, indexInOutside_;
+      std::vector< int > twistInInside_, twistInOutside_;
+      std::vector< unsigned char > flags_;
+      std::vector< NormalType > normal_;
+      std::vector< ctype > integrationElement_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_GRIDPART_COMMON_INTERSECTIONTABLE_HH
@@ -5,6 +5,10 @@
 #error "Experimental grid extensions required for IdGridPart. Reconfigure with -DDUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS=TRUE."
 #else
 
+#include <cstddef>
+
+#include <vector>
+
 #include <dune/grid/common/gridview.hh>
 
 #include <dune/fem/gridpart/common/deaditerator.hh>
@@ -320,8 +324,42 @@ namespace Dune
         return EntityImpl( data_, hostEntitySearch_( x ) );
       }
 
+      bool find ( const GlobalCoordinateType &x, EntityType &entity ) const
+      {
+        typedef typename EntityType::Implementation EntityImpl;
+        typename EntitySearch< HostGridPart, codim, partition >::EntityType hostEntity;
+        if( !hostEntitySearch_.find( x, hostEntity ) )
+          return false;
+        entity = EntityImpl( data_, hostEntity );
+        return true;
+      }
+
+      std::vector< EntityType > findEntities ( const std::vector< GlobalCoordinateType > &points, std::vector< char > &found ) const
+      {
+        typedef typename EntityType::Implementation EntityImpl;
+        const auto hostEntities = hostEntitySearch_.findEntities( points, found );
+        std::vector< EntityType > entities;
+        entities.reserve( hostEntities.size() );
+        for( std::size_t i = 0; i < hostEntities.size(); ++i )
+          entities.push_back( found[ i ] ? EntityType( EntityImpl( data_, hostEntities[ i ] ) ) : EntityType() );
+        return entities;
+      }
+
+      std::vector< EntityType > findEntities ( const std::vector< GlobalCoordinateType > &points ) const
+      {
+        typedef typename EntityType::Implementation EntityImpl;
+        const auto hostEntities = hostEntitySearch_.findEntities( points );
+        std::vector< EntityType > entities;
+        entities.reserve( hostEntities.size() );
+        for( const auto &hostEntity : hostEntities )
+          entities.push_back( EntityImpl( data_, hostEntity ) );
+        return entities;
+      }
+
+      void update () const { hostEntitySearch_.update(); }
+
     protected:
-      const EntitySearch< HostGridPart > hostEntitySearch_;
+      const EntitySearch< HostGridPart, codim, partition > hostEntitySearch_;
       ExtraData data_;
     };
 
@@ -1,7 +1,82 @@
 #include <config.h>
 
+#include <cmath>
+#include <cstddef>
+
 #include "checkgridpart.hh"
 
+#include <dune/fem/gridpart/common/capabilities.hh>
+#include <dune/fem/gridpart/common/intersectiontable.hh>
+
+// compare the intersection table with the intersections of the grid part
+template< class GridPart >
+void checkIntersectionTable ( const GridPart &gridPart )
+{
+  typedef Dune::Fem::IntersectionTable< GridPart > IntersectionTableType;
+  typedef typename GridPart::TwistUtilityType TwistUtilityType;
+  auto &table = IntersectionTableType::ProviderType::getObject( &gridPart );
+  table.update();
+
+  const auto &indexSet = gridPart.indexSet();
+  for( const auto &element : elements( gridPart ) )
+  {
+    const std::size_t index = indexSet.index( element );
+    if( !table.contains( index ) || (table.element( index ) != element) )
+      DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong element" );
+
+    std::size_t i = table.begin( index );
+    for( const auto &intersection : intersections( gridPart, element ) )
+    {
+      if( i >= table.end( index ) )
+        DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: too few intersections" );
+      if( (table.inside( i ) != index) || (table.indexInInside( i ) != intersection.indexInInside())
+          || (table.neighbor( i ) != intersection.neighbor()) || (table.boundary( i ) != intersection.boundary()) )
+        DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong topology" );
+      if( table.twistInInside( i ) != TwistUtilityType::twistInSelf( gridPart.grid(), intersection ) )
+        DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong twist in inside" );
+      if( intersection.neighbor() )
+      {
+        if( table.outside( i ) != std::size_t( indexSet.index( intersection.outside() ) ) )
+          DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong neighbor" );
+        if( table.indexInOutside( i ) != intersection.indexInOutside() )
+          DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong index in outside" );
+        if( table.twistInOutside( i ) != TwistUtilityType::twistInNeighbor( gridPart.grid(), intersection ) )
+          DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong twist in outside" );
+        if( table.conforming( i ) != (Dune::Fem::GridPartCapabilities::isConforming< GridPart >::v || intersection.conforming()) )
+          DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong conformity" );
+      }
+      else if( table.outside( i ) != IntersectionTableType::noNeighbor )
+        DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: neighbor on the boundary" );
+
+      const auto geometry = intersection.geometry();
+      const auto &local = geometry.local( geometry.center() );
+      auto normal = intersection.unitOuterNormal( local );
+      normal -= table.unitOuterNormal( i );
+      if( geometry.affine() && (normal.two_norm() > 1e-8) )
+        DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong normal" );
+      if( geometry.affine() && (std::abs( geometry.integrationElement( local ) - table.integrationElement( i ) ) > 1e-8 * geometry.integrationElement( local )) )
+        DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong integration element" );
+      ++i;
+    }
+    if( i != table.end( index ) )
+      DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: too many intersections" );
+  }
+
+  // all intersections belong to an element of the grid part
+  std::size_t numIntersections = 0;
+  for( std::size_t index = 0; index < table.size(); ++index )
+  {
+    if( table.contains( index ) )
+      numIntersections += table.end( index ) - table.begin( index );
+    else if( table.begin( index ) != table.end( index ) )
+      DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: intersections of an element not in the grid part" );
+  }
+  if( numIntersections != table.numIntersections() )
+    DUNE_THROW( Dune::InvalidStateException, "IntersectionTable: wrong number of intersections" );
+
+  IntersectionTableType::ProviderType::removeObject( table );
+}
+
 int main ( int argc, char ** argv )
 try
 {
@@ -58,6 +133,8 @@ try
   Dune::Fem::CheckIndexSet< GridPartType, FailureHandlerType >::check( gridPart, failureHandler );
   std::cout << "Testing intersections" << std::endl;
   Dune::Fem::CheckIntersections< GridPartType, FailureHandlerType >::check( gridPart, failureHandler );
+  std::cout << "Testing intersection table" << std::endl;
+  checkIntersectionTable( gridPart );
 
   return 0;
 }
@@ -0,0 +1,283 @@
+#include <config.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/gridpart/common/entitysearch.hh>
+#include <dune/fem/gridpart/common/entitysearchtree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/adaptationmanager.hh>
+#include <dune/fem/test/testgrid.hh>
+
+#if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
+#include <dune/fem/gridpart/idgridpart.hh>
+#endif // #if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
+
+typedef Dune::GridSelector::GridType GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef GridPartType::Codim< 0 >::EntityType::Geometry::GlobalCoordinate GlobalCoordinateType;
+
+
+// reference: first element in iteration order containing x
+template< class GridPart, class Entity >
+bool linearFind ( const GridPart &gridPart, const GlobalCoordinateType &x, Entity &entity )
+{
+  for( const auto &element : elements( gridPart ) )
+  {
+    const auto geometry = element.geometry();
+    const auto &refElement = Dune::ReferenceElements< typename GridPart::ctype, GridPart::dimension >::general( element.type() );
+    if( refElement.checkInside( geometry.local( x ) ) )
+    {
+      entity = element;
+      return true;
+    }
+  }
+  return false;
+}
+
+// random points in the bounding box of the grid part, enlarged by 10%, i.e., some points lie outside
+template< class GridPart >
+std::vector< GlobalCoordinateType > randomPoints ( const GridPart &gridPart, std::size_t n )
+{
+  GlobalCoordinateType lower( std::numeric_limits< double >::max() ), upper( std::numeric_limits< double >::lowest() );
+  for( const auto &element : elements( gridPart ) )
+  {
+    const auto geometry = element.geometry();
+    for( int i = 0; i < geometry.corners(); ++i )
+      for( int k = 0; k < GlobalCoordinateType::dimension; ++k )
+      {
+        lower[ k ] = std::min( lower[ k ], geometry.corner( i )[ k ] );
+        upper[ k ] = std::max( upper[ k ], geometry.corner( i )[ k ] );
+      }
+  }
+
+  std::mt19937 generator( 42 );
+  std::vector< GlobalCoordinateType > points( n );
+  for( GlobalCoordinateType &x : points )
+    for( int k = 0; k < GlobalCoordinateType::dimension; ++k )
+    {
+      const double h = 0.1*(upper[ k ] - lower[ k ]);
+      x[ k ] = std::uniform_real_distribution< double >( lower[ k ] - h, upper[ k ] + h )( generator );
+    }
+  return points;
+}
+
+// compare the single point searches and the batched search (search tree) to the linear scan
+template< class GridPart, class Search >
+int checkSearch ( const GridPart &gridPart, const Search &search, const std::vector< GlobalCoordinateType > &points, const std::string &name )
+{
+  typedef typename Search::EntityType EntityType;
+  const auto &indexSet = gridPart.indexSet();
+
+  int errors = 0;
+  std::size_t outside = 0;
+  std::vector< char > referenceFound( points.size() );
+  std::vector< EntityType > reference( points.size() );
+  for( std::size_t i = 0; i < points.size(); ++i )
+  {
+    referenceFound[ i ] = linearFind( gridPart, points[ i ], reference[ i ] );
+    if( !referenceFound[ i ] )
+    {
+      ++outside;
+      continue;
+    }
+
+    EntityType entity;
+    if( !search.find( points[ i ], entity ) )
+    {
+      std::cerr << "Error: " << name << " did not find point " << points[ i ] << "." << std::endl;
+      ++errors;
+    }
+    else if( indexSet.index( entity ) != indexSet.index( reference[ i ] ) )
+    {
+      std::cerr << "Error: " << name << " found the wrong element for point " << points[ i ] << "." << std::endl;
+      ++errors;
+    }
+    else if( indexSet.index( search( points[ i ] ) ) != indexSet.index( reference[ i ] ) )
+    {
+      std::cerr << "Error: " << name << " (operator()) found the wrong element for point " << points[ i ] << "." << std::endl;
+      ++errors;
+    }
+  }
+
+  for( std::size_t i = 0; i < points.size(); ++i )
+  {
+    if( referenceFound[ i ] )
+      continue;
+
+    EntityType entity;
+    if( search.find( points[ i ], entity ) )
+    {
+      std::cerr << "Error: " << name << " found point " << points[ i ] << " outside the grid." << std::endl;
+      ++errors;
+    }
+
+    try
+    {
+      search( points[ i ] );
+      std::cerr << "Error: " << name << " (operator()) did not throw for point " << points[ i ] << " outside the grid." << std::endl;
+      ++errors;
+    }
+    catch( const Dune::GridError & )
+    {}
+  }
+
+  if( (outside == 0) || (outside == points.size()) )
+  {
+    std::cerr << "Error: the random points should lie inside and outside the grid." << std::endl;
+    ++errors;
+  }
+
+  // batched search (builds the search tree)
+  std::vector< char > found;
+  const std::vector< EntityType > entities = search.findEntities( points, found );
+  if( (entities.size() != points.size()) || (found.size() != points.size()) )
+  {
+    std::cerr << "Error: " << name << " (batched) returned a wrong number of entities." << std::endl;
+    return ++errors;
+  }
+  for( std::size_t i = 0; i < points.size(); ++i )
+  {
+    if( !found[ i ] != !referenceFound[ i ] )
+    {
+      std::cerr << "Error: " << name << " (batched) disagrees on point " << points[ i ] << " being inside the grid." << std::endl;
+      ++errors;
+    }
+    else if( found[ i ] && (indexSet.index( entities[ i ] ) != indexSet.index( reference[ i ] )) )
+    {
+      std::cerr << "Error: " << name << " (batched) found the wrong element for point " << points[ i ] << "." << std::endl;
+      ++errors;
+    }
+  }
+
+  return errors;
+}
+
+// points on the element boundaries are located in the first element of the iteration order
+// (for the batched search and, if inOrder is set, also for the single point search)
+template< class GridPart, class Search >
+int checkInterfacePoints ( const GridPart &gridPart, const Search &search, bool inOrder, const std::string &name )
+{
+  typedef typename Search::EntityType EntityType;
+  const auto &indexSet = gridPart.indexSet();
+
+  std::vector< GlobalCoordinateType > points;
+  for( const auto &element : elements( gridPart ) )
+  {
+    const auto geometry = element.geometry();
+    for( int i = 0; i < geometry.corners(); ++i )
+      points.push_back( geometry.corner( i ) );
+  }
+
+  std::vector< char > found;
+  const std::vector< EntityType > entities = search.findEntities( points, found );
+
+  int errors = 0;
+  for( std::size_t i = 0; i < points.size(); ++i )
+  {
+    const GlobalCoordinateType &x = points[ i ];
+    EntityType reference, entity;
+    if( !linearFind( gridPart, x, reference ) )
+    {
+      std::cerr << "Error: linear search did not find vertex " << x << "." << std::endl;
+      ++errors;
+      continue;
+    }
+
+    if( !found[ i ] )
+    {
+      std::cerr << "Error: " << name << " (batched) did not find vertex " << x << "." << std::endl;
+      ++errors;
+    }
+    else if( indexSet.index( entities[ i ] ) != indexSet.index( reference ) )
+    {
+      std::cerr << "Error: " << name << " (batched) did not return the first element containing vertex " << x << "." << std::endl;
+      ++errors;
+    }
+
+    if( !search.find( x, entity ) )
+    {
+      std::cerr << "Error: " << name << " did not find vertex " << x << "." << std::endl;
+      ++errors;
+    }
+    else if( inOrder && (indexSet.index( entity ) != indexSet.index( reference )) )
+    {
+      std::cerr << "Error: " << name << " did not return the first element containing vertex " << x << "." << std::endl;
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  GridType &grid = Dune::Fem::TestGrid::grid();
+  grid.globalRefine( Dune::Fem::TestGrid::refineStepsForHalf() );
+  GridPartType gridPart( grid );
+
+  const std::vector< GlobalCoordinateType > points = randomPoints( gridPart, 2000 );
+
+  int errors = 0;
+
+  // linear scan and search tree
+  Dune::Fem::DefaultEntitySearch< GridPartType, 0, Dune::All_Partition > defaultSearch( gridPart );
+  errors += checkSearch( gridPart, defaultSearch, points, "DefaultEntitySearch" );
+  errors += checkInterfacePoints( gridPart, defaultSearch, true, "DefaultEntitySearch" );
+
+  // HierarchicSearch and search tree
+  Dune::Fem::EntitySearch< GridPartType > gridSearch( gridPart );
+  errors += checkSearch( gridPart, gridSearch, points, "GridEntitySearch" );
+  errors += checkInterfacePoints( gridPart, gridSearch, false, "GridEntitySearch" );
+
+  // the tree is rebuilt after the grid changed
+  Dune::Fem::EntitySearchTree< GridPartType > tree( gridPart );
+  tree.update();
+  const int sequence = tree.sequence();
+  Dune::Fem::GlobalRefine::apply( grid, Dune::Fem::TestGrid::refineStepsForHalf() );
+  if( tree.valid() )
+  {
+    std::cerr << "Error: search tree still valid after refinement." << std::endl;
+    ++errors;
+  }
+  tree.update();
+  if( !tree.valid() || (tree.sequence() == sequence) || (tree.size() != gridPart.indexSet().size( 0 )) )
+  {
+    std::cerr << "Error: search tree not rebuilt after refinement." << std::endl;
+    ++errors;
+  }
+
+  errors += checkSearch( gridPart, defaultSearch, points, "DefaultEntitySearch (after refinement)" );
+  errors += checkSearch( gridPart, gridSearch, points, "GridEntitySearch (after refinement)" );
+
+#if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
+  // IdGridPart forwards to the search on the host grid part
+  typedef Dune::Fem::IdGridPart< GridPartType > IdGridPartType;
+  IdGridPartType idGridPart( gridPart );
+  Dune::Fem::EntitySearch< IdGridPartType > idSearch( idGridPart );
+  errors += checkSearch( idGridPart, idSearch, points, "EntitySearch for IdGridPart" );
+#endif // #if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
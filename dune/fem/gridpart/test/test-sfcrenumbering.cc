@@ -0,0 +1,196 @@
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+
+#include <dune/alugrid/grid.hh>
+#include <dune/alugrid/dgf.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/misc/spacefillingcurve.hh>
+#include <dune/fem/space/common/adaptationmanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/common/restrictprolonginterface.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::ALUGrid< 2, 2, Dune::cube, Dune::nonconforming > GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+typedef GridType::Codim< 0 >::Geometry::GlobalCoordinate GlobalCoordinateType;
+typedef Dune::Fem::MortonOrder< double, 2 > MortonOrderType;
+
+// a linear function, represented exactly before and after the adaptation
+struct LinearFunction
+  : public Dune::Fem::Function< FunctionSpaceType, LinearFunction >
+{
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u = 1.0 + 2.0*x[ 0 ] - 3.0*x[ 1 ];
+  }
+};
+
+const char *unitSquare
+   = "DGF\n\n"
+     "INTERVAL\n"
+     "0 0\n"
+     "1 1\n"
+     "8 8\n"
+     "#\n";
+
+// the keys of the Morton order are given by interleaving the bits of the cell coordinates
+int checkMortonOrder ()
+{
+  int errors = 0;
+  const MortonOrderType order( GlobalCoordinateType( 0.0 ), GlobalCoordinateType( 1.0 ) );
+
+  const MortonOrderType::KeyType max = ~MortonOrderType::KeyType( 0 );
+  if( (order( GlobalCoordinateType( 0.0 ) ) != 0) || (order( GlobalCoordinateType( 1.0 ) ) != max) || (order( GlobalCoordinateType( 2.0 ) ) != max) )
+  {
+    std::cerr << "Error: wrong Morton keys of the corners of the bounding box." << std::endl;
+    ++errors;
+  }
+
+  // the quadrants are traversed in the order (0,0), (0,1), (1,0), (1,1), the first coordinate is the most significant bit
+  const GlobalCoordinateType quadrants[] = { { 0.25, 0.25 }, { 0.25, 0.75 }, { 0.75, 0.25 }, { 0.75, 0.75 } };
+  for( int i = 0; i < 4; ++i )
+  {
+    if( (order( quadrants[ i ] ) >> 62) != MortonOrderType::KeyType( i ) )
+    {
+      std::cerr << "Error: wrong Morton key of " << quadrants[ i ] << "." << std::endl;
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+// the interior elements are numbered first, along the Morton order of their centers
+int checkOrder ( const GridPartType &gridPart, const std::string &when )
+{
+  const auto &indexSet = gridPart.indexSet();
+  const std::size_t size = indexSet.size( 0 );
+
+  GlobalCoordinateType lower( std::numeric_limits< double >::max() ), upper( std::numeric_limits< double >::lowest() );
+  std::vector< GlobalCoordinateType > centers( size );
+  std::vector< char > interior( size, 0 ), visited( size, 0 );
+  int errors = 0;
+  for( const auto &element : elements( gridPart, Dune::Partitions::all ) )
+  {
+    const std::size_t index = indexSet.index( element );
+    if( (index >= size) || visited[ index ] )
+    {
+      std::cerr << "Error: invalid element index " << index << " " << when << "." << std::endl;
+      return ++errors;
+    }
+    visited[ index ] = 1;
+    interior[ index ] = (element.partitionType() == Dune::InteriorEntity);
+    centers[ index ] = element.geometry().center();
+    for( int i = 0; i < 2; ++i )
+    {
+      lower[ i ] = std::min( lower[ i ], centers[ index ][ i ] );
+      upper[ i ] = std::max( upper[ i ], centers[ index ][ i ] );
+    }
+  }
+
+  const MortonOrderType order( lower, upper );
+  for( std::size_t index = 1; index < size; ++index )
+  {
+    if( interior[ index ] > interior[ index-1 ] )
+    {
+      std::cerr << "Error: interior element " << index << " numbered after a non-interior element " << when << "." << std::endl;
+      ++errors;
+    }
+    else if( (interior[ index ] == interior[ index-1 ]) && (order( centers[ index ] ) < order( centers[ index-1 ] )) )
+    {
+      std::cerr << "Error: elements " << index-1 << " and " << index << " not numbered along the Morton order " << when << "." << std::endl;
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+// the dofs have to be moved along with the renumbering
+int checkValues ( const DiscreteFunctionType &uh, const std::string &when )
+{
+  const LinearFunction f;
+  double error = 0;
+  for( const auto &element : elements( uh.gridPart(), Dune::Partitions::interior ) )
+  {
+    const auto geometry = element.geometry();
+    for( int i = 0; i < geometry.corners(); ++i )
+    {
+      FunctionSpaceType::RangeType u, uExact;
+      uh.localFunction( element ).evaluate( geometry.local( geometry.corner( i ) ), u );
+      f.evaluate( geometry.corner( i ), uExact );
+      error = std::max( error, std::abs( u[ 0 ] - uExact[ 0 ] ) );
+    }
+  }
+
+  if( error < 1e-10 )
+    return 0;
+  std::cerr << "Error: wrong values " << when << " (error = " << error << ")." << std::endl;
+  return 1;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+  Dune::Fem::Parameter::append( "fem.indexset.sfcrenumbering", "true" );
+
+  int errors = checkMortonOrder();
+
+  std::istringstream dgf( unitSquare );
+  Dune::GridPtr< GridType > gridPtr( dgf );
+  GridType &grid = *gridPtr;
+  grid.loadBalance();
+
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+  DiscreteFunctionType uh( "uh", space );
+  interpolate( gridFunctionAdapter( LinearFunction(), gridPart, 1 ), uh );
+
+  typedef Dune::Fem::RestrictProlongDefault< DiscreteFunctionType > RestrictProlongType;
+  RestrictProlongType rp( uh );
+  Dune::Fem::AdaptationManager< GridType, RestrictProlongType > adaptationManager( grid, rp );
+
+  // refine the lower left corner twice, then coarsen everything once
+  for( int step = 0; step < 3; ++step )
+  {
+    for( const auto &element : elements( gridPart, Dune::Partitions::interior ) )
+    {
+      const GlobalCoordinateType x = element.geometry().center();
+      grid.mark( (step < 2 ? (x.two_norm() < 0.5 ? 1 : 0) : -1), element );
+    }
+    adaptationManager.adapt();
+
+    const std::string when = "after adaptation step " + std::to_string( step );
+    errors += checkOrder( gridPart, when );
+    errors += checkValues( uh, when );
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,276 @@
+#ifndef DUNE_FEM_IO_FILE_ASYNCFILEWRITER_HH
+#define DUNE_FEM_IO_FILE_ASYNCFILEWRITER_HH
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // StagingStreamBuffer
+    // -------------------
+
+    /** \class StagingStreamBuffer
+     *  \ingroup Checkpointing
+     *  \brief std::streambuf collecting all written data in memory
+     *
+     *  The data is collected in chunks of fixed size, so that growing the
+     *  buffer never copies (and never temporarily doubles) the data already
+     *  collected. The chunks can be moved out of the buffer without copying,
+     *  e.g., to hand them over to an AsyncFileWriter.
+     */
+    class StagingStreamBuffer
+    : public std::streambuf
+    {
+    public:
+      typedef std::vector< std::vector< char > > ChunksType;
+
+      //! size of the chunks in bytes
+      static const std::size_t chunkSize = std::size_t( 1 ) << 24;
+
+      //! move the collected data out of the buffer
+      ChunksType release ()
+      {
+        ChunksType chunks;
+        chunks.swap( chunks_ );
+        return chunks;
+      }
+
+      //! number of bytes collected
+      std::size_t size () const
+      {
+        std::size_t size = 0;
+        for( const auto &chunk : chunks_ )
+          size += chunk.size();
+        return size;
+      }
+
+    protected:
+      int_type overflow ( int_type c ) override
+      {
+        if( !traits_type::eq_int_type( c, traits_type::eof() ) )
+        {
+          const char ch = traits_type::to_char_type( c );
+          xsputn( &ch, 1 );
+        }
+        return traits_type::not_eof( c );
+      }
+
+      std::streamsize xsputn ( const char *s, std::streamsize n ) override
+      {
+        for( std::size_t left = n; left > 0; )
+        {
+          if( chunks_.empty() || (chunks_.back().size() == chunkSize) )
+          {
+            chunks_.emplace_back();
+            chunks_.back().reserve( chunkSize );
+          }
+          std::vector< char > &chunk = chunks_.back();
+          const std::size_t count = std::min( left, chunkSize - chunk.size() );
+          chunk.insert( chunk.end(), s, s+count );
+          s += count;
+          left -= count;
+        }
+        return n;
+      }
+
+    private:
+      ChunksType chunks_;
+    };
+
+
+
+    // AsyncFileWriter
+    // ---------------
+
+    /** \class AsyncFileWriter
+     *  \ingroup Checkpointing
+     *  \brief executes file output on a background thread
+     *
+     *  Tasks are executed in the order of submission. The method wait() is
+     *  a completion barrier: it blocks until all submitted tasks are done and
+     *  rethrows the first exception raised by any of them. The destructor
+     *  waits for all pending tasks.
+     *
+     *  \note Tasks must not access data the calling thread modifies
+     *        concurrently; usually they own (a snapshot of) the data to write.
+     */
+    class AsyncFileWriter
+    {
+      typedef AsyncFileWriter ThisType;
+
+    public:
+      typedef std::function< void () > TaskType;
+
+      AsyncFileWriter () = default;
+
+      AsyncFileWriter ( const ThisType & ) = delete;
+      ThisType &operator= ( const ThisType & ) = delete;
+
+      ~AsyncFileWriter ()
+      {
+        try
+        {
+          wait();
+        }
+        catch( const Dune::Exception &e )
+        {
+          std::cerr << "ERROR: AsyncFileWriter: " << e << std::endl;
+        }
+        catch( const std::exception &e )
+        {
+          std::cerr << "ERROR: AsyncFileWriter: " << e.what() << std::endl;
+        }
+
+        if( thread_.joinable() )
+        {
+          {
+            std::lock_guard< std::mutex > guard( mutex_ );
+            stop_ = true;
+          }
+          wakeUp_.notify_all();
+          thread_.join();
+        }
+      }
+
+      //! submit a task to the background thread
+      void submit ( TaskType task )
+      {
+        {
+          std::lock_guard< std::mutex > guard( mutex_ );
+          tasks_.push_back( std::move( task ) );
+          if( !thread_.joinable() )
+            thread_ = std::thread( [ this ] () { run(); } );
+        }
+        wakeUp_.notify_all();
+      }
+
+      //! write data into a file on the background thread
+      void write ( std::string filename, std::vector< char > data )
+      {
+        StagingStreamBuffer::ChunksType chunks;
+        chunks.push_back( std::move( data ) );
+        write( std::move( filename ), std::move( chunks ) );
+      }
+
+      //! write the chunks (e.g., of a StagingStreamBuffer) into a file on the background thread
+      void write ( std::string filename, StagingStreamBuffer::ChunksType chunks )
+      {
+        auto buffer = std::make_shared< StagingStreamBuffer::ChunksType >( std::move( chunks ) );
+        submit( [ filename, buffer ] () {
+            std::ofstream file( filename.c_str(), std::ios::binary );
+            if( !file )
+              DUNE_THROW( IOError, "Unable to open file: " << filename );
+            for( auto &chunk : *buffer )
+            {
+              file.write( chunk.data(), chunk.size() );
+              // free the memory as soon as possible
+              std::vector< char >().swap( chunk );
+            }
+            if( !file )
+              DUNE_THROW( IOError, "Unable to write file: " << filename );
+          } );
+      }
+
+      //! return true if there are unfinished tasks
+      bool pending () const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        return !tasks_.empty() || busy_;
+      }
+
+      //! return number of unfinished tasks (including the running one)
+      std::size_t numPending () const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        return tasks_.size() + (busy_ ? 1u : 0u);
+      }
+
+      //! wait for all submitted tasks and rethrow the first error
+      void wait ()
+      {
+        waitPending( 0 );
+      }
+
+      /** \brief wait until at most maxPending tasks are unfinished and rethrow the first error
+       *
+       *  As tasks are executed in the order of submission, all but the last
+       *  maxPending submitted tasks are done on return.
+       */
+      void waitPending ( std::size_t maxPending )
+      {
+        std::unique_lock< std::mutex > lock( mutex_ );
+        done_.wait( lock, [ this, maxPending ] () { return tasks_.size() + (busy_ ? 1u : 0u) <= maxPending; } );
+        if( exception_ )
+        {
+          std::exception_ptr exception;
+          std::swap( exception, exception_ );
+          std::rethrow_exception( exception );
+        }
+      }
+
+    protected:
+      void run ()
+      {
+        std::unique_lock< std::mutex > lock( mutex_ );
+        while( true )
+        {
+          wakeUp_.wait( lock, [ this ] () { return stop_ || !tasks_.empty(); } );
+          if( tasks_.empty() )
+            return;
+
+          TaskType task = std::move( tasks_.front() );
+          tasks_.pop_front();
+          busy_ = true;
+          lock.unlock();
+
+          std::exception_ptr exception;
+          try
+          {
+            task();
+          }
+          catch( ... )
+          {
+            exception = std::current_exception();
+          }
+
+          lock.lock();
+          busy_ = false;
+          if( exception && !exception_ )
+            exception_ = exception;
+          done_.notify_all();
+        }
+      }
+
+      mutable std::mutex mutex_;
+      std::condition_variable wakeUp_, done_;
+      std::deque< TaskType > tasks_;
+      std::exception_ptr exception_;
+      bool busy_ = false;
+      bool stop_ = false;
+      std::thread thread_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_IO_FILE_ASYNCFILEWRITER_HH
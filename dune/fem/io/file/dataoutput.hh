@@ -1,9 +1,12 @@
 #ifndef DUNE_FEM_DATAOUTPUT_HH
 #define DUNE_FEM_DATAOUTPUT_HH
 
+#include <algorithm>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -22,13 +25,16 @@
 #include <dune/fem/common/utility.hh>
 #include <dune/fem/function/adaptivefunction.hh>
 #include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/io/file/asyncfilewriter.hh>
 #include <dune/fem/io/file/iointerface.hh>
 #include <dune/fem/io/file/iotuple.hh>
 #include <dune/fem/io/file/vtkio.hh>
+#include <dune/fem/io/file/vtuwriter.hh>
 #include <dune/fem/io/parameter.hh>
 #include <dune/fem/operator/projection/vtxprojection.hh>
-#include <dune/fem/quadrature/cachingquadrature.hh>
+#include <dune/fem/quadrature/elementquadrature.hh>
 #include <dune/fem/solver/timeprovider.hh>
+#include <dune/fem/space/common/dofmanager.hh>
 #include <dune/fem/space/common/loadbalancer.hh>
 #include <dune/fem/space/common/interpolate.hh>
 #include <dune/fem/gridpart/adaptiveleafgridpart.hh>
@@ -110,7 +116,7 @@ namespace Dune
       virtual int outputformat () const
       {
         static const std::string formatTable[]
-          = { "vtk-cell", "vtk-vertex", "sub-vtk-cell", "binary" , "gnuplot" , "none" };
+          = { "vtk-cell", "vtk-vertex", "sub-vtk-cell", "binary" , "gnuplot" , "none", "vtk-lagrange" };
         int format = parameter().getEnum( keyPrefix_ + "outputformat", formatTable, 1 );
         return format;
       }
@@ -148,6 +154,35 @@ namespace Dune
         return parameter().getValue< int >( keyPrefix_ + "subsamplinglevel", 1 );
       }
 
+      /** \brief order of VTK Lagrange cells for format vtk-lagrange (fem.io.lagrangeorder)
+       *
+       *  The default 0 uses the maximal polynomial order of the written functions.
+       */
+      virtual int lagrangeOrder () const
+      {
+        return parameter().getValue< int >( keyPrefix_ + "lagrangeorder", 0 );
+      }
+
+      /** \brief write visualization data on a background thread (fem.io.async)
+       *
+       *  The data to write is copied (or projected, for vtk-vertex) on the
+       *  calling thread, evaluation and file output are done in the
+       *  background. Quadratures are created on the calling thread as well,
+       *  the background thread only evaluates the copies in plain local
+       *  coordinates. Pending output is finished before the grid is adapted
+       *  or load balanced.
+       */
+      virtual bool asyncoutput () const
+      {
+        return parameter().getValue< bool >( keyPrefix_ + "async", false );
+      }
+
+      //! \brief maximal number of data sets pending for asynchronous output (fem.io.asyncbuffers)
+      virtual int asyncbuffers () const
+      {
+        return parameter().getValue< int >( keyPrefix_ + "asyncbuffers", 2 );
+      }
+
       //! \brief number for first data file (no parameter available)
       virtual int startcounter () const
       {
@@ -221,6 +256,9 @@ namespace Dune
 
       template< class VTKOut >
       struct VTKOutputerDG;
+
+      template< class GridPartType >
+      struct VTUOutputerLagrange;
 #endif // #if USE_VTKWRITER
 
       template< class GridPartType >
@@ -274,7 +312,7 @@ namespace Dune
       };
 
     public:
-      enum OutputFormat { vtk = 0, vtkvtx = 1, subvtk = 2 , binary = 3, gnuplot = 4, none = 5 };
+      enum OutputFormat { vtk = 0, vtkvtx = 1, subvtk = 2 , binary = 3, gnuplot = 4, none = 5, vtklagrange = 6 };
 
       //! \brief type of grid used
       typedef GridImp GridType;
@@ -332,6 +370,12 @@ namespace Dune
         : DataOutput( grid, data, tp, DataOutputParameters( parameter ) )
       {}
 
+      virtual ~DataOutput ()
+      {
+        if( asyncOutput_ )
+          DofManager< GridType >::instance( grid_ ).removePreModificationCallback( this );
+      }
+
       void consistentSaveStep ( const TimeProviderBase &tp ) const;
 
     public:
@@ -404,6 +448,20 @@ namespace Dune
         writeData( sequenceStamp, "" );
       }
 
+      /** \brief wait until all asynchronous output is written
+       *
+       *  \note This is called automatically before the grid is adapted or
+       *        load balanced (see DofManager::addPreModificationCallback).
+       */
+      void wait () const
+      {
+        if( asyncOutput_ )
+        {
+          asyncOutput_->wait();
+          snapshots_.clear();
+        }
+      }
+
       //! \brief print class name
       virtual const char* myClassName () const
       {
@@ -452,12 +510,63 @@ namespace Dune
         return std::get< 0 >( data_ )->gridPart();
       }
 
+      // data kept alive for one asynchronous write (released in reverse order)
+      struct Snapshot
+      {
+        ~Snapshot () { while( !data.empty() ) data.pop_back(); }
+
+        std::vector< std::shared_ptr< void > > data;
+      };
+
 #if USE_VTKWRITER
       std::string writeVTKOutput () const;
+
+      template< class GridPartType, class Write >
+      void vtkOutput ( const GridPartType &gridPart, const OutPutDataType &data, Write write ) const;
 #endif
 
       std::string writeGnuPlotOutput () const;
 
+      // local coordinates of the gnuplot output points for each geometry type
+      template< class GridPartType >
+      using GnuplotPoints = std::map< GeometryType, std::vector< typename GridPartType::template Codim< 0 >::EntityType::Geometry::LocalCoordinate > >;
+
+      // the quadratures are created here, i.e., on the calling thread
+      template< class GridPartType >
+      static GnuplotPoints< GridPartType > gnuplotPoints ( const GridPartType &gridPart );
+
+      template< class GridPartType >
+      static std::string writeGnuPlotOutput ( const GridPartType &gridPart, const GnuplotPoints< GridPartType > &points,
+                                              const OutPutDataType &data, const std::string &name );
+
+      void writeAsync ( double sequenceStamp, const std::string &outstring ) const;
+
+      static void writeSeries ( FileWriter *sequence, PVDWriter *pvd, int writeStep, double sequenceStamp,
+                                const std::string &outstring, const std::string &filename )
+      {
+        if( sequence )
+          (*sequence)( std::to_string( writeStep ) + " " + filename + " " + std::to_string( sequenceStamp ) + outstring );
+        if( pvd )
+          (*pvd)( sequenceStamp, filename );
+      }
+
+      template< class DF >
+      static std::shared_ptr< std::remove_const_t< DF > > copyFunction ( DF *df )
+      {
+        return (df ? std::make_shared< std::remove_const_t< DF > >( *df ) : nullptr);
+      }
+
+      // copy all discrete functions, the copies are kept alive by the snapshot
+      template< std::size_t... i >
+      static OutPutDataType copyData ( const OutPutDataType &data, Snapshot &snapshot, std::index_sequence< i... > )
+      {
+        auto copies = std::make_tuple( copyFunction( std::get< i >( data ) )... );
+        Hybrid::forEach( Std::make_index_sequence< sizeof...( i ) >{}, [ &copies, &snapshot ] ( auto j ) {
+            snapshot.data.push_back( std::get< j >( copies ) );
+          } );
+        return OutPutDataType( std::get< i >( copies ).get()... );
+      }
+
       //! \brief write binary data
       virtual void writeBinaryData ( const double ) const
       {
@@ -501,6 +610,10 @@ namespace Dune
       std::unique_ptr< FileWriter > sequence_;
       std::unique_ptr< PVDWriter > pvd_;
       std::unique_ptr< const DataOutputParameters > param_;
+
+      // asynchronous output (the writer is destroyed, i.e., finished, first)
+      mutable std::deque< Snapshot > snapshots_;
+      std::unique_ptr< AsyncFileWriter > asyncOutput_;
     };
 
 
@@ -595,6 +708,12 @@ namespace Dune
         return (parallel ? vtkOut_.pwrite( name, path, "." ) : vtkOut_.write( name ));
       }
 
+      // write without communication (name includes the path)
+      std::string write ( const std::string &name, int rank, int size )
+      {
+        return vtkOut_.write( name, rank, size );
+      }
+
     private:
       bool conforming_;
       VTKOut vtkOut_;
@@ -645,6 +764,12 @@ namespace Dune
         return (parallel ? vtkOut_.pwrite( name, path, "." ) : vtkOut_.write( name ));
       }
 
+      // write without communication (name includes the path)
+      std::string write ( const std::string &name, int rank, int size )
+      {
+        return vtkOut_.write( name, rank, size );
+      }
+
     private:
       std::vector< std::unique_ptr< VTKListEntry< VTKOut > > > vec_;
       VTKOut vtkOut_;
@@ -654,6 +779,61 @@ namespace Dune
 
 
 
+    // DataOutput::VTUOutputerLagrange
+    // -------------------------------
+
+#if USE_VTKWRITER
+    template< class GridImp, class DataImp >
+    template< class GridPartType >
+    struct DataOutput< GridImp, DataImp >::VTUOutputerLagrange
+    {
+      //! Constructor
+      VTUOutputerLagrange ( const GridPartType &gridPart, int order, const ParameterReader &parameter )
+        : order_( order ), vtuOut_( gridPart, 0, parameter )
+      {}
+
+      template< typename ...  T >
+      void forEach ( const std::tuple< T ... >& data )
+      {
+        Hybrid::forEach( Std::make_index_sequence< sizeof...( T ) >{},
+          [&]( auto i ) {
+                          auto df( std::get< i >( data ) );
+                          if( df )
+                          {
+                            maxOrder_ = std::max( maxOrder_, df->order() );
+                            vtuOut_.addVertexData( *df );
+                          }
+                        });
+        vtuOut_.setLagrangeOrder( order_ > 0 ? order_ : std::max( maxOrder_, 1 ) );
+      }
+
+      template< typename T >
+      void forEach ( const T& data )
+      {
+        std::tuple< T > tup( data );
+        forEach( tup );
+      }
+
+      std::string write ( bool parallel, const std::string &name, const std::string &path )
+      {
+        return vtuOut_.write( parallel ? path + "/" + name : name );
+      }
+
+      // write without communication (name includes the path)
+      std::string write ( const std::string &name, int rank, int size )
+      {
+        return vtuOut_.write( name, rank, size );
+      }
+
+    private:
+      int order_;
+      int maxOrder_ = 0;
+      VTUWriter< GridPartType > vtuOut_;
+    };
+#endif // #if USE_VTKWRITER
+
+
+
     // DataOutput::GnuplotOutputer
     // ---------------------------
     template< class GridImp, class DataImp >
@@ -661,18 +841,17 @@ namespace Dune
     class DataOutput< GridImp, DataImp >::GnuplotOutputer
     {
       typedef typename GridPartType::template Codim< 0 >::IteratorType::Entity Entity;
+      typedef typename Entity::Geometry::LocalCoordinate LocalCoordinate;
       std::ostream& out_;
-      CachingQuadrature<GridPartType,0> &quad_;
-      int i_;
+      const LocalCoordinate &x_;
       const Entity& en_;
 
     public:
       //! Constructor
       GnuplotOutputer ( std::ostream& out,
-                        CachingQuadrature<GridPartType,0> &quad,
-                        int i,
+                        const LocalCoordinate &x,
                         const Entity &en )
-      : out_(out), quad_(quad), i_(i), en_(en)
+      : out_(out), x_(x), en_(en)
       {}
 
       template< typename ... T >
@@ -687,7 +866,7 @@ namespace Dune
                             lf.bind(en_);
                             typedef typename std::remove_pointer< decltype( df ) >::type DFType;
                             typename DFType::FunctionSpaceType::RangeType u;
-                            lf.evaluate( quad_[ i_ ], u );
+                            lf.evaluate( x_, u );
 
                             constexpr int dimRange = DFType::FunctionSpaceType::dimRange;
                             for( auto k = 0; k < dimRange; ++k )
@@ -744,12 +923,20 @@ namespace Dune
         case 3: outputFormat_ = binary; break;
         case 4: outputFormat_ = gnuplot; break;
         case 5: outputFormat_ = none; break;
+        case 6: outputFormat_ = vtklagrange; break;
         default:
           DUNE_THROW(NotImplemented,"DataOutput::init: wrong output format");
       }
 
       conformingOutput_ = param_->conformingoutput();
 
+      if( writeMode && param_->asyncoutput() && (outputFormat_ != binary) && (outputFormat_ != none) )
+      {
+        asyncOutput_.reset( new AsyncFileWriter() );
+        // pending output reads the grid and the (managed) snapshots, so finish it before they change
+        DofManager< GridType >::instance( grid_ ).addPreModificationCallback( this, [ this ] () { wait(); } );
+      }
+
       grapeDisplay_ = param_->grapedisplay();
 
       // get parameters for data writing
@@ -764,7 +951,7 @@ namespace Dune
       if( writeMode )
       {
         // only write series file for VTK output
-        if ( Parameter :: verbose() && outputFormat_ < binary )
+        if ( Parameter :: verbose() && (outputFormat_ < binary || outputFormat_ == vtklagrange) )
         {
           sequence_.reset( new FileWriter( path_ + "/" + datapref_ + ".series" ) );
           pvd_.reset( new PVDWriter( path_ + "/" + datapref_ + ".pvd" ) );
@@ -800,6 +987,25 @@ namespace Dune
       std::string filename;
       // check online display
       display();
+
+      if( asyncOutput_ && (outputFormat_ != binary) && (outputFormat_ != none) )
+      {
+        writeAsync( sequenceStamp, outstring );
+
+        if( Parameter::verbose() )
+        {
+          std::cout << myClassName() << "[" << grid_.comm().rank() << "]::write data (async)"
+                    << " writestep=" << writeStep_
+                    << " sequenceStamp=" << sequenceStamp
+                    << outstring
+                    << std::endl;
+        }
+
+        saveTime_ += saveStep_;
+        ++writeStep_;
+        return;
+      }
+
       switch( outputFormat_ )
       {
         // if no output was chosen just return
@@ -808,6 +1014,7 @@ namespace Dune
         case vtk :
         case vtkvtx :
         case subvtk :
+        case vtklagrange :
 #if USE_VTKWRITER
           // write data in vtk output format
           filename = writeVTKOutput();
@@ -822,11 +1029,7 @@ namespace Dune
 
       if( outputFormat_ != none )
       {
-        if( sequence_ )
-          (*sequence_)( std::to_string( writeStep_ ) + " " + filename + " " + std::to_string( sequenceStamp ) + outstring );
-
-        if( pvd_ )
-          (*pvd_)( sequenceStamp, filename );
+        writeSeries( sequence_.get(), pvd_.get(), writeStep_, sequenceStamp, outstring, filename );
 
         if( Parameter::verbose() )
         {
@@ -849,8 +1052,6 @@ namespace Dune
     inline std::string DataOutput< GridImp, DataImp >::writeVTKOutput () const
     {
       std::string filename;
-      // check whether to use vertex data of discontinuous data
-      const bool vertexData = (outputFormat_ == vtkvtx);
 
       // check whether we have parallel run
       const bool parallel = (grid_.comm().size() > 1);
@@ -860,44 +1061,65 @@ namespace Dune
 
       // get GridPart
       const auto& gridPart = getGridPart();
-      typedef typename std::decay< decltype( gridPart ) >::type GridPartType;
 
-      if( vertexData )
+      // write all data
+      vtkOutput( gridPart, data_, [ this, parallel, &name, &filename ] ( auto io ) {
+          filename = io->write( parallel, name, path_ );
+        } );
+      return filename;
+    }
+
+
+    template< class GridImp, class DataImp >
+    template< class GridPartType, class Write >
+    inline void DataOutput< GridImp, DataImp >::vtkOutput ( const GridPartType &gridPart, const OutPutDataType &data, Write write ) const
+    {
+      if( outputFormat_ == vtkvtx )
       {
 #if ENABLE_VTXPROJECTION
         // create vtk output handler
-        VTKOutputerLagrange< VTKIO< GridPartType > > io( gridPart, VTK::conforming, param_->parameter() );
+        auto io = std::make_shared< VTKOutputerLagrange< VTKIO< GridPartType > > >( gridPart, VTK::conforming, param_->parameter() );
 
         // add all functions
-        io.forEach( data_ );
+        io->forEach( data );
 
         // write all data
-        filename = io.write( parallel, name, path_ );
+        write( io );
 #endif
       }
       else if ( outputFormat_ == vtk )
       {
         // create vtk output handler
-        VTKOutputerDG< VTKIO< GridPartType > > io( conformingOutput_, gridPart, conformingOutput_ ? VTK::conforming : VTK::nonconforming, param_->parameter() );
+        auto io = std::make_shared< VTKOutputerDG< VTKIO< GridPartType > > >( conformingOutput_, gridPart, conformingOutput_ ? VTK::conforming : VTK::nonconforming, param_->parameter() );
 
         // add all functions
-        io.forEach( data_ );
+        io->forEach( data );
 
         // write all data
-        filename = io.write( parallel, name, path_ );
+        write( io );
       }
       else if ( outputFormat_ == subvtk )
       {
         // create vtk output handler
-        VTKOutputerDG< SubsamplingVTKIO < GridPartType > > io( conformingOutput_, gridPart, static_cast< unsigned int >( param_->subsamplingLevel() ), param_->parameter() );
+        auto io = std::make_shared< VTKOutputerDG< SubsamplingVTKIO < GridPartType > > >( conformingOutput_, gridPart, static_cast< unsigned int >( param_->subsamplingLevel() ), param_->parameter() );
 
         // add all functions
-        io.forEach( data_ );
+        io->forEach( data );
 
         // write all data
-        filename = io.write( parallel, name, path_ );
+        write( io );
+      }
+      else if ( outputFormat_ == vtklagrange )
+      {
+        // create vtu output handler
+        auto io = std::make_shared< VTUOutputerLagrange< GridPartType > >( gridPart, param_->lagrangeOrder(), param_->parameter() );
+
+        // add all functions
+        io->forEach( data );
+
+        // write all data
+        write( io );
       }
-      return filename;
     }
 #endif // #if USE_VTKWRITER
 
@@ -908,22 +1130,50 @@ namespace Dune
       // generate filename
       auto name = generateFilename( path_ + "/" + datapref_, writeStep_ );
       name += ".gnu";
+      const auto &gridPart = getGridPart();
+      return writeGnuPlotOutput( gridPart, gnuplotPoints( gridPart ), data_, name );
+    }
+
+
+    template< class GridImp, class DataImp >
+    template< class GridPartType >
+    inline typename DataOutput< GridImp, DataImp >::template GnuplotPoints< GridPartType >
+    DataOutput< GridImp, DataImp >::gnuplotPoints ( const GridPartType &gridPart )
+    {
+      GnuplotPoints< GridPartType > points;
+      for( const auto &entity : elements( gridPart ) )
+      {
+        auto &typePoints = points[ entity.type() ];
+        if( !typePoints.empty() )
+          continue;
+        ElementQuadrature< GridPartType, 0 > quad( entity.type(), 1 );
+        for( decltype(quad.nop()) i = 0; i < quad.nop(); ++i )
+          typePoints.push_back( quad.point( i ) );
+      }
+      return points;
+    }
+
+
+    template< class GridImp, class DataImp >
+    template< class GridPartType >
+    inline std::string DataOutput< GridImp, DataImp >
+      ::writeGnuPlotOutput ( const GridPartType &gridPart, const GnuplotPoints< GridPartType > &points,
+                             const OutPutDataType &data, const std::string &name )
+    {
       std::ofstream gnuout(name.c_str());
       gnuout << std::scientific << std::setprecision( 16 );
 
-      // start iteration
-      const auto& gridPart = getGridPart();
-      typedef typename std::decay< decltype( gridPart ) >::type GridPartType;
+      // start iteration (the local functions are evaluated in plain coordinates,
+      // so no caching quadratures or other singletons are used here)
       for( const auto& entity : elements( gridPart ) )
       {
-        CachingQuadrature< GridPartType, 0 > quad( entity, 1 );
-        for( decltype(quad.nop()) i = 0; i < quad.nop(); ++i )
+        for( const auto &xLocal : points.at( entity.type() ) )
         {
-          const auto x = entity.geometry().global( quad.point( i ) );
+          const auto x = entity.geometry().global( xLocal );
           for( auto k = 0; k < x.dimension; ++k )
             gnuout << (k > 0 ? " " : "") << x[ k ];
-          GnuplotOutputer< GridPartType > io( gnuout, quad, i, entity );
-          io.forEach( data_ );
+          GnuplotOutputer< GridPartType > io( gnuout, xLocal, entity );
+          io.forEach( data );
           gnuout << std::endl;
         }
       }
@@ -931,6 +1181,65 @@ namespace Dune
     }
 
 
+    template< class GridImp, class DataImp >
+    inline void DataOutput< GridImp, DataImp >::writeAsync ( double sequenceStamp, const std::string &outstring ) const
+    {
+      // bound the number of data sets in flight and release finished snapshots
+      asyncOutput_->waitPending( static_cast< std::size_t >( std::max( param_->asyncbuffers(), 1 ) - 1 ) );
+      const std::size_t pending = asyncOutput_->numPending();
+      while( snapshots_.size() > pending )
+        snapshots_.pop_front();
+
+      // the snapshot owns all data of this write; it is only released on this
+      // thread, since discrete functions must not be destroyed in the background
+      Snapshot snapshot;
+
+      // keep the snapshot until the task is finished (snapshots_ must match the
+      // pending tasks, so it is only stored if a task is actually submitted)
+      auto submit = [ this, &snapshot ] ( auto task ) {
+          snapshots_.emplace_back();
+          snapshots_.back().data.swap( snapshot.data );
+          asyncOutput_->submit( std::move( task ) );
+        };
+
+      typedef std::decay_t< decltype( getGridPart() ) > GridPartType;
+      auto gridPart = std::make_shared< GridPartType >( getGridPart() );
+      snapshot.data.push_back( gridPart );
+
+      // copy the discrete functions (vertex data is projected on this thread)
+      auto data = std::make_shared< OutPutDataType >( data_ );
+      if( outputFormat_ != vtkvtx )
+        *data = copyData( data_, snapshot, std::make_index_sequence< std::tuple_size< OutPutDataType >::value >() );
+      snapshot.data.push_back( data );
+
+      auto series = [ sequence = sequence_.get(), pvd = pvd_.get(), writeStep = writeStep_, sequenceStamp, outstring ] ( const std::string &filename ) {
+          writeSeries( sequence, pvd, writeStep, sequenceStamp, outstring, filename );
+        };
+
+      if( outputFormat_ == gnuplot )
+      {
+        const std::string name = generateFilename( path_ + "/" + datapref_, writeStep_ ) + ".gnu";
+        submit( [ gridPart = gridPart.get(), points = gnuplotPoints( *gridPart ), data = data.get(), name, series ] () {
+            series( writeGnuPlotOutput( *gridPart, points, *data, name ) );
+          } );
+        return;
+      }
+
+#if USE_VTKWRITER
+      // write without communication on the background thread
+      const std::string name = generateFilename( path_ + "/" + datapref_, writeStep_ );
+      const int rank = grid_.comm().rank();
+      const int size = grid_.comm().size();
+      vtkOutput( *gridPart, *data, [ &snapshot, &submit, name, rank, size, series ] ( auto io ) {
+          snapshot.data.push_back( io );
+          submit( [ io = io.get(), name, rank, size, series ] () { series( io->write( name, rank, size ) ); } );
+        } );
+#else // #if USE_VTKWRITER
+      DUNE_THROW(NotImplemented,"DataOutput::write: VTKWriter was disabled by USE_VTKWRITER 0");
+#endif // #else // #if USE_VTKWRITER
+    }
+
+
 #if USE_GRAPE
     template< class GridImp, class DataImp >
     template< class OutputTupleType >
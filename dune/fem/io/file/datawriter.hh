@@ -1,12 +1,15 @@
 #ifndef DUNE_FEM_DATAWRITER_HH
 #define DUNE_FEM_DATAWRITER_HH
 
+#include <exception>
+#include <iostream>
 #include <string>
 #include <tuple>
 #include <limits>
 #include <memory>
 
 #include <dune/fem/io/file/asciiparser.hh>
+#include <dune/fem/io/file/asyncfilewriter.hh>
 #include <dune/fem/io/file/iointerface.hh>
 #include <dune/fem/io/file/iotuple.hh>
 #include <dune/fem/io/parameter.hh>
@@ -205,6 +208,12 @@ namespace Dune
         return parameter().getValue< std::string > ( keyPrefix_ +  "checkpointfile", "checkpoint" );
       }
 
+      //! return true if checkpoints are written on a background thread (fem.io.checkpointasync)
+      virtual bool asyncCheckPoint() const
+      {
+        return parameter().getValue< bool > ( keyPrefix_ + "checkpointasync", false );
+      }
+
       //! writeMode, true when checkpointer is in backup mode
       virtual bool writeMode() const
       {
@@ -231,6 +240,25 @@ namespace Dune
        The derivation from DataWriter is simply to use the writeStep method. The
        binary output of DataWriter is not used anymore and does not work for
        checkpointing.
+
+       If the parameter fem.io.checkpointasync is set, the persistent objects
+       are serialized into memory and written to disk by a background thread
+       while the computation continues. A new checkpoint is staged while the
+       previous one is still written (if they use different directories) and
+       waits for its completion afterwards. The checkpoint info file is only
+       updated once all ranks have written the data, i.e., by the next
+       checkpoint, by waitForCompletion or by the destructor; all of these are
+       collective operations.
+
+       Limitations of the asynchronous checkpoints:
+       - Only the disk output is asynchronous. The serialization, including
+         the grid backup, is done by the calling thread. If the grid does not
+         support the stream backup, the grid is even written to disk
+         synchronously.
+       - The staged checkpoint is held in memory until it is written, i.e.,
+         the dof data needs twice its memory while a checkpoint is pending.
+         The stream backup of the grid is temporarily held three times (grid
+         backup stream, its string copy and the staging buffer).
     */
     template< class GridImp >
     class CheckPointer
@@ -347,6 +375,10 @@ namespace Dune
 
       bool takeCareOfPersistenceManager_;
 
+      std::unique_ptr< AsyncFileWriter > asyncWriter_;
+      // info of the last asynchronous checkpoint, written once all ranks have finished it
+      mutable std::string pendingInfo_, pendingInfoFile_;
+
     public:
       /** \brief Constructor generating a checkpointer
         \param grid corresponding grid
@@ -386,6 +418,22 @@ namespace Dune
         initialize( parameter );
       }
 
+      ~CheckPointer ()
+      {
+        try
+        {
+          finishCheckPoint();
+        }
+        catch( const Dune::Exception &e )
+        {
+          std::cerr << "ERROR: CheckPointer: " << e << std::endl;
+        }
+        catch( const std::exception &e )
+        {
+          std::cerr << "ERROR: CheckPointer: " << e.what() << std::endl;
+        }
+      }
+
     protected:
       void initialize( const CheckPointerParameters& parameter )
       {
@@ -398,6 +446,9 @@ namespace Dune
         checkPointFile_ += "/";
         checkPointFile_ += parameter.prefix();
 
+        if( parameter.asyncCheckPoint() )
+          asyncWriter_.reset( new AsyncFileWriter() );
+
         // write parameter file
         Parameter::write("parameter.log");
       }
@@ -666,9 +717,32 @@ namespace Dune
         // reset writeStep_ when maxCheckPointNumber_ is reached
         if( writeStep_ >= maxCheckPointNumber_ ) writeStep_ = 0;
 
+        // the previous checkpoint is written to the same directory
+        if( asyncWriter_ && (maxCheckPointNumber_ <= 1) )
+          finishCheckPoint();
+
         // write data
         std::string path = this->writeMyBinaryData( time, writeStep_, data_ );
 
+        if( asyncWriter_ )
+        {
+          // stage persistent values in memory while the previous checkpoint is written
+          PersistenceManager::StagedBackup staged;
+          if( takeCareOfPersistenceManager_ )
+            staged = PersistenceManager::backupStaged( path );
+
+          // completion barrier for the previous checkpoint (on all ranks)
+          finishCheckPoint();
+
+          if( !staged.filename.empty() )
+            asyncWriter_->write( std::move( staged.filename ), std::move( staged.data ) );
+
+          // the checkpoint info is written once all ranks have written this checkpoint
+          pendingInfo_ = checkPointInfo( time, writeStep_ );
+          pendingInfoFile_ = path + "/" + datapref_;
+          return;
+        }
+
         // if true also backup PersistenceManager
         if( takeCareOfPersistenceManager_ )
         {
@@ -683,7 +757,48 @@ namespace Dune
         return;
       }
 
+      /** \brief wait until the last checkpoint has been written completely
+       *         by all ranks and update the checkpoint info file
+       *
+       *  \note Only needed for asynchronous checkpointing, e.g., before the
+       *        checkpoint files are accessed by the program itself. This is a
+       *        collective operation.
+       */
+      void waitForCompletion () const
+      {
+        finishCheckPoint();
+      }
+
     protected:
+      // wait for the asynchronous checkpoint on all ranks and write its info file
+      void finishCheckPoint () const
+      {
+        if( !asyncWriter_ )
+          return;
+
+        std::exception_ptr exception;
+        try
+        {
+          asyncWriter_->wait();
+        }
+        catch( ... )
+        {
+          exception = std::current_exception();
+        }
+
+        // the info file may only refer to checkpoints written on all ranks
+        const bool written = (grid_.comm().min( exception ? 0 : 1 ) == 1);
+        if( written && !pendingInfo_.empty() && (myRank_ <= 0) )
+          writeCheckPointFiles( pendingInfo_, checkPointFile_, pendingInfoFile_ );
+        pendingInfo_.clear();
+        pendingInfoFile_.clear();
+
+        if( exception )
+          std::rethrow_exception( exception );
+        if( !written )
+          DUNE_THROW( IOError, "CheckPointer: checkpoint could not be written on all ranks." );
+      }
+
       //! read checkpoint file
       bool readCheckPoint(const bool warn = true)
       {
@@ -723,39 +838,46 @@ namespace Dune
         // only proc 0 writes the global checkpoint file
         if( myRank_ <= 0 )
         {
-          std::string checkpointstr ;
-          {
-            std::stringstream checkpoint;
-            checkpoint << "LastCheckPoint: " << savestep << std::endl;
-            checkpoint.precision( 16 );
-            checkpoint << "Time: " << std::scientific << time << std::endl;
-            checkpoint << "SaveCount: " << savestep << std::endl;
-            checkpoint << "PersistenceManager: " << takeCareOfPersistenceManager_ << std::endl;
-            checkpoint << "NumberProcessors: " << grid_.comm().size() << std::endl;
-            checkpoint << "# RecoverPath can be edited by hand if data has been moved!" << std::endl;
-            checkpoint << "RecoverPath: " << path_ << std::endl;
-            checkpointstr = checkpoint.str();
-          }
+          std::string checkPointStepFile( path );
+          checkPointStepFile += "/" + datapref_;
+          writeCheckPointFiles( checkPointInfo( time, savestep ), checkPointFile_, checkPointStepFile );
+        }
+      }
+
+      // contents of the checkpoint file
+      std::string checkPointInfo ( const double time, const int savestep ) const
+      {
+        std::stringstream checkpoint;
+        checkpoint << "LastCheckPoint: " << savestep << std::endl;
+        checkpoint.precision( 16 );
+        checkpoint << "Time: " << std::scientific << time << std::endl;
+        checkpoint << "SaveCount: " << savestep << std::endl;
+        checkpoint << "PersistenceManager: " << takeCareOfPersistenceManager_ << std::endl;
+        checkpoint << "NumberProcessors: " << grid_.comm().size() << std::endl;
+        checkpoint << "# RecoverPath can be edited by hand if data has been moved!" << std::endl;
+        checkpoint << "RecoverPath: " << path_ << std::endl;
+        return checkpoint.str();
+      }
 
-          // overwrite the last checkpoint file
+      static void writeCheckPointFiles ( const std::string &checkpointstr,
+                                         const std::string &checkPointFile,
+                                         const std::string &checkPointStepFile )
+      {
+        // overwrite the last checkpoint file
+        {
+          std::ofstream file (checkPointFile.c_str());
+          if( file.is_open() )
           {
-            std::ofstream file (checkPointFile_.c_str());
-            if( file.is_open() )
-            {
-              file << checkpointstr;
-            }
+            file << checkpointstr;
           }
+        }
 
-          // write check point file for this checkpoint
+        // write check point file for this checkpoint
+        {
+          std::ofstream file ( checkPointStepFile.c_str() );
+          if( file.is_open() )
           {
-            std::string checkPointStepFile( path );
-            checkPointStepFile += "/" + datapref_;
-
-            std::ofstream file ( checkPointStepFile.c_str() );
-            if( file.is_open() )
-            {
-              file << checkpointstr;
-            }
+            file << checkpointstr;
           }
         }
       }
@@ -0,0 +1,326 @@
+#ifndef DUNE_FEM_IO_FILE_ENTITYKEYEDDATA_HH
+#define DUNE_FEM_IO_FILE_ENTITYKEYEDDATA_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/fem/gridpart/common/gridpart.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/streams/sharedfilestreams.hh>
+#include <dune/fem/io/streams/standardstreams.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    /** \addtogroup Checkpointing
+     *
+     *  \section EntityKeyedData Redistributable Discrete Functions
+     *
+     *  writeEntityKeyedData stores the local dofs of a discrete function for
+     *  each interior element together with the global id of the element in a
+     *  single shared file (see SharedFile). readEntityKeyedData restores the
+     *  discrete function on a grid with the same elements (i.e., the same
+     *  global ids), which may be distributed differently or onto a different
+     *  number of processes. Each process reads only its share of the chunks.
+     *  The entries are then redistributed by hashing the global id: first to
+     *  the process owning the hash value, which then answers the requests of
+     *  the processes holding the elements. This way, each process reads
+     *  about 1/P of the file.
+     */
+
+    namespace Impl
+    {
+
+      template< class GridPart, class Entity >
+      inline std::string entityKey ( const GridPart &gridPart, const Entity &entity )
+      {
+        std::ostringstream key;
+        key << gridPart.grid().globalIdSet().id( gridEntity( entity ) );
+        return key.str();
+      }
+
+      // process collecting the entry for a given key during redistribution
+      inline int entityKeyOwner ( const std::string &key, int size )
+      {
+        return static_cast< int >( std::hash< std::string >()( key ) % std::size_t( size ) );
+      }
+
+      // send one buffer to each process and receive one buffer from each process (collective)
+      inline std::vector< std::string > exchangeEntityKeyedData ( const std::vector< std::string > &send,
+                                                                 MPIHelper::MPICommunicator mpiComm )
+      {
+#if HAVE_MPI
+        int size = 1;
+        MPI_Comm_size( mpiComm, &size );
+        if( size > 1 )
+        {
+          assert( send.size() == std::size_t( size ) );
+          const std::size_t maxCount = std::numeric_limits< int >::max();
+
+          std::vector< int > sendCounts( size ), sendDispls( size ), recvCounts( size ), recvDispls( size );
+          std::size_t sendSize = 0;
+          for( int p = 0; p < size; ++p )
+            sendSize += send[ p ].size();
+          int valid = (sendSize <= maxCount);
+
+          std::string sendData;
+          if( valid )
+          {
+            sendData.reserve( sendSize );
+            for( int p = 0; p < size; ++p )
+            {
+              sendDispls[ p ] = sendData.size();
+              sendCounts[ p ] = send[ p ].size();
+              sendData += send[ p ];
+            }
+          }
+
+          MPI_Alltoall( sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, mpiComm );
+          std::size_t recvSize = 0;
+          for( int p = 0; p < size; ++p )
+          {
+            recvDispls[ p ] = std::min( recvSize, maxCount );
+            recvSize += recvCounts[ p ];
+          }
+          valid = valid && (recvSize <= maxCount);
+
+          // MPI counts are int, so each process may send and receive at most 2 GiB
+          int allValid = 0;
+          MPI_Allreduce( &valid, &allValid, 1, MPI_INT, MPI_MIN, mpiComm );
+          if( !allValid )
+            DUNE_THROW( IOError, "Entity keyed data exceeds the message size for redistribution." );
+
+          std::string recvData( recvSize, '\0' );
+          MPI_Alltoallv( const_cast< char * >( sendData.data() ), sendCounts.data(), sendDispls.data(), MPI_CHAR,
+                         &recvData[ 0 ], recvCounts.data(), recvDispls.data(), MPI_CHAR, mpiComm );
+
+          std::vector< std::string > recv( size );
+          for( int p = 0; p < size; ++p )
+            recv[ p ] = recvData.substr( recvDispls[ p ], recvCounts[ p ] );
+          return recv;
+        }
+#endif // #if HAVE_MPI
+        return send;
+      }
+
+      // read all entries (key and local dofs) from a buffer
+      template< class DofType, class F >
+      inline void forEachEntityKeyedEntry ( const std::string &buffer, F f )
+      {
+        std::stringstream data( buffer );
+        StandardInStream in( data );
+        std::string key;
+        std::vector< DofType > localDofs;
+        while( data.peek() != std::char_traits< char >::eof() )
+        {
+          in >> key;
+          unsigned int size = 0;
+          in >> size;
+          localDofs.resize( size );
+          for( DofType &dof : localDofs )
+            in >> dof;
+          f( key, localDofs );
+        }
+      }
+
+      // append an entry (key and local dofs) to a stream
+      template< class DofType >
+      inline void writeEntityKeyedEntry ( StandardOutStream &out, const std::string &key, const std::vector< DofType > &localDofs )
+      {
+        out << key;
+        out << static_cast< unsigned int >( localDofs.size() );
+        for( const DofType &dof : localDofs )
+          out << dof;
+      }
+
+    } // namespace Impl
+
+
+
+    /** \brief write the local dofs of all interior elements keyed by global
+     *         entity id into a shared file (collective)
+     *
+     *  \param[in]  df        discrete function to write
+     *  \param[in]  filename  name of the file (must be the same on all ranks)
+     *  \param[in]  mpiComm   MPI communicator of the grid
+     *  \param[in]  parameter parameters (reads fem.io.sharedfile.mpiio)
+     */
+    template< class DiscreteFunction >
+    inline void writeEntityKeyedData ( const DiscreteFunction &df, const std::string &filename,
+                                       MPIHelper::MPICommunicator mpiComm,
+                                       const ParameterReader &parameter = Parameter::container() )
+    {
+      typedef typename DiscreteFunction::DofType DofType;
+      const auto &gridPart = df.space().gridPart();
+
+      std::stringstream data;
+      {
+        StandardOutStream out( data );
+        std::vector< DofType > localDofs;
+        for( const auto &entity : elements( gridPart, Partitions::interior ) )
+        {
+          localDofs.resize( df.space().basisFunctionSet( entity ).size() );
+          df.getLocalDofs( entity, localDofs );
+          Impl::writeEntityKeyedEntry( out, Impl::entityKey( gridPart, entity ), localDofs );
+        }
+        out.flush();
+      }
+
+      SharedFile::write( filename, data.str(), mpiComm, parameter.getValue< bool >( "fem.io.sharedfile.mpiio", true ) );
+    }
+
+    /** \brief write the local dofs of all interior elements keyed by global
+     *         entity id into a shared file (collective on MPIHelper::getCommunicator())
+     */
+    template< class DiscreteFunction >
+    inline void writeEntityKeyedData ( const DiscreteFunction &df, const std::string &filename,
+                                       const ParameterReader &parameter = Parameter::container() )
+    {
+      writeEntityKeyedData( df, filename, MPIHelper::getCommunicator(), parameter );
+    }
+
+
+
+    /** \brief restore a discrete function written by writeEntityKeyedData,
+     *         possibly with a different number of processes (collective)
+     *
+     *  \param[out]  df        discrete function to restore
+     *  \param[in]   filename  name of the file
+     *  \param[in]   mpiComm   MPI communicator of the grid
+     */
+    template< class DiscreteFunction >
+    inline void readEntityKeyedData ( DiscreteFunction &df, const std::string &filename,
+                                      MPIHelper::MPICommunicator mpiComm = MPIHelper::getCommunicator() )
+    {
+      typedef typename DiscreteFunction::DofType DofType;
+      const auto &gridPart = df.space().gridPart();
+
+      const CollectiveCommunication< MPIHelper::MPICommunicator > comm( mpiComm );
+      const int rank = comm.rank(), size = comm.size();
+
+      // read this process' share of the chunks and send each entry to the owner of its key
+      std::vector< std::string > entries( size );
+      {
+        std::ifstream file( filename.c_str(), std::ios::binary );
+        if( !file )
+          DUNE_THROW( IOError, "Unable to open file: " << filename );
+
+        const SharedFile::Index index = SharedFile::readIndex( file );
+        const int begin = (long( rank ) * index.chunks()) / size;
+        const int end = (long( rank+1 ) * index.chunks()) / size;
+
+        std::vector< std::stringstream > data( size );
+        std::vector< std::unique_ptr< StandardOutStream > > out( size );
+        for( int p = 0; p < size; ++p )
+          out[ p ].reset( new StandardOutStream( data[ p ] ) );
+        for( int chunk = begin; chunk < end; ++chunk )
+        {
+          Impl::forEachEntityKeyedEntry< DofType >( SharedFile::read( file, index, chunk ), [ &out, size ] ( const std::string &key, const std::vector< DofType > &localDofs ) {
+              Impl::writeEntityKeyedEntry( *out[ Impl::entityKeyOwner( key, size ) ], key, localDofs );
+            } );
+        }
+        for( int p = 0; p < size; ++p )
+        {
+          out[ p ]->flush();
+          entries[ p ] = data[ p ].str();
+        }
+      }
+      entries = Impl::exchangeEntityKeyedData( entries, mpiComm );
+
+      // entries of the keys owned by this process
+      std::unordered_map< std::string, std::vector< DofType > > owned;
+      for( const std::string &buffer : entries )
+      {
+        Impl::forEachEntityKeyedEntry< DofType >( buffer, [ &owned ] ( const std::string &key, const std::vector< DofType > &localDofs ) {
+            owned[ key ] = localDofs;
+          } );
+      }
+      entries.clear();
+
+      // request the entries of the elements of this process from the owners of their keys
+      std::vector< std::string > requests( size );
+      {
+        std::vector< std::stringstream > data( size );
+        std::vector< std::unique_ptr< StandardOutStream > > out( size );
+        for( int p = 0; p < size; ++p )
+          out[ p ].reset( new StandardOutStream( data[ p ] ) );
+        for( const auto &entity : elements( gridPart ) )
+        {
+          const std::string key = Impl::entityKey( gridPart, entity );
+          *out[ Impl::entityKeyOwner( key, size ) ] << key;
+        }
+        for( int p = 0; p < size; ++p )
+        {
+          out[ p ]->flush();
+          requests[ p ] = data[ p ].str();
+        }
+      }
+      requests = Impl::exchangeEntityKeyedData( requests, mpiComm );
+
+      // answer the requests (keys without data are answered with an empty entry)
+      std::vector< std::string > replies( size );
+      for( int p = 0; p < size; ++p )
+      {
+        std::stringstream data;
+        {
+          StandardOutStream out( data );
+          std::stringstream request( requests[ p ] );
+          StandardInStream in( request );
+          std::string key;
+          const std::vector< DofType > empty;
+          while( request.peek() != std::char_traits< char >::eof() )
+          {
+            in >> key;
+            const auto it = owned.find( key );
+            Impl::writeEntityKeyedEntry( out, key, (it != owned.end() ? it->second : empty) );
+          }
+          out.flush();
+        }
+        replies[ p ] = data.str();
+      }
+      owned.clear();
+      replies = Impl::exchangeEntityKeyedData( replies, mpiComm );
+
+      std::unordered_map< std::string, std::vector< DofType > > values;
+      for( const std::string &buffer : replies )
+      {
+        Impl::forEachEntityKeyedEntry< DofType >( buffer, [ &values ] ( const std::string &key, const std::vector< DofType > &localDofs ) {
+            if( !localDofs.empty() )
+              values[ key ] = localDofs;
+          } );
+      }
+
+      for( const auto &entity : elements( gridPart ) )
+      {
+        const auto it = values.find( Impl::entityKey( gridPart, entity ) );
+        if( it == values.end() )
+          DUNE_THROW( IOError, "No data for element found in " << filename << "." );
+        if( it->second.size() != std::size_t( df.space().basisFunctionSet( entity ).size() ) )
+          DUNE_THROW( IOError, "Wrong number of local dofs in " << filename << "." );
+        df.setLocalDofs( entity, it->second );
+      }
+    }
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_IO_FILE_ENTITYKEYEDDATA_HH
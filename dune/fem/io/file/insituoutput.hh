@@ -0,0 +1,428 @@
+#ifndef DUNE_FEM_IO_FILE_INSITUOUTPUT_HH
+#define DUNE_FEM_IO_FILE_INSITUOUTPUT_HH
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/type.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/fem/function/localfunction/const.hh>
+#include <dune/fem/gridpart/common/entitysearch.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/streams/binarystreams.hh>
+#include <dune/fem/misc/threads/parallelfor.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
+#include <dune/fem/quadrature/elementquadrature.hh>
+#include <dune/fem/solver/timeprovider.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // InSituOutput
+    // ------------
+
+    /** \brief reduced output of discrete functions during time stepping
+     *
+     *  Instead of full fields, the InSituOutput records
+     *  - the values in given probe points (addProbes),
+     *  - the values in equidistant points on a line segment (addLineSampler),
+     *  - the values in an equidistant grid of points on a plane (addPlaneSampler),
+     *  - integrals over the (interior part of the) domain (addIntegral).
+     *
+     *  The elements containing the sampling points are located once (using
+     *  the batched EntitySearch::findEntities) and only again after the grid
+     *  part's sequence changed.
+     *  The evaluation is thread parallel; the values are summed up over all
+     *  ranks (every point is evaluated by one rank only) and rank 0 appends
+     *  them to the binary time series file \<fem.prefix\>/\<name\>.insitu,
+     *  which can be read by a BinaryFileInStream:
+     *  - header: number of quantities; for each quantity its name, the number
+     *    of components, the number of points (0 for integrals) and the points,
+     *  - one record per write: time and all values (as doubles, ordered by
+     *    quantity, point and component).
+     *
+     *  All quantities must be added before the first write.
+     *
+     *  Parameters:
+     *  - <tt>fem.io.insitu.interval</tt>: write only every n-th call to write
+     *    (default: 1)
+     *
+     *  \note The discrete functions must stay alive as long as the
+     *        InSituOutput is used.
+     */
+    template< class GridPart >
+    class InSituOutput
+    {
+      typedef InSituOutput< GridPart > ThisType;
+
+    public:
+      typedef GridPart GridPartType;
+
+      typedef typename GridPartType::ctype ctype;
+      static const int dimensionworld = GridPartType::dimensionworld;
+
+      typedef FieldVector< ctype, dimensionworld > GlobalCoordinateType;
+
+      typedef typename GridPartType::template Codim< 0 >::EntityType ElementType;
+      typedef typename GridPartType::template Codim< 0 >::EntitySeedType ElementSeedType;
+
+    protected:
+      struct Quantity
+      {
+        virtual ~Quantity () {}
+
+        virtual const std::string &name () const = 0;
+        virtual int ncomps () const = 0;
+        virtual const std::vector< GlobalCoordinateType > &points () const = 0;
+
+        // number of values
+        std::size_t size () const { return ncomps() * std::max( points().size(), std::size_t( 1 ) ); }
+
+        // (re)locate the points after a grid change
+        virtual void update () = 0;
+        // local contribution of this rank to the values
+        virtual void evaluate ( double *values ) const = 0;
+      };
+
+      template< class DF >
+      struct PointQuantity;
+
+      template< class DF >
+      struct IntegralQuantity;
+
+    public:
+      /** \brief constructor
+       *
+       *  \param[in]  gridPart   grid part the functions live on
+       *  \param[in]  name       name of the time series file
+       *  \param[in]  parameter  parameters
+       */
+      InSituOutput ( const GridPartType &gridPart, const std::string &name,
+                     const ParameterReader &parameter = Parameter::container() )
+        : gridPart_( gridPart ),
+          filename_( parameter.getValue< std::string >( "fem.prefix", "." ) + "/" + name + ".insitu" ),
+          interval_( std::max( parameter.getValue< int >( "fem.io.insitu.interval", 1 ), 1 ) )
+      {}
+
+      //! record the values of a discrete function in the given points
+      template< class DF >
+      void addProbes ( const DF &df, std::vector< GlobalCoordinateType > points, const std::string &name = "" )
+      {
+        add( new PointQuantity< DF >( gridPart_, df, name.empty() ? df.name() : name, std::move( points ) ) );
+      }
+
+      /** \brief record the values of a discrete function on a line segment
+       *
+       *  \note The sampling points are equidistant and include the end points
+       *        (cf. LineSegmentSampler).
+       */
+      template< class DF >
+      void addLineSampler ( const DF &df, const GlobalCoordinateType &left, const GlobalCoordinateType &right,
+                            int numSamples, const std::string &name = "" )
+      {
+        if( numSamples < 2 )
+          DUNE_THROW( InvalidStateException, "InSituOutput cannot sample less than 2 points on a line." );
+
+        std::vector< GlobalCoordinateType > points( numSamples, left );
+        for( int i = 0; i < numSamples; ++i )
+          points[ i ].axpy( ctype( i ) / ctype( numSamples-1 ), right - left );
+        addProbes( df, std::move( points ), name );
+      }
+
+      /** \brief record the values of a discrete function on a plane
+       *
+       *  The sampling points are origin + s*u + t*v for equidistant s and t
+       *  in [0, 1] (including the end points).
+       */
+      template< class DF >
+      void addPlaneSampler ( const DF &df, const GlobalCoordinateType &origin,
+                             const GlobalCoordinateType &u, const GlobalCoordinateType &v,
+                             int numSamplesU, int numSamplesV, const std::string &name = "" )
+      {
+        if( (numSamplesU < 2) || (numSamplesV < 2) )
+          DUNE_THROW( InvalidStateException, "InSituOutput cannot sample less than 2 points in each direction of a plane." );
+
+        std::vector< GlobalCoordinateType > points;
+        points.reserve( numSamplesU * numSamplesV );
+        for( int j = 0; j < numSamplesV; ++j )
+          for( int i = 0; i < numSamplesU; ++i )
+          {
+            GlobalCoordinateType x = origin;
+            x.axpy( ctype( i ) / ctype( numSamplesU-1 ), u );
+            x.axpy( ctype( j ) / ctype( numSamplesV-1 ), v );
+            points.push_back( x );
+          }
+        addProbes( df, std::move( points ), name );
+      }
+
+      /** \brief record the integral of a discrete function over the domain
+       *
+       *  \param[in]  df     discrete function to integrate
+       *  \param[in]  name   name of the quantity (defaults to the function's name)
+       *  \param[in]  order  quadrature order (negative: order of the function)
+       */
+      template< class DF >
+      void addIntegral ( const DF &df, const std::string &name = "", int order = -1 )
+      {
+        add( new IntegralQuantity< DF >( gridPart_, df, name.empty() ? df.name() : name, order < 0 ? df.order() : order ) );
+      }
+
+      //! returns true if data will be written on the next call to write
+      bool willWrite () const { return (calls_ % interval_) == 0; }
+
+      //! record all quantities (in every fem.io.insitu.interval-th call)
+      void write ( double time )
+      {
+        if( willWrite() )
+          writeRecord( time );
+        ++calls_;
+      }
+
+      //! record all quantities at the current time (in every fem.io.insitu.interval-th call)
+      void write ( const TimeProviderBase &tp )
+      {
+        write( tp.time() );
+      }
+
+      //! name of the time series file
+      const std::string &filename () const { return filename_; }
+
+    protected:
+      void add ( Quantity *quantity )
+      {
+        std::unique_ptr< Quantity > q( quantity );
+        if( sequence_ >= 0 )
+          DUNE_THROW( InvalidStateException, "InSituOutput: Cannot add quantities after the first write." );
+        quantities_.push_back( std::move( q ) );
+      }
+
+      void writeRecord ( double time )
+      {
+        if( sequence_ != gridPart_.sequence() )
+        {
+          for( const auto &quantity : quantities_ )
+            quantity->update();
+          sequence_ = gridPart_.sequence();
+        }
+
+        std::vector< double > values;
+        for( const auto &quantity : quantities_ )
+        {
+          const std::size_t offset = values.size();
+          values.resize( offset + quantity->size() );
+          quantity->evaluate( values.data() + offset );
+        }
+        gridPart_.comm().sum( values.data(), values.size() );
+
+        if( gridPart_.comm().rank() != 0 )
+          return;
+
+        if( !out_ )
+        {
+          out_.reset( new BinaryFileOutStream( filename_ ) );
+          *out_ << static_cast< int >( quantities_.size() );
+          for( const auto &quantity : quantities_ )
+          {
+            *out_ << quantity->name() << quantity->ncomps() << static_cast< int >( quantity->points().size() );
+            for( const GlobalCoordinateType &x : quantity->points() )
+              for( int i = 0; i < dimensionworld; ++i )
+                *out_ << static_cast< double >( x[ i ] );
+          }
+        }
+
+        *out_ << time;
+        for( double value : values )
+          *out_ << value;
+        out_->flush();
+      }
+
+      const GridPartType &gridPart_;
+      std::string filename_;
+      int interval_;
+      int calls_ = 0;
+      int sequence_ = -1;
+
+      std::vector< std::unique_ptr< Quantity > > quantities_;
+      std::unique_ptr< BinaryFileOutStream > out_;
+    };
+
+
+
+    // InSituOutput::PointQuantity
+    // ---------------------------
+
+    template< class GridPart >
+    template< class DF >
+    struct InSituOutput< GridPart >::PointQuantity
+      : public Quantity
+    {
+      typedef typename DF::RangeType RangeType;
+      typedef typename ElementType::Geometry::LocalCoordinate LocalCoordinateType;
+
+      PointQuantity ( const GridPartType &gridPart, const DF &df, std::string name, std::vector< GlobalCoordinateType > points )
+        : gridPart_( gridPart ), name_( std::move( name ) ), points_( std::move( points ) ),
+          localFunctions_( ThreadManager::maxThreads(), ConstLocalFunction< DF >( df ) )
+      {}
+
+      const std::string &name () const override { return name_; }
+      int ncomps () const override { return RangeType::dimension; }
+      const std::vector< GlobalCoordinateType > &points () const override { return points_; }
+
+      void update () override
+      {
+        const std::size_t n = points_.size();
+        const int rank = gridPart_.comm().rank();
+        const int size = gridPart_.comm().size();
+
+        seeds_.resize( n );
+        local_.resize( n );
+        std::vector< int > owner( n, size );
+
+        std::vector< char > found;
+        const EntitySearch< GridPartType, 0, Interior_Partition > search( gridPart_ );
+        const std::vector< ElementType > elements = search.findEntities( points_, found );
+        for( std::size_t i = 0; i < n; ++i )
+        {
+          if( !found[ i ] )
+            continue;
+          seeds_[ i ] = elements[ i ].seed();
+          local_[ i ] = elements[ i ].geometry().local( points_[ i ] );
+          owner[ i ] = rank;
+        }
+
+        // points on the boundary between two ranks are evaluated by the lower rank
+        gridPart_.comm().min( owner.data(), n );
+        owned_.resize( n );
+        for( std::size_t i = 0; i < n; ++i )
+        {
+          if( owner[ i ] == size )
+            DUNE_THROW( InvalidStateException, "InSituOutput: Point " << points_[ i ] << " of '" << name_ << "' is outside the grid." );
+          owned_[ i ] = (owner[ i ] == rank);
+        }
+      }
+
+      void evaluate ( double *values ) const override
+      {
+        parallelFor( 0, points_.size(), 16, [ this, values ] ( std::size_t i ) {
+            double *value = values + i*RangeType::dimension;
+            if( !owned_[ i ] )
+            {
+              std::fill( value, value + RangeType::dimension, 0.0 );
+              return;
+            }
+
+            auto &localFunction = localFunctions_[ ThreadManager::thread() ];
+            localFunction.bind( gridPart_.entity( seeds_[ i ] ) );
+            RangeType u;
+            localFunction.evaluate( local_[ i ], u );
+            localFunction.unbind();
+            for( int k = 0; k < RangeType::dimension; ++k )
+              value[ k ] = std::real( u[ k ] );
+          } );
+      }
+
+    private:
+      const GridPartType &gridPart_;
+      std::string name_;
+      std::vector< GlobalCoordinateType > points_;
+
+      std::vector< ElementSeedType > seeds_;
+      std::vector< LocalCoordinateType > local_;
+      std::vector< char > owned_;
+
+      mutable std::vector< ConstLocalFunction< DF > > localFunctions_;
+    };
+
+
+
+    // InSituOutput::IntegralQuantity
+    // ------------------------------
+
+    template< class GridPart >
+    template< class DF >
+    struct InSituOutput< GridPart >::IntegralQuantity
+      : public Quantity
+    {
+      typedef typename DF::RangeType RangeType;
+      typedef ElementQuadrature< GridPartType, 0 > QuadratureType;
+
+      IntegralQuantity ( const GridPartType &gridPart, const DF &df, std::string name, int order )
+        : gridPart_( gridPart ), name_( std::move( name ) ), order_( order ),
+          localFunctions_( ThreadManager::maxThreads(), ConstLocalFunction< DF >( df ) )
+      {}
+
+      const std::string &name () const override { return name_; }
+      int ncomps () const override { return RangeType::dimension; }
+      const std::vector< GlobalCoordinateType > &points () const override { return points_; }
+
+      void update () override
+      {
+        elements_.clear();
+        std::vector< GeometryType > types;
+        for( const ElementType &element : elements( gridPart_, Partitions::interior ) )
+        {
+          elements_.push_back( element.seed() );
+          if( std::find( types.begin(), types.end(), element.type() ) == types.end() )
+            types.push_back( element.type() );
+        }
+
+        // quadratures must be created outside of parallel regions
+        for( const GeometryType &type : types )
+          QuadratureType( type, order_ );
+      }
+
+      void evaluate ( double *values ) const override
+      {
+        std::vector< RangeType > sums( localFunctions_.size(), RangeType( 0 ) );
+        parallelFor( 0, elements_.size(), 16, [ this, &sums ] ( std::size_t e ) {
+            const int thread = ThreadManager::thread();
+            const ElementType element = gridPart_.entity( elements_[ e ] );
+            const auto geometry = element.geometry();
+
+            auto &localFunction = localFunctions_[ thread ];
+            localFunction.bind( element );
+            const QuadratureType quadrature( element, order_ );
+            RangeType u;
+            for( std::size_t qp = 0; qp < quadrature.nop(); ++qp )
+            {
+              localFunction.evaluate( quadrature[ qp ], u );
+              sums[ thread ].axpy( quadrature.weight( qp ) * geometry.integrationElement( quadrature.point( qp ) ), u );
+            }
+            localFunction.unbind();
+          } );
+
+        std::fill( values, values + RangeType::dimension, 0.0 );
+        for( const RangeType &sum : sums )
+          for( int k = 0; k < RangeType::dimension; ++k )
+            values[ k ] += std::real( sum[ k ] );
+      }
+
+    private:
+      const GridPartType &gridPart_;
+      std::string name_;
+      int order_;
+      std::vector< GlobalCoordinateType > points_;
+
+      std::vector< ElementSeedType > elements_;
+
+      mutable std::vector< ConstLocalFunction< DF > > localFunctions_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_IO_FILE_INSITUOUTPUT_HH
@@ -144,7 +144,9 @@ namespace Dune
                 - binary = write binary data (only available with DataWriter and CheckPointer)
                 - gnuplot = write gunplot compatible data
                 - none = no data output
+                - vtk-lagrange = VTK Lagrange cells of order fem.io.lagrangeorder (native high order output)
                 .
+        \femparam{fem.io.lagrangeorder, order of VTK Lagrange cells (0 = maximal order of the data), 0}
         \femparam{fem.io.grapedisplay, use grape for online visualization; default is false}
         \femparam{fem.io.savestep, interval for writting data files}
          use value <0 to deativate
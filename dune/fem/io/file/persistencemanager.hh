@@ -8,9 +8,11 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <dune/common/visibility.hh>
 
+#include <dune/fem/io/file/asyncfilewriter.hh>
 #include <dune/fem/io/file/iointerface.hh>
 #include <dune/fem/io/parameter.hh>
 #include <dune/fem/io/streams/binarystreams.hh>
@@ -157,6 +159,19 @@ namespace Dune
       static const bool singleBackupRestoreFile = false ;
 #endif
 
+      //! true if the backup stream can write into memory (see backupStaged)
+      static const bool stagedBackupSupported = std::is_constructible< BackupStreamType, std::ostream & >::value;
+
+      /** \brief backup of all persistent objects staged in memory
+       *
+       *  If filename is empty, the backup has already been written.
+       */
+      struct StagedBackup
+      {
+        std::string filename;
+        StagingStreamBuffer::ChunksType data;
+      };
+
     private:
       typedef std::list< std::pair< PersistentObject *, unsigned int > > PersistentType;
       typedef PersistentType::iterator IteratorType;
@@ -279,6 +294,29 @@ namespace Dune
         closeStreams();
       }
 
+      StagedBackup backupObjectsStaged ( const std::string& path )
+      {
+        StagedBackup staged;
+        if( !stagedBackupSupported || invalid_ )
+        {
+          backupObjects( path );
+          return staged;
+        }
+
+        closed_ = true;
+        StagingStreamBuffer buffer;
+        std::ostream stream( &buffer );
+        staged.filename = startBackup( path, &stream );
+        typedef PersistentType::iterator IteratorType;
+
+        for( IteratorType it = objects_.begin(); it != objects_.end(); ++it )
+          it->first->backup();
+
+        closeStreams();
+        staged.data = buffer.release();
+        return staged;
+      }
+
       void restoreObjects ( const std::string &path )
       {
         if (invalid_) {
@@ -371,6 +409,19 @@ namespace Dune
         instance().backupObjects( path );
       }
 
+      /** \brief backup all objects into memory
+       *
+       *  All data written to backupStream() is collected in memory and
+       *  returned together with the name of the file it belongs to, e.g., to
+       *  write it asynchronously. Files written by the objects themselves
+       *  (e.g., using uniqueFileName) are written immediately. If the backup
+       *  stream type cannot write into memory, a regular backup is performed.
+       */
+      static StagedBackup backupStaged ( const std::string& path )
+      {
+        return instance().backupObjectsStaged( path );
+      }
+
       static void restore ( const std::string& path )
       {
         instance().restoreObjects( path );
@@ -417,18 +468,35 @@ namespace Dune
         return s.str();
       }
 
-      void startBackup ( const std::string &path )
+      template< class Stream >
+      static Stream *createStagingStream ( std::ostream &stream, std::true_type )
+      {
+        return new Stream( stream );
+      }
+
+      template< class Stream >
+      static Stream *createStagingStream ( std::ostream &stream, std::false_type )
+      {
+        return nullptr;
+      }
+
+      // open backup stream (writing into staging, if given) and return file name
+      std::string startBackup ( const std::string &path, std::ostream *staging = nullptr )
       {
         path_ = path + "/";
 
+        std::string filename;
         if( createDirectory( path_ ) )
         {
           const int rank = MPIManager :: rank() ;
           const int size = MPIManager :: size() ;
-          std::string filename( createFilename( path_, rank, size ) );
+          filename = createFilename( path_, rank, size );
 
           assert( backupStream_ == 0 );
-          backupStream_ = Fem :: StreamFactory<BackupStreamType> :: create( filename );
+          if( staging )
+            backupStream_ = createStagingStream< BackupStreamType >( *staging, std::integral_constant< bool, stagedBackupSupported >() );
+          else
+            backupStream_ = Fem :: StreamFactory<BackupStreamType> :: create( filename );
 
           if( rank == 0 )
           {
@@ -442,6 +510,7 @@ namespace Dune
         }
         else
           std::cerr << "Error: Unable to create '" << path_ << "'" << std::endl;
+        return filename;
       }
 
       void startRestoreImpl ( const std::string &path )
@@ -0,0 +1,164 @@
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/io/file/datawriter.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+static const int dimw = Dune::GridSelector::dimworld;
+
+typedef Dune::GridSelector::GridType GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< GridType::ctype, double, dimw, 2 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, POLORDER > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+typedef Dune::Fem::CheckPointer< GridType > CheckPointerType;
+
+// a linear function, different for each checkpoint
+struct LinearFunction
+  : public Dune::Fem::Function< FunctionSpaceType, LinearFunction >
+{
+  explicit LinearFunction ( int step ) : step_( step ) {}
+
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u[ 0 ] = step_;
+    u[ 1 ] = 1.0 - step_;
+    for( int i = 0; i < dimw; ++i )
+    {
+      u[ 0 ] += (step_+1) * x[ i ];
+      u[ 1 ] -= (i+1) * x[ i ];
+    }
+  }
+
+private:
+  int step_;
+};
+
+const std::string prefix = "./asynccheckpoint";
+const std::string checkPointFile = prefix + "/checkpoint";
+
+// return the value of the given key in the checkpoint info file
+std::string readInfo ( const std::string &key )
+{
+  std::ifstream in( checkPointFile );
+  for( std::string line; std::getline( in, line ); )
+  {
+    if( line.compare( 0, key.size()+1, key + ":" ) == 0 )
+      return line.substr( key.size()+2 );
+  }
+  return std::string();
+}
+
+// compare the info file to the checkpoint that should be recorded last
+int checkInfo ( int step, const std::string &when )
+{
+  const std::string time = readInfo( "Time" );
+  if( !time.empty() && (std::stod( time ) == step) )
+    return 0;
+  std::cerr << "Error: checkpoint info " << when << " records time '" << time << "' instead of " << step << "." << std::endl;
+  return 1;
+}
+
+// compare the dofs of uh to the interpolation of the function of the given step
+int checkValues ( const DiscreteFunctionType &uh, int step )
+{
+  DiscreteFunctionType wh( "reference", uh.space() );
+  interpolate( gridFunctionAdapter( LinearFunction( step ), uh.gridPart(), POLORDER ), wh );
+
+  double error = 0;
+  auto wit = wh.dbegin();
+  for( auto it = uh.dbegin(); it != uh.dend(); ++it, ++wit )
+    error = std::max( error, std::abs( *it - *wit ) );
+  if( error < 1e-12 )
+    return 0;
+  std::cerr << "Error: restored data differs from checkpoint " << step << " (error = " << error << ")." << std::endl;
+  return 1;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+  Dune::Fem::Parameter::append( argc, argv );
+  Dune::Fem::Parameter::append( "fem.prefix", prefix );
+  Dune::Fem::Parameter::append( "fem.io.checkpointfile", "checkpoint" );
+  Dune::Fem::Parameter::append( "fem.io.checkpointasync", "true" );
+  Dune::Fem::Parameter::append( "fem.io.checkpointmax", "2" );
+
+  int errors = 0;
+  const int lastStep = 2;
+
+  // write checkpoints, each overlapping with the next one
+  {
+    Dune::GridPtr< GridType > gridPtr( std::to_string( dimw ) + "dgrid.dgf" );
+    GridType &grid = *gridPtr;
+    grid.globalRefine( Dune::DGFGridInfo< GridType >::refineStepsForHalf() );
+    GridPartType gridPart( grid );
+    DiscreteFunctionSpaceType space( gridPart );
+    DiscreteFunctionType uh( "uh", space );
+    Dune::Fem::persistenceManager << uh;
+
+    CheckPointerType checkPointer( grid );
+    for( int step = 0; step <= lastStep; ++step )
+    {
+      interpolate( gridFunctionAdapter( LinearFunction( step ), gridPart, POLORDER ), uh );
+      checkPointer.writeData( step );
+
+      // the checkpoint holds a snapshot, so the data may be modified while it is written
+      uh.clear();
+
+      // the info file names the previous checkpoint, which has been finished by this one
+      if( (step > 0) && (grid.comm().rank() == 0) )
+        errors += checkInfo( step-1, "after checkpoint " + std::to_string( step ) );
+    }
+
+    checkPointer.waitForCompletion();
+    if( grid.comm().rank() == 0 )
+      errors += checkInfo( lastStep, "after waitForCompletion" );
+
+    Dune::Fem::persistenceManager >> uh;
+  }
+
+  // reset PersistenceManager to initial state (otherwise the restore will not work)
+  Dune::Fem::persistenceManager.reset();
+
+  // restore the last checkpoint
+  {
+    std::unique_ptr< GridType > grid( CheckPointerType::restoreGrid( checkPointFile ) );
+    GridPartType gridPart( *grid );
+    DiscreteFunctionSpaceType space( gridPart );
+    DiscreteFunctionType uh( "uh", space );
+    Dune::Fem::persistenceManager << uh;
+
+    CheckPointerType::restoreData( *grid, checkPointFile );
+    errors += checkValues( uh, lastStep );
+
+    Dune::Fem::persistenceManager >> uh;
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,168 @@
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/io/file/dataoutput.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/adaptationmanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/common/restrictprolonginterface.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+static const int dimw = Dune::GridSelector::dimworld;
+
+typedef Dune::GridSelector::GridType GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< GridType::ctype, double, dimw, 2 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, POLORDER > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+// a linear function, represented exactly before and after the adaptation
+struct LinearFunction
+  : public Dune::Fem::Function< FunctionSpaceType, LinearFunction >
+{
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u[ 0 ] = u[ 1 ] = 0;
+    for( int i = 0; i < dimw; ++i )
+    {
+      u[ 0 ] += x[ i ];
+      u[ 1 ] += (i+1) * x[ i ];
+    }
+  }
+};
+
+struct AsyncOutputParameters
+  : public Dune::Fem::LocalParameter< Dune::Fem::DataOutputParameters, AsyncOutputParameters >
+{
+  virtual std::string path () const { return "async"; }
+  virtual std::string prefix () const { return "solution"; }
+  // gnuplot
+  virtual int outputformat () const { return 4; }
+  virtual bool asyncoutput () const { return true; }
+  virtual int asyncbuffers () const { return 2; }
+  virtual double savestep () const { return -1; }
+  virtual int savecount () const { return 1; }
+  virtual bool willWrite ( bool write ) const { return write; }
+};
+
+// check the gnuplot file of the given step: one line per element (quadrature of order 1)
+// holding the values of the function at the time of writing
+int checkFile ( const std::string &name, std::size_t numElements )
+{
+  std::ifstream in( name );
+  if( !in )
+  {
+    std::cerr << "Error: unable to open '" << name << "'." << std::endl;
+    return 1;
+  }
+
+  const LinearFunction f;
+  std::size_t lines = 0;
+  double error = 0;
+  for( std::string line; std::getline( in, line ); ++lines )
+  {
+    std::istringstream values( line );
+    FunctionSpaceType::DomainType x;
+    FunctionSpaceType::RangeType u, uExact;
+    for( int i = 0; i < dimw; ++i )
+      values >> x[ i ];
+    for( int k = 0; k < FunctionSpaceType::dimRange; ++k )
+      values >> u[ k ];
+    if( !values )
+    {
+      std::cerr << "Error: invalid line '" << line << "' in '" << name << "'." << std::endl;
+      return 1;
+    }
+    f.evaluate( x, uExact );
+    u -= uExact;
+    error = std::max( error, u.infinity_norm() );
+  }
+
+  int errors = 0;
+  if( lines != numElements )
+  {
+    std::cerr << "Error: '" << name << "' contains " << lines << " lines instead of " << numElements << "." << std::endl;
+    ++errors;
+  }
+  if( error > 1e-8 )
+  {
+    std::cerr << "Error: wrong values in '" << name << "' (error = " << error << ")." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  // gnuplot output is written per process to the same file, so run serially only
+  if( Dune::Fem::MPIManager::size() > 1 )
+    return 0;
+
+  Dune::GridPtr< GridType > gridPtr( std::to_string( dimw ) + "dgrid.dgf" );
+  GridType &grid = *gridPtr;
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+  DiscreteFunctionType solution( "solution", space );
+
+  const LinearFunction f;
+  interpolate( gridFunctionAdapter( f, gridPart, POLORDER ), solution );
+
+  typedef Dune::Fem::RestrictProlongDefault< DiscreteFunctionType > RestrictProlongType;
+  RestrictProlongType rp( solution );
+  Dune::Fem::AdaptationManager< GridType, RestrictProlongType > adaptationManager( grid, rp );
+
+  typedef std::tuple< DiscreteFunctionType * > IOTupleType;
+  IOTupleType ioTuple( &solution );
+  const AsyncOutputParameters parameters;
+  Dune::Fem::DataOutput< GridType, IOTupleType > output( grid, ioTuple, parameters );
+
+  int errors = 0;
+  for( int step = 0; step < 3; ++step )
+  {
+    const std::size_t numElements = gridPart.indexSet().size( 0 );
+    output.writeData( step );
+
+    // modify the data and the grid while the output is pending; the output
+    // has to be finished before the grid is adapted and must not see the
+    // modified data
+    solution.clear();
+    for( const auto &entity : elements( gridPart ) )
+      grid.mark( 1, entity );
+    adaptationManager.adapt();
+    interpolate( gridFunctionAdapter( f, gridPart, POLORDER ), solution );
+
+    // no explicit wait: the adaptation did that
+    std::ostringstream name;
+    name << "./async/solution" << std::setw( 6 ) << std::setfill( '0' ) << step << ".gnu";
+    errors += checkFile( name.str(), numElements );
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,214 @@
+#include <config.h>
+
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/file/insituoutput.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/io/streams/binarystreams.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::YaspGrid< 2 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 2 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+typedef Dune::Fem::InSituOutput< GridPartType > InSituOutputType;
+typedef InSituOutputType::GlobalCoordinateType GlobalCoordinateType;
+
+// a linear function, represented exactly by the discrete function
+struct LinearFunction
+  : public Dune::Fem::Function< FunctionSpaceType, LinearFunction >
+{
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u[ 0 ] = 1.0 + x[ 0 ] + 2.0*x[ 1 ];
+    u[ 1 ] = 3.0*x[ 0 ] - x[ 1 ];
+  }
+};
+
+// integral of the linear function over the unit square
+const FunctionSpaceType::RangeType integral = { 2.5, 1.0 };
+
+GlobalCoordinateType point ( double x, double y )
+{
+  GlobalCoordinateType p;
+  p[ 0 ] = x;
+  p[ 1 ] = y;
+  return p;
+}
+
+struct Expected
+{
+  std::string name;
+  std::vector< GlobalCoordinateType > points;
+};
+
+// read the time series file and compare it to the expected quantities and records
+int checkFile ( const std::string &filename, const std::vector< Expected > &quantities, const std::vector< double > &times )
+{
+  const LinearFunction f;
+  int errors = 0;
+
+  Dune::Fem::BinaryFileInStream in( filename );
+
+  // header
+  int numQuantities;
+  in >> numQuantities;
+  if( numQuantities != static_cast< int >( quantities.size() ) )
+  {
+    std::cerr << "Error: " << numQuantities << " quantities instead of " << quantities.size() << "." << std::endl;
+    return ++errors;
+  }
+
+  for( const Expected &quantity : quantities )
+  {
+    std::string name;
+    int ncomps, npoints;
+    in >> name >> ncomps >> npoints;
+    if( (name != quantity.name) || (ncomps != FunctionSpaceType::dimRange) || (npoints != static_cast< int >( quantity.points.size() )) )
+    {
+      std::cerr << "Error: wrong header of quantity '" << quantity.name << "' (read '" << name << "', "
+                << ncomps << " components, " << npoints << " points)." << std::endl;
+      return ++errors;
+    }
+    for( const GlobalCoordinateType &x : quantity.points )
+    {
+      GlobalCoordinateType y;
+      in >> y[ 0 ] >> y[ 1 ];
+      if( (y - x).two_norm() > 1e-12 )
+      {
+        std::cerr << "Error: point " << y << " instead of " << x << " in the header of '" << quantity.name << "'." << std::endl;
+        ++errors;
+      }
+    }
+  }
+
+  // records
+  for( double time : times )
+  {
+    double t;
+    in >> t;
+    if( t != time )
+    {
+      std::cerr << "Error: record for time " << t << " instead of " << time << "." << std::endl;
+      ++errors;
+    }
+
+    for( const Expected &quantity : quantities )
+    {
+      std::vector< FunctionSpaceType::RangeType > exact;
+      for( const GlobalCoordinateType &x : quantity.points )
+      {
+        exact.emplace_back();
+        f.evaluate( x, exact.back() );
+      }
+      if( quantity.points.empty() )
+        exact.push_back( integral );
+
+      // points on the boundary between two ranks would be summed up twice
+      for( std::size_t i = 0; i < exact.size(); ++i )
+      {
+        FunctionSpaceType::RangeType u;
+        in >> u[ 0 ] >> u[ 1 ];
+        if( (u - exact[ i ]).infinity_norm() > 1e-8 )
+        {
+          std::cerr << "Error: value " << u << " instead of " << exact[ i ] << " (quantity '" << quantity.name
+                    << "', index " << i << ", time " << time << ")." << std::endl;
+          ++errors;
+        }
+      }
+    }
+  }
+
+  if( in.stream().peek() != std::char_traits< char >::eof() )
+  {
+    std::cerr << "Error: unexpected data at the end of '" << filename << "'." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  const Dune::FieldVector< double, 2 > upper( 1.0 );
+  const std::array< int, 2 > cells = {{ 16, 16 }};
+  GridType grid( upper, cells, std::bitset< 2 >(), 1 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  DiscreteFunctionType uh( "u", space );
+  interpolate( gridFunctionAdapter( LinearFunction(), gridPart, 1 ), uh );
+
+  Dune::ParameterTree parameter;
+  parameter[ "fem.prefix" ] = ".";
+  parameter[ "fem.io.insitu.interval" ] = "2";
+  InSituOutputType output( gridPart, "insituoutputtest", Dune::Fem::parameterReader( parameter ) );
+
+  // the ranks are separated at x = 1/2 and (for 4 ranks) y = 1/2, so the
+  // first probes lie on the boundary between ranks (and on element faces)
+  std::vector< Expected > quantities;
+  quantities.push_back( { "probes", { point( 0.5, 0.25 ), point( 0.25, 0.5 ), point( 0.5, 0.5 ), point( 0.3, 0.7 ) } } );
+  output.addProbes( uh, quantities.back().points, quantities.back().name );
+
+  quantities.push_back( { "line", {} } );
+  for( int i = 0; i < 5; ++i )
+    quantities.back().points.push_back( point( 0.1 + 0.2*i, 0.2 + 0.1*i ) );
+  output.addLineSampler( uh, point( 0.1, 0.2 ), point( 0.9, 0.6 ), 5, quantities.back().name );
+
+  quantities.push_back( { "plane", {} } );
+  for( int j = 0; j < 3; ++j )
+    for( int i = 0; i < 3; ++i )
+      quantities.back().points.push_back( point( 0.5*i, 0.5*j ) );
+  output.addPlaneSampler( uh, point( 0.0, 0.0 ), point( 1.0, 0.0 ), point( 0.0, 1.0 ), 3, 3, quantities.back().name );
+
+  quantities.push_back( { "u", {} } );
+  output.addIntegral( uh );
+
+  // with an interval of 2, only the times 0 and 2 are recorded
+  std::vector< double > times;
+  for( int step = 0; step < 4; ++step )
+  {
+    if( output.willWrite() )
+      times.push_back( step );
+    output.write( double( step ) );
+  }
+
+  int errors = 0;
+  if( times != std::vector< double >{ 0.0, 2.0 } )
+  {
+    std::cerr << "Error: wrong write interval." << std::endl;
+    ++errors;
+  }
+
+  if( gridPart.comm().rank() == 0 )
+    errors += checkFile( output.filename(), quantities, times );
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,172 @@
+#include <config.h>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/geometry/type.hh>
+
+#include <dune/fem/io/file/vtuwriter.hh>
+#include <dune/fem/misc/mpimanager.hh>
+
+typedef Dune::Fem::Impl::VTKLagrangeNodes::Node Node;
+
+// reference node orderings of the VTK Lagrange cells (as lattice points of {0, ..., order}^3),
+// see vtkHigherOrderQuadrilateral/Hexahedron::PointIndexFromIJK (file format version 2.2),
+// vtkLagrangeTriangle and vtkLagrangeTetra
+
+const std::vector< Node > line2 = {{
+    {{ 0, 0, 0 }}, {{ 2, 0, 0 }}, {{ 1, 0, 0 }}
+  }};
+
+const std::vector< Node > line3 = {{
+    {{ 0, 0, 0 }}, {{ 3, 0, 0 }}, {{ 1, 0, 0 }}, {{ 2, 0, 0 }}
+  }};
+
+const std::vector< Node > quadrilateral2 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 2, 0, 0 }}, {{ 2, 2, 0 }}, {{ 0, 2, 0 }},
+    // edges
+    {{ 1, 0, 0 }}, {{ 2, 1, 0 }}, {{ 1, 2, 0 }}, {{ 0, 1, 0 }},
+    // interior
+    {{ 1, 1, 0 }}
+  }};
+
+const std::vector< Node > quadrilateral3 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 3, 0, 0 }}, {{ 3, 3, 0 }}, {{ 0, 3, 0 }},
+    // edges (the edges 2 and 3 are oriented along the axes)
+    {{ 1, 0, 0 }}, {{ 2, 0, 0 }}, {{ 3, 1, 0 }}, {{ 3, 2, 0 }},
+    {{ 1, 3, 0 }}, {{ 2, 3, 0 }}, {{ 0, 1, 0 }}, {{ 0, 2, 0 }},
+    // interior
+    {{ 1, 1, 0 }}, {{ 2, 1, 0 }}, {{ 1, 2, 0 }}, {{ 2, 2, 0 }}
+  }};
+
+const std::vector< Node > hexahedron2 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 2, 0, 0 }}, {{ 2, 2, 0 }}, {{ 0, 2, 0 }},
+    {{ 0, 0, 2 }}, {{ 2, 0, 2 }}, {{ 2, 2, 2 }}, {{ 0, 2, 2 }},
+    // edges
+    {{ 1, 0, 0 }}, {{ 2, 1, 0 }}, {{ 1, 2, 0 }}, {{ 0, 1, 0 }},
+    {{ 1, 0, 2 }}, {{ 2, 1, 2 }}, {{ 1, 2, 2 }}, {{ 0, 1, 2 }},
+    {{ 0, 0, 1 }}, {{ 2, 0, 1 }}, {{ 2, 2, 1 }}, {{ 0, 2, 1 }},
+    // faces (x = 0, x = 2, y = 0, y = 2, z = 0, z = 2)
+    {{ 0, 1, 1 }}, {{ 2, 1, 1 }}, {{ 1, 0, 1 }}, {{ 1, 2, 1 }}, {{ 1, 1, 0 }}, {{ 1, 1, 2 }},
+    // interior
+    {{ 1, 1, 1 }}
+  }};
+
+const std::vector< Node > hexahedron3 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 3, 0, 0 }}, {{ 3, 3, 0 }}, {{ 0, 3, 0 }},
+    {{ 0, 0, 3 }}, {{ 3, 0, 3 }}, {{ 3, 3, 3 }}, {{ 0, 3, 3 }},
+    // edges
+    {{ 1, 0, 0 }}, {{ 2, 0, 0 }}, {{ 3, 1, 0 }}, {{ 3, 2, 0 }},
+    {{ 1, 3, 0 }}, {{ 2, 3, 0 }}, {{ 0, 1, 0 }}, {{ 0, 2, 0 }},
+    {{ 1, 0, 3 }}, {{ 2, 0, 3 }}, {{ 3, 1, 3 }}, {{ 3, 2, 3 }},
+    {{ 1, 3, 3 }}, {{ 2, 3, 3 }}, {{ 0, 1, 3 }}, {{ 0, 2, 3 }},
+    {{ 0, 0, 1 }}, {{ 0, 0, 2 }}, {{ 3, 0, 1 }}, {{ 3, 0, 2 }},
+    {{ 3, 3, 1 }}, {{ 3, 3, 2 }}, {{ 0, 3, 1 }}, {{ 0, 3, 2 }},
+    // faces
+    {{ 0, 1, 1 }}, {{ 0, 2, 1 }}, {{ 0, 1, 2 }}, {{ 0, 2, 2 }},
+    {{ 3, 1, 1 }}, {{ 3, 2, 1 }}, {{ 3, 1, 2 }}, {{ 3, 2, 2 }},
+    {{ 1, 0, 1 }}, {{ 2, 0, 1 }}, {{ 1, 0, 2 }}, {{ 2, 0, 2 }},
+    {{ 1, 3, 1 }}, {{ 2, 3, 1 }}, {{ 1, 3, 2 }}, {{ 2, 3, 2 }},
+    {{ 1, 1, 0 }}, {{ 2, 1, 0 }}, {{ 1, 2, 0 }}, {{ 2, 2, 0 }},
+    {{ 1, 1, 3 }}, {{ 2, 1, 3 }}, {{ 1, 2, 3 }}, {{ 2, 2, 3 }},
+    // interior
+    {{ 1, 1, 1 }}, {{ 2, 1, 1 }}, {{ 1, 2, 1 }}, {{ 2, 2, 1 }},
+    {{ 1, 1, 2 }}, {{ 2, 1, 2 }}, {{ 1, 2, 2 }}, {{ 2, 2, 2 }}
+  }};
+
+const std::vector< Node > triangle2 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 2, 0, 0 }}, {{ 0, 2, 0 }},
+    // edges
+    {{ 1, 0, 0 }}, {{ 1, 1, 0 }}, {{ 0, 1, 0 }}
+  }};
+
+const std::vector< Node > triangle3 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 3, 0, 0 }}, {{ 0, 3, 0 }},
+    // edges (0-1, 1-2, 2-0)
+    {{ 1, 0, 0 }}, {{ 2, 0, 0 }}, {{ 2, 1, 0 }}, {{ 1, 2, 0 }}, {{ 0, 2, 0 }}, {{ 0, 1, 0 }},
+    // interior
+    {{ 1, 1, 0 }}
+  }};
+
+const std::vector< Node > tetrahedron2 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 2, 0, 0 }}, {{ 0, 2, 0 }}, {{ 0, 0, 2 }},
+    // edges (0-1, 1-2, 2-0, 0-3, 1-3, 2-3)
+    {{ 1, 0, 0 }}, {{ 1, 1, 0 }}, {{ 0, 1, 0 }}, {{ 0, 0, 1 }}, {{ 1, 0, 1 }}, {{ 0, 1, 1 }}
+  }};
+
+const std::vector< Node > tetrahedron3 = {{
+    // vertices
+    {{ 0, 0, 0 }}, {{ 3, 0, 0 }}, {{ 0, 3, 0 }}, {{ 0, 0, 3 }},
+    // edges (0-1, 1-2, 2-0, 0-3, 1-3, 2-3)
+    {{ 1, 0, 0 }}, {{ 2, 0, 0 }}, {{ 2, 1, 0 }}, {{ 1, 2, 0 }}, {{ 0, 2, 0 }}, {{ 0, 1, 0 }},
+    {{ 0, 0, 1 }}, {{ 0, 0, 2 }}, {{ 2, 0, 1 }}, {{ 1, 0, 2 }}, {{ 0, 2, 1 }}, {{ 0, 1, 2 }},
+    // faces (0-1-3, 1-2-3, 2-0-3, 0-2-1)
+    {{ 1, 0, 1 }}, {{ 1, 1, 1 }}, {{ 0, 1, 1 }}, {{ 1, 1, 0 }}
+  }};
+
+
+int check ( const Dune::GeometryType &type, int order, const std::vector< Node > &reference, int cellType )
+{
+  const std::string name = "type " + std::to_string( type.id() ) + " (dim " + std::to_string( type.dim() ) + "), order " + std::to_string( order );
+
+  int errors = 0;
+  if( Dune::Fem::Impl::VTKLagrangeNodes::cellType( type ) != cellType )
+  {
+    std::cerr << "Error: wrong VTK cell type for " << name << "." << std::endl;
+    ++errors;
+  }
+
+  const std::vector< Node > nodes = Dune::Fem::Impl::VTKLagrangeNodes::nodes( type, order );
+  if( nodes.size() != reference.size() )
+  {
+    std::cerr << "Error: " << nodes.size() << " nodes instead of " << reference.size() << " for " << name << "." << std::endl;
+    return ++errors;
+  }
+
+  for( std::size_t i = 0; i < nodes.size(); ++i )
+  {
+    if( nodes[ i ] == reference[ i ] )
+      continue;
+    std::cerr << "Error: node " << i << " is (" << nodes[ i ][ 0 ] << ", " << nodes[ i ][ 1 ] << ", " << nodes[ i ][ 2 ] << ")"
+              << " instead of (" << reference[ i ][ 0 ] << ", " << reference[ i ][ 1 ] << ", " << reference[ i ][ 2 ] << ")"
+              << " for " << name << "." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  int errors = 0;
+  errors += check( Dune::GeometryTypes::line, 2, line2, 68 );
+  errors += check( Dune::GeometryTypes::line, 3, line3, 68 );
+  errors += check( Dune::GeometryTypes::triangle, 2, triangle2, 69 );
+  errors += check( Dune::GeometryTypes::triangle, 3, triangle3, 69 );
+  errors += check( Dune::GeometryTypes::quadrilateral, 2, quadrilateral2, 70 );
+  errors += check( Dune::GeometryTypes::quadrilateral, 3, quadrilateral3, 70 );
+  errors += check( Dune::GeometryTypes::tetrahedron, 2, tetrahedron2, 71 );
+  errors += check( Dune::GeometryTypes::tetrahedron, 3, tetrahedron3, 71 );
+  errors += check( Dune::GeometryTypes::hexahedron, 2, hexahedron2, 72 );
+  errors += check( Dune::GeometryTypes::hexahedron, 3, hexahedron3, 72 );
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,322 @@
+#include <config.h>
+
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if HAVE_LZ4
+#include <lz4.h>
+#endif // #if HAVE_LZ4
+
+#include <dune/common/dynvector.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/file/vtuwriter.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::YaspGrid< 2 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 2 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 0 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+
+// value of component i of the (piecewise constant) data on an element
+template< class Entity >
+double value ( const Entity &entity, int i )
+{
+  const auto center = entity.geometry().center();
+  return center[ 0 ] + 2.0*center[ 1 ] + i;
+}
+
+void fill ( DiscreteFunctionType &df )
+{
+  Dune::DynamicVector< double > localDofs;
+  for( const auto &entity : elements( df.gridPart() ) )
+  {
+    localDofs.resize( df.space().basisFunctionSet( entity ).size() );
+    for( std::size_t i = 0; i < localDofs.size(); ++i )
+      localDofs[ i ] = value( entity, i );
+    df.setLocalDofs( entity, localDofs );
+  }
+}
+
+std::string readFile ( const std::string &filename )
+{
+  std::ifstream in( filename.c_str(), std::ios::binary );
+  if( !in )
+    DUNE_THROW( Dune::IOError, "Unable to open file: " << filename );
+  return std::string( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+}
+
+// value of an attribute of the first tag starting at pos
+std::string attribute ( const std::string &content, std::size_t pos, const std::string &name )
+{
+  const std::size_t end = content.find( '>', pos );
+  const std::size_t begin = content.find( " " + name + "=\"", pos );
+  if( (begin == std::string::npos) || (begin > end) )
+    return std::string();
+  const std::size_t first = begin + name.size() + 3;
+  return content.substr( first, content.find( '"', first ) - first );
+}
+
+// the binary data is read back natively, so the header has to name the byte order of this machine
+std::string byteOrder ()
+{
+  const std::uint32_t one = 1;
+  char first;
+  std::memcpy( &first, &one, 1 );
+  return (first == 1 ? "LittleEndian" : "BigEndian");
+}
+
+template< class T >
+T readValue ( const std::string &content, std::size_t pos )
+{
+  if( pos + sizeof( T ) > content.size() )
+    DUNE_THROW( Dune::IOError, "Appended data truncated." );
+  T value;
+  std::memcpy( &value, content.data() + pos, sizeof( T ) );
+  return value;
+}
+
+// decode one appended data array (raw or LZ4 compressed)
+std::vector< char > decode ( const std::string &content, std::size_t pos, bool compressed )
+{
+  if( !compressed )
+  {
+    const std::uint64_t size = readValue< std::uint64_t >( content, pos );
+    pos += sizeof( std::uint64_t );
+    if( pos + size > content.size() )
+      DUNE_THROW( Dune::IOError, "Appended data truncated." );
+    return std::vector< char >( content.data() + pos, content.data() + pos + size );
+  }
+
+#if HAVE_LZ4
+  const std::uint64_t blocks = readValue< std::uint64_t >( content, pos );
+  const std::uint64_t blockSize = readValue< std::uint64_t >( content, pos + 8 );
+  const std::uint64_t lastBlockSize = readValue< std::uint64_t >( content, pos + 16 );
+  std::size_t data = pos + 8*(3 + blocks);
+
+  std::vector< char > result;
+  for( std::uint64_t b = 0; b < blocks; ++b )
+  {
+    const std::uint64_t compressedSize = readValue< std::uint64_t >( content, pos + 8*(3 + b) );
+    const std::uint64_t size = (b+1 < blocks ? blockSize : lastBlockSize);
+    if( data + compressedSize > content.size() )
+      DUNE_THROW( Dune::IOError, "Appended data truncated." );
+
+    const std::size_t offset = result.size();
+    result.resize( offset + size );
+    const int decompressed = LZ4_decompress_safe( content.data() + data, result.data() + offset, static_cast< int >( compressedSize ), static_cast< int >( size ) );
+    if( decompressed != static_cast< int >( size ) )
+      DUNE_THROW( Dune::IOError, "Unable to decompress block " << b << "." );
+    data += compressedSize;
+  }
+  return result;
+#else // #if HAVE_LZ4
+  DUNE_THROW( Dune::NotImplemented, "LZ4 not available." );
+#endif // #else // #if HAVE_LZ4
+}
+
+template< class T >
+std::vector< T > values ( const std::vector< char > &data )
+{
+  std::vector< T > result( data.size() / sizeof( T ) );
+  std::memcpy( result.data(), data.data(), result.size() * sizeof( T ) );
+  return result;
+}
+
+// check a vtu piece against the grid part
+int checkPiece ( const std::string &filename, const GridPartType &gridPart, bool compressed )
+{
+  const std::string content = readFile( filename );
+  int errors = 0;
+  auto check = [ &errors, &filename ] ( bool condition, const std::string &message ) {
+      if( !condition )
+      {
+        std::cerr << "Error: " << message << " (" << filename << ")." << std::endl;
+        ++errors;
+      }
+    };
+
+  // header
+  const std::size_t vtkFile = content.find( "<VTKFile" );
+  check( vtkFile != std::string::npos, "VTKFile tag missing" );
+  check( attribute( content, vtkFile, "type" ) == "UnstructuredGrid", "wrong file type" );
+  check( attribute( content, vtkFile, "byte_order" ) == byteOrder(), "wrong byte order" );
+  check( attribute( content, vtkFile, "header_type" ) == "UInt64", "wrong header type" );
+  check( attribute( content, vtkFile, "compressor" ) == (compressed ? "vtkLZ4DataCompressor" : ""), "wrong compressor" );
+
+  std::size_t numElements = 0;
+  for( const auto &element : elements( gridPart, Dune::Partitions::interior ) )
+  {
+    (void)element;
+    ++numElements;
+  }
+  const std::size_t piece = content.find( "<Piece" );
+  check( attribute( content, piece, "NumberOfPoints" ) == std::to_string( 4*numElements ), "wrong number of points" );
+  check( attribute( content, piece, "NumberOfCells" ) == std::to_string( numElements ), "wrong number of cells" );
+
+  const std::size_t appended = content.find( "<AppendedData encoding=\"raw\">" );
+  check( appended != std::string::npos, "raw appended data missing" );
+  if( errors > 0 )
+    return errors;
+  const std::size_t start = content.find( '_', appended ) + 1;
+
+  // data arrays (in the order of the header, the offsets must increase)
+  std::vector< std::string > names;
+  std::vector< std::vector< char > > arrays;
+  std::size_t lastOffset = 0;
+  for( std::size_t pos = content.find( "<DataArray" ); pos < appended; pos = content.find( "<DataArray", pos+1 ) )
+  {
+    check( attribute( content, pos, "format" ) == "appended", "data array not appended" );
+    const std::size_t offset = std::stoul( attribute( content, pos, "offset" ) );
+    check( names.empty() || (offset > lastOffset), "offsets not increasing" );
+    lastOffset = offset;
+    names.push_back( attribute( content, pos, "Name" ) );
+    arrays.push_back( decode( content, start + offset, compressed ) );
+  }
+
+  const std::vector< std::string > expectedNames = { "vertexdata", "celldata", "Points", "connectivity", "offsets", "types" };
+  check( names == expectedNames, "wrong data arrays" );
+  if( errors > 0 )
+    return errors;
+
+  const std::vector< float > vertexData = values< float >( arrays[ 0 ] );
+  const std::vector< float > cellData = values< float >( arrays[ 1 ] );
+  const std::vector< float > points = values< float >( arrays[ 2 ] );
+  const std::vector< std::int64_t > connectivity = values< std::int64_t >( arrays[ 3 ] );
+  const std::vector< std::int64_t > offsets = values< std::int64_t >( arrays[ 4 ] );
+  const std::vector< std::uint8_t > types = values< std::uint8_t >( arrays[ 5 ] );
+
+  check( vertexData.size() == 2*4*numElements, "wrong size of vertex data" );
+  check( cellData.size() == 2*numElements, "wrong size of cell data" );
+  check( points.size() == 3*4*numElements, "wrong size of points" );
+  check( connectivity.size() == 4*numElements, "wrong size of connectivity" );
+  check( offsets.size() == numElements, "wrong size of offsets" );
+  check( types.size() == numElements, "wrong size of types" );
+  if( errors > 0 )
+    return errors;
+
+  // elements are written in the order of the interior iteration, with their corners as points
+  const std::array< int, 4 > vtkQuadrilateral = {{ 0, 1, 3, 2 }};
+  std::size_t e = 0;
+  for( const auto &element : elements( gridPart, Dune::Partitions::interior ) )
+  {
+    const auto geometry = element.geometry();
+    for( int i = 0; i < 4; ++i )
+    {
+      const std::size_t p = 4*e + i;
+      const auto corner = geometry.corner( i );
+      check( (std::abs( points[ 3*p ] - corner[ 0 ] ) < 1e-6) && (std::abs( points[ 3*p+1 ] - corner[ 1 ] ) < 1e-6) && (points[ 3*p+2 ] == 0.0f), "wrong point" );
+      check( connectivity[ p ] == std::int64_t( 4*e + vtkQuadrilateral[ i ] ), "wrong connectivity" );
+      for( int c = 0; c < 2; ++c )
+        check( std::abs( vertexData[ 2*p + c ] - value( element, c ) ) < 1e-5, "wrong vertex data" );
+    }
+    for( int c = 0; c < 2; ++c )
+      check( std::abs( cellData[ 2*e + c ] - value( element, c ) ) < 1e-5, "wrong cell data" );
+    check( offsets[ e ] == std::int64_t( 4*(e+1) ), "wrong offset" );
+    check( types[ e ] == 9, "wrong cell type" );
+    ++e;
+  }
+  return errors;
+}
+
+// check the pvtu collection written by rank 0
+int checkCollection ( const std::string &name, int size )
+{
+  const std::string content = readFile( name + ".pvtu" );
+  int errors = 0;
+  const std::size_t vtkFile = content.find( "<VTKFile type=\"PUnstructuredGrid\"" );
+  if( (vtkFile == std::string::npos) || (attribute( content, vtkFile, "byte_order" ) != byteOrder()) )
+    ++errors;
+  if( content.find( "<PDataArray type=\"Float32\" Name=\"vertexdata\" NumberOfComponents=\"2\"/>" ) == std::string::npos )
+    ++errors;
+  if( content.find( "<PDataArray type=\"Float32\" Name=\"celldata\" NumberOfComponents=\"2\"/>" ) == std::string::npos )
+    ++errors;
+  for( int rank = 0; rank < size; ++rank )
+  {
+    std::ostringstream piece;
+    piece << "<Piece Source=\"" << name << "-p" << std::setw( 4 ) << std::setfill( '0' ) << rank << ".vtu\"/>";
+    if( content.find( piece.str() ) == std::string::npos )
+      ++errors;
+  }
+  if( errors > 0 )
+    std::cerr << "Error: wrong pvtu file " << name << ".pvtu." << std::endl;
+  return errors;
+}
+
+int write ( const GridPartType &gridPart, const DiscreteFunctionType &df, const std::string &name, bool compressed )
+{
+  // small chunks to test the streaming
+  Dune::ParameterTree parameter;
+  parameter[ "fem.io.vtu.compress" ] = (compressed ? "true" : "false");
+  parameter[ "fem.io.vtu.chunksize" ] = "7";
+
+  Dune::Fem::VTUWriter< GridPartType > writer( gridPart, 0, Dune::Fem::parameterReader( parameter ) );
+  writer.addVertexData( df, "vertexdata" );
+  writer.addCellData( df, "celldata" );
+  writer.write( name );
+
+  const int rank = gridPart.comm().rank(), size = gridPart.comm().size();
+  gridPart.comm().barrier();
+  if( size == 1 )
+    return checkPiece( name + ".vtu", gridPart, compressed );
+
+  std::ostringstream piece;
+  piece << name << "-p" << std::setw( 4 ) << std::setfill( '0' ) << rank << ".vtu";
+  int errors = checkPiece( piece.str(), gridPart, compressed );
+  if( rank == 0 )
+    errors += checkCollection( name, size );
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  // large enough for several LZ4 blocks per array
+  const Dune::FieldVector< double, 2 > upper( 1.0 );
+  const std::array< int, 2 > cells = {{ 64, 64 }};
+  GridType grid( upper, cells, std::bitset< 2 >(), 1 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  DiscreteFunctionType df( "df", space );
+  fill( df );
+
+  int errors = write( gridPart, df, "vtuwritertest", false );
+#if HAVE_LZ4
+  errors += write( gridPart, df, "vtuwritertest-lz4", true );
+#endif // #if HAVE_LZ4
+
+  errors = gridPart.comm().sum( errors );
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,836 @@
+#ifndef DUNE_FEM_IO_FILE_VTUWRITER_HH
+#define DUNE_FEM_IO_FILE_VTUWRITER_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <complex>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if HAVE_LZ4
+#include <lz4.h>
+#endif // #if HAVE_LZ4
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/type.hh>
+#include <dune/geometry/virtualrefinement.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/io/file/vtk/common.hh>
+
+#include <dune/fem/function/localfunction/const.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/misc/threads/parallelfor.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    namespace Impl
+    {
+
+      // VTKLagrangeNodes
+      // ----------------
+
+      /* nodes of the VTK Lagrange cells (VTK_LAGRANGE_CURVE, _TRIANGLE,
+       * _QUADRILATERAL, _TETRAHEDRON, _HEXAHEDRON) in VTK order, given as
+       * points of the lattice {0, ..., order}^3 */
+      struct VTKLagrangeNodes
+      {
+        typedef std::array< int, 3 > Node;
+
+        // VTK cell type of the Lagrange cell for a geometry type
+        static std::uint8_t cellType ( const GeometryType &type )
+        {
+          if( type.isLine() )
+            return 68;
+          else if( type.isTriangle() )
+            return 69;
+          else if( type.isQuadrilateral() )
+            return 70;
+          else if( type.isTetrahedron() )
+            return 71;
+          else if( type.isHexahedron() )
+            return 72;
+          DUNE_THROW( NotImplemented, "VTK Lagrange cells not implemented for geometry type " << type << "." );
+        }
+
+        static std::vector< Node > nodes ( const GeometryType &type, int order )
+        {
+          std::vector< Node > nodes;
+          if( type.isCube() )
+            cube( type.dim(), order, nodes );
+          else if( type.isTriangle() )
+            triangle( { 0, 0, 0 }, { order, 0, 0 }, { 0, order, 0 }, order, nodes );
+          else if( type.isTetrahedron() )
+            tetrahedron( { 0, 0, 0 }, { order, 0, 0 }, { 0, order, 0 }, { 0, 0, order }, order, nodes );
+          else
+            DUNE_THROW( NotImplemented, "VTK Lagrange cells not implemented for geometry type " << type << "." );
+          return nodes;
+        }
+
+      private:
+        static Node step ( const Node &a, const Node &b, int order )
+        {
+          return {{ (b[ 0 ] - a[ 0 ]) / order, (b[ 1 ] - a[ 1 ]) / order, (b[ 2 ] - a[ 2 ]) / order }};
+        }
+
+        static Node axpy ( const Node &a, int k, const Node &u )
+        {
+          return {{ a[ 0 ] + k*u[ 0 ], a[ 1 ] + k*u[ 1 ], a[ 2 ] + k*u[ 2 ] }};
+        }
+
+        static void edge ( const Node &a, const Node &b, int order, std::vector< Node > &nodes )
+        {
+          const Node u = step( a, b, order );
+          for( int k = 1; k < order; ++k )
+            nodes.push_back( axpy( a, k, u ) );
+        }
+
+        // vertices, edges and (recursively) interior of a triangle
+        static void triangle ( const Node &a, const Node &b, const Node &c, int order, std::vector< Node > &nodes )
+        {
+          if( order < 0 )
+            return;
+          nodes.push_back( a );
+          if( order == 0 )
+            return;
+          nodes.push_back( b );
+          nodes.push_back( c );
+          edge( a, b, order, nodes );
+          edge( b, c, order, nodes );
+          edge( c, a, order, nodes );
+          if( order >= 3 )
+            interiorTriangle( a, b, c, order, nodes );
+        }
+
+        static void interiorTriangle ( const Node &a, const Node &b, const Node &c, int order, std::vector< Node > &nodes )
+        {
+          const Node u = step( a, b, order ), v = step( a, c, order );
+          const Node a0 = axpy( axpy( a, 1, u ), 1, v );
+          triangle( a0, axpy( a0, order-3, u ), axpy( a0, order-3, v ), order-3, nodes );
+        }
+
+        // vertices, edges, faces and (recursively) interior of a tetrahedron
+        static void tetrahedron ( const Node &a, const Node &b, const Node &c, const Node &d, int order, std::vector< Node > &nodes )
+        {
+          if( order < 0 )
+            return;
+          nodes.push_back( a );
+          if( order == 0 )
+            return;
+          nodes.push_back( b );
+          nodes.push_back( c );
+          nodes.push_back( d );
+          edge( a, b, order, nodes );
+          edge( b, c, order, nodes );
+          edge( c, a, order, nodes );
+          edge( a, d, order, nodes );
+          edge( b, d, order, nodes );
+          edge( c, d, order, nodes );
+          if( order >= 3 )
+          {
+            interiorTriangle( a, b, d, order, nodes );
+            interiorTriangle( b, c, d, order, nodes );
+            interiorTriangle( c, a, d, order, nodes );
+            interiorTriangle( a, c, b, order, nodes );
+          }
+          if( order >= 4 )
+          {
+            const Node u = step( a, b, order ), v = step( a, c, order ), w = step( a, d, order );
+            const Node a0 = axpy( axpy( axpy( a, 1, u ), 1, v ), 1, w );
+            tetrahedron( a0, axpy( a0, order-4, u ), axpy( a0, order-4, v ), axpy( a0, order-4, w ), order-4, nodes );
+          }
+        }
+
+        // VTK index of the lattice point (i, j, k) in a Lagrange line, quadrilateral or hexahedron
+        static std::size_t cubeIndex ( int dim, int n, int i, int j, int k )
+        {
+          const bool ibdy = (i == 0 || i == n);
+          const bool jbdy = (dim < 2) || (j == 0 || j == n);
+          const bool kbdy = (dim < 3) || (k == 0 || k == n);
+          const int nbdy = (ibdy ? 1 : 0) + (jbdy ? 1 : 0) + (kbdy ? 1 : 0);
+          const int m = n-1;
+
+          // vertices
+          if( nbdy == 3 )
+            return (i ? (j ? 2 : 1) : (j ? 3 : 0)) + (k ? 4 : 0);
+
+          std::size_t offset = (1u << dim);
+          if( dim == 1 )
+            return offset + (i-1);
+
+          // edges
+          if( nbdy == 2 )
+          {
+            if( !ibdy )
+              return offset + (i-1) + (j ? 2*m : 0) + (k ? 4*m : 0);
+            if( !jbdy )
+              return offset + (j-1) + (i ? m : 3*m) + (k ? 4*m : 0);
+            offset += 8*m;
+            return offset + (k-1) + m*(i ? (j ? 2 : 1) : (j ? 3 : 0));
+          }
+
+          if( dim == 2 )
+            return offset + 4*m + (i-1) + m*(j-1);
+
+          // faces
+          offset += 12*m;
+          if( nbdy == 1 )
+          {
+            if( ibdy )
+              return offset + (j-1) + m*(k-1) + (i ? m*m : 0);
+            offset += 2*m*m;
+            if( jbdy )
+              return offset + (i-1) + m*(k-1) + (j ? m*m : 0);
+            offset += 2*m*m;
+            return offset + (i-1) + m*(j-1) + (k ? m*m : 0);
+          }
+
+          // interior
+          offset += 6*m*m;
+          return offset + (i-1) + m*((j-1) + m*(k-1));
+        }
+
+        static void cube ( int dim, int n, std::vector< Node > &nodes )
+        {
+          const int nj = (dim > 1 ? n : 0), nk = (dim > 2 ? n : 0);
+          nodes.resize( (n+1) * (nj+1) * (nk+1) );
+          for( int k = 0; k <= nk; ++k )
+            for( int j = 0; j <= nj; ++j )
+              for( int i = 0; i <= n; ++i )
+                nodes[ cubeIndex( dim, n, i, j, k ) ] = {{ i, j, k }};
+        }
+      };
+
+    } // namespace Impl
+
+
+
+    // VTUWriter
+    // ---------
+
+    /** \brief native VTK unstructured grid writer for discrete functions
+     *
+     *  In contrast to VTKIO (which wraps Dune::VTKWriter and evaluates the
+     *  discrete functions point by point through virtual calls), this writer
+     *  - evaluates each element at all (subsampled) vertices at once using
+     *    thread-local local functions (in parallel, see parallelFor),
+     *  - writes appended raw binary data (no base64 encoding), optionally
+     *    compressed with LZ4 (vtkLZ4DataCompressor),
+     *  - streams each data array to the file in chunks of elements, so the
+     *    whole data set is never held in memory.
+     *
+     *  The output is discontinuous (vertices are not shared between elements),
+     *  which is exact for discontinuous spaces and allows elements to be
+     *  processed independently. Each element can be subsampled by a number
+     *  of refinement levels or, for high order functions, be written as a
+     *  single VTK Lagrange cell of given order (see setLagrangeOrder), i.e.,
+     *  the functions are interpolated in the nodes of the VTK Lagrange cell.
+     *
+     *  Parameters:
+     *  - <tt>fem.io.vtu.compress</tt>: compress the data arrays (default: false,
+     *    requires LZ4)
+     *  - <tt>fem.io.vtu.chunksize</tt>: number of elements processed at once
+     *    (default: 4096)
+     */
+    template< class GridPart >
+    class VTUWriter
+    {
+      typedef VTUWriter< GridPart > ThisType;
+
+    public:
+      typedef GridPart GridPartType;
+
+      typedef typename GridPartType::ctype ctype;
+      static const int dimension = GridPartType::dimension;
+      static const int dimensionworld = GridPartType::dimensionworld;
+
+      typedef typename GridPartType::template Codim< 0 >::EntityType ElementType;
+      typedef typename GridPartType::template Codim< 0 >::EntitySeedType ElementSeedType;
+      typedef FieldVector< ctype, dimension > LocalCoordinateType;
+
+    protected:
+      // evaluation of one data array on one element (one instance per thread)
+      struct LocalEvaluator
+      {
+        virtual ~LocalEvaluator () {}
+        virtual void evaluate ( const ElementType &element, const std::vector< LocalCoordinateType > &points, float *values ) = 0;
+      };
+
+      struct DataFunction
+      {
+        virtual ~DataFunction () {}
+        virtual std::string name () const = 0;
+        virtual int ncomps () const = 0;
+        virtual std::unique_ptr< LocalEvaluator > localEvaluator () const = 0;
+      };
+
+      template< class DF >
+      struct DiscreteFunctionData
+        : public DataFunction
+      {
+        typedef typename DF::RangeType RangeType;
+
+        struct Evaluator
+          : public LocalEvaluator
+        {
+          explicit Evaluator ( const DF &df ) : localFunction_( df ) {}
+
+          void evaluate ( const ElementType &element, const std::vector< LocalCoordinateType > &points, float *values ) override
+          {
+            localFunction_.bind( element );
+            RangeType value;
+            for( const LocalCoordinateType &x : points )
+            {
+              localFunction_.evaluate( x, value );
+              for( int i = 0; i < RangeType::dimension; ++i )
+                *(values++) = static_cast< float >( std::real( value[ i ] ) );
+            }
+            localFunction_.unbind();
+          }
+
+        private:
+          ConstLocalFunction< DF > localFunction_;
+        };
+
+        DiscreteFunctionData ( const DF &df, const std::string &name )
+          : df_( df ), name_( name.empty() ? df.name() : name )
+        {}
+
+        std::string name () const override { return name_; }
+        int ncomps () const override { return RangeType::dimension; }
+        std::unique_ptr< LocalEvaluator > localEvaluator () const override { return std::unique_ptr< LocalEvaluator >( new Evaluator( df_ ) ); }
+
+      private:
+        const DF &df_;
+        const std::string name_;
+      };
+
+      // position of an offset in the XML header (patched after writing the data)
+      struct ArrayInfo
+      {
+        std::streampos offsetPosition;
+        std::size_t rawSize = 0;
+        std::size_t offset = 0;
+      };
+
+      static const int offsetWidth = 20;
+
+      // the binary data is written in the byte order of the machine
+      static const char *byteOrder ()
+      {
+        const std::uint16_t one = 1;
+        return (*reinterpret_cast< const unsigned char * >( &one ) == 1 ? "LittleEndian" : "BigEndian");
+      }
+
+      // points and cells written for each element of a geometry type
+      struct Layout
+      {
+        std::vector< LocalCoordinateType > points, centers;
+        std::vector< std::int64_t > connectivity, offsets;
+        std::vector< std::uint8_t > types;
+      };
+
+    public:
+      /** \brief constructor
+       *
+       *  \param[in]  gridPart   grid part to write
+       *  \param[in]  level      number of refinement levels for subsampling
+       *  \param[in]  parameter  parameters
+       */
+      explicit VTUWriter ( const GridPartType &gridPart, unsigned int level = 0,
+                           const ParameterReader &parameter = Parameter::container() )
+        : gridPart_( gridPart ),
+          intervals_( Dune::refinementLevels( level ) ),
+          compress_( parameter.getValue< bool >( "fem.io.vtu.compress", false ) ),
+          chunkSize_( std::max( parameter.getValue< int >( "fem.io.vtu.chunksize", 4096 ), 1 ) )
+      {
+#if !HAVE_LZ4
+        compress_ = false;
+#endif // #if !HAVE_LZ4
+      }
+
+      //! add the values of a discrete function in the vertices
+      template< class DF >
+      void addVertexData ( const DF &df, const std::string &name = "" )
+      {
+        vertexData_.emplace_back( new DiscreteFunctionData< DF >( df, name ) );
+      }
+
+      //! add the values of a discrete function in the cell centers
+      template< class DF >
+      void addCellData ( const DF &df, const std::string &name = "" )
+      {
+        cellData_.emplace_back( new DiscreteFunctionData< DF >( df, name ) );
+      }
+
+      /** \brief write each element as one VTK Lagrange cell of given order
+       *
+       *  Lagrange cells are available for lines, triangles, quadrilaterals,
+       *  tetrahedra and hexahedra. An order of 0 switches back to linear
+       *  (subsampled) cells.
+       */
+      void setLagrangeOrder ( int order )
+      {
+        if( order != lagrangeOrder_ )
+          layouts_.clear();
+        lagrangeOrder_ = std::max( order, 0 );
+      }
+
+      //! order of the VTK Lagrange cells (0 for linear cells)
+      int lagrangeOrder () const { return lagrangeOrder_; }
+
+      //! remove all data
+      void clear ()
+      {
+        vertexData_.clear();
+        cellData_.clear();
+      }
+
+      /** \brief write the grid part and all data
+       *
+       *  In parallel, each rank writes name-pXXXX.vtu and rank 0 additionally
+       *  writes name.pvtu.
+       *
+       *  \returns name of the written vtu or pvtu file
+       */
+      std::string write ( const std::string &name )
+      {
+        return write( name, gridPart_.comm().rank(), gridPart_.comm().size() );
+      }
+
+      //! write the grid part and all data for given rank (without communication)
+      std::string write ( const std::string &name, int rank, int size )
+      {
+        if( size == 1 )
+        {
+          writePiece( name + ".vtu" );
+          return name + ".vtu";
+        }
+
+        writePiece( pieceName( name, rank ) );
+        if( rank == 0 )
+          writeCollection( name, size );
+        return name + ".pvtu";
+      }
+
+    protected:
+      static std::string pieceName ( const std::string &name, int rank )
+      {
+        std::ostringstream s;
+        s << name << "-p" << std::setw( 4 ) << std::setfill( '0' ) << rank << ".vtu";
+        return s.str();
+      }
+
+      static std::string baseName ( const std::string &name )
+      {
+        const std::size_t pos = name.find_last_of( '/' );
+        return (pos == std::string::npos ? name : name.substr( pos+1 ));
+      }
+
+      // layout for a geometry type (must not be called concurrently)
+      const Layout &layout ( const GeometryType &type )
+      {
+        auto pos = layouts_.find( type );
+        if( pos != layouts_.end() )
+          return pos->second;
+
+        Layout &layout = layouts_[ type ];
+        if( lagrangeOrder_ > 0 )
+        {
+          for( const auto &node : Impl::VTKLagrangeNodes::nodes( type, lagrangeOrder_ ) )
+          {
+            LocalCoordinateType x;
+            for( int i = 0; i < dimension; ++i )
+              x[ i ] = ctype( node[ i ] ) / ctype( lagrangeOrder_ );
+            layout.connectivity.push_back( layout.points.size() );
+            layout.points.push_back( x );
+          }
+          layout.offsets.push_back( layout.connectivity.size() );
+          layout.types.push_back( Impl::VTKLagrangeNodes::cellType( type ) );
+          layout.centers.push_back( ReferenceElements< ctype, dimension >::general( type ).position( 0, 0 ) );
+          return layout;
+        }
+
+        const GeometryType cellType = (type.isCube() || type.isSimplex()) ? type : Dune::GeometryTypes::simplex( dimension );
+        const auto &refinement = buildRefinement< dimension, ctype >( type, cellType );
+        for( auto it = refinement.vBegin( intervals_ ), end = refinement.vEnd( intervals_ ); it != end; ++it )
+          layout.points.push_back( it.coords() );
+        for( auto it = refinement.eBegin( intervals_ ), end = refinement.eEnd( intervals_ ); it != end; ++it )
+        {
+          const auto indices = it.vertexIndices();
+          LocalCoordinateType center( 0 );
+          for( std::size_t i = 0; i < indices.size(); ++i )
+          {
+            layout.connectivity.push_back( indices[ Dune::VTK::renumber( cellType, i ) ] );
+            center += layout.points[ indices[ i ] ];
+          }
+          center /= ctype( indices.size() );
+          layout.centers.push_back( center );
+          layout.offsets.push_back( layout.connectivity.size() );
+          layout.types.push_back( static_cast< std::uint8_t >( Dune::VTK::geometryType( cellType ) ) );
+        }
+        return layout;
+      }
+
+      void writeCollection ( const std::string &name, int size ) const
+      {
+        std::ofstream out( (name + ".pvtu").c_str() );
+        if( !out )
+          DUNE_THROW( IOError, "Unable to open file: " << name << ".pvtu" );
+
+        out << "<?xml version=\"1.0\"?>\n";
+        out << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << byteOrder() << "\" header_type=\"UInt64\">\n";
+        out << "  <PUnstructuredGrid GhostLevel=\"0\">\n";
+        out << "    <PPointData>\n";
+        for( const auto &data : vertexData_ )
+          out << "      <PDataArray type=\"Float32\" Name=\"" << data->name() << "\" NumberOfComponents=\"" << data->ncomps() << "\"/>\n";
+        out << "    </PPointData>\n";
+        out << "    <PCellData>\n";
+        for( const auto &data : cellData_ )
+          out << "      <PDataArray type=\"Float32\" Name=\"" << data->name() << "\" NumberOfComponents=\"" << data->ncomps() << "\"/>\n";
+        out << "    </PCellData>\n";
+        out << "    <PPoints>\n";
+        out << "      <PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n";
+        out << "    </PPoints>\n";
+        for( int rank = 0; rank < size; ++rank )
+          out << "    <Piece Source=\"" << baseName( pieceName( name, rank ) ) << "\"/>\n";
+        out << "  </PUnstructuredGrid>\n";
+        out << "</VTKFile>\n";
+      }
+
+      void writePiece ( const std::string &filename )
+      {
+        // collect elements and offsets of their points, cells and corners
+        elements_.clear();
+        elementLayouts_.clear();
+        pointOffset_.assign( 1, 0 );
+        cellOffset_.assign( 1, 0 );
+        cornerOffset_.assign( 1, 0 );
+        for( const ElementType &element : elements( gridPart_, Partitions::interior ) )
+        {
+          const Layout &layout = this->layout( element.type() );
+          elements_.push_back( element.seed() );
+          elementLayouts_.push_back( &layout );
+          pointOffset_.push_back( pointOffset_.back() + layout.points.size() );
+          cellOffset_.push_back( cellOffset_.back() + layout.types.size() );
+          cornerOffset_.push_back( cornerOffset_.back() + layout.connectivity.size() );
+        }
+
+        std::ofstream out( filename.c_str(), std::ios::binary );
+        if( !out )
+          DUNE_THROW( IOError, "Unable to open file: " << filename );
+
+        // header with placeholders for the offsets
+        std::vector< ArrayInfo > arrays;
+        out << "<?xml version=\"1.0\"?>\n";
+        // version 2.2 marks the current node numbering of Lagrange hexahedra
+        out << "<VTKFile type=\"UnstructuredGrid\" version=\"" << (lagrangeOrder_ > 0 ? "2.2" : "1.0") << "\" byte_order=\"" << byteOrder() << "\" header_type=\"UInt64\"";
+        if( compress_ )
+          out << " compressor=\"vtkLZ4DataCompressor\"";
+        out << ">\n";
+        out << "  <UnstructuredGrid>\n";
+        out << "    <Piece NumberOfPoints=\"" << pointOffset_.back() << "\" NumberOfCells=\"" << cellOffset_.back() << "\">\n";
+        out << "      <PointData>\n";
+        for( const auto &data : vertexData_ )
+          arrays.push_back( dataArrayHeader( out, "Float32", data->name(), data->ncomps(), pointOffset_.back() * data->ncomps() * sizeof( float ) ) );
+        out << "      </PointData>\n";
+        out << "      <CellData>\n";
+        for( const auto &data : cellData_ )
+          arrays.push_back( dataArrayHeader( out, "Float32", data->name(), data->ncomps(), cellOffset_.back() * data->ncomps() * sizeof( float ) ) );
+        out << "      </CellData>\n";
+        out << "      <Points>\n";
+        arrays.push_back( dataArrayHeader( out, "Float32", "Points", 3, pointOffset_.back() * 3 * sizeof( float ) ) );
+        out << "      </Points>\n";
+        out << "      <Cells>\n";
+        arrays.push_back( dataArrayHeader( out, "Int64", "connectivity", 1, cornerOffset_.back() * sizeof( std::int64_t ) ) );
+        arrays.push_back( dataArrayHeader( out, "Int64", "offsets", 1, cellOffset_.back() * sizeof( std::int64_t ) ) );
+        arrays.push_back( dataArrayHeader( out, "UInt8", "types", 1, cellOffset_.back() * sizeof( std::uint8_t ) ) );
+        out << "      </Cells>\n";
+        out << "    </Piece>\n";
+        out << "  </UnstructuredGrid>\n";
+        out << "  <AppendedData encoding=\"raw\">\n_";
+        const std::streampos appendedStart = out.tellp();
+
+        // data arrays in the order of the header
+        std::size_t array = 0;
+        for( const auto &data : vertexData_ )
+        {
+          writeArray( out, appendedStart, arrays[ array++ ], pointOffset_, data->ncomps() * sizeof( float ), [ &data ] () {
+              return makeKernel( data->localEvaluator(), [] ( const LocalEvaluatorKernelData &d, LocalEvaluator *evaluator, char *buffer ) {
+                  evaluator->evaluate( d.element, d.layout->points, reinterpret_cast< float * >( buffer ) );
+                } );
+            } );
+        }
+        for( const auto &data : cellData_ )
+        {
+          writeArray( out, appendedStart, arrays[ array++ ], cellOffset_, data->ncomps() * sizeof( float ), [ &data ] () {
+              return makeKernel( data->localEvaluator(), [] ( const LocalEvaluatorKernelData &d, LocalEvaluator *evaluator, char *buffer ) {
+                  evaluator->evaluate( d.element, d.layout->centers, reinterpret_cast< float * >( buffer ) );
+                } );
+            } );
+        }
+        writeArray( out, appendedStart, arrays[ array++ ], pointOffset_, 3 * sizeof( float ), [] () {
+            return makeKernel( nullptr, [] ( const LocalEvaluatorKernelData &d, LocalEvaluator *, char *buffer ) {
+                float *points = reinterpret_cast< float * >( buffer );
+                const auto geometry = d.element.geometry();
+                for( const LocalCoordinateType &x : d.layout->points )
+                {
+                  const auto y = geometry.global( x );
+                  for( int i = 0; i < 3; ++i )
+                    *(points++) = (i < dimensionworld ? static_cast< float >( y[ i ] ) : 0.0f);
+                }
+              } );
+          } );
+        writeArray( out, appendedStart, arrays[ array++ ], cornerOffset_, sizeof( std::int64_t ), [] () {
+            return makeKernel( nullptr, [] ( const LocalEvaluatorKernelData &d, LocalEvaluator *, char *buffer ) {
+                std::int64_t *connectivity = reinterpret_cast< std::int64_t * >( buffer );
+                for( std::int64_t i : d.layout->connectivity )
+                  *(connectivity++) = d.firstPoint + i;
+              } );
+          } );
+        writeArray( out, appendedStart, arrays[ array++ ], cellOffset_, sizeof( std::int64_t ), [] () {
+            return makeKernel( nullptr, [] ( const LocalEvaluatorKernelData &d, LocalEvaluator *, char *buffer ) {
+                std::int64_t *offsets = reinterpret_cast< std::int64_t * >( buffer );
+                for( std::int64_t offset : d.layout->offsets )
+                  *(offsets++) = d.firstCorner + offset;
+              } );
+          } );
+        writeArray( out, appendedStart, arrays[ array++ ], cellOffset_, sizeof( std::uint8_t ), [] () {
+            return makeKernel( nullptr, [] ( const LocalEvaluatorKernelData &d, LocalEvaluator *, char *buffer ) {
+                std::copy( d.layout->types.begin(), d.layout->types.end(), reinterpret_cast< std::uint8_t * >( buffer ) );
+              } );
+          } );
+
+        out << "\n  </AppendedData>\n";
+        out << "</VTKFile>\n";
+
+        // patch the offsets in the header
+        for( const ArrayInfo &info : arrays )
+        {
+          out.seekp( info.offsetPosition );
+          out << std::setw( offsetWidth ) << std::setfill( '0' ) << info.offset;
+        }
+
+        if( !out )
+          DUNE_THROW( IOError, "Unable to write file: " << filename );
+      }
+
+      ArrayInfo dataArrayHeader ( std::ostream &out, const std::string &type, const std::string &name, int ncomps, std::size_t rawSize ) const
+      {
+        ArrayInfo info;
+        info.rawSize = rawSize;
+        out << "        <DataArray type=\"" << type << "\" Name=\"" << name << "\" NumberOfComponents=\"" << ncomps
+            << "\" format=\"appended\" offset=\"";
+        info.offsetPosition = out.tellp();
+        out << std::string( offsetWidth, '0' ) << "\"/>\n";
+        return info;
+      }
+
+      // data of one element passed to the kernels
+      struct LocalEvaluatorKernelData
+      {
+        ElementType element;
+        const Layout *layout = nullptr;
+        std::int64_t firstPoint = 0, firstCorner = 0;
+      };
+
+      // kernel writing the data of one element (one instance per thread)
+      struct Kernel
+      {
+        virtual ~Kernel () {}
+        virtual void operator() ( const LocalEvaluatorKernelData &data, char *buffer ) = 0;
+      };
+
+      template< class F >
+      struct KernelImpl
+        : public Kernel
+      {
+        KernelImpl ( std::unique_ptr< LocalEvaluator > evaluator, F f ) : evaluator_( std::move( evaluator ) ), f_( f ) {}
+
+        void operator() ( const LocalEvaluatorKernelData &data, char *buffer ) override { f_( data, evaluator_.get(), buffer ); }
+
+      private:
+        std::unique_ptr< LocalEvaluator > evaluator_;
+        F f_;
+      };
+
+      template< class F >
+      static std::unique_ptr< Kernel > makeKernel ( std::unique_ptr< LocalEvaluator > evaluator, F f )
+      {
+        return std::unique_ptr< Kernel >( new KernelImpl< F >( std::move( evaluator ), f ) );
+      }
+
+      void setupElement ( std::size_t e, LocalEvaluatorKernelData &data ) const
+      {
+        data.element = gridPart_.entity( elements_[ e ] );
+        data.layout = elementLayouts_[ e ];
+        data.firstPoint = pointOffset_[ e ];
+        data.firstCorner = cornerOffset_[ e ];
+      }
+
+      /* write one data array: the elements are processed in chunks, each
+       * chunk is filled in parallel (entity e writes entries
+       * [offset[e], offset[e+1]) of the array) and then written (or
+       * compressed) before the next chunk is processed */
+      template< class KernelFactory >
+      void writeArray ( std::ostream &out, std::streampos appendedStart, ArrayInfo &info,
+                        const std::vector< std::size_t > &offset, std::size_t entrySize, KernelFactory kernelFactory )
+      {
+        info.offset = static_cast< std::size_t >( out.tellp() - appendedStart );
+        ArraySink sink( out, info.rawSize, compress_ );
+
+        const int maxThreads = ThreadManager::maxThreads();
+        std::vector< std::unique_ptr< Kernel > > kernels( maxThreads );
+        std::vector< LocalEvaluatorKernelData > data( maxThreads );
+        for( int t = 0; t < maxThreads; ++t )
+          kernels[ t ] = kernelFactory();
+
+        std::vector< char > buffer;
+        const std::size_t numElements = elements_.size();
+        for( std::size_t begin = 0; begin < numElements; begin += chunkSize_ )
+        {
+          const std::size_t end = std::min( begin + chunkSize_, numElements );
+          buffer.resize( (offset[ end ] - offset[ begin ]) * entrySize );
+
+          parallelFor( begin, end, 64, [ this, &kernels, &data, &buffer, &offset, begin, entrySize ] ( std::size_t e ) {
+              const int thread = ThreadManager::thread();
+              setupElement( e, data[ thread ] );
+              (*kernels[ thread ])( data[ thread ], buffer.data() + (offset[ e ] - offset[ begin ]) * entrySize );
+            }, maxThreads );
+          sink.write( buffer.data(), buffer.size() );
+        }
+        sink.close();
+      }
+
+      /* sink for the data of one array
+       *
+       * uncompressed: UInt64 size followed by the data
+       * compressed:   UInt64 header [#blocks, block size, last block size,
+       *               compressed sizes...] followed by the compressed blocks;
+       *               the header is reserved and patched in close()
+       */
+      class ArraySink
+      {
+        static const std::size_t blockSize = 1 << 16;
+
+      public:
+        ArraySink ( std::ostream &out, std::size_t rawSize, bool compress )
+          : out_( out ), rawSize_( rawSize ), compress_( compress )
+        {
+          if( compress_ )
+          {
+            const std::size_t blocks = (rawSize_ + blockSize - 1) / blockSize;
+            header_.assign( 3 + blocks, 0 );
+            header_[ 0 ] = blocks;
+            header_[ 1 ] = blockSize;
+            header_[ 2 ] = (blocks > 0 ? rawSize_ - (blocks-1)*blockSize : 0);
+            headerPosition_ = out_.tellp();
+            writeHeader();
+          }
+          else
+          {
+            const std::uint64_t size = rawSize_;
+            out_.write( reinterpret_cast< const char * >( &size ), sizeof( size ) );
+          }
+        }
+
+        void write ( const char *data, std::size_t size )
+        {
+          if( !compress_ )
+          {
+            out_.write( data, size );
+            return;
+          }
+
+          pending_.insert( pending_.end(), data, data + size );
+          const std::size_t blocks = pending_.size() / blockSize;
+          compressBlocks( blocks, blockSize );
+        }
+
+        void close ()
+        {
+          if( !compress_ )
+            return;
+
+          if( !pending_.empty() )
+            compressBlocks( 1, pending_.size() );
+
+          const std::streampos end = out_.tellp();
+          out_.seekp( headerPosition_ );
+          writeHeader();
+          out_.seekp( end );
+        }
+
+      private:
+        void writeHeader ()
+        {
+          out_.write( reinterpret_cast< const char * >( header_.data() ), header_.size() * sizeof( std::uint64_t ) );
+        }
+
+        // compress the first blocks of the pending data (in parallel)
+        void compressBlocks ( std::size_t blocks, std::size_t size )
+        {
+#if HAVE_LZ4
+          std::vector< std::vector< char > > compressed( blocks );
+          parallelFor( 0, blocks, 1, [ this, &compressed, size ] ( std::size_t b ) {
+              compressed[ b ].resize( LZ4_compressBound( size ) );
+              const int result = LZ4_compress_default( pending_.data() + b*size, compressed[ b ].data(), size, compressed[ b ].size() );
+              compressed[ b ].resize( result > 0 ? result : 0 );
+            } );
+          for( std::size_t b = 0; b < blocks; ++b )
+          {
+            if( compressed[ b ].empty() )
+              DUNE_THROW( IOError, "Unable to compress VTK data block." );
+            out_.write( compressed[ b ].data(), compressed[ b ].size() );
+            header_[ 3 + block_++ ] = compressed[ b ].size();
+          }
+          pending_.erase( pending_.begin(), pending_.begin() + blocks*size );
+#else // #if HAVE_LZ4
+          DUNE_THROW( NotImplemented, "VTU compression requires LZ4." );
+#endif // #else // #if HAVE_LZ4
+        }
+
+        std::ostream &out_;
+        std::size_t rawSize_;
+        bool compress_;
+        std::vector< std::uint64_t > header_;
+        std::streampos headerPosition_;
+        std::vector< char > pending_;
+        std::size_t block_ = 0;
+      };
+
+      const GridPartType &gridPart_;
+      RefinementIntervals intervals_;
+      int lagrangeOrder_ = 0;
+      bool compress_;
+      std::size_t chunkSize_;
+
+      std::map< GeometryType, Layout > layouts_;
+
+      std::vector< std::unique_ptr< DataFunction > > vertexData_, cellData_;
+
+      std::vector< ElementSeedType > elements_;
+      std::vector< const Layout * > elementLayouts_;
+      std::vector< std::size_t > pointOffset_, cellOffset_, cornerOffset_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_IO_FILE_VTUWRITER_HH
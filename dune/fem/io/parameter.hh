@@ -1,6 +1,8 @@
 #ifndef DUNE_FEM_PARAMETER_HH
 #define DUNE_FEM_PARAMETER_HH
 
+#include <cstddef>
+
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -468,6 +470,13 @@ namespace Dune
        */
       static void write ( std::ostream &out, bool writeAll = true ) { return container().write( out, writeAll ); }
 
+      /** \brief write the most frequently read parameters to a stream
+       *
+       *  \param[in]  out  stream for the statistics.
+       *  \param[in]  n    maximal number of parameters to write
+       */
+      static void writeLookups ( std::ostream &out, std::size_t n = 20 ) { container().writeLookups( out, n ); }
+
     protected:
       friend class PersistenceManager ;
 
@@ -10,6 +10,7 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include <dune/grid/io/file/dgfparser/dgfparser.hh>
@@ -59,9 +60,12 @@ namespace Dune
         return (verboseRank == MPIManager::rank());
       }
 
-      mutable std::map< std::string, Value > map;
+      mutable std::unordered_map< std::string, Value > map;
       std::set< std::string > deprecated;
       int verboseRank = -1;
+
+      // parsed values and lookup counters (see BasicParameterReader)
+      ParameterCache cache;
     };
 
 
@@ -139,7 +143,11 @@ namespace Dune
       void appendDGF ( const std::string &filename );
 
       /** \brief clear all parameters */
-      void clear () { parameter_.map.clear(); }
+      void clear ()
+      {
+        parameter_.map.clear();
+        parameter_.cache.clear();
+      }
 
       /** \brief obtain the cached value for fem.verbose */
       bool verbose () const { return parameter_.verbose(); }
@@ -170,6 +178,23 @@ namespace Dune
        */
       void write ( std::ostream &out, bool writeAll = true ) const;
 
+      /**
+       * \brief write the most frequently read parameters to a stream
+       *
+       * Each read access to a parameter (through the container or a
+       * ParameterReader obtained from it) is counted. Reading a parameter
+       * repeatedly is cheap, since the parsed value is cached, but a high
+       * count usually points to a parameter read inside a loop.
+       *
+       * \param[in]  out  stream for the statistics.
+       * \param[in]  n    maximal number of parameters to write
+       */
+      void writeLookups ( std::ostream &out, std::size_t n = 20 ) const
+      {
+        for( const auto &key : parameter_.cache.hotKeys( n ) )
+          out << key.first << ": " << key.second << std::endl;
+      }
+
     private:
       std::string curFileName_;
       int curLineNumber_;
@@ -199,7 +224,7 @@ namespace Dune
       if( deprecated.find( key ) != deprecated.end() )
         DUNE_THROW( ParameterInvalid, "Parameter '" << key << "' deprecated" );
 
-      std::map< std::string, Value >::iterator pos;
+      std::unordered_map< std::string, Value >::iterator pos;
       if( defaultValue )
       {
         const std::string& defaultValueStr = *defaultValue;
@@ -431,7 +456,11 @@ namespace Dune
       if( key == "paramfile" )
         includes.push( commonInputPath() + "/" + value );
       else if( key == "deprecated" )
+      {
         parameter_.deprecated.insert( value );
+        // cached values bypass the deprecation check
+        parameter_.cache.invalidate();
+      }
       else
         insert( key, value );
       return true;
@@ -2,11 +2,22 @@
 #define DUNE_FEM_IO_PARAMETER_READER_HH
 
 #include <cassert>
+#include <cstddef>
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include <dune/common/typetraits.hh>
+#include <dune/common/typeutilities.hh>
 
 #include <dune/fem/io/parameter/exceptions.hh>
 #include <dune/fem/io/parameter/parser.hh>
@@ -23,6 +34,209 @@ namespace Dune
       return defaultKeyForExistCheck;
     }
 
+    struct ParameterContainerData;
+
+
+
+    // ParameterCache
+    // --------------
+
+    /** \brief cache for parsed parameter values
+     *
+     *  Converting the default value into a string and parsing the parameter
+     *  value is considerably more expensive than looking up the key. A
+     *  parameter source may therefore provide a public member \c cache of this
+     *  type. BasicParameterReader then stores the parsed value on the first
+     *  lookup of a key and returns it for subsequent lookups with the same type
+     *  and default value. Only copyable and equality comparable types are
+     *  cached.
+     *
+     *  Additionally, the cache counts all lookups of each key (see lookups and
+     *  hotKeys), which helps to find parameters read within hot loops.
+     *
+     *  \note Cached values assume that the value of a parameter does not
+     *        change once it has been read, which holds for the
+     *        ParameterContainer.
+     */
+    class ParameterCache
+    {
+      template< class T, class = void >
+      struct IsCacheable
+        : std::false_type
+      {};
+
+      template< class T >
+      struct IsCacheable< T, void_t< decltype( static_cast< bool >( std::declval< const T & >() == std::declval< const T & >() ) ) > >
+        : std::is_copy_assignable< T >
+      {};
+
+      struct Entry
+      {
+        std::size_t lookups = 0;
+        std::type_index type = typeid( void );
+        std::shared_ptr< const void > value, defaultValue;
+      };
+
+    public:
+      ParameterCache () = default;
+
+      // copies of a parameter source start with an empty cache
+      ParameterCache ( const ParameterCache & ) {}
+      ParameterCache &operator= ( const ParameterCache & ) { clear(); return *this; }
+
+      /**
+       * \brief look up a cached parameter value
+       *
+       * This method also counts the lookup of the key.
+       *
+       * \param[in]   key           name of the parameter
+       * \param[in]   defaultValue  pointer to default value (nullptr for mandatory parameters)
+       * \param[out]  value         cached value of the parameter
+       *
+       * \returns \b true, if a value for the key, type and default value was cached
+       */
+      template< class T >
+      bool find ( const std::string &key, const T *defaultValue, T &value ) const
+      {
+        return find( key, defaultValue, value, IsCacheable< T >() );
+      }
+
+      /** \brief store a parsed parameter value */
+      template< class T >
+      void insert ( const std::string &key, const T *defaultValue, const T &value ) const
+      {
+        insert( key, defaultValue, value, IsCacheable< T >() );
+      }
+
+      /** \brief count a lookup of a key without caching a value */
+      void count ( const std::string &key ) const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        ++entries_[ key ].lookups;
+      }
+
+      /** \brief number of lookups of a key */
+      std::size_t lookups ( const std::string &key ) const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        const auto pos = entries_.find( key );
+        return (pos != entries_.end() ? pos->second.lookups : 0u);
+      }
+
+      /** \brief obtain (at most) n keys with the highest number of lookups, most frequent first */
+      std::vector< std::pair< std::string, std::size_t > > hotKeys ( std::size_t n ) const
+      {
+        std::vector< std::pair< std::string, std::size_t > > keys;
+        {
+          std::lock_guard< std::mutex > guard( mutex_ );
+          keys.reserve( entries_.size() );
+          for( const auto &entry : entries_ )
+            keys.emplace_back( entry.first, entry.second.lookups );
+        }
+        const auto compare = [] ( const std::pair< std::string, std::size_t > &a, const std::pair< std::string, std::size_t > &b ) {
+            return (a.second > b.second) || ((a.second == b.second) && (a.first < b.first));
+          };
+        n = std::min( n, keys.size() );
+        std::partial_sort( keys.begin(), keys.begin() + n, keys.end(), compare );
+        keys.resize( n );
+        return keys;
+      }
+
+      /** \brief drop all cached values, keeping the lookup counters */
+      void invalidate () const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        for( auto &entry : entries_ )
+        {
+          entry.second.value.reset();
+          entry.second.defaultValue.reset();
+        }
+      }
+
+      /** \brief drop all cached values and lookup counters */
+      void clear () const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        entries_.clear();
+      }
+
+    private:
+      template< class T >
+      bool find ( const std::string &key, const T *defaultValue, T &value, std::true_type ) const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        Entry &entry = entries_[ key ];
+        ++entry.lookups;
+        if( !entry.value || (entry.type != std::type_index( typeid( T ) )) )
+          return false;
+        // defer parameters with changed defaults to the parameter source, which reports the error
+        if( static_cast< bool >( defaultValue ) != static_cast< bool >( entry.defaultValue ) )
+          return false;
+        if( defaultValue && !static_cast< bool >( *defaultValue == *static_cast< const T * >( entry.defaultValue.get() ) ) )
+          return false;
+        value = *static_cast< const T * >( entry.value.get() );
+        return true;
+      }
+
+      template< class T >
+      bool find ( const std::string &key, const T *, T &, std::false_type ) const
+      {
+        count( key );
+        return false;
+      }
+
+      template< class T >
+      void insert ( const std::string &key, const T *defaultValue, const T &value, std::true_type ) const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        Entry &entry = entries_[ key ];
+        entry.type = std::type_index( typeid( T ) );
+        entry.value = std::make_shared< const T >( value );
+        if( defaultValue )
+          entry.defaultValue = std::make_shared< const T >( *defaultValue );
+        else
+          entry.defaultValue.reset();
+      }
+
+      template< class T >
+      void insert ( const std::string &, const T *, const T &, std::false_type ) const
+      {}
+
+      mutable std::unordered_map< std::string, Entry > entries_;
+      mutable std::mutex mutex_;
+    };
+
+
+
+    namespace Impl
+    {
+
+      // parameterCache
+      // --------------
+
+      template< class Parameter >
+      inline const ParameterCache *parameterCache ( const Parameter &, PriorityTag< 0 > )
+      {
+        return nullptr;
+      }
+
+      template< class Parameter >
+      inline auto parameterCache ( const Parameter &parameter, PriorityTag< 1 > )
+        -> decltype( static_cast< const ParameterCache * >( &parameter.cache ) )
+      {
+        return &parameter.cache;
+      }
+
+      // ParameterReader wrapping a ParameterContainer (see ParameterContainer::operator ParameterReader)
+      template< class Signature, class Data = ParameterContainerData >
+      inline const ParameterCache *parameterCache ( const std::function< Signature > &parameter, PriorityTag< 2 > )
+      {
+        const auto *data = parameter.template target< std::reference_wrapper< const Data > >();
+        return (data ? parameterCache( data->get(), PriorityTag< 1 >() ) : nullptr);
+      }
+
+    } // namespace Impl
+
     // BasicParameterReader
     // --------------------
 
@@ -42,6 +256,8 @@ namespace Dune
        */
       bool exists ( const std::string &key ) const
       {
+        if( const ParameterCache *cache = this->cache() )
+          cache->count( key );
         return static_cast< bool >( parameter_( key, &checkParameterExistsString() ) );
       }
 
@@ -57,11 +273,7 @@ namespace Dune
       template< class T >
       void get ( const std::string &key, T &value ) const
       {
-        const std::string *string = parameter_( key, nullptr );
-        if( !string )
-          DUNE_THROW( ParameterNotFound, "Parameter '" << key << "' not found." );
-        if( !ParameterParser< T >::parse( *string, value ) )
-          DUNE_THROW( ParameterInvalid, "Parameter '" << key << "' invalid." );
+        lookup( key, static_cast< const T * >( nullptr ), value );
       }
 
       /**
@@ -77,11 +289,7 @@ namespace Dune
       template< class T >
       void get ( const std::string &key, const T &defaultValue, T &value ) const
       {
-        const std::string defaultString = ParameterParser< T >::toString( defaultValue );
-        const std::string *string = parameter_( key, &defaultString );
-        assert( string );
-        if( !ParameterParser< T >::parse( *string, value ) )
-          DUNE_THROW( ParameterInvalid, "Parameter '" << key << "' invalid." );
+        lookup( key, &defaultValue, value );
       }
 
       /**
@@ -97,10 +305,7 @@ namespace Dune
       void get ( const std::string &key, const char* defaultValue, std::string &value ) const
       {
         const std::string defaultString( defaultValue );
-        const std::string *string = parameter_( key, &defaultString );
-        assert( string );
-        if( !ParameterParser< std::string >::parse( *string, value ) )
-          DUNE_THROW( ParameterInvalid, "Parameter '" << key << "' invalid." );
+        lookup( key, &defaultString, value );
       }
 
       /**
@@ -116,10 +321,8 @@ namespace Dune
       template< class T, class Validator >
       void getValid ( const std::string &key, const Validator &validator, T &value ) const
       {
-        const std::string *string = parameter_( key, nullptr );
-        if( !string )
-          DUNE_THROW( ParameterNotFound, "Parameter '" << key << "' not found." );
-        if( !ParameterParser< T >::parse( *string, value ) || !validator( value ) )
+        lookup( key, static_cast< const T * >( nullptr ), value );
+        if( !validator( value ) )
           DUNE_THROW( ParameterInvalid, "Parameter '" << key << "' invalid." );
       }
 
@@ -137,10 +340,8 @@ namespace Dune
       template< class T, class Validator >
       void getValid ( const std::string &key, const T &defaultValue, const Validator &validator, T &value ) const
       {
-        const std::string defaultString = ParameterParser< T >::toString( defaultValue );
-        const std::string *string = parameter_( key, &defaultString );
-        assert( string );
-        if( !ParameterParser< T >::parse( *string, value ) || !validator( value ) )
+        lookup( key, &defaultValue, value );
+        if( !validator( value ) )
           DUNE_THROW( ParameterInvalid, "Parameter '" << key << "' invalid." );
       }
 
@@ -223,6 +424,8 @@ namespace Dune
       template< int n >
       int getEnum ( const std::string &key, const std::string (&values)[ n ] ) const
       {
+        if( const ParameterCache *cache = this->cache() )
+          cache->count( key );
         const std::string *string = parameter_( key, nullptr );
         if( !string )
           DUNE_THROW( ParameterNotFound, "Parameter '" << key << "' not found." );
@@ -232,11 +435,49 @@ namespace Dune
       template< int n >
       int getEnum ( const std::string &key, const std::string (&values)[ n ], int defaultValue ) const
       {
+        if( const ParameterCache *cache = this->cache() )
+          cache->count( key );
         const std::string *string = parameter_( key, &values[ defaultValue ] );
         return getEnumeration( key, *string, values );
       }
 
+      /**
+       * \brief obtain the number of lookups of a parameter
+       *
+       * \note Lookups are only counted for parameter sources providing a
+       *       ParameterCache, e.g., the ParameterContainer. For other sources
+       *       this method always returns 0.
+       *
+       * \param[in]   key    name of the parameter
+       */
+      std::size_t lookups ( const std::string &key ) const
+      {
+        const ParameterCache *cache = this->cache();
+        return (cache ? cache->lookups( key ) : 0u);
+      }
+
     private:
+      const ParameterCache *cache () const { return Impl::parameterCache( parameter_, PriorityTag< 42 >() ); }
+
+      template< class T >
+      void lookup ( const std::string &key, const T *defaultValue, T &value ) const
+      {
+        const ParameterCache *cache = this->cache();
+        if( cache && cache->find( key, defaultValue, value ) )
+          return;
+
+        // note: the parameter source may return a pointer to defaultString
+        const std::string defaultString = (defaultValue ? ParameterParser< T >::toString( *defaultValue ) : std::string());
+        const std::string *string = parameter_( key, (defaultValue ? &defaultString : nullptr) );
+        if( !string )
+          DUNE_THROW( ParameterNotFound, "Parameter '" << key << "' not found." );
+        if( !ParameterParser< T >::parse( *string, value ) )
+          DUNE_THROW( ParameterInvalid, "Parameter '" << key << "' invalid." );
+
+        if( cache )
+          cache->insert( key, defaultValue, value );
+      }
+
       template< int n >
       static int getEnumeration ( const std::string &key, const std::string& value, const std::string (&values)[ n ] )
       {
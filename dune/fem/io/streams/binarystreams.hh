@@ -1,6 +1,9 @@
 #ifndef DUNE_FEM_BINARYSTREAMS_HH
 #define DUNE_FEM_BINARYSTREAMS_HH
 
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/streams/compressedstreams.hh>
+#include <dune/fem/io/streams/mappedstreams.hh>
 #include <dune/fem/io/streams/standardstreams.hh>
 
 namespace Dune
@@ -11,6 +14,9 @@ namespace Dune
 
     /** \class BinaryFileOutStream
      *  \copydoc StandardOutStream
+     *
+     *  \note The data is compressed if selected by the parameter
+     *        fem.io.compression (see \ref CompressedStreams).
      */
     class BinaryFileOutStream : public StandardOutStream
     {
@@ -22,20 +28,36 @@ namespace Dune
     public:
       /** \brief constructor
        *
-       *  \param[in]  filename  name of a file to write to
+       *  \param[in]  filename   name of a file to write to
+       *  \param[in]  parameter  parameters selecting the compression
        */
-      explicit BinaryFileOutStream ( const std::string &filename )
-        : BaseType( openFile( filename ) )
+      explicit BinaryFileOutStream ( const std::string &filename,
+                                     const StreamCompressionParameters &parameter = StreamCompressionParameters() )
+        : BaseType( openFile( filename, parameter ) )
+      {
+      }
+
+      /** \brief constructor writing into a given stream instead of a file,
+       *         e.g., to stage the data in memory
+       *
+       *  \param[in]  stream     std::ostream to write to
+       *  \param[in]  parameter  parameters selecting the compression
+       */
+      explicit BinaryFileOutStream ( std::ostream &stream,
+                                     const StreamCompressionParameters &parameter = StreamCompressionParameters() )
+        : BaseType( compress( stream, parameter ) ), file_( nullptr )
       {
       }
 
       /** \brief destructor deleteing file stream */
       ~BinaryFileOutStream()
       {
+        // write the remaining compressed blocks before closing the file
+        delete compressed_; compressed_ = 0;
         delete file_; file_ = 0;
       }
     protected:
-      std::ostream& openFile( const std::string& filename )
+      std::ostream& openFile( const std::string& filename, const StreamCompressionParameters &parameter )
       {
         // init file
         file_ = new std::ofstream( filename.c_str(), std::ios::binary );
@@ -43,15 +65,31 @@ namespace Dune
         if( ! (*file_) )
           DUNE_THROW( Dune::IOError, "Unable to open file: " << filename );
 
-        return *file_;
+        return compress( *file_, parameter );
+      }
+
+      std::ostream& compress( std::ostream& stream, const StreamCompressionParameters &parameter )
+      {
+        compressed_ = 0;
+        if( parameter.compression() == StreamCompression::none )
+          return stream;
+
+        compressed_ = new CompressingOStream( stream, parameter );
+        return *compressed_;
       }
 
       //! standard file stream
       std::ofstream* file_;
+      //! compressing stream (if compression is enabled)
+      CompressingOStream* compressed_;
     };
 
     /** \class BinaryFileInStream
      *  \copydoc StandardInStream
+     *
+     *  \note The file is memory mapped unless disabled by the parameter
+     *        fem.io.mmap (default true), so large arrays (e.g., the dofs of
+     *        discrete functions) are copied directly from the mapped pages.
      */
     class BinaryFileInStream: public StandardInStream
     {
@@ -64,32 +102,48 @@ namespace Dune
     public:
       /** \brief constructor
        *
-       *  \param[in]  filename  name of a file to write to
+       *  \param[in]  filename   name of a file to write to
+       *  \param[in]  parameter  parameters (reads fem.io.mmap)
        */
-      explicit BinaryFileInStream ( const std::string &filename )
-      : BaseType( openFile( filename ) )
+      explicit BinaryFileInStream ( const std::string &filename,
+                                    const ParameterReader &parameter = Parameter::container() )
+      : BaseType( openFile( filename, parameter.getValue< bool >( "fem.io.mmap", true ) ) )
       {
       }
 
       /** \brief destructor deleteing file stream */
       ~BinaryFileInStream()
       {
+        delete decompressed_; decompressed_ = 0;
         delete file_; file_ = 0;
       }
 
     protected:
-      std::istream& openFile( const std::string& filename )
+      std::istream& openFile( const std::string& filename, bool map )
       {
-        file_ = (new std::ifstream( filename.c_str(), std::ios::binary ));
-
-        if( ! (*file_) )
-          DUNE_THROW( Dune::IOError, "Unable to open file: " << filename );
-
-        return *file_;
+        if( map )
+          file_ = new MappedFileIStream( filename );
+        else
+        {
+          file_ = (new std::ifstream( filename.c_str(), std::ios::binary ));
+
+          if( ! (*file_) )
+            DUNE_THROW( Dune::IOError, "Unable to open file: " << filename );
+        }
+
+        // compressed files are detected automatically
+        decompressed_ = 0;
+        if( !Impl::CompressedStreamFormat::detect( *file_ ) )
+          return *file_;
+
+        decompressed_ = new DecompressingIStream( *file_ );
+        return *decompressed_;
       }
 
-      //! standard file stream
-      std::ifstream* file_;
+      //! file stream (memory mapped or standard file stream)
+      std::istream* file_;
+      //! decompressing stream (if the file is compressed)
+      DecompressingIStream* decompressed_;
     };
 
   } // namespace Fem
@@ -0,0 +1,724 @@
+#ifndef DUNE_FEM_COMPRESSEDSTREAMS_HH
+#define DUNE_FEM_COMPRESSEDSTREAMS_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if HAVE_ZSTD
+#include <zstd.h>
+#endif // #if HAVE_ZSTD
+
+#if HAVE_LZ4
+#include <lz4.h>
+#endif // #if HAVE_LZ4
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/misc/threads/parallelfor.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    /** \addtogroup InOutStreams
+     *
+     *  \section CompressedStreams Compressed Binary Streams
+     *
+     *  The binary file streams can compress the data they write (see
+     *  BinaryFileOutStream). The data is split into blocks of fixed size
+     *  (fem.io.compressionblocksize, default 1 MiB), which are compressed and
+     *  decompressed independently, so that several blocks can be processed
+     *  in parallel. Before compression, the bytes of each block are
+     *  interpreted as a sequence of 8 byte words (e.g., doubles), each word is
+     *  replaced by the bitwise difference (xor) to its predecessor and the
+     *  bytes are regrouped by their position within the word. For smooth
+     *  fields this leaves long runs of zeros in the sign, exponent and leading
+     *  mantissa bytes.
+     *
+     *  The codec is selected by the parameter fem.io.compression:
+     *  - none:    do not compress (default)
+     *  - builtin: run length encoding, no external dependencies
+     *  - zstd:    Zstandard (level given by fem.io.compressionlevel, default 1)
+     *  - lz4:     LZ4
+     *
+     *  If zstd or lz4 are not available, the built-in codec is used instead.
+     *  Compressed files are recognized automatically when read.
+     */
+
+    // StreamCompression
+    // -----------------
+
+    struct StreamCompression
+    {
+      enum Type { none = 0, builtin = 1, zstd = 2, lz4 = 3 };
+
+      static const std::string &name ( Type type )
+      {
+        static const std::string names[] = { "none", "builtin", "zstd", "lz4" };
+        return names[ type ];
+      }
+
+      //! return true if the codec is available in this build
+      static bool available ( Type type )
+      {
+        switch( type )
+        {
+        case zstd:
+#if HAVE_ZSTD
+          return true;
+#else // #if HAVE_ZSTD
+          return false;
+#endif // #else // #if HAVE_ZSTD
+
+        case lz4:
+#if HAVE_LZ4
+          return true;
+#else // #if HAVE_LZ4
+          return false;
+#endif // #else // #if HAVE_LZ4
+
+        default:
+          return true;
+        }
+      }
+    };
+
+
+
+    // StreamCompressionParameters
+    // ---------------------------
+
+    struct StreamCompressionParameters
+#ifndef DOXYGEN
+    : public LocalParameter< StreamCompressionParameters, StreamCompressionParameters >
+#endif
+    {
+    protected:
+      const std::string keyPrefix_;
+      ParameterReader parameter_;
+
+    public:
+      explicit StreamCompressionParameters ( std::string keyPrefix, const ParameterReader &parameter = Parameter::container() )
+        : keyPrefix_( std::move( keyPrefix ) ), parameter_( parameter )
+      {}
+
+      explicit StreamCompressionParameters ( const ParameterReader &parameter = Parameter::container() )
+        : keyPrefix_( "fem.io." ), parameter_( parameter )
+      {}
+
+      //! codec used to compress binary files (fem.io.compression)
+      virtual StreamCompression::Type compression () const
+      {
+        static const std::string names[] = { "none", "builtin", "zstd", "lz4" };
+        StreamCompression::Type type = static_cast< StreamCompression::Type >( parameter().getEnum( keyPrefix_ + "compression", names, 0 ) );
+        if( !StreamCompression::available( type ) )
+        {
+          if( Parameter::verbose() )
+            std::cerr << "WARNING: compression '" << StreamCompression::name( type ) << "' not available, using 'builtin'." << std::endl;
+          type = StreamCompression::builtin;
+        }
+        return type;
+      }
+
+      //! size of the independently compressed blocks in bytes (fem.io.compressionblocksize)
+      virtual std::size_t blockSize () const
+      {
+        const int blockSize = parameter().getValue< int >( keyPrefix_ + "compressionblocksize", 1 << 20 );
+        if( blockSize < 64 )
+          DUNE_THROW( InvalidStateException, "Parameter " << keyPrefix_ << "compressionblocksize must be at least 64." );
+        return blockSize;
+      }
+
+      //! compression level passed to zstd (fem.io.compressionlevel)
+      virtual int level () const
+      {
+        return parameter().getValue< int >( keyPrefix_ + "compressionlevel", 1 );
+      }
+
+      const ParameterReader &parameter () const { return parameter_; }
+    };
+
+
+
+    namespace Impl
+    {
+
+      // file format of compressed streams
+      //
+      // header: magic (8 bytes), version (1 byte), codec (1 byte),
+      //         reserved (2 bytes), block size (4 bytes)
+      // block:  raw size (4 bytes), stored size (4 bytes), method (1 byte),
+      //         reserved (3 bytes), stored data
+      //
+      // A block with raw size 0 terminates the stream. All integers are
+      // stored little endian.
+      struct CompressedStreamFormat
+      {
+        static const std::size_t headerSize = 16;
+        static const std::size_t blockHeaderSize = 12;
+        static const char version = 1;
+
+        static const char *magic () { return "DFEMCBLK"; }
+
+        // check for the magic and rewind the stream
+        static bool detect ( std::istream &in )
+        {
+          char buffer[ 8 ];
+          in.read( buffer, 8 );
+          const bool found = (in.gcount() == 8) && (std::memcmp( buffer, magic(), 8 ) == 0);
+          in.clear();
+          in.seekg( 0 );
+          return found;
+        }
+
+        static void put32 ( char *out, std::uint32_t value )
+        {
+          for( int i = 0; i < 4; ++i )
+            out[ i ] = static_cast< char >( (value >> (8*i)) & 0xff );
+        }
+
+        static std::uint32_t get32 ( const char *in )
+        {
+          std::uint32_t value = 0;
+          for( int i = 0; i < 4; ++i )
+            value |= std::uint32_t( static_cast< unsigned char >( in[ i ] ) ) << (8*i);
+          return value;
+        }
+      };
+
+
+
+      // xor each 8 byte word with its predecessor and group the bytes by their position in the word
+      inline void shuffleBytes ( const char *in, std::size_t size, char *out )
+      {
+        const std::size_t words = size / 8;
+        for( std::size_t b = 0; b < 8; ++b )
+        {
+          char *dest = out + b*words;
+          if( words > 0 )
+            dest[ 0 ] = in[ b ];
+          for( std::size_t i = 1; i < words; ++i )
+            dest[ i ] = in[ 8*i + b ] ^ in[ 8*(i-1) + b ];
+        }
+        std::copy( in + 8*words, in + size, out + 8*words );
+      }
+
+      inline void unshuffleBytes ( const char *in, std::size_t size, char *out )
+      {
+        const std::size_t words = size / 8;
+        for( std::size_t b = 0; b < 8; ++b )
+        {
+          const char *src = in + b*words;
+          if( words > 0 )
+            out[ b ] = src[ 0 ];
+          for( std::size_t i = 1; i < words; ++i )
+            out[ 8*i + b ] = src[ i ] ^ out[ 8*(i-1) + b ];
+        }
+        std::copy( in + 8*words, in + size, out + 8*words );
+      }
+
+
+
+      // run length encoding: a control byte c < 128 is followed by c+1 literal
+      // bytes, a control byte c >= 128 is followed by one byte repeated c-125 times
+      inline void runLengthEncode ( const char *in, std::size_t size, std::vector< char > &out )
+      {
+        out.clear();
+        out.reserve( size + size / 128 + 1 );
+        std::size_t i = 0, literal = 0;
+        auto flushLiteral = [ & ] ( std::size_t end ) {
+          while( literal < end )
+          {
+            const std::size_t count = std::min< std::size_t >( end - literal, 128 );
+            out.push_back( static_cast< char >( count-1 ) );
+            out.insert( out.end(), in + literal, in + literal + count );
+            literal += count;
+          }
+        };
+
+        while( i < size )
+        {
+          std::size_t run = 1;
+          while( (i+run < size) && (run < 130) && (in[ i+run ] == in[ i ]) )
+            ++run;
+
+          if( run >= 3 )
+          {
+            flushLiteral( i );
+            out.push_back( static_cast< char >( run + 125 ) );
+            out.push_back( in[ i ] );
+            i += run;
+            literal = i;
+          }
+          else
+            i += run;
+        }
+        flushLiteral( size );
+      }
+
+      inline bool runLengthDecode ( const char *in, std::size_t size, char *out, std::size_t rawSize )
+      {
+        std::size_t i = 0, pos = 0;
+        while( i < size )
+        {
+          const unsigned int control = static_cast< unsigned char >( in[ i++ ] );
+          if( control < 128 )
+          {
+            const std::size_t count = control+1;
+            if( (i+count > size) || (pos+count > rawSize) )
+              return false;
+            std::copy( in + i, in + i + count, out + pos );
+            i += count;
+            pos += count;
+          }
+          else
+          {
+            const std::size_t count = control - 125;
+            if( (i >= size) || (pos+count > rawSize) )
+              return false;
+            std::fill( out + pos, out + pos + count, in[ i++ ] );
+            pos += count;
+          }
+        }
+        return (pos == rawSize);
+      }
+
+
+
+      // compressed block (method none means the data is stored raw)
+      struct CompressedBlock
+      {
+        std::uint32_t rawSize = 0;
+        StreamCompression::Type method = StreamCompression::none;
+        std::vector< char > data;
+      };
+
+      inline void compressBlock ( const std::vector< char > &raw, StreamCompression::Type codec, int level, CompressedBlock &block )
+      {
+        const std::size_t size = raw.size();
+        block.rawSize = size;
+        static_cast< void >( level ); // only used by zstd
+
+        std::vector< char > shuffled( size );
+        shuffleBytes( raw.data(), size, shuffled.data() );
+
+        block.method = codec;
+        switch( codec )
+        {
+        case StreamCompression::builtin:
+          runLengthEncode( shuffled.data(), size, block.data );
+          break;
+
+#if HAVE_ZSTD
+        case StreamCompression::zstd:
+          {
+            block.data.resize( ZSTD_compressBound( size ) );
+            const std::size_t result = ZSTD_compress( block.data.data(), block.data.size(), shuffled.data(), size, level );
+            if( ZSTD_isError( result ) )
+              DUNE_THROW( IOError, "zstd compression failed: " << ZSTD_getErrorName( result ) );
+            block.data.resize( result );
+          }
+          break;
+#endif // #if HAVE_ZSTD
+
+#if HAVE_LZ4
+        case StreamCompression::lz4:
+          {
+            block.data.resize( LZ4_compressBound( size ) );
+            const int result = LZ4_compress_default( shuffled.data(), block.data.data(), size, block.data.size() );
+            if( result <= 0 )
+              DUNE_THROW( IOError, "lz4 compression failed." );
+            block.data.resize( result );
+          }
+          break;
+#endif // #if HAVE_LZ4
+
+        default:
+          block.data.clear();
+          block.method = StreamCompression::none;
+        }
+
+        // store incompressible data raw
+        if( (block.method == StreamCompression::none) || (block.data.size() >= size) )
+        {
+          block.method = StreamCompression::none;
+          block.data = raw;
+        }
+      }
+
+      inline void decompressBlock ( const CompressedBlock &block, std::vector< char > &raw )
+      {
+        raw.resize( block.rawSize );
+        if( block.method == StreamCompression::none )
+        {
+          if( block.data.size() != block.rawSize )
+            DUNE_THROW( IOError, "Corrupt block in compressed stream." );
+          std::copy( block.data.begin(), block.data.end(), raw.begin() );
+          return;
+        }
+
+        std::vector< char > shuffled( block.rawSize );
+        switch( block.method )
+        {
+        case StreamCompression::builtin:
+          if( !runLengthDecode( block.data.data(), block.data.size(), shuffled.data(), block.rawSize ) )
+            DUNE_THROW( IOError, "Corrupt block in compressed stream." );
+          break;
+
+        case StreamCompression::zstd:
+#if HAVE_ZSTD
+          {
+            const std::size_t result = ZSTD_decompress( shuffled.data(), block.rawSize, block.data.data(), block.data.size() );
+            if( ZSTD_isError( result ) || (result != block.rawSize) )
+              DUNE_THROW( IOError, "Corrupt block in compressed stream." );
+          }
+          break;
+#else // #if HAVE_ZSTD
+          DUNE_THROW( NotImplemented, "Compressed stream requires zstd, which is not available." );
+#endif // #else // #if HAVE_ZSTD
+
+        case StreamCompression::lz4:
+#if HAVE_LZ4
+          {
+            const int result = LZ4_decompress_safe( block.data.data(), shuffled.data(), block.data.size(), block.rawSize );
+            if( result != int( block.rawSize ) )
+              DUNE_THROW( IOError, "Corrupt block in compressed stream." );
+          }
+          break;
+#else // #if HAVE_LZ4
+          DUNE_THROW( NotImplemented, "Compressed stream requires lz4, which is not available." );
+#endif // #else // #if HAVE_LZ4
+
+        default:
+          DUNE_THROW( IOError, "Unknown compression method in compressed stream." );
+        }
+        unshuffleBytes( shuffled.data(), block.rawSize, raw.data() );
+      }
+
+
+
+      // number of blocks processed in one parallel batch
+      inline int compressionBatchSize ()
+      {
+        return 2 * ThreadManager::maxThreads();
+      }
+
+    } // namespace Impl
+
+
+
+    // CompressingStreamBuffer
+    // -----------------------
+
+    /** \brief std::streambuf compressing all data into another std::ostream
+     *
+     *  Complete blocks are collected and compressed in parallel batches. The
+     *  method sync() (e.g., called by flush) writes all pending data, possibly
+     *  as a shorter block; close() additionally terminates the stream.
+     */
+    class CompressingStreamBuffer
+    : public std::streambuf
+    {
+      typedef Impl::CompressedStreamFormat Format;
+
+    public:
+      CompressingStreamBuffer ( std::ostream &sink, StreamCompression::Type codec, std::size_t blockSize, int level = 1 )
+        : sink_( sink ), codec_( codec ), level_( level ), blockSize_( blockSize ), block_( blockSize )
+      {
+        char header[ Format::headerSize ] = {};
+        std::copy( Format::magic(), Format::magic() + 8, header );
+        header[ 8 ] = Format::version;
+        header[ 9 ] = static_cast< char >( codec );
+        Format::put32( header + 12, blockSize );
+        sink_.write( header, Format::headerSize );
+        if( !sink_ )
+          DUNE_THROW( IOError, "Unable to write compressed stream header." );
+
+        setp( block_.data(), block_.data() + block_.size() );
+      }
+
+      CompressingStreamBuffer ( const CompressingStreamBuffer & ) = delete;
+      CompressingStreamBuffer &operator= ( const CompressingStreamBuffer & ) = delete;
+
+      //! write all pending data and the end marker
+      void close ()
+      {
+        if( closed_ )
+          return;
+        writePending( true );
+        char terminator[ Format::blockHeaderSize ] = {};
+        sink_.write( terminator, Format::blockHeaderSize );
+        sink_.flush();
+        closed_ = true;
+        if( !sink_ )
+          DUNE_THROW( IOError, "Unable to write compressed stream." );
+      }
+
+    protected:
+      int_type overflow ( int_type c ) override
+      {
+        if( closed_ )
+          return traits_type::eof();
+        finishBlock();
+        if( pending_.size() >= std::size_t( Impl::compressionBatchSize() ) )
+          writePending( false );
+        if( !traits_type::eq_int_type( c, traits_type::eof() ) )
+        {
+          *pptr() = traits_type::to_char_type( c );
+          pbump( 1 );
+        }
+        return traits_type::not_eof( c );
+      }
+
+      std::streamsize xsputn ( const char *s, std::streamsize n ) override
+      {
+        std::streamsize written = 0;
+        while( written < n )
+        {
+          if( pptr() == epptr() && traits_type::eq_int_type( overflow( traits_type::eof() ), traits_type::eof() ) )
+            break;
+          const std::streamsize count = std::min< std::streamsize >( n - written, epptr() - pptr() );
+          std::copy( s + written, s + written + count, pptr() );
+          pbump( count );
+          written += count;
+        }
+        return written;
+      }
+
+      int sync () override
+      {
+        if( closed_ )
+          return 0;
+        writePending( true );
+        sink_.flush();
+        return (sink_ ? 0 : -1);
+      }
+
+      // move the current block to the pending blocks
+      void finishBlock ()
+      {
+        const std::size_t size = pptr() - pbase();
+        if( size > 0 )
+        {
+          block_.resize( size );
+          pending_.emplace_back();
+          pending_.back().swap( block_ );
+          block_.resize( blockSize_ );
+        }
+        setp( block_.data(), block_.data() + block_.size() );
+      }
+
+      // compress the pending blocks in parallel and write them in order
+      void writePending ( bool all )
+      {
+        if( all )
+          finishBlock();
+
+        const int size = pending_.size();
+        std::vector< Impl::CompressedBlock > blocks( size );
+        parallelFor( 0, size, 1, [ this, &blocks ] ( std::size_t i ) {
+            Impl::compressBlock( pending_[ i ], codec_, level_, blocks[ i ] );
+          } );
+
+        for( const Impl::CompressedBlock &block : blocks )
+        {
+          char header[ Format::blockHeaderSize ] = {};
+          Format::put32( header, block.rawSize );
+          Format::put32( header + 4, block.data.size() );
+          header[ 8 ] = static_cast< char >( block.method );
+          sink_.write( header, Format::blockHeaderSize );
+          sink_.write( block.data.data(), block.data.size() );
+        }
+        if( !sink_ )
+          DUNE_THROW( IOError, "Unable to write compressed stream." );
+
+        pending_.clear();
+      }
+
+      std::ostream &sink_;
+      StreamCompression::Type codec_;
+      int level_;
+      std::size_t blockSize_;
+      std::vector< char > block_;
+      std::vector< std::vector< char > > pending_;
+      bool closed_ = false;
+    };
+
+
+
+    // DecompressingStreamBuffer
+    // -------------------------
+
+    /** \brief std::streambuf reading the data written by a
+     *         CompressingStreamBuffer
+     *
+     *  Batches of blocks are read sequentially and decompressed in parallel.
+     */
+    class DecompressingStreamBuffer
+    : public std::streambuf
+    {
+      typedef Impl::CompressedStreamFormat Format;
+
+    public:
+      explicit DecompressingStreamBuffer ( std::istream &source )
+        : source_( source )
+      {
+        char header[ Format::headerSize ];
+        source_.read( header, Format::headerSize );
+        if( !source_ || (std::memcmp( header, Format::magic(), 8 ) != 0) )
+          DUNE_THROW( IOError, "Invalid header of compressed stream." );
+        if( header[ 8 ] != Format::version )
+          DUNE_THROW( IOError, "Unsupported version of compressed stream." );
+        setg( nullptr, nullptr, nullptr );
+      }
+
+      DecompressingStreamBuffer ( const DecompressingStreamBuffer & ) = delete;
+      DecompressingStreamBuffer &operator= ( const DecompressingStreamBuffer & ) = delete;
+
+    protected:
+      int_type underflow () override
+      {
+        while( gptr() == egptr() )
+        {
+          if( current_ < blocks_.size() )
+          {
+            std::vector< char > &block = blocks_[ current_++ ];
+            setg( block.data(), block.data(), block.data() + block.size() );
+          }
+          else if( !readBatch() )
+            return traits_type::eof();
+        }
+        return traits_type::to_int_type( *gptr() );
+      }
+
+      // read the next batch of blocks and decompress them in parallel
+      bool readBatch ()
+      {
+        if( finished_ )
+          return false;
+
+        std::vector< Impl::CompressedBlock > compressed;
+        const std::size_t batchSize = Impl::compressionBatchSize();
+        while( compressed.size() < batchSize )
+        {
+          char header[ Format::blockHeaderSize ];
+          source_.read( header, Format::blockHeaderSize );
+          if( source_.gcount() == 0 )
+          {
+            // tolerate missing end marker
+            finished_ = true;
+            break;
+          }
+          if( source_.gcount() != std::streamsize( Format::blockHeaderSize ) )
+            DUNE_THROW( IOError, "Truncated compressed stream." );
+
+          Impl::CompressedBlock block;
+          block.rawSize = Format::get32( header );
+          block.method = static_cast< StreamCompression::Type >( header[ 8 ] );
+          if( block.rawSize == 0 )
+          {
+            finished_ = true;
+            break;
+          }
+          block.data.resize( Format::get32( header + 4 ) );
+          source_.read( block.data.data(), block.data.size() );
+          if( source_.gcount() != std::streamsize( block.data.size() ) )
+            DUNE_THROW( IOError, "Truncated compressed stream." );
+          compressed.push_back( std::move( block ) );
+        }
+
+        const int size = compressed.size();
+        blocks_.resize( size );
+        parallelFor( 0, size, 1, [ this, &compressed ] ( std::size_t i ) {
+            Impl::decompressBlock( compressed[ i ], blocks_[ i ] );
+          } );
+        current_ = 0;
+        return (size > 0);
+      }
+
+      std::istream &source_;
+      std::vector< std::vector< char > > blocks_;
+      std::size_t current_ = 0;
+      bool finished_ = false;
+    };
+
+
+
+    // CompressingOStream
+    // ------------------
+
+    //! std::ostream compressing all data into another std::ostream
+    class CompressingOStream
+    : public std::ostream
+    {
+    public:
+      CompressingOStream ( std::ostream &sink, const StreamCompressionParameters &parameter )
+        : std::ostream( nullptr ),
+          buffer_( sink, parameter.compression(), parameter.blockSize(), parameter.level() )
+      {
+        rdbuf( &buffer_ );
+      }
+
+      ~CompressingOStream ()
+      {
+        try
+        {
+          buffer_.close();
+        }
+        catch( const Dune::Exception &e )
+        {
+          std::cerr << "ERROR: CompressingOStream: " << e << std::endl;
+        }
+        catch( const std::exception &e )
+        {
+          std::cerr << "ERROR: CompressingOStream: " << e.what() << std::endl;
+        }
+        catch( ... )
+        {
+          std::cerr << "ERROR: CompressingOStream: unknown exception while closing the stream." << std::endl;
+        }
+      }
+
+      //! write all pending data and the end marker
+      void close () { buffer_.close(); }
+
+    private:
+      CompressingStreamBuffer buffer_;
+    };
+
+
+
+    // DecompressingIStream
+    // --------------------
+
+    //! std::istream reading the data written by a CompressingOStream
+    class DecompressingIStream
+    : public std::istream
+    {
+    public:
+      explicit DecompressingIStream ( std::istream &source )
+        : std::istream( nullptr ), buffer_( source )
+      {
+        rdbuf( &buffer_ );
+      }
+
+    private:
+      DecompressingStreamBuffer buffer_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_COMPRESSEDSTREAMS_HH
@@ -0,0 +1,155 @@
+#ifndef DUNE_FEM_MAPPEDSTREAMS_HH
+#define DUNE_FEM_MAPPEDSTREAMS_HH
+
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // #if HAVE_SYS_MMAN_H
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // MappedFileStreamBuffer
+    // ----------------------
+
+    /** \brief read-only std::streambuf on a memory mapped file
+     *
+     *  The whole file is the get area, so reading data (e.g., by
+     *  std::istream::read) is a plain copy from the mapped pages and the
+     *  operating system can share the pages between processes on the same
+     *  node reading the same file.
+     *
+     *  If mmap is not available, the file is read into memory.
+     */
+    class MappedFileStreamBuffer
+    : public std::streambuf
+    {
+    public:
+      explicit MappedFileStreamBuffer ( const std::string &filename )
+      {
+#if HAVE_SYS_MMAN_H
+        const int fd = ::open( filename.c_str(), O_RDONLY );
+        if( fd < 0 )
+          DUNE_THROW( IOError, "Unable to open file: " << filename );
+
+        struct stat info;
+        if( ::fstat( fd, &info ) != 0 )
+        {
+          ::close( fd );
+          DUNE_THROW( IOError, "Unable to stat file: " << filename );
+        }
+
+        size_ = info.st_size;
+        if( size_ > 0 )
+        {
+          void *data = ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+          if( data == MAP_FAILED )
+          {
+            ::close( fd );
+            DUNE_THROW( IOError, "Unable to map file: " << filename );
+          }
+          data_ = static_cast< char * >( data );
+          ::madvise( data, size_, MADV_SEQUENTIAL );
+        }
+        ::close( fd );
+#else // #if HAVE_SYS_MMAN_H
+        std::ifstream file( filename.c_str(), std::ios::binary );
+        if( !file )
+          DUNE_THROW( IOError, "Unable to open file: " << filename );
+        buffer_.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+        size_ = buffer_.size();
+        data_ = buffer_.data();
+#endif // #else // #if HAVE_SYS_MMAN_H
+
+        setg( data_, data_, data_ + size_ );
+      }
+
+      MappedFileStreamBuffer ( const MappedFileStreamBuffer & ) = delete;
+      MappedFileStreamBuffer &operator= ( const MappedFileStreamBuffer & ) = delete;
+
+      ~MappedFileStreamBuffer ()
+      {
+#if HAVE_SYS_MMAN_H
+        if( data_ )
+          ::munmap( data_, size_ );
+#endif // #if HAVE_SYS_MMAN_H
+      }
+
+      //! size of the file
+      std::size_t size () const { return size_; }
+
+    protected:
+      pos_type seekoff ( off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which ) override
+      {
+        if( !(which & std::ios_base::in) )
+          return pos_type( off_type( -1 ) );
+
+        off_type position = off;
+        if( dir == std::ios_base::cur )
+          position += gptr() - eback();
+        else if( dir == std::ios_base::end )
+          position += size_;
+
+        if( (position < 0) || (position > off_type( size_ )) )
+          return pos_type( off_type( -1 ) );
+        setg( data_, data_ + position, data_ + size_ );
+        return pos_type( position );
+      }
+
+      pos_type seekpos ( pos_type position, std::ios_base::openmode which ) override
+      {
+        return seekoff( off_type( position ), std::ios_base::beg, which );
+      }
+
+      std::streamsize showmanyc () override
+      {
+        return (gptr() < egptr() ? egptr() - gptr() : -1);
+      }
+
+    private:
+      char *data_ = nullptr;
+      std::size_t size_ = 0;
+#if !HAVE_SYS_MMAN_H
+      std::vector< char > buffer_;
+#endif // #if !HAVE_SYS_MMAN_H
+    };
+
+
+
+    // MappedFileIStream
+    // -----------------
+
+    //! std::istream reading from a memory mapped file
+    class MappedFileIStream
+    : public std::istream
+    {
+    public:
+      explicit MappedFileIStream ( const std::string &filename )
+        : std::istream( nullptr ), buffer_( filename )
+      {
+        rdbuf( &buffer_ );
+      }
+
+    private:
+      MappedFileStreamBuffer buffer_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_MAPPEDSTREAMS_HH
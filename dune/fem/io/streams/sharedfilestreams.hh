@@ -0,0 +1,448 @@
+#ifndef DUNE_FEM_SHAREDFILESTREAMS_HH
+#define DUNE_FEM_SHAREDFILESTREAMS_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/streams/standardstreams.hh>
+#include <dune/fem/misc/mpimanager.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // SharedFile
+    // ----------
+
+    /** \class SharedFile
+     *  \ingroup InOutStreams
+     *  \brief single file holding one chunk of data per process
+     *
+     *  The file consists of a header, the chunks in the order of the ranks
+     *  and an index storing offset and size of each chunk:
+     *  \code
+     *  header: magic (8 bytes), version (1 byte), reserved (7 bytes),
+     *          number of chunks (8 bytes), offset of the index (8 bytes)
+     *  chunks
+     *  index:  offset (8 bytes) and size (8 bytes) of each chunk
+     *  \endcode
+     *  All integers are stored little endian.
+     *
+     *  The file is written collectively, either with MPI-IO or with
+     *  independent POSIX writes of each process at its offset
+     *  (fem.io.sharedfile.mpiio, default true). Any chunk can be read by any
+     *  process, so the file can also be read with a different number of
+     *  processes.
+     */
+    class SharedFile
+    {
+    public:
+      typedef MPIHelper::MPICommunicator MPICommunicatorType;
+
+      static const std::size_t headerSize = 32;
+      static const char version = 1;
+
+      static const char *magic () { return "DFEMSHRD"; }
+
+      //! offsets and sizes of the chunks
+      struct Index
+      {
+        std::vector< std::uint64_t > offset, size;
+
+        int chunks () const { return offset.size(); }
+      };
+
+      /** \brief write the data of this process into a shared file (collective)
+       *
+       *  \param[in]  filename  name of the file (must be the same on all ranks)
+       *  \param[in]  data      data of this process
+       *  \param[in]  mpiComm   MPI communicator
+       *  \param[in]  mpiio     use MPI-IO instead of POSIX writes
+       */
+      static void write ( const std::string &filename, const std::string &data,
+                          MPICommunicatorType mpiComm = MPIHelper::getCommunicator(),
+                          bool mpiio = true )
+      {
+#if HAVE_MPI
+        int size = 1;
+        MPI_Comm_size( mpiComm, &size );
+        if( size > 1 )
+        {
+          writeParallel( filename, data, mpiComm, mpiio );
+          return;
+        }
+#endif // #if HAVE_MPI
+
+        std::ofstream file( filename.c_str(), std::ios::binary );
+        if( !file )
+          DUNE_THROW( IOError, "Unable to open file: " << filename );
+        const std::vector< std::uint64_t > sizes( 1, data.size() );
+        const std::string header = createHeader( sizes ), index = createIndex( sizes );
+        file.write( header.data(), header.size() );
+        file.write( data.data(), data.size() );
+        file.write( index.data(), index.size() );
+        if( !file )
+          DUNE_THROW( IOError, "Unable to write file: " << filename );
+      }
+
+      //! read the index of a shared file
+      static Index readIndex ( std::istream &in )
+      {
+        char header[ headerSize ];
+        in.seekg( 0 );
+        in.read( header, headerSize );
+        if( !in || (std::memcmp( header, magic(), 8 ) != 0) )
+          DUNE_THROW( IOError, "Invalid header of shared file." );
+        if( header[ 8 ] != version )
+          DUNE_THROW( IOError, "Unsupported version of shared file." );
+
+        const std::uint64_t chunks = get64( header + 16 );
+        std::vector< char > index( 16*chunks );
+        in.seekg( get64( header + 24 ) );
+        in.read( index.data(), index.size() );
+        if( !in )
+          DUNE_THROW( IOError, "Truncated index of shared file." );
+
+        Index result;
+        for( std::uint64_t i = 0; i < chunks; ++i )
+        {
+          result.offset.push_back( get64( index.data() + 16*i ) );
+          result.size.push_back( get64( index.data() + 16*i + 8 ) );
+        }
+        return result;
+      }
+
+      //! read the index of a shared file
+      static Index readIndex ( const std::string &filename )
+      {
+        std::ifstream file( filename.c_str(), std::ios::binary );
+        if( !file )
+          DUNE_THROW( IOError, "Unable to open file: " << filename );
+        return readIndex( file );
+      }
+
+      //! read one chunk of a shared file (independent of the number of processes)
+      static std::string read ( std::istream &in, const Index &index, int chunk )
+      {
+        if( (chunk < 0) || (chunk >= index.chunks()) )
+          DUNE_THROW( IOError, "Shared file does not contain chunk " << chunk << " (written by " << index.chunks() << " processes)." );
+
+        std::string data( index.size[ chunk ], '\0' );
+        in.seekg( index.offset[ chunk ] );
+        in.read( &data[ 0 ], data.size() );
+        if( !in )
+          DUNE_THROW( IOError, "Truncated chunk " << chunk << " in shared file." );
+        return data;
+      }
+
+      //! read one chunk of a shared file (independent of the number of processes)
+      static std::string read ( const std::string &filename, int chunk )
+      {
+        std::ifstream file( filename.c_str(), std::ios::binary );
+        if( !file )
+          DUNE_THROW( IOError, "Unable to open file: " << filename );
+        return read( file, readIndex( file ), chunk );
+      }
+
+    protected:
+      static void put64 ( char *out, std::uint64_t value )
+      {
+        for( int i = 0; i < 8; ++i )
+          out[ i ] = static_cast< char >( (value >> (8*i)) & 0xff );
+      }
+
+      static std::uint64_t get64 ( const char *in )
+      {
+        std::uint64_t value = 0;
+        for( int i = 0; i < 8; ++i )
+          value |= std::uint64_t( static_cast< unsigned char >( in[ i ] ) ) << (8*i);
+        return value;
+      }
+
+      static std::uint64_t totalSize ( const std::vector< std::uint64_t > &sizes )
+      {
+        std::uint64_t total = 0;
+        for( std::uint64_t size : sizes )
+          total += size;
+        return total;
+      }
+
+      static std::string createHeader ( const std::vector< std::uint64_t > &sizes )
+      {
+        std::string header( headerSize, '\0' );
+        std::copy( magic(), magic() + 8, header.begin() );
+        header[ 8 ] = version;
+        put64( &header[ 16 ], sizes.size() );
+        put64( &header[ 24 ], headerSize + totalSize( sizes ) );
+        return header;
+      }
+
+      static std::string createIndex ( const std::vector< std::uint64_t > &sizes )
+      {
+        std::string index( 16*sizes.size(), '\0' );
+        std::uint64_t offset = headerSize;
+        for( std::size_t i = 0; i < sizes.size(); ++i )
+        {
+          put64( &index[ 16*i ], offset );
+          put64( &index[ 16*i + 8 ], sizes[ i ] );
+          offset += sizes[ i ];
+        }
+        return index;
+      }
+
+#if HAVE_MPI
+      static void writeParallel ( const std::string &filename, const std::string &data,
+                                  MPICommunicatorType mpiComm, bool mpiio )
+      {
+        int rank = 0, size = 1;
+        MPI_Comm_rank( mpiComm, &rank );
+        MPI_Comm_size( mpiComm, &size );
+
+        // offset of the chunk of this process
+        std::uint64_t mySize = data.size(), offset = 0;
+        MPI_Exscan( &mySize, &offset, 1, MPI_UINT64_T, MPI_SUM, mpiComm );
+        if( rank == 0 )
+          offset = 0;
+        offset += headerSize;
+
+        // header and index are written by rank 0
+        std::vector< std::uint64_t > sizes( rank == 0 ? size : 0 );
+        MPI_Gather( &mySize, 1, MPI_UINT64_T, sizes.data(), 1, MPI_UINT64_T, 0, mpiComm );
+        std::string header, index;
+        if( rank == 0 )
+        {
+          header = createHeader( sizes );
+          index = createIndex( sizes );
+        }
+
+        int failed = 0;
+        if( mpiio )
+        {
+          MPI_File file;
+          if( MPI_File_open( mpiComm, const_cast< char * >( filename.c_str() ), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file ) != MPI_SUCCESS )
+            DUNE_THROW( IOError, "Unable to open file: " << filename );
+          MPI_File_set_size( file, 0 );
+
+          // write collectively in pieces, since MPI counts are int
+          const std::uint64_t maxPiece = std::uint64_t( 1 ) << 30;
+          std::uint64_t pieces = (mySize + maxPiece - 1) / maxPiece, maxPieces = 0;
+          MPI_Allreduce( &pieces, &maxPieces, 1, MPI_UINT64_T, MPI_MAX, mpiComm );
+          for( std::uint64_t piece = 0; piece < maxPieces; ++piece )
+          {
+            const std::uint64_t begin = std::min( piece*maxPiece, mySize );
+            const int count = std::min( maxPiece, mySize - begin );
+            if( MPI_File_write_at_all( file, offset + begin, const_cast< char * >( data.data() + begin ), count, MPI_CHAR, MPI_STATUS_IGNORE ) != MPI_SUCCESS )
+              failed = 1;
+          }
+
+          if( rank == 0 )
+          {
+            if( MPI_File_write_at( file, 0, const_cast< char * >( header.data() ), header.size(), MPI_CHAR, MPI_STATUS_IGNORE ) != MPI_SUCCESS )
+              failed = 1;
+            if( MPI_File_write_at( file, headerSize + totalSize( sizes ), const_cast< char * >( index.data() ), index.size(), MPI_CHAR, MPI_STATUS_IGNORE ) != MPI_SUCCESS )
+              failed = 1;
+          }
+          MPI_File_close( &file );
+        }
+        else
+        {
+          // rank 0 creates the file, all other ranks write at their offsets
+          if( rank == 0 )
+          {
+            std::ofstream file( filename.c_str(), std::ios::binary );
+            file.write( header.data(), header.size() );
+            file.write( data.data(), data.size() );
+            file.seekp( headerSize + totalSize( sizes ) );
+            file.write( index.data(), index.size() );
+            failed = !file;
+          }
+          MPI_Barrier( mpiComm );
+          if( rank != 0 )
+          {
+            std::fstream file( filename.c_str(), std::ios::binary | std::ios::in | std::ios::out );
+            file.seekp( offset );
+            file.write( data.data(), data.size() );
+            failed = !file;
+          }
+        }
+
+        int anyFailed = 0;
+        MPI_Allreduce( &failed, &anyFailed, 1, MPI_INT, MPI_MAX, mpiComm );
+        if( anyFailed )
+          DUNE_THROW( IOError, "Unable to write shared file: " << filename );
+      }
+#endif // #if HAVE_MPI
+    };
+
+
+
+    /** \class SharedFileOutStream
+     *  \ingroup InOutStreams
+     *  \brief output stream writing the data of all processes into a single
+     *         file (see SharedFile)
+     *
+     *  The data is collected in memory and written collectively by the
+     *  destructor.
+     *
+     *  \note The filename must be the same on all ranks.
+     */
+    class SharedFileOutStream
+    : public StandardOutStream
+    {
+      typedef SharedFileOutStream ThisType;
+      typedef StandardOutStream   BaseType;
+
+      typedef MPIHelper::MPICommunicator MPICommunicatorType;
+
+      // don't allow copying because of interal pointers
+      SharedFileOutStream ( const SharedFileOutStream & );
+
+    public:
+      /** \brief constructor
+       *
+       *  \param[in]  filename   name of a global file to write to
+       *  \param[in]  mpiComm    MPI communicator (defaults to MPIHelper::getCommunicator())
+       *  \param[in]  parameter  parameters (reads fem.io.sharedfile.mpiio)
+       */
+      explicit SharedFileOutStream ( const std::string &filename,
+                                     MPICommunicatorType mpiComm = MPIHelper::getCommunicator(),
+                                     ParameterReader parameter = Parameter::container() )
+        : BaseType( dataStream() ),
+          filename_( filename ),
+          mpiComm_( mpiComm ),
+          mpiio_( parameter.getValue< bool >( "fem.io.sharedfile.mpiio", true ) )
+      {}
+
+      /** \brief destructor writing the data collectively */
+      ~SharedFileOutStream ()
+      {
+        try
+        {
+          SharedFile::write( filename_, data_->str(), mpiComm_, mpiio_ );
+        }
+        catch( const Dune::Exception &e )
+        {
+          std::cerr << "ERROR: SharedFileOutStream: " << e << std::endl;
+        }
+        delete data_; data_ = 0;
+      }
+
+    protected:
+      std::ostream &dataStream ()
+      {
+        data_ = new std::stringstream();
+        return *data_;
+      }
+
+      std::stringstream *data_;
+
+      const std::string filename_;
+      MPICommunicatorType mpiComm_;
+      const bool mpiio_;
+    };
+
+
+
+    /** \class SharedFileInStream
+     *  \ingroup InOutStreams
+     *  \brief input stream reading the data of one process from a file written
+     *         by SharedFileOutStream
+     */
+    class SharedFileInStream
+    : public StandardInStream
+    {
+      typedef SharedFileInStream ThisType;
+      typedef StandardInStream   BaseType;
+
+      // don't allow copying because of interal pointers
+      SharedFileInStream ( const SharedFileInStream & );
+
+    public:
+      /** \brief constructor
+       *
+       *  \param[in]  filename  name of a file to read from
+       *  \param[in]  rank      rank of the process data is read for
+       */
+      explicit SharedFileInStream ( const std::string &filename, int rank = MPIManager::rank() )
+        : BaseType( readFile( filename, rank ) )
+      {}
+
+      /** \brief destructor deleting interal data buffer */
+      ~SharedFileInStream ()
+      {
+        delete data_; data_ = 0;
+      }
+
+    protected:
+      std::istream &readFile ( const std::string &filename, int rank )
+      {
+        data_ = new std::stringstream( SharedFile::read( filename, rank ) );
+        return *data_;
+      }
+
+      std::stringstream *data_;
+    };
+
+
+
+    template<>
+    struct StreamFactory< SharedFileInStream >
+    {
+      typedef MPIHelper::MPICommunicator MPICommunicatorType;
+
+      static SharedFileInStream *create ( const std::string &filename,
+                                          const int rank = MPIManager::rank(),
+                                          const MPICommunicatorType &mpiComm = MPIHelper::getCommunicator() )
+      {
+        return new SharedFileInStream( filename, rank );
+      }
+    };
+
+    template<>
+    struct StreamFactory< SharedFileOutStream >
+    {
+      typedef MPIHelper::MPICommunicator MPICommunicatorType;
+
+      static SharedFileOutStream *create ( const std::string &filename,
+                                           const int rank = MPIManager::rank(),
+                                           const MPICommunicatorType &mpiComm = MPIHelper::getCommunicator() )
+      {
+        return new SharedFileOutStream( filename, mpiComm );
+      }
+    };
+
+
+
+    /** \brief stream traits for the PersistenceManager writing a single
+     *         shared file instead of one file per process
+     *
+     *  To be used by defining
+     *  \code
+     *  #define FEM_PERSISTENCEMANAGERSTREAMTRAITS SharedFileStreamTraits
+     *  \endcode
+     *  before including dune/fem/io/file/persistencemanager.hh.
+     */
+    struct SharedFileStreamTraits
+    {
+      typedef SharedFileOutStream BackupStreamType;
+      typedef SharedFileInStream  RestoreStreamType;
+      static const bool singleBackupRestoreFile = true;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_SHAREDFILESTREAMS_HH
@@ -141,6 +141,27 @@ namespace Dune
         writePrimitive( value );
       }
 
+      /** \brief write an array of doubles in one go
+       *
+       *  The result is the same as writing the values one by one.
+       *
+       *  \param[in]  values  pointer to the first value
+       *  \param[in]  n       number of values
+       */
+      void writeDoubles ( const double *values, std::size_t n )
+      {
+        if( ByteOrder :: order == ByteOrder :: defaultEndian )
+          stream_.write( reinterpret_cast< const char * >( values ), n*sizeof( double ) );
+        else
+        {
+          for( std::size_t i = 0; i < n; ++i )
+            writePrimitive( values[ i ] );
+        }
+
+        if( !valid () )
+          writeError();
+      }
+
     protected:
       bool valid () const
       {
@@ -275,6 +296,30 @@ namespace Dune
         readPrimitive( value );
       }
 
+      /** \brief read an array of doubles in one go
+       *
+       *  The data is copied directly from the stream buffer (e.g., from the
+       *  mapped file, see BinaryFileInStream) into the array.
+       *
+       *  \param[out]  values  pointer to the first value
+       *  \param[in]   n       number of values
+       */
+      void readDoubles ( double *values, std::size_t n )
+      {
+        if( ByteOrder :: order == ByteOrder :: defaultEndian )
+        {
+          const std::streamsize size = n*sizeof( double );
+          stream_.read( reinterpret_cast< char * >( values ), size );
+          if( stream_.gcount() != size )
+            readError();
+        }
+        else
+        {
+          for( std::size_t i = 0; i < n; ++i )
+            readPrimitive( values[ i ] );
+        }
+      }
+
     protected:
       bool valid () const
       {
@@ -5,6 +5,7 @@
 #include <array>
 
 #include <dune/common/fvector.hh>
+#include <dune/common/typeutilities.hh>
 
 #include "streams.hh"
 
@@ -308,6 +309,61 @@ namespace Dune
       return in;
     }
 
+
+
+    namespace Impl
+    {
+
+      template< class Stream >
+      inline auto writeDoubles ( Stream &out, const double *values, std::size_t n, PriorityTag< 1 > )
+        -> decltype( out.writeDoubles( values, n ) )
+      {
+        out.writeDoubles( values, n );
+      }
+
+      template< class Stream >
+      inline void writeDoubles ( Stream &out, const double *values, std::size_t n, PriorityTag< 0 > )
+      {
+        for( std::size_t i = 0; i < n; ++i )
+          out.writeDouble( values[ i ] );
+      }
+
+      template< class Stream >
+      inline auto readDoubles ( Stream &in, double *values, std::size_t n, PriorityTag< 1 > )
+        -> decltype( in.readDoubles( values, n ) )
+      {
+        in.readDoubles( values, n );
+      }
+
+      template< class Stream >
+      inline void readDoubles ( Stream &in, double *values, std::size_t n, PriorityTag< 0 > )
+      {
+        for( std::size_t i = 0; i < n; ++i )
+          in.readDouble( values[ i ] );
+      }
+
+    } // namespace Impl
+
+    /** \brief write an array of doubles, in one go if supported by the stream
+     *
+     *  \note The result is the same as writing the values one by one.
+     */
+    template< class Traits >
+    inline void writeDoubles ( OutStreamInterface< Traits > &out, const double *values, std::size_t n )
+    {
+      Impl::writeDoubles( static_cast< typename Traits::OutStreamType & >( out ), values, n, PriorityTag< 1 >() );
+    }
+
+    /** \brief read an array of doubles, in one go if supported by the stream
+     *
+     *  \note The result is the same as reading the values one by one.
+     */
+    template< class Traits >
+    inline void readDoubles ( InStreamInterface< Traits > &in, double *values, std::size_t n )
+    {
+      Impl::readDoubles( static_cast< typename Traits::InStreamType & >( in ), values, n, PriorityTag< 1 >() );
+    }
+
   } // namespace Fem
 
 } // namespace Dune
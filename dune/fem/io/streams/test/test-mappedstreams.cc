@@ -0,0 +1,219 @@
+#include <config.h>
+
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/io/streams/binarystreams.hh>
+#include <dune/fem/io/streams/mappedstreams.hh>
+#include <dune/fem/misc/mpimanager.hh>
+
+using namespace Dune;
+using namespace Fem;
+
+// more values than fit into a compressed block or a single read of the stream buffer
+const std::size_t numValues = 100000;
+
+std::vector< double > values ()
+{
+  std::vector< double > v( numValues );
+  for( std::size_t i = 0; i < numValues; ++i )
+    v[ i ] = std::sin( 0.001*i ) + 1e-3*i;
+  return v;
+}
+
+// an int, the array, a string and a trailing double
+void write ( BinaryFileOutStream &out, const std::vector< double > &v, bool inOneGo )
+{
+  out << int( v.size() );
+  if( inOneGo )
+    writeDoubles( out, v.data(), v.size() );
+  else
+  {
+    for( double value : v )
+      out << value;
+  }
+  out << std::string( "end of array" ) << 42.0;
+  out.flush();
+}
+
+int read ( BinaryFileInStream &in, const std::vector< double > &v, bool inOneGo, const std::string &name )
+{
+  int size;
+  in >> size;
+  if( size != int( v.size() ) )
+  {
+    std::cerr << "Error: " << name << ": read size " << size << " instead of " << v.size() << "." << std::endl;
+    return 1;
+  }
+
+  std::vector< double > w( size );
+  if( inOneGo )
+    readDoubles( in, w.data(), w.size() );
+  else
+  {
+    for( double &value : w )
+      in >> value;
+  }
+
+  std::string text;
+  double trailer;
+  in >> text >> trailer;
+
+  int errors = 0;
+  if( w != v )
+  {
+    std::cerr << "Error: " << name << ": array not read back exactly." << std::endl;
+    ++errors;
+  }
+  if( (text != "end of array") || (trailer != 42.0) )
+  {
+    std::cerr << "Error: " << name << ": wrong data after the array." << std::endl;
+    ++errors;
+  }
+
+  // no more data
+  try
+  {
+    in.readDouble();
+    std::cerr << "Error: " << name << ": reading beyond the end of the file succeeded." << std::endl;
+    ++errors;
+  }
+  catch( const StreamError & )
+  {}
+  return errors;
+}
+
+std::vector< char > fileContents ( const std::string &filename )
+{
+  std::ifstream file( filename.c_str(), std::ios::binary );
+  return std::vector< char >( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+}
+
+// seeking within the mapped file
+int checkSeek ( const std::string &filename )
+{
+  const std::vector< char > contents = fileContents( filename );
+  MappedFileIStream in( filename );
+
+  int errors = 0;
+  in.seekg( 0, std::ios::end );
+  if( in.tellg() != std::streampos( contents.size() ) )
+  {
+    std::cerr << "Error: end of mapped file at " << in.tellg() << " instead of " << contents.size() << "." << std::endl;
+    ++errors;
+  }
+
+  const std::size_t position = contents.size() / 3;
+  in.seekg( position );
+  char c = 0;
+  in.get( c );
+  if( !in || (c != contents[ position ]) || (in.tellg() != std::streampos( position+1 )) )
+  {
+    std::cerr << "Error: wrong data after seeking in the mapped file." << std::endl;
+    ++errors;
+  }
+
+  in.seekg( contents.size() + 1 );
+  if( in )
+  {
+    std::cerr << "Error: seeking beyond the end of the mapped file succeeded." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  MPIManager::initialize( argc, argv );
+
+  const std::vector< double > v = values();
+  const std::string prefix = Parameter::commonOutputPath() + "/test-mapped." + std::to_string( MPIManager::rank() ) + ".";
+
+  ParameterTree mapped, unmapped;
+  mapped[ "fem.io.mmap" ] = "true";
+  unmapped[ "fem.io.mmap" ] = "false";
+
+  ParameterTree compressed;
+  compressed[ "fem.io.compression" ] = "builtin";
+  compressed[ "fem.io.compressionblocksize" ] = "4096";
+
+  int errors = 0;
+
+  // writing in one go yields the same file as writing value by value
+  {
+    BinaryFileOutStream out( prefix + "single" );
+    write( out, v, false );
+  }
+  {
+    BinaryFileOutStream out( prefix + "array" );
+    write( out, v, true );
+  }
+  if( fileContents( prefix + "single" ) != fileContents( prefix + "array" ) )
+  {
+    std::cerr << "Error: writeDoubles does not write the same data as writeDouble." << std::endl;
+    ++errors;
+  }
+
+  // all combinations of reading mapped / unmapped, in one go / value by value
+  {
+    {
+      BinaryFileOutStream out( prefix + "compressed", StreamCompressionParameters( parameterReader( compressed ) ) );
+      write( out, v, true );
+    }
+
+    for( const std::string file : { "array", "compressed" } )
+    {
+      for( bool inOneGo : { true, false } )
+      {
+        const std::string name = file + (inOneGo ? ", readDoubles" : ", readDouble");
+        BinaryFileInStream mappedIn( prefix + file, parameterReader( mapped ) );
+        errors += read( mappedIn, v, inOneGo, name + ", mapped" );
+        BinaryFileInStream unmappedIn( prefix + file, parameterReader( unmapped ) );
+        errors += read( unmappedIn, v, inOneGo, name + ", not mapped" );
+      }
+    }
+  }
+
+  errors += checkSeek( prefix + "array" );
+
+  // empty files can be mapped
+  {
+    std::ofstream( prefix + "empty" );
+    MappedFileIStream in( prefix + "empty" );
+    if( in.get() != std::char_traits< char >::eof() )
+    {
+      std::cerr << "Error: data read from an empty mapped file." << std::endl;
+      ++errors;
+    }
+  }
+
+  // missing files are reported
+  try
+  {
+    MappedFileIStream in( prefix + "missing" );
+    std::cerr << "Error: mapping a missing file succeeded." << std::endl;
+    ++errors;
+  }
+  catch( const IOError & )
+  {}
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
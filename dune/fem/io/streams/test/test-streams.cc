@@ -7,6 +7,7 @@
 #include <dune/fem/io/streams/asciistreams.hh>
 #include <dune/fem/io/streams/binarystreams.hh>
 #include <dune/fem/io/streams/xdrstreams.hh>
+#include <dune/fem/io/streams/sharedfilestreams.hh>
 #include <dune/fem/io/streams/sionlibstreams.hh>
 
 using namespace Dune;
@@ -156,6 +157,30 @@ int main ( int argc, char** argv )
         failed = true ;
     }
 
+    {
+      std::string filename( filestr.str() + "compressed" );
+      std :: cerr << "Checking compressed Binary streams..." << std :: endl;
+      if( writeStreams )
+      {
+        Parameter :: append( "test.io.compression", "builtin" );
+        Parameter :: append( "test.io.compressionblocksize", "64" );
+        Fem :: BinaryFileOutStream bout( filename.c_str(), StreamCompressionParameters( "test.io." ) );
+        write( bout, data );
+        bout.flush();
+        for( int i = 0; i < 1000; ++i )
+          bout << data.my_double;
+      }
+      Fem :: BinaryFileInStream bin( filename.c_str() );
+      if( !read( bin, data ) )
+        failed = true ;
+      for( int i = 0; i < 1000; ++i )
+      {
+        double value;
+        bin >> value;
+        failed |= (value != data.my_double);
+      }
+    }
+
     {
       std::string filename( filestr.str() + "xdr" );
       std :: cerr << "Checking XDR streams..." << std :: endl;
@@ -170,6 +195,26 @@ int main ( int argc, char** argv )
         failed = true ;
     }
 
+    {
+      std :: cerr << "Checking shared file streams..." << std :: endl;
+      std::stringstream file;
+      file << Parameter::commonOutputPath() << "/test.shared." << MPIManager :: size() ;
+      std::string filename( file.str() );
+      if( writeStreams )
+      {
+        Fem :: SharedFileOutStream sharedout( filename.c_str() );
+        write( sharedout, data );
+        sharedout.flush();
+      }
+      // every chunk can be read by any rank
+      for( int rank = 0; rank < SharedFile :: readIndex( filename ).chunks(); ++rank )
+      {
+        Fem :: SharedFileInStream sharedin( filename.c_str(), rank );
+        if( ! read( sharedin, data ) )
+          failed = true ;
+      }
+    }
+
 #if HAVE_SIONLIB
     {
       std :: cerr << "Checking SIONlib streams..." << std :: endl;
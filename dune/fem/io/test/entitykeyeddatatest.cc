@@ -0,0 +1,147 @@
+#include <config.h>
+
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <dune/common/dynvector.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/file/entitykeyeddata.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::YaspGrid< 2 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 2 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+typedef Dune::MPIHelper::MPICommunicator MPICommunicatorType;
+
+
+// create a 16x16 unit square distributed over the given communicator
+std::unique_ptr< GridType > createGrid ( MPICommunicatorType comm )
+{
+  const Dune::FieldVector< double, 2 > upper( 1.0 );
+  const std::array< int, 2 > cells = {{ 16, 16 }};
+  return std::unique_ptr< GridType >( new GridType( upper, cells, std::bitset< 2 >(), 1, GridType::CollectiveCommunication( comm ) ) );
+}
+
+// dofs only depending on the position of the element, i.e., not on the partitioning
+template< class Entity >
+double localDof ( const Entity &entity, int i )
+{
+  const auto center = entity.geometry().center();
+  return 1000.0*center[ 0 ] + center[ 1 ] + 0.125*i;
+}
+
+void fill ( DiscreteFunctionType &df )
+{
+  Dune::DynamicVector< double > localDofs;
+  for( const auto &entity : elements( df.gridPart() ) )
+  {
+    localDofs.resize( df.space().basisFunctionSet( entity ).size() );
+    for( std::size_t i = 0; i < localDofs.size(); ++i )
+      localDofs[ i ] = localDof( entity, i );
+    df.setLocalDofs( entity, localDofs );
+  }
+}
+
+int check ( const DiscreteFunctionType &df, const std::string &name )
+{
+  int errors = 0;
+  Dune::DynamicVector< double > localDofs;
+  for( const auto &entity : elements( df.gridPart() ) )
+  {
+    localDofs.resize( df.space().basisFunctionSet( entity ).size() );
+    df.getLocalDofs( entity, localDofs );
+    for( std::size_t i = 0; i < localDofs.size(); ++i )
+    {
+      if( std::abs( localDofs[ i ] - localDof( entity, i ) ) > 1e-12 )
+        ++errors;
+    }
+  }
+  if( errors > 0 )
+    std::cerr << "Error: " << errors << " wrong dofs after reading on " << name << "." << std::endl;
+  return errors;
+}
+
+// read the file on a grid distributed over comm and compare the dofs
+int readAndCheck ( const std::string &filename, MPICommunicatorType comm, const std::string &name )
+{
+  std::unique_ptr< GridType > grid = createGrid( comm );
+  GridPartType gridPart( *grid );
+  DiscreteFunctionSpaceType space( gridPart );
+  DiscreteFunctionType df( "df", space );
+  df.clear();
+
+  Dune::Fem::readEntityKeyedData( df, filename, comm );
+  return check( df, name );
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  const MPICommunicatorType world = Dune::MPIHelper::getCommunicator();
+  const int rank = Dune::Fem::MPIManager::rank(), size = Dune::Fem::MPIManager::size();
+  const std::string filename = "entitykeyeddata.dat";
+
+  // write on N = size ranks
+  {
+    std::unique_ptr< GridType > grid = createGrid( world );
+    GridPartType gridPart( *grid );
+    DiscreteFunctionSpaceType space( gridPart );
+    DiscreteFunctionType df( "df", space );
+    fill( df );
+    Dune::Fem::writeEntityKeyedData( df, filename, world );
+  }
+
+  int errors = 0;
+
+  // read on M = N ranks
+  errors += readAndCheck( filename, world, "all ranks" );
+
+  // read on M = 1 rank (each rank reads the whole file independently)
+  errors += readAndCheck( filename, Dune::MPIHelper::getLocalCommunicator(), "a single rank" );
+
+#if HAVE_MPI
+  // read on M = N-1 ranks
+  if( size > 2 )
+  {
+    MPI_Comm comm;
+    MPI_Comm_split( world, (rank < size-1 ? 0 : MPI_UNDEFINED), rank, &comm );
+    if( comm != MPI_COMM_NULL )
+    {
+      errors += readAndCheck( filename, comm, std::to_string( size-1 ) + " ranks" );
+      MPI_Comm_free( &comm );
+    }
+  }
+#endif // #if HAVE_MPI
+
+  Dune::CollectiveCommunication< MPICommunicatorType > comm( world );
+  errors = comm.sum( errors );
+  if( (rank == 0) && (errors > 0) )
+    std::cerr << "Error: entity keyed data not restored correctly." << std::endl;
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
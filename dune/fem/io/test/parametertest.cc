@@ -85,6 +85,21 @@ int main(int argc, char** argv)
     double factor1 = parameter.getValue<double>("factor1", 1.0 );
     double factor2 = parameter.getValue<double>("factor2", 1.0 );
 
+    // repeated reads are served from the value cache and counted
+    for( int j = 0; j < 10; ++j )
+    {
+      if( parameter.getValue< double >( "factor1", 1.0 ) != factor1 )
+        DUNE_THROW( Dune::Exception, "Cached parameter value differs" );
+    }
+    if( parameter.lookups( "factor1" ) != 11 )
+      DUNE_THROW( Dune::Exception, "Wrong number of parameter lookups" );
+    try
+    {
+      parameter.getValue< double >( "factor1", 2.0 );
+      DUNE_THROW( Dune::Exception, "Changed default value not detected" );
+    }
+    catch ( Dune::Fem::ParameterInvalid ) {}
+
     //*****************OutPut*********************//
     std::cout<<"User: "<< userId <<" started his compution of Project: "<< project <<"\nThe acctual date is: "<< date <<std::endl;
     std::cout<<std::endl;
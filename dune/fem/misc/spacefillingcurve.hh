@@ -0,0 +1,76 @@
+#ifndef DUNE_FEM_MISC_SPACEFILLINGCURVE_HH
+#define DUNE_FEM_MISC_SPACEFILLINGCURVE_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <dune/common/fvector.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // MortonOrder
+    // -----------
+
+    /** \class MortonOrder
+     *  \ingroup Utility
+     *  \brief keys of the Morton (Z-order) space filling curve
+     *
+     *  Points of a bounding box are mapped onto a uniform grid with
+     *  \f$2^b\f$ cells per direction, where \f$b = \lfloor 64/d \rfloor\f$
+     *  (at most 32), and the key is obtained by interleaving the bits of the
+     *  cell coordinates. Sorting points by their key yields an ordering with
+     *  good spatial locality.
+     */
+    template< class ctype, int dim >
+    class MortonOrder
+    {
+    public:
+      typedef FieldVector< ctype, dim > CoordinateType;
+      typedef std::uint64_t KeyType;
+
+      static const int bits = std::min( 64 / dim, 32 );
+
+      /** \brief constructor
+       *
+       *  \param[in]  lower  lower left corner of the bounding box
+       *  \param[in]  upper  upper right corner of the bounding box
+       */
+      MortonOrder ( const CoordinateType &lower, const CoordinateType &upper )
+        : lower_( lower )
+      {
+        const ctype cells = static_cast< ctype >( (std::uint64_t( 1 ) << bits) - 1 );
+        for( int i = 0; i < dim; ++i )
+          scale_[ i ] = (upper[ i ] > lower[ i ] ? cells / (upper[ i ] - lower[ i ]) : ctype( 0 ));
+      }
+
+      //! return key of a point within the bounding box
+      KeyType operator() ( const CoordinateType &x ) const
+      {
+        const ctype maxCell = static_cast< ctype >( (std::uint64_t( 1 ) << bits) - 1 );
+
+        std::uint64_t cell[ dim ];
+        for( int i = 0; i < dim; ++i )
+          cell[ i ] = static_cast< std::uint64_t >( std::min( std::max( (x[ i ] - lower_[ i ]) * scale_[ i ], ctype( 0 ) ), maxCell ) );
+
+        KeyType key = 0;
+        for( int b = bits-1; b >= 0; --b )
+          for( int i = 0; i < dim; ++i )
+            key = (key << 1) | ((cell[ i ] >> b) & 1u);
+        return key;
+      }
+
+    protected:
+      CoordinateType lower_;
+      CoordinateType scale_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_MISC_SPACEFILLINGCURVE_HH
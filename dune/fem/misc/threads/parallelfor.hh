@@ -0,0 +1,146 @@
+#ifndef DUNE_FEM_PARALLELFOR_HH
+#define DUNE_FEM_PARALLELFOR_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+#if defined(USE_PTHREADS) && !defined(_OPENMP)
+#include <thread>
+#include <vector>
+#endif
+
+#include <dune/fem/misc/threads/threadmanager.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    /** \brief return the number of threads parallelRun and parallelFor may use
+     *
+     *  This is ThreadManager::maxThreads() in single thread mode and 1 if the
+     *  caller is already running in a multi thread section, i.e., nested
+     *  loops run on the calling thread.
+     */
+    inline int availableThreads ()
+    {
+      return ThreadManager::singleThreadMode() ? ThreadManager::maxThreads() : 1;
+    }
+
+    /** \brief run a function once on each of the given number of threads
+     *
+     *  The threads are started through the backend of the ThreadManager
+     *  (OpenMP or pthreads), so ThreadManager::thread() identifies the
+     *  thread inside f. The number of threads is bounded by
+     *  availableThreads(); with a single thread, f is called directly.
+     *
+     *  \note The first exception thrown by f is rethrown on the calling
+     *        thread after all threads finished.
+     */
+    template< class F >
+    inline void parallelRun ( int threads, F &&f )
+    {
+      threads = std::min( threads, availableThreads() );
+      if( threads <= 1 )
+      {
+        f();
+        return;
+      }
+
+      std::exception_ptr exception;
+      std::mutex mutex;
+      auto run = [ &f, &exception, &mutex ] () {
+          try
+          {
+            f();
+          }
+          catch( ... )
+          {
+            std::lock_guard< std::mutex > guard( mutex );
+            if( !exception )
+              exception = std::current_exception();
+          }
+        };
+
+#if defined(_OPENMP)
+#pragma omp parallel num_threads( threads )
+      run();
+#elif defined(USE_PTHREADS)
+      const int maxThreads = ThreadManager::maxThreads();
+      std::vector< std::thread > workers;
+      for( int thread = 1; thread < threads; ++thread )
+        workers.emplace_back( [ &run, maxThreads, threads, thread ] () {
+            ThreadManager::initThread( maxThreads, thread );
+            ThreadManager::initMultiThreadMode( threads );
+            run();
+          } );
+      ThreadManager::initMultiThreadMode( threads );
+      run();
+      for( std::thread &worker : workers )
+        worker.join();
+      ThreadManager::initSingleThreadMode();
+#else
+      run();
+#endif
+
+      if( exception )
+        std::rethrow_exception( exception );
+    }
+
+    /** \brief call f( i ) for all i in [begin, end) using the threads of the ThreadManager
+     *
+     *  Chunks of chunkSize consecutive indices are distributed dynamically
+     *  over at most maxThreads threads (see parallelRun), so f may use
+     *  ThreadManager::thread() to address per thread data. Passing
+     *  maxThreads = 1 runs the loop on the calling thread.
+     *
+     *  \note After an exception thrown by f, no further chunks are started
+     *        and the exception is rethrown on the calling thread.
+     */
+    template< class F >
+    inline void parallelFor ( std::size_t begin, std::size_t end, std::size_t chunkSize, F &&f,
+                              int maxThreads = ThreadManager::maxThreads() )
+    {
+      if( begin >= end )
+        return;
+
+      chunkSize = std::max( chunkSize, std::size_t( 1 ) );
+      const std::size_t chunks = (end - begin + chunkSize - 1) / chunkSize;
+      const int threads = static_cast< int >( std::min( std::size_t( std::max( maxThreads, 1 ) ), chunks ) );
+      if( (threads <= 1) || (availableThreads() <= 1) )
+      {
+        for( std::size_t i = begin; i < end; ++i )
+          f( i );
+        return;
+      }
+
+      std::atomic< std::size_t > next( begin );
+      parallelRun( threads, [ &f, &next, end, chunkSize ] () {
+          try
+          {
+            for( std::size_t first = next.fetch_add( chunkSize ); first < end; first = next.fetch_add( chunkSize ) )
+            {
+              const std::size_t last = std::min( end, first + chunkSize );
+              for( std::size_t i = first; i < last; ++i )
+                f( i );
+            }
+          }
+          catch( ... )
+          {
+            // do not start further chunks
+            next.store( end );
+            throw;
+          }
+        } );
+    }
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_PARALLELFOR_HH
@@ -1,6 +1,8 @@
 #ifndef DUNE_FEM_THREADITERATOR_HH
 #define DUNE_FEM_THREADITERATOR_HH
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 #include <dune/common/exceptions.hh>
@@ -9,6 +11,7 @@
 #include <dune/fem/misc/threads/threadmanager.hh>
 #include <dune/fem/misc/threads/threaditeratorstorage.hh>
 #include <dune/fem/space/common/dofmanager.hh>
+#include <dune/fem/storage/arraymemorypool.hh>
 #include <dune/fem/storage/dynamicarray.hh>
 
 namespace Dune
@@ -178,6 +181,18 @@ namespace Dune
             DUNE_THROW(InvalidStateException,"Partitioning inconsistent!");
           }
 
+          // let the first touch of dof arrays follow this partition of the element indices
+          std::vector< double > bounds( maxThreads+1, 0.0 );
+          for( size_t i = 0; i < size; ++i )
+          {
+            if( threadNum_[ i ] >= 0 )
+              bounds[ threadNum_[ i ]+1 ] = std::max( bounds[ threadNum_[ i ]+1 ], double( i+1 ) / double( size ) );
+          }
+          for( size_t thread = 1; thread <= maxThreads; ++thread )
+            bounds[ thread ] = std::max( bounds[ thread ], bounds[ thread-1 ] );
+          bounds[ maxThreads ] = 1.0;
+          ArrayMemoryPool::instance().setPartition( std::move( bounds ) );
+
           // update sequence number
           sequence_ = sequence;
 
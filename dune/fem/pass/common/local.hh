@@ -6,11 +6,19 @@
 #endif
 
 
+#include <cstddef>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/typetraits.hh>
 
 #include <dune/fem/common/memory.hh>
+#include <dune/fem/gridpart/common/intersectiontable.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
 #include <dune/fem/pass/common/pass.hh>
 
 namespace Dune
@@ -25,12 +33,56 @@ namespace Dune
     template <class DiscreteModelImp, class PreviousPassImp , int passIdImp >
     class Pass;
 
+    template< class DiscreteModelImp, class PreviousPassImp , int passIdImp >
+    class LocalPass;
+
+
+
+    // IsFusableLocalPass
+    // ------------------
+
+    namespace Impl
+    {
+
+      //! true if Pass is a LocalPass on the grid part GridPart
+      template< class Pass, class GridPart, class = void >
+      struct IsFusableLocalPass
+        : public std::false_type
+      {};
+
+      template< class Pass, class GridPart >
+      struct IsFusableLocalPass< Pass, GridPart, void_t< typename Pass::DiscreteModelType, typename Pass::DiscreteFunctionSpaceType > >
+        : public std::integral_constant< bool, std::is_base_of< LocalPass< typename Pass::DiscreteModelType, typename Pass::PreviousPassType, Pass::passId >, Pass >::value
+                                               && std::is_same< typename Pass::DiscreteFunctionSpaceType::GridPartType, GridPart >::value >
+      {};
+
+    } // namespace Impl
+
+
+
     // LocalPass
     // ---------
 
     /** \brief Specialisation of Pass which provides a grid walk-through,
      *         but leaves open what needs to be done on each elements.
      *
+     *  If the previous pass is a LocalPass on the same grid part, both passes
+     *  can be computed in a single grid sweep (see fuseWithPrevious): After
+     *  the previous pass has been applied to an element, this pass is applied
+     *  to each element whose neighborhood is complete. Therefore, the
+     *  intermediate result is still in cache when it is used. Elements next
+     *  to ghost or overlap elements are computed after the previous pass has
+     *  been finalized (i.e., communicated).
+     *
+     *  \note Fused execution requires that the result of the previous pass on
+     *        an element is final after applyLocal has been called for it (as
+     *        for LocalDGPass). Moreover, applyLocal of this pass may only read
+     *        the previous result on the element itself and on its face
+     *        neighbors (i.e., the outside elements of its intersections), and
+     *        prepare may not read it at all. Passes with a wider stencil
+     *        (e.g., vertex neighbors or reconstructions) must not be fused;
+     *        they can override fusedWithPrevious to prevent this.
+     *
      *  \tparam  DiscreteModelImp  discrete model
      *  \tparam  PreviousPassImp   previous pass
      *  \tparam  passIdImp         id for this pass
@@ -39,6 +91,9 @@ namespace Dune
     class LocalPass
     : public Pass< DiscreteModelImp , PreviousPassImp , passIdImp>
     {
+      template< class, class, int >
+      friend class LocalPass;
+
     public:
       //! \brief type of the preceding pass
       typedef PreviousPassImp PreviousPassType;
@@ -46,6 +101,9 @@ namespace Dune
       //! \brief base class
       typedef Pass< DiscreteModelImp , PreviousPassImp , passIdImp > BaseType;
 
+      //! \brief discrete model
+      typedef DiscreteModelImp DiscreteModelType;
+
       /** \brief The type of the argument (and destination) type of
        *         the overall operator
        */
@@ -59,6 +117,8 @@ namespace Dune
       typedef typename DiscreteFunctionSpaceType::IteratorType IteratorType;
       //! \brief the codim 0 entity
       typedef typename DiscreteFunctionSpaceType::EntityType EntityType;
+      //! \brief cached intersections of the grid part
+      typedef IntersectionTable< typename DiscreteFunctionSpaceType::GridPartType > IntersectionTableType;
 
       /** \brief constructor
        *  \param pass Previous pass
@@ -118,6 +178,23 @@ namespace Dune
       /** \brief set pass status to inactive */
       void disable() const { passIsActive_ = false ; }
 
+      //! \brief true if the previous pass is a LocalPass on the same grid part
+      static const bool fusable = Impl::IsFusableLocalPass< PreviousPassType, typename DiscreteFunctionSpaceType::GridPartType >::value;
+
+      /** \brief compute the previous pass in the same grid sweep as this pass
+       *
+       *  \note This only has an effect if the previous pass is fusable.
+       *  \note This pass must only access the previous result on face
+       *        neighbors (see above).
+       */
+      void fuseWithPrevious ( bool fuse = true ) { fuseWithPrevious_ = fuse; }
+
+      //! \brief return true if the previous pass is computed in the same grid sweep
+      bool fusedWithPrevious () const override
+      {
+        return fusable && fuseWithPrevious_ && active() && previousActive( std::integral_constant< bool, fusable >() );
+      }
+
     protected:
       //! Actions to be carried out before a global grid walkthrough.
       //! To be overridden in a derived class.
@@ -141,6 +218,13 @@ namespace Dune
         // get stopwatch
         Dune::Timer timer;
 
+        if( fusedWithPrevious() )
+        {
+          computeFused( arg, dest, std::integral_constant< bool, fusable >() );
+          computeTime_ += timer.elapsed();
+          return;
+        }
+
         prepare(arg, dest);
 
         numberOfElements_ = 0 ;
@@ -157,11 +241,121 @@ namespace Dune
       }
 
     protected:
+      bool previousActive ( std::false_type ) const { return false; }
+      bool previousActive ( std::true_type ) const { return this->previousPass_.active(); }
+
+      void computeFused ( const ArgumentType &, DestinationType &, std::false_type ) const {}
+
+      //! compute the previous pass and this pass in one grid sweep
+      void computeFused ( const ArgumentType &arg, DestinationType &dest, std::true_type ) const
+      {
+        typedef typename PreviousPassType::DiscreteModelType PreviousDiscreteModelType;
+        typedef typename PreviousPassType::PreviousPassType PrePreviousPassType;
+        typedef LocalPass< PreviousDiscreteModelType, PrePreviousPassType, PreviousPassType::passId > PreviousLocalPassType;
+
+        const PreviousLocalPassType &previous = this->previousPass_;
+        const auto previousArg = previous.totalArgument( *std::get< 0 >( arg ) );
+        auto &previousDest = *previous.destination_;
+
+        const IntersectionTableType &table = intersectionTable();
+        const auto &indexSet = space().gridPart().indexSet();
+
+        // 1: previous pass applied, 2: this pass applied, 4: element is computed by the passes
+        std::vector< unsigned char > state( table.size(), 0 );
+        for( const EntityType &entity : space() )
+          state[ indexSet.index( entity ) ] = 4;
+
+        auto ready = [ &table, &state ] ( std::size_t element ) {
+          if( state[ element ] != (4 | 1) )
+            return false;
+          for( std::size_t i = table.begin( element ); i < table.end( element ); ++i )
+          {
+            const std::size_t outside = table.outside( i );
+            if( (outside != IntersectionTableType::noNeighbor) && ((state[ outside ] & (4 | 1)) != (4 | 1)) )
+              return false;
+          }
+          return true;
+        };
+
+        previous.prepare( previousArg, previousDest );
+        prepare( arg, dest );
+
+        numberOfElements_ = 0;
+        previous.numberOfElements_ = 0;
+        const IteratorType endit = space().end();
+        for( IteratorType it = space().begin(); it != endit; ++it )
+        {
+          const EntityType &entity = *it;
+          const std::size_t element = indexSet.index( entity );
+
+          previous.applyLocal( entity );
+          ++previous.numberOfElements_;
+          state[ element ] |= 1;
+
+          // apply this pass to the element and its neighbors, if their neighborhood is complete
+          if( ready( element ) )
+          {
+            applyLocal( entity );
+            ++numberOfElements_;
+            state[ element ] |= 2;
+          }
+          for( std::size_t i = table.begin( element ); i < table.end( element ); ++i )
+          {
+            const std::size_t outside = table.outside( i );
+            if( (outside != IntersectionTableType::noNeighbor) && ready( outside ) )
+            {
+              applyLocal( table.element( outside ) );
+              ++numberOfElements_;
+              state[ outside ] |= 2;
+            }
+          }
+        }
+
+        // communicates the result of the previous pass
+        previous.finalize( previousArg, previousDest );
+
+        // elements next to ghost or overlap elements
+        for( IteratorType it = space().begin(); it != endit; ++it )
+        {
+          if( !(state[ indexSet.index( *it ) ] & 2) )
+          {
+            applyLocal( *it );
+            ++numberOfElements_;
+          }
+        }
+
+        finalize( arg, dest );
+      }
+
+      /** \brief intersection table of the grid part, updated to the current grid
+       *
+       *  In single thread mode, the table is shared by all users of the grid
+       *  part (see IntersectionTable). The shared tables must not be obtained
+       *  in multi thread mode, so a pass used on a thread builds a table of
+       *  its own.
+       */
+      const IntersectionTableType &intersectionTable () const
+      {
+        if( !intersectionTable_ && !ownIntersectionTable_ )
+        {
+          if( ThreadManager::singleThreadMode() )
+            intersectionTable_.reset( &IntersectionTableType::ProviderType::getObject( &space().gridPart() ) );
+          else
+            ownIntersectionTable_.reset( new IntersectionTableType( space().gridPart() ) );
+        }
+        IntersectionTableType &table = (intersectionTable_ ? *intersectionTable_ : *ownIntersectionTable_);
+        table.update();
+        return table;
+      }
+
       std::shared_ptr< const DiscreteFunctionSpaceType > spc_;
       const std::string passName_;
       mutable double computeTime_;
       mutable size_t numberOfElements_;
       mutable bool passIsActive_;
+      bool fuseWithPrevious_ = false;
+      mutable std::unique_ptr< IntersectionTableType, typename IntersectionTableType::ProviderType::Deleter > intersectionTable_;
+      mutable std::unique_ptr< IntersectionTableType > ownIntersectionTable_;
     };
 
   } // namespace Fem
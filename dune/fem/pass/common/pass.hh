@@ -76,6 +76,12 @@ namespace Dune
         nonBlockingComm_.initComm( arg );
       }
 
+      //! same as pass, the start pass has nothing to compute
+      void prepass( const GlobalArgumentType& arg ) const
+      {
+        pass( arg );
+      }
+
       //! receive data for previously initialized communication
       void receiveCommunication( const GlobalArgumentType& arg ) const
       {
@@ -217,9 +223,12 @@ namespace Dune
       //! only sense to call this operator directly on the last pass.
       void operator()(const GlobalArgumentType& arg, DestinationType& dest) const
       {
-        previousPass_.pass(arg);
-        LocalArgumentType prevArg = previousPass_.localArgument();
-        const TotalArgumentType totalArg = tuple_push_front( prevArg, &arg );
+        // a fused previous pass is computed within this pass' compute
+        if( fusedWithPrevious() )
+          previousPass_.prepass(arg);
+        else
+          previousPass_.pass(arg);
+        const TotalArgumentType totalArg = totalArgument( arg );
         this->compute(totalArg, dest);
 
         // if initComm has not been called for this pass, we have to
@@ -274,6 +283,22 @@ namespace Dune
         operator()(arg, *destination_);
       }
 
+      //! Same as pass, but leaves the computation of this pass to the next
+      //! pass (see fusedWithPrevious).
+      void prepass(const GlobalArgumentType& arg) const
+      {
+        initComm();
+        finalizeCommunication_ = false ;
+        previousPass_.pass(arg);
+      }
+
+      //! Returns the argument of this pass' computations
+      TotalArgumentType totalArgument ( const GlobalArgumentType &arg ) const
+      {
+        LocalArgumentType prevArg = previousPass_.localArgument();
+        return tuple_push_front( prevArg, &arg );
+      }
+
       //! Returns a compilation of the results of the preceding passes
       NextArgumentType localArgument () const
       {
@@ -323,6 +348,12 @@ namespace Dune
        */
       virtual bool requireCommunication () const { return true; }
 
+      /** \brief return true if the previous pass is computed by this pass in
+       *         the same grid sweep (fused execution, see LocalPass)
+       *         \note The default implementation returns \b false \b
+       */
+      virtual bool fusedWithPrevious () const { return false; }
+
     protected:
       //! Does the actual computations. Needs to be overridden in the derived
       //! clases
@@ -29,6 +29,33 @@ namespace Dune
      *
      *  \note The definition of f(u) differs from the usual definition for
      *        conservation laws in the leading sign.
+     *
+     *  Optionally, a discrete model may implement batched versions of the flux
+     *  and source methods, receiving the values in all quadrature points of an
+     *  element or face at once (e.g., to vectorize across quadrature points):
+     *  \code
+     *  template< class ArgumentTupleVector >
+     *  void analyticalFluxes ( const EntityType &en, double time, const VolumeQuadrature &quad,
+     *                          const ArgumentTupleVector &u, JacobianRangeType *f );
+     *  template< class ArgumentTupleVector, class JacobianTupleVector >
+     *  void sources ( const EntityType &en, double time, const VolumeQuadrature &quad,
+     *                 const ArgumentTupleVector &u, const JacobianTupleVector &jac,
+     *                 RangeType *s, double *dtEst );
+     *  template< class FaceQuadrature, class ArgumentTupleVector >
+     *  void numericalFluxes ( const IntersectionType &intersection, double time,
+     *                         const FaceQuadrature &inside, const FaceQuadrature &outside,
+     *                         const ArgumentTupleVector &uLeft, const ArgumentTupleVector &uRight,
+     *                         RangeType *gLeft, RangeType *gRight, double *waveSpeed );
+     *  template< class ArgumentTupleVector >
+     *  void boundaryFluxes ( const IntersectionType &intersection, double time,
+     *                        const FaceQuadrature &quad, const ArgumentTupleVector &uLeft,
+     *                        RangeType *gLeft, double *waveSpeed );
+     *  \endcode
+     *  The i-th entry of each array belongs to the i-th quadrature point; the
+     *  values returned by the point-wise methods are stored in dtEst and
+     *  waveSpeed. The DGDiscreteModelCaller detects these methods at compile
+     *  time and falls back to the point-wise methods otherwise. They are
+     *  deliberately not part of this interface.
      */
     template <class DGDiscreteModelTraits>
     struct DGDiscreteModelInterface
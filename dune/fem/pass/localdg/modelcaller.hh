@@ -6,8 +6,11 @@
 #endif
 
 #include <cstddef>
+#include <utility>
 #include <vector>
 
+#include <dune/common/typeutilities.hh>
+
 #include <dune/fem/common/tupletypetraits.hh>
 #include <dune/fem/common/tupleutility.hh>
 #include <dune/fem/common/typeindexedtuple.hh>
@@ -28,6 +31,14 @@ namespace Dune
      *  \class   DGDiscreteModelCaller
      *  \ingroup PassHyp
      *
+     *  Besides the point-wise methods, the caller provides batched methods
+     *  (analyticalFluxes, sources, numericalFluxes, boundaryFluxes) evaluating
+     *  all quadrature points of an element or face at once. If the discrete
+     *  model implements the corresponding optional batched method (see
+     *  DGDiscreteModelInterface), it is called with the arrays of all
+     *  quadrature point values; otherwise the point-wise method is called in
+     *  a loop. The decision is made at compile time.
+     *
      *  \todo please doc me
      */
     template< class DiscreteModel, class Argument, class PassIds >
@@ -76,6 +87,9 @@ namespace Dune
       typedef typename LocalFunctionTupleType::RangeTupleType RangeTupleType;
       typedef typename LocalFunctionTupleType::JacobianRangeTupleType JacobianRangeTupleType;
 
+      typedef std::vector< Dune::TypeIndexedTuple< RangeTupleType, Selector > > RangeTupleVectorType;
+      typedef std::vector< Dune::TypeIndexedTuple< JacobianRangeTupleType, Selector > > JacobianRangeTupleVectorType;
+
     public:
       DGDiscreteModelCaller ( ArgumentType &argument, DiscreteModelType &discreteModel )
       : discreteModel_( discreteModel ),
@@ -199,6 +213,42 @@ namespace Dune
         return discreteModel().boundaryFlux( intersection, time(), quadrature.localPoint( qp ), valuesInside_[ qp ], gLeft );
       }
 
+      // evaluate analytical flux in all quadrature points
+      void analyticalFluxes ( const EntityType &entity,
+                              const VolumeQuadratureType &quadrature,
+                              JacobianRangeType *flux )
+      {
+        assert( hasFlux() );
+        analyticalFluxes( entity, quadrature, flux, PriorityTag< 1 >() );
+      }
+
+      // evaluate source in all quadrature points, dtEst receives the time step estimates
+      void sources ( const EntityType &entity,
+                     const VolumeQuadratureType &quadrature,
+                     RangeType *source, double *dtEst )
+      {
+        assert( hasSource() );
+        sources( entity, quadrature, source, dtEst, PriorityTag< 1 >() );
+      }
+
+      // evaluate numerical flux in all quadrature points, waveSpeed receives the wave speeds
+      template< class QuadratureType >
+      void numericalFluxes ( const IntersectionType &intersection,
+                             const QuadratureType &inside,
+                             const QuadratureType &outside,
+                             RangeType *gLeft, RangeType *gRight, double *waveSpeed )
+      {
+        numericalFluxes( intersection, inside, outside, gLeft, gRight, waveSpeed, PriorityTag< 1 >() );
+      }
+
+      // evaluate boundary flux in all quadrature points, waveSpeed receives the wave speeds
+      void boundaryFluxes ( const IntersectionType &intersection,
+                            const FaceQuadratureType &quadrature,
+                            RangeType *gLeft, double *waveSpeed )
+      {
+        boundaryFluxes( intersection, quadrature, gLeft, waveSpeed, PriorityTag< 1 >() );
+      }
+
       // evaluate mass
       void mass ( const EntityType &entity,
                   const VolumeQuadratureType &quadrature,
@@ -216,14 +266,81 @@ namespace Dune
       const DiscreteModelType &discreteModel () const { return discreteModel_; }
 
     private:
+      // batched model methods (if implemented by the discrete model)
+
+      template< class Model = DiscreteModelType >
+      auto analyticalFluxes ( const EntityType &entity, const VolumeQuadratureType &quadrature, JacobianRangeType *flux, PriorityTag< 1 > )
+        -> decltype( std::declval< Model & >().analyticalFluxes( entity, 0.0, quadrature, std::declval< const RangeTupleVectorType & >(), flux ), void() )
+      {
+        discreteModel().analyticalFluxes( entity, time(), quadrature, values_, flux );
+      }
+
+      template< class Model = DiscreteModelType >
+      auto sources ( const EntityType &entity, const VolumeQuadratureType &quadrature, RangeType *source, double *dtEst, PriorityTag< 1 > )
+        -> decltype( std::declval< Model & >().sources( entity, 0.0, quadrature, std::declval< const RangeTupleVectorType & >(),
+                                                                    std::declval< const JacobianRangeTupleVectorType & >(), source, dtEst ), void() )
+      {
+        discreteModel().sources( entity, time(), quadrature, values_, jacobians_, source, dtEst );
+      }
+
+      template< class QuadratureType, class Model = DiscreteModelType >
+      auto numericalFluxes ( const IntersectionType &intersection, const QuadratureType &inside, const QuadratureType &outside,
+                             RangeType *gLeft, RangeType *gRight, double *waveSpeed, PriorityTag< 1 > )
+        -> decltype( std::declval< Model & >().numericalFluxes( intersection, 0.0, inside, outside, std::declval< const RangeTupleVectorType & >(),
+                                                                            std::declval< const RangeTupleVectorType & >(), gLeft, gRight, waveSpeed ), void() )
+      {
+        discreteModel().numericalFluxes( intersection, time(), inside, outside, valuesInside_, valuesOutside_, gLeft, gRight, waveSpeed );
+      }
+
+      template< class Model = DiscreteModelType >
+      auto boundaryFluxes ( const IntersectionType &intersection, const FaceQuadratureType &quadrature,
+                            RangeType *gLeft, double *waveSpeed, PriorityTag< 1 > )
+        -> decltype( std::declval< Model & >().boundaryFluxes( intersection, 0.0, quadrature, std::declval< const RangeTupleVectorType & >(), gLeft, waveSpeed ), void() )
+      {
+        discreteModel().boundaryFluxes( intersection, time(), quadrature, valuesInside_, gLeft, waveSpeed );
+      }
+
+      // point-wise fallbacks
+
+      void analyticalFluxes ( const EntityType &entity, const VolumeQuadratureType &quadrature, JacobianRangeType *flux, PriorityTag< 0 > )
+      {
+        const std::size_t nop = quadrature.nop();
+        for( std::size_t qp = 0; qp < nop; ++qp )
+          analyticalFlux( entity, quadrature, qp, flux[ qp ] );
+      }
+
+      void sources ( const EntityType &entity, const VolumeQuadratureType &quadrature, RangeType *source, double *dtEst, PriorityTag< 0 > )
+      {
+        const std::size_t nop = quadrature.nop();
+        for( std::size_t qp = 0; qp < nop; ++qp )
+          dtEst[ qp ] = ThisType::source( entity, quadrature, qp, source[ qp ] );
+      }
+
+      template< class QuadratureType >
+      void numericalFluxes ( const IntersectionType &intersection, const QuadratureType &inside, const QuadratureType &outside,
+                             RangeType *gLeft, RangeType *gRight, double *waveSpeed, PriorityTag< 0 > )
+      {
+        const std::size_t nop = inside.nop();
+        for( std::size_t qp = 0; qp < nop; ++qp )
+          waveSpeed[ qp ] = numericalFlux( intersection, inside, outside, qp, gLeft[ qp ], gRight[ qp ] );
+      }
+
+      void boundaryFluxes ( const IntersectionType &intersection, const FaceQuadratureType &quadrature,
+                            RangeType *gLeft, double *waveSpeed, PriorityTag< 0 > )
+      {
+        const std::size_t nop = quadrature.nop();
+        for( std::size_t qp = 0; qp < nop; ++qp )
+          waveSpeed[ qp ] = boundaryFlux( intersection, quadrature, qp, gLeft[ qp ] );
+      }
+
       DiscreteModelType &discreteModel_;
       double time_;
       DiscreteFunctionPointerTupleType discreteFunctions_;
 
     protected:
       LocalFunctionTupleType localFunctionsInside_, localFunctionsOutside_;
-      std::vector< Dune::TypeIndexedTuple< RangeTupleType, Selector > > values_, valuesInside_, valuesOutside_;
-      std::vector< Dune::TypeIndexedTuple< JacobianRangeTupleType, Selector > > jacobians_;
+      RangeTupleVectorType values_, valuesInside_, valuesOutside_;
+      JacobianRangeTupleVectorType jacobians_;
     };
 
   } // namespace Fem
@@ -5,12 +5,20 @@
 #error "Outdated header, #include <dune/fem-dg/pass/dgpass.hh> instead!"
 #endif
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 #include <dune/fem/function/localfunction/temporary.hh>
 #include <dune/fem/gridpart/common/capabilities.hh>
+#include <dune/fem/io/parameter.hh>
 #include <dune/fem/operator/1order/localmassmatrix.hh>
 #include <dune/fem/pass/common/local.hh>
 #include <dune/fem/quadrature/caching/twistutility.hh>
 #include <dune/fem/quadrature/intersectionquadrature.hh>
+#include <dune/fem/solver/localtimestepclasses.hh>
 #include <dune/fem/storage/dynamicarray.hh>
 
 #include "modelcaller.hh"
@@ -35,6 +43,27 @@ namespace Dune
     ** where \f$ \tilde{A} \f$ denotes the arithmetic average and \f$ [u] \f$ the jump of
     ** \f$ u \f$ over the cell interface.\\
     ** The discrete model provides the \b analyticalFlux f, the \b source Q and the \b numericalFlux g.
+    **
+    ** By default, the pass walks over the elements and evaluates the numerical
+    ** flux on each face once, adding the contribution for the neighbor
+    ** directly to the neighbor's dofs. If the parameter
+    ** <tt>fem.localdg.facecentric</tt> is set to true, the computation is split
+    ** into two phases instead: During prepare, a flat list of all faces
+    ** (built once per grid sequence) is evaluated and the contributions of
+    ** both sides are stored in per-face flux buffers. applyLocal then only
+    ** evaluates the volume terms and gathers the face contributions of its
+    ** own faces. Neither phase writes to data of other elements, so no
+    ** neighbor checker is required in threaded runs. Local time stepping is
+    ** not supported in this mode (the element-wise mode is used instead).
+    ** As the face phase reads the argument on all elements, a face-centric
+    ** pass is never fused with its previous pass (see LocalPass).
+    **
+    ** In threaded runs (one pass per thread), each pass only evaluates the
+    ** faces of the elements of its thread, which it records during the first
+    ** application after a grid change; in that first application (and for
+    ** elements newly assigned to the thread) the faces are evaluated while
+    ** visiting the element. Faces between elements of different threads are
+    ** evaluated by both threads, each keeping its own contribution.
     ** @{
     **************************************************************************/
 
@@ -75,6 +104,7 @@ namespace Dune
       typedef typename DiscreteFunctionSpaceType::GridType GridType;
       typedef typename DiscreteFunctionSpaceType::GridPartType GridPartType;
       typedef typename DiscreteFunctionSpaceType::DomainType DomainType;
+      typedef typename DiscreteFunctionSpaceType::RangeFieldType RangeFieldType;
       typedef typename DiscreteFunctionSpaceType::RangeType RangeType;
       typedef typename DiscreteFunctionSpaceType::JacobianRangeType JacobianRangeType;
       typedef typename DiscreteFunctionSpaceType::BasisFunctionSetType BasisFunctionSetType;
@@ -82,6 +112,7 @@ namespace Dune
       // Types extracted from the underlying grids
       typedef typename GridPartType::IntersectionIteratorType IntersectionIteratorType;
       typedef typename IntersectionIteratorType::Intersection IntersectionType;
+      typedef typename BaseType::IntersectionTableType IntersectionTableType;
       typedef typename GridType::template Codim<0>::Geometry Geometry;
 
 
@@ -100,6 +131,24 @@ namespace Dune
       //! type of local mass matrix
       typedef LocalMassMatrix< DiscreteFunctionSpaceType, VolumeQuadratureType > LocalMassMatrixType;
 
+      //! entry of the face list used in face-centric mode
+      struct FaceInfo
+      {
+        //! indices of inside and outside element
+        std::size_t inside = 0, outside = 0;
+        //! local face numbers within inside and outside element
+        int indexInInside = -1, indexInOutside = -1;
+        //! twists of the face with respect to inside and outside element
+        int twistInInside = 0, twistInOutside = 0;
+        //! true for interior faces, false for boundary faces
+        bool neighbor = false;
+        bool conforming = true;
+        //! offsets of the inside and outside contribution in the flux buffer
+        std::size_t offset[ 2 ] = { 0, 0 };
+        //! number of dofs of the inside and outside contribution (0 if not needed)
+        std::size_t numDofs[ 2 ] = { 0, 0 };
+      };
+
     public:
       //- Public methods
       //! Constructor
@@ -109,12 +158,14 @@ namespace Dune
       //! \param volumeQuadOrd defines the order of the volume quadrature which is by default 2* space polynomial order
       //! \param faceQuadOrd defines the order of the face quadrature which is by default 2* space polynomial order
       //! \param notThreadParallel  true if pass is used in single thread mode
+      //! \param parameter parameters (reads fem.localdg.facecentric)
       LocalDGPass(DiscreteModelType& problem,
                   PreviousPassType& pass,
                   const DiscreteFunctionSpaceType& spc,
                   const int volumeQuadOrd =-1,
                   const int faceQuadOrd=-1,
-                  const bool notThreadParallel = true ) :
+                  const bool notThreadParallel = true,
+                  const ParameterReader &parameter = Parameter::container() ) :
         BaseType(pass, spc),
         caller_(0),
         problem_(problem),
@@ -128,16 +179,19 @@ namespace Dune
         fMatVec_( 20 ),
         valEnVec_( 20 ),
         valNbVec_( 20 ),
+        speedVec_( 20 ),
         dtMin_(std::numeric_limits<double>::max()),
         minLimit_(2.0*std::numeric_limits<double>::min()),
         volumeQuadOrd_( (volumeQuadOrd < 0) ?  ( 2 * space().order()) : volumeQuadOrd ),
         faceQuadOrd_( (faceQuadOrd < 0) ?  ( 2 * space().order()+1) : faceQuadOrd ),
         localMassMatrix_( space() , volumeQuadOrd_ ),
-        notThreadParallel_( notThreadParallel )
+        notThreadParallel_( notThreadParallel ),
+        faceCentric_( parameter.getValue< bool >( "fem.localdg.facecentric", false ) )
       {
         fMatVec_.setMemoryFactor( 1.1 );
         valEnVec_.setMemoryFactor( 1.1 );
         valNbVec_.setMemoryFactor( 1.1 );
+        speedVec_.setMemoryFactor( 1.1 );
 
         assert( volumeQuadOrd_ >= 0 );
         assert( faceQuadOrd_ >= 0 );
@@ -165,6 +219,23 @@ namespace Dune
         return dtMin_ / p;
       }
 
+      /** \brief enable support for local time stepping
+       *
+       *  The pass provides element-wise time step estimates to the given
+       *  classes. While sub stepping is enabled, only active elements are
+       *  computed and all contributions are multiplied by the time step of
+       *  the corresponding class (see DuneODE::LocalTimeSteppingEulerSolver).
+       *  Ghost elements are never computed, so the elements on both sides of a
+       *  process boundary are assigned to the finest class.
+       *
+       *  \note Local time stepping requires the pass to run in single thread mode.
+       */
+      void setLocalTimeStepping ( LocalTimeStepClasses &classes )
+      {
+        assert( notThreadParallel_ );
+        localTimeStepping_ = &classes;
+      }
+
     public:
       //! In the preparations, store pointers to the actual arguments and
       //! destinations. Filter out the "right" arguments for this pass.
@@ -173,7 +244,26 @@ namespace Dune
         arg_ = const_cast<ArgumentType*>(&arg);
         dest_ = &dest;
 
-        if( notThreadParallel_ )
+        if( localTimeStepping_ )
+        {
+          localTimeStepping_->resize( indexSet_.size( 0 ) );
+          // a full application renews the estimates of all elements (including ghosts)
+          if( !localTimeStepping_->enabled() )
+            localTimeStepping_->resetEstimates();
+          for( const EntityType &entity : space() )
+          {
+            const auto index = indexSet_.index( entity );
+            if( localTimeStepping_->active( index ) )
+            {
+              // inactive elements keep their (accumulated) update
+              if( localTimeStepping_->enabled() )
+                dest_->localFunction( entity ).clear();
+              localTimeStepping_->resetEstimate( index );
+            }
+          }
+        }
+
+        if( notThreadParallel_ && !lts() )
         {
           // clear destination
           dest_->clear();
@@ -191,6 +281,19 @@ namespace Dune
 
         // time initialisation to max value
         dtMin_ = std::numeric_limits<double>::max();
+
+        // face phase of the face-centric mode
+        if( faceCentric() && problem_.hasFlux() )
+        {
+          // in threaded runs, record the elements of this thread for the face list
+          if( !notThreadParallel_ && (ownedSequence_ != space().sequence()) )
+          {
+            ownedSequence_ = space().sequence();
+            owned_.assign( indexSet_.size( 0 ), 0 );
+            numOwned_ = 0;
+          }
+          computeFaceFluxes();
+        }
       }
 
       //! Some timestep size management.
@@ -235,11 +338,29 @@ namespace Dune
       template <class NeighborChecker>
       void applyLocal( const EntityType& en, const NeighborChecker& nbChecker ) const
       {
+        // skip elements not updated in the current local time step
+        if( lts() && !localTimeStepping_->active( indexSet_.index( en ) ) )
+          return;
+
         // init local function
         initLocalFunction( en , updEn_ );
 
         // call real apply local
-        applyLocal(en, updEn_, nbChecker );
+        if( faceCentric() )
+        {
+          const std::size_t index = indexSet_.index( en );
+          if( problem_.hasFlux() && !notThreadParallel_ && !owned_[ index ] )
+          {
+            owned_[ index ] = 1;
+            ++numOwned_;
+          }
+          if( !problem_.hasFlux() || covered_[ index ] )
+            applyLocalGather( en, updEn_ );
+          else
+            applyLocalFaces( en, updEn_ );
+        }
+        else
+          applyLocal(en, updEn_, nbChecker );
 
         // add update to real function
         updateFunctionAndApplyMass(en, updEn_ );
@@ -247,19 +368,29 @@ namespace Dune
 
       using BaseType::space;
 
-    protected:
-      //! local integration
-      template <class NeighborChecker>
-      void applyLocal( const EntityType& en,
-                       TemporaryLocalFunctionType& updEn,
-                       const NeighborChecker& nbChecker ) const
+      //! return true if the face-centric two-phase mode is used
+      bool faceCentric () const
       {
-        // only call geometry once, who know what is done in this function
-        const Geometry & geo = en.geometry();
+        return faceCentric_ && !localTimeStepping_;
+      }
 
-        // get volume of element
-        const double vol = geo.volume();
+      //! a face-centric pass reads the argument on all elements in prepare and thus cannot be fused
+      bool fusedWithPrevious () const override
+      {
+        return BaseType::fusedWithPrevious() && !faceCentric();
+      }
 
+      //! return the face list of the face-centric mode
+      const std::vector< FaceInfo > &faces () const
+      {
+        updateFaceList();
+        return faces_;
+      }
+
+    protected:
+      //! volume integral of an element, also sets the entity in the caller
+      void evalVolumetricPart ( const EntityType &en, const Geometry &geo, TemporaryLocalFunctionType &updEn ) const
+      {
         // only apply volumetric integral if order > 0
         // otherwise this contribution is zero
 
@@ -287,6 +418,21 @@ namespace Dune
           // only set entity here without evaluation
           caller().setEntity( en );
         }
+      }
+
+      //! local integration
+      template <class NeighborChecker>
+      void applyLocal( const EntityType& en,
+                       TemporaryLocalFunctionType& updEn,
+                       const NeighborChecker& nbChecker ) const
+      {
+        // only call geometry once, who know what is done in this function
+        const Geometry & geo = en.geometry();
+
+        // get volume of element
+        const double vol = geo.volume();
+
+        evalVolumetricPart( en, geo, updEn );
 
         /////////////////////////////
         // Surface integral part
@@ -309,7 +455,7 @@ namespace Dune
 
               const bool canUpdateNeighbor = nbChecker( en, nb );
 
-              if ( ! visited_[ indexSet_.index( nb ) ] )
+              if ( computeFace( en, nb ) )
               {
                 // for conforming situations apply Quadrature given
                 if( !GridPartCapabilities::isConforming< GridPartType >::v
@@ -334,45 +480,50 @@ namespace Dune
                                        canUpdateNeighbor );
                 }
 
+                // update on neighbor
+                if( canUpdateNeighbor )
+                {
+                  // inactive neighbors are not visited in this local time step and
+                  // coarser neighbors might already be finalized, so the inverse
+                  // mass matrix is applied to the contribution directly
+                  const auto nbIndex = indexSet_.index( nb );
+                  if( lts() && (!localTimeStepping_->active( nbIndex ) || visited_[ nbIndex ]) )
+                    localMassMatrix_.applyInverse( nb, updNb_ );
+                  // add update to real function
+                  updateFunction(nb, updNb_ );
+                }
+
               } // end if do something
 
             } // end if neighbor
             else if( intersection.boundary() )
             {
-              FaceQuadratureType faceQuadInner(gridPart_, intersection, faceQuadOrd_,
-                                               FaceQuadratureType::INSIDE);
-
-              // set neighbor entity to inside entity
-              caller().setBoundary(en, faceQuadInner);
-
-              // cache number of quadrature points
-              const size_t faceQuadInner_nop = faceQuadInner.nop();
-
-              if( valEnVec_.size() < faceQuadInner_nop )
-                valEnVec_.resize( faceQuadInner_nop );
-
-              // loop over quadrature points
-              for (size_t l = 0; l < faceQuadInner_nop; ++l)
-              {
-                RangeType& flux = valEnVec_[ l ];
-
-                // eval boundary Flux
-                wspeedS += caller().boundaryFlux( intersection, faceQuadInner, l, flux )
-                         * faceQuadInner.weight(l);
-
-                // apply weights
-                flux *= -faceQuadInner.weight(l);
-              }
-
-              // add factor
-              updEn.axpyQuadrature ( faceQuadInner, valEnVec_ );
-
+              evalBoundaryFlux( intersection, en, updEn, wspeedS );
             } // end if boundary
 
             if (wspeedS > minLimit_ )
             {
               double minvolS = std::min(vol,nbvol);
               dtMin_ = std::min(dtMin_,minvolS/wspeedS);
+
+              if( localTimeStepping_ )
+              {
+                provideLocalTimeStepEstimate( en, minvolS/wspeedS );
+                if( intersection.neighbor() )
+                {
+                  // ghosts are not computed, so elements on both sides of a
+                  // process boundary take the finest step and the interior
+                  // side always computes the face
+                  const EntityType nb = intersection.outside();
+                  if( nb.partitionType() == InteriorEntity )
+                    provideLocalTimeStepEstimate( nb, minvolS/wspeedS );
+                  else
+                  {
+                    localTimeStepping_->setFinest( indexSet_.index( en ) );
+                    localTimeStepping_->setFinest( indexSet_.index( nb ) );
+                  }
+                }
+              }
             }
           } // end intersection loop
 
@@ -382,6 +533,273 @@ namespace Dune
         visited_[ indexSet_.index( en ) ] = true ;
       }
 
+      //! element phase of the face-centric mode: volume part and gathering of face fluxes
+      void applyLocalGather ( const EntityType &en, TemporaryLocalFunctionType &updEn ) const
+      {
+        evalVolumetricPart( en, en.geometry(), updEn );
+
+        if( !problem_.hasFlux() )
+          return;
+
+        const std::size_t index = indexSet_.index( en );
+        const std::size_t numDofs = updEn.size();
+        for( std::size_t k = elementFaceOffset_[ index ]; k < elementFaceOffset_[ index+1 ]; ++k )
+        {
+          const RangeFieldType *flux = fluxBuffer_.data() + elementFaces_[ k ];
+          for( std::size_t i = 0; i < numDofs; ++i )
+            updEn[ i ] += flux[ i ];
+        }
+      }
+
+      //! face-centric mode for elements not covered by the face list: evaluate all faces locally
+      void applyLocalFaces ( const EntityType &en, TemporaryLocalFunctionType &updEn ) const
+      {
+        const Geometry &geo = en.geometry();
+        const double vol = geo.volume();
+
+        evalVolumetricPart( en, geo, updEn );
+
+        if( !problem_.hasFlux() )
+          return;
+
+        const IntersectionIteratorType endnit = gridPart_.iend( en );
+        for( IntersectionIteratorType nit = gridPart_.ibegin( en ); nit != endnit; ++nit )
+        {
+          const IntersectionType &intersection = *nit;
+
+          double nbvol = vol;
+          double wspeedS = 0.0;
+          if( intersection.neighbor() )
+          {
+            const EntityType nb = intersection.outside();
+            if( GridPartCapabilities::isConforming< GridPartType >::v || intersection.conforming() )
+              nbvol = applyLocalNeighbor< true >( intersection, en, nb, updEn, updNb_, wspeedS, false );
+            else
+              nbvol = applyLocalNeighbor< false >( intersection, en, nb, updEn, updNb_, wspeedS, false );
+          }
+          else if( intersection.boundary() )
+            evalBoundaryFlux( intersection, en, updEn, wspeedS );
+
+          if( wspeedS > minLimit_ )
+            dtMin_ = std::min( dtMin_, std::min( vol, nbvol ) / wspeedS );
+        }
+      }
+
+      //! face phase of the face-centric mode: evaluate numerical fluxes on all faces of the face list
+      void computeFaceFluxes () const
+      {
+        updateFaceList();
+
+        const std::size_t numFaces = faces_.size();
+        for( std::size_t f = 0; f < numFaces; ++f )
+          applyFace( faces_[ f ], intersections_[ f ] );
+      }
+
+      //! evaluate the numerical flux on one face and store the contributions in the flux buffer
+      void applyFace ( const FaceInfo &face, const IntersectionType &intersection ) const
+      {
+        const EntityType en = intersection.inside();
+        caller().setEntity( en );
+        initLocalFunction( en, updEn_ );
+
+        const double vol = en.geometry().volume();
+        double nbvol = vol;
+        double wspeedS = 0.0;
+        if( face.neighbor )
+        {
+          const EntityType nb = intersection.outside();
+          if( face.conforming )
+            nbvol = applyLocalNeighbor< true >( intersection, en, nb, updEn_, updNb_, wspeedS, face.numDofs[ 1 ] > 0 );
+          else
+            nbvol = applyLocalNeighbor< false >( intersection, en, nb, updEn_, updNb_, wspeedS, face.numDofs[ 1 ] > 0 );
+
+          RangeFieldType *fluxNb = fluxBuffer_.data() + face.offset[ 1 ];
+          for( std::size_t i = 0; i < face.numDofs[ 1 ]; ++i )
+            fluxNb[ i ] = updNb_[ i ];
+        }
+        else
+          evalBoundaryFlux( intersection, en, updEn_, wspeedS );
+
+        RangeFieldType *fluxEn = fluxBuffer_.data() + face.offset[ 0 ];
+        for( std::size_t i = 0; i < face.numDofs[ 0 ]; ++i )
+          fluxEn[ i ] = updEn_[ i ];
+
+        if( wspeedS > minLimit_ )
+          dtMin_ = std::min( dtMin_, std::min( vol, nbvol ) / wspeedS );
+      }
+
+      /** \brief build the face list and the element-to-face map
+       *
+       *  The face list covers all elements (of this thread in threaded runs)
+       *  and is rebuilt once per grid sequence (or if further elements were
+       *  assigned to this thread). The topology of the faces is taken from
+       *  the intersection table of the grid part.
+       */
+      void updateFaceList () const
+      {
+        const std::size_t numCovered = (notThreadParallel_ ? 0 : numOwned_);
+        if( (faceListSequence_ == space().sequence()) && (faceListCovered_ == numCovered) )
+          return;
+        faceListSequence_ = space().sequence();
+        faceListCovered_ = numCovered;
+
+        faces_.clear();
+        intersections_.clear();
+
+        const IntersectionTableType &table = this->intersectionTable();
+
+        const std::size_t numElements = indexSet_.size( 0 );
+        std::vector< char > &computed = covered_;
+        computed.assign( numElements, 0 );
+        for( const EntityType &entity : space() )
+        {
+          const std::size_t index = indexSet_.index( entity );
+          computed[ index ] = (notThreadParallel_ || owned_[ index ]);
+        }
+
+        // (element index, buffer offset) of all contributions
+        std::vector< std::pair< std::size_t, std::size_t > > contributions;
+        std::size_t bufferSize = 0;
+        for( const EntityType &entity : space() )
+        {
+          const std::size_t enIndex = indexSet_.index( entity );
+          if( !computed[ enIndex ] )
+            continue;
+          const std::size_t enDofs = space().basisFunctionSet( entity ).size();
+
+          // the table stores the intersections in the order of the intersection iterator
+          std::size_t i = table.begin( enIndex );
+          const IntersectionIteratorType endnit = gridPart_.iend( entity );
+          for( IntersectionIteratorType nit = gridPart_.ibegin( entity ); nit != endnit; ++nit, ++i )
+          {
+            assert( i < table.end( enIndex ) );
+
+            FaceInfo face;
+            face.inside = enIndex;
+            face.indexInInside = table.indexInInside( i );
+            face.twistInInside = table.twistInInside( i );
+            if( table.neighbor( i ) )
+            {
+              face.outside = table.outside( i );
+              // faces between computed elements are owned by the element with the smaller index
+              if( computed[ face.outside ] && (face.outside < enIndex) )
+                continue;
+
+              face.neighbor = true;
+              face.conforming = table.conforming( i );
+              face.indexInOutside = table.indexInOutside( i );
+              face.twistInOutside = table.twistInOutside( i );
+              if( computed[ face.outside ] )
+                face.numDofs[ 1 ] = space().basisFunctionSet( table.element( face.outside ) ).size();
+            }
+            else if( !table.boundary( i ) )
+              continue;
+
+            face.numDofs[ 0 ] = enDofs;
+            for( int side = 0; side < 2; ++side )
+            {
+              face.offset[ side ] = bufferSize;
+              bufferSize += face.numDofs[ side ];
+              if( face.numDofs[ side ] > 0 )
+                contributions.emplace_back( side == 0 ? face.inside : face.outside, face.offset[ side ] );
+            }
+
+            faces_.push_back( face );
+            intersections_.push_back( *nit );
+          }
+          assert( i == table.end( enIndex ) );
+        }
+
+        fluxBuffer_.resize( bufferSize );
+
+        // sort contributions by element (compressed row storage)
+        elementFaceOffset_.assign( numElements+1, 0 );
+        for( const auto &contribution : contributions )
+          ++elementFaceOffset_[ contribution.first+1 ];
+        for( std::size_t i = 0; i < numElements; ++i )
+          elementFaceOffset_[ i+1 ] += elementFaceOffset_[ i ];
+        elementFaces_.resize( contributions.size() );
+        std::vector< std::size_t > position( elementFaceOffset_.begin(), elementFaceOffset_.end()-1 );
+        for( const auto &contribution : contributions )
+          elementFaces_[ position[ contribution.first ]++ ] = contribution.second;
+      }
+
+      //! boundary flux on an intersection with the domain boundary
+      void evalBoundaryFlux ( const IntersectionType &intersection,
+                              const EntityType &en,
+                              TemporaryLocalFunctionType &updEn,
+                              double &wspeedS ) const
+      {
+        FaceQuadratureType faceQuadInner(gridPart_, intersection, faceQuadOrd_,
+                                         FaceQuadratureType::INSIDE);
+
+        // set neighbor entity to inside entity
+        caller().setBoundary(en, faceQuadInner);
+
+        // cache number of quadrature points
+        const size_t faceQuadInner_nop = faceQuadInner.nop();
+
+        if( valEnVec_.size() < faceQuadInner_nop )
+          valEnVec_.resize( faceQuadInner_nop );
+        if( speedVec_.size() < faceQuadInner_nop )
+          speedVec_.resize( faceQuadInner_nop );
+
+        const double ltsWeight = timeStepWeight( en );
+
+        // eval boundary flux in all quadrature points
+        caller().boundaryFluxes( intersection, faceQuadInner, valEnVec_.data(), speedVec_.data() );
+
+        // loop over quadrature points
+        for (size_t l = 0; l < faceQuadInner_nop; ++l)
+        {
+          RangeType& flux = valEnVec_[ l ];
+
+          wspeedS += speedVec_[ l ] * faceQuadInner.weight(l);
+
+          // apply weights
+          flux *= -faceQuadInner.weight(l) * ltsWeight;
+        }
+
+        // add factor
+        updEn.axpyQuadrature ( faceQuadInner, valEnVec_ );
+      }
+
+      //! return true if local time stepping is in progress
+      bool lts () const
+      {
+        return localTimeStepping_ && localTimeStepping_->enabled();
+      }
+
+      //! return true if the face between en and nb has to be computed from en
+      bool computeFace ( const EntityType &en, const EntityType &nb ) const
+      {
+        const auto nbIndex = indexSet_.index( nb );
+        if( !lts() )
+          return !visited_[ nbIndex ];
+
+        // ghosts are never visited, so the interior side computes the face
+        if( nb.partitionType() != InteriorEntity )
+          return true;
+
+        // in local time stepping the face is owned by the finer element
+        const int enClass = localTimeStepping_->elementClass( indexSet_.index( en ) );
+        const int nbClass = localTimeStepping_->elementClass( nbIndex );
+        return (nbClass > enClass) || ((nbClass == enClass) && !visited_[ nbIndex ]);
+      }
+
+      //! weight of element contributions (time step of element in local time stepping)
+      double timeStepWeight ( const EntityType &en ) const
+      {
+        return lts() ? localTimeStepping_->weight( indexSet_.index( en ) ) : 1.0;
+      }
+
+      //! provide element-wise time step estimate (scaled like timeStepEstimateImpl)
+      void provideLocalTimeStepEstimate ( const EntityType &en, double dt ) const
+      {
+        const double p = 2 * space().order() + 1;
+        localTimeStepping_->provideEstimate( indexSet_.index( en ), dt / p );
+      }
+
       // initialize local update function
       template <class LocalFunctionImp>
       void initLocalFunction( const EntityType& en, LocalFunctionImp& update) const
@@ -431,15 +849,17 @@ namespace Dune
           fMatVec_.resize( volQuad_nop );
         }
 
+        const double ltsWeight = timeStepWeight( en );
+
+        // evaluate analytical flux in all quadrature points
+        caller().analyticalFluxes( en, volQuad, fMatVec_.data() );
+
         for (size_t l = 0; l < volQuad_nop; ++l)
         {
           JacobianRangeType& flux = fMatVec_[ l ];
 
-          // evaluate analytical flux and source
-          caller().analyticalFlux(en, volQuad, l, flux );
-
           const double intel = geo.integrationElement(volQuad.point(l))
-                             * volQuad.weight(l);
+                             * volQuad.weight(l) * ltsWeight;
 
           // apply integration weights
           flux *= intel;
@@ -470,24 +890,39 @@ namespace Dune
           valEnVec_.resize( volQuad_nop );
         }
 
+        if( speedVec_.size() < volQuad_nop )
+        {
+          speedVec_.resize( volQuad_nop );
+        }
+
+        const double ltsWeight = timeStepWeight( en );
+
+        // evaluate analytical flux and source in all quadrature points
+        if( problem_.hasFlux() )
+          caller().analyticalFluxes( en, volQuad, fMatVec_.data() );
+        else
+          std::fill( fMatVec_.data(), fMatVec_.data() + volQuad_nop, JacobianRangeType( 0 ) );
+        caller().sources( en, volQuad, valEnVec_.data(), speedVec_.data() );
+
         for (size_t l = 0; l < volQuad_nop; ++l)
         {
           JacobianRangeType& flux = fMatVec_[ l ];
           RangeType& source = valEnVec_[ l ];
-
-          // evaluate analytical flux and source
-          const double dtEst =
-            caller().analyticalFluxAndSource(en, volQuad, l, flux, source );
+          const double dtEst = speedVec_[ l ];
 
           const double intel = geo.integrationElement(volQuad.point(l))
-                             * volQuad.weight(l);
+                             * volQuad.weight(l) * ltsWeight;
 
           // apply integration weights
           source *= intel;
           flux   *= intel;
 
           if( dtEst > minLimit_ )
+          {
             dtMin_ = std::min(dtMin_, dtEst);
+            if( localTimeStepping_ )
+              provideLocalTimeStepEstimate( en, dtEst );
+          }
         }
 
         // add values to local function
@@ -535,36 +970,38 @@ namespace Dune
           valEnVec_.resize( faceQuadInner_nop );
           valNbVec_.resize( faceQuadInner_nop );
         }
+        if( speedVec_.size() < faceQuadInner_nop )
+          speedVec_.resize( faceQuadInner_nop );
+
+        // in local time stepping both sides are weighted with the time step of the finer element
+        const double ltsWeight = lts() ? localTimeStepping_->weight( indexSet_.index( en ), indexSet_.index( nb ) ) : 1.0;
+
+        // evaluate numerical flux in all quadrature points
+        caller().numericalFluxes( intersection, faceQuadInner, faceQuadOuter,
+                                  valEnVec_.data(), valNbVec_.data(), speedVec_.data() );
 
         for (size_t l = 0; l < faceQuadInner_nop; ++l)
         {
           RangeType& fluxEn = valEnVec_[ l ];
           RangeType& fluxNb = valNbVec_[ l ];
 
-          wspeedS += caller().numericalFlux(intersection,
-                                           faceQuadInner,
-                                           faceQuadOuter,
-                                           l,
-                                           fluxEn, fluxNb )
-                   * faceQuadInner.weight(l);
+          wspeedS += speedVec_[ l ] * faceQuadInner.weight(l);
 
           // apply weights
-          fluxEn *= -faceQuadInner.weight(l);
-          fluxNb *=  faceQuadOuter.weight(l);
+          fluxEn *= -faceQuadInner.weight(l) * ltsWeight;
+          fluxNb *=  faceQuadOuter.weight(l) * ltsWeight;
         }
 
         // add values to local functions
         updEn.axpyQuadrature( faceQuadInner, valEnVec_ );
 
-        // update on neighbor
+        // contribution for neighbor (added by the caller)
         if( canUpdateNeighbor )
         {
           // init local function
           initLocalFunction( nb, updNb );
           // add fluxes
           updNb.axpyQuadrature( faceQuadOuter, valNbVec_ );
-          // add update to real function
-          updateFunction(nb, updNb );
         }
 
         return nbvol;
@@ -597,6 +1034,7 @@ namespace Dune
       mutable DynamicArray< JacobianRangeType > fMatVec_;
       mutable DynamicArray< RangeType > valEnVec_;
       mutable DynamicArray< RangeType > valNbVec_;
+      mutable DynamicArray< double > speedVec_;
 
       mutable double dtMin_;
       const double minLimit_;
@@ -604,6 +1042,24 @@ namespace Dune
       const int volumeQuadOrd_, faceQuadOrd_;
       LocalMassMatrixType localMassMatrix_;
       const bool notThreadParallel_;
+      const bool faceCentric_;
+
+      // face list, element-to-face map and flux buffer of the face-centric mode
+      mutable int faceListSequence_ = -1;
+      mutable std::size_t faceListCovered_ = 0;
+      mutable std::vector< char > covered_;
+      mutable std::vector< FaceInfo > faces_;
+      mutable std::vector< IntersectionType > intersections_;
+      mutable std::vector< std::size_t > elementFaceOffset_;
+      mutable std::vector< std::size_t > elementFaces_;
+      mutable std::vector< RangeFieldType > fluxBuffer_;
+
+      // elements of this thread (recorded in threaded runs)
+      mutable int ownedSequence_ = -1;
+      mutable std::vector< char > owned_;
+      mutable std::size_t numOwned_ = 0;
+
+      LocalTimeStepClasses *localTimeStepping_ = nullptr;
     };
   //! @}
 
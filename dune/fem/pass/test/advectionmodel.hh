@@ -0,0 +1,197 @@
+#ifndef DUNE_FEM_PASS_TEST_ADVECTIONMODEL_HH
+#define DUNE_FEM_PASS_TEST_ADVECTIONMODEL_HH
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include <dune/common/dynvector.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/pass/localdg/discretemodel.hh>
+#include <dune/fem/quadrature/cachingquadrature.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    template< class DiscreteFunctionSpace, int argumentId >
+    class AdvectionModel;
+
+
+
+    // AdvectionModelTraits
+    // --------------------
+
+    template< class DiscreteFunctionSpace, int argumentId >
+    struct AdvectionModelTraits
+    {
+      typedef DiscreteFunctionSpace DiscreteFunctionSpaceType;
+      typedef typename DiscreteFunctionSpaceType::GridPartType GridPartType;
+
+      typedef AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DestinationType;
+
+      typedef CachingQuadrature< GridPartType, 0 > VolumeQuadratureType;
+      typedef CachingQuadrature< GridPartType, 1 > FaceQuadratureType;
+
+      typedef AdvectionModel< DiscreteFunctionSpace, argumentId > DGDiscreteModelType;
+    };
+
+
+
+    // AdvectionModel
+    // --------------
+
+    /** \brief linear advection with upwind flux, inflow value 1 and a linear
+     *         source term, applied to the result of the pass argumentId
+     *
+     *  The model is used to compare different evaluation strategies of the
+     *  LocalDGPass.
+     */
+    template< class DiscreteFunctionSpace, int argumentId >
+    class AdvectionModel
+      : public DGDiscreteModelDefault< AdvectionModelTraits< DiscreteFunctionSpace, argumentId >, argumentId >
+    {
+      typedef DGDiscreteModelDefault< AdvectionModelTraits< DiscreteFunctionSpace, argumentId >, argumentId > BaseType;
+
+    public:
+      typedef typename BaseType::DomainType DomainType;
+      typedef typename BaseType::RangeType RangeType;
+      typedef typename BaseType::JacobianRangeType JacobianRangeType;
+
+      typedef typename BaseType::EntityType EntityType;
+      typedef typename BaseType::IntersectionType IntersectionType;
+      typedef typename BaseType::LocalCoordinateType LocalCoordinateType;
+
+      static const int dimRange = RangeType::dimension;
+
+      explicit AdvectionModel ( const DomainType &velocity, double decay = 0.5 )
+        : velocity_( velocity ), decay_( decay )
+      {}
+
+      bool hasFlux () const { return true; }
+      bool hasSource () const { return true; }
+
+      template< class ArgumentTuple, class FaceDomainType >
+      double numericalFlux ( const IntersectionType &intersection, double time, const FaceDomainType &x,
+                             const ArgumentTuple &uLeft, const ArgumentTuple &uRight,
+                             RangeType &gLeft, RangeType &gRight )
+      {
+        const double vn = velocity_ * intersection.integrationOuterNormal( x );
+        gLeft = (vn > 0 ? uLeft[ argument() ] : uRight[ argument() ]);
+        gLeft *= vn;
+        gRight = gLeft;
+        return std::abs( vn );
+      }
+
+      template< class ArgumentTuple, class FaceDomainType >
+      double boundaryFlux ( const IntersectionType &intersection, double time, const FaceDomainType &x,
+                            const ArgumentTuple &uLeft, RangeType &gLeft )
+      {
+        const double vn = velocity_ * intersection.integrationOuterNormal( x );
+        if( vn > 0 )
+          gLeft = uLeft[ argument() ];
+        else
+          gLeft = RangeType( 1 );
+        gLeft *= vn;
+        return std::abs( vn );
+      }
+
+      template< class ArgumentTuple >
+      void analyticalFlux ( const EntityType &entity, double time, const LocalCoordinateType &x,
+                            const ArgumentTuple &u, JacobianRangeType &f )
+      {
+        for( int r = 0; r < dimRange; ++r )
+        {
+          f[ r ] = velocity_;
+          f[ r ] *= u[ argument() ][ r ];
+        }
+      }
+
+      template< class ArgumentTuple, class JacobianTuple >
+      double source ( const EntityType &entity, double time, const LocalCoordinateType &x,
+                      const ArgumentTuple &u, const JacobianTuple &jac, RangeType &s )
+      {
+        s = u[ argument() ];
+        s *= -decay_;
+        return 0.0;
+      }
+
+    protected:
+      static std::integral_constant< int, argumentId > argument () { return std::integral_constant< int, argumentId >(); }
+
+      DomainType velocity_;
+      double decay_;
+    };
+
+
+
+
+    // fillNonSmooth
+    // -------------
+
+    /** \brief fill a discrete function with some non-smooth data
+     *
+     *  The i-th local dof of an element with center (x, y) is set to
+     *  \f$\sin( a x + b y + c i + phase )\f$.
+     */
+    template< class DiscreteFunction >
+    inline void fillNonSmooth ( DiscreteFunction &df, double a, double b, double c, double phase = 0 )
+    {
+      Dune::DynamicVector< double > localDofs;
+      for( const auto &entity : elements( df.gridPart() ) )
+      {
+        const auto center = entity.geometry().center();
+        localDofs.resize( df.space().basisFunctionSet( entity ).size() );
+        for( std::size_t i = 0; i < localDofs.size(); ++i )
+          localDofs[ i ] = std::sin( a*center[ 0 ] + b*center[ 1 ] + c*i + phase );
+        df.setLocalDofs( entity, localDofs );
+      }
+    }
+
+
+
+    // compareInterior
+    // ---------------
+
+    /** \brief compare the dofs of two discrete functions on the interior elements
+     *
+     *  \param[in]  a        first discrete function
+     *  \param[in]  b        second discrete function
+     *  \param[in]  message  description of the failure, printed if the dofs differ
+     *
+     *  \returns 1 if the dofs differ by more than 1e-10, 0 otherwise
+     */
+    template< class DiscreteFunction >
+    inline int compareInterior ( const DiscreteFunction &a, const DiscreteFunction &b, const std::string &message )
+    {
+      double error = 0;
+      Dune::DynamicVector< double > aDofs, bDofs;
+      for( const auto &entity : elements( a.gridPart(), Dune::Partitions::interior ) )
+      {
+        aDofs.resize( a.space().basisFunctionSet( entity ).size() );
+        bDofs.resize( aDofs.size() );
+        a.getLocalDofs( entity, aDofs );
+        b.getLocalDofs( entity, bDofs );
+        for( std::size_t i = 0; i < aDofs.size(); ++i )
+          error = std::max( error, std::abs( aDofs[ i ] - bDofs[ i ] ) );
+      }
+      if( error > 1e-10 )
+      {
+        std::cerr << "Error: " << message << " (error = " << error << ")." << std::endl;
+        return 1;
+      }
+      return 0;
+    }
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_PASS_TEST_ADVECTIONMODEL_HH
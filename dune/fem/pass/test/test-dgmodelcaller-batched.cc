@@ -0,0 +1,191 @@
+#include <config.h>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/pass/common/pass.hh>
+#include <dune/fem/pass/localdg/pass.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+#include "advectionmodel.hh"
+
+typedef Dune::YaspGrid< 2 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 3 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 2 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+enum { u, advection };
+
+typedef Dune::Fem::StartPass< DiscreteFunctionType, u > StartPassType;
+typedef Dune::Fem::AdvectionModel< DiscreteFunctionSpaceType, u > ModelType;
+
+
+
+// BatchedAdvectionModel
+// ---------------------
+
+// advection model implementing the optional batched methods (independently of the point-wise ones)
+class BatchedAdvectionModel
+  : public ModelType
+{
+  typedef ModelType BaseType;
+
+public:
+  typedef BaseType::DomainType DomainType;
+  typedef BaseType::RangeType RangeType;
+  typedef BaseType::JacobianRangeType JacobianRangeType;
+  typedef BaseType::EntityType EntityType;
+  typedef BaseType::IntersectionType IntersectionType;
+
+  using BaseType::BaseType;
+
+  template< class VolumeQuadrature, class ArgumentTupleVector >
+  void analyticalFluxes ( const EntityType &entity, double time, const VolumeQuadrature &quad,
+                          const ArgumentTupleVector &u, JacobianRangeType *f )
+  {
+    ++calls[ 0 ];
+    for( std::size_t qp = 0; qp < quad.nop(); ++qp )
+    {
+      for( int r = 0; r < dimRange; ++r )
+        for( int d = 0; d < DomainType::dimension; ++d )
+          f[ qp ][ r ][ d ] = velocity_[ d ] * u[ qp ][ argument() ][ r ];
+    }
+  }
+
+  template< class VolumeQuadrature, class ArgumentTupleVector, class JacobianTupleVector >
+  void sources ( const EntityType &entity, double time, const VolumeQuadrature &quad,
+                 const ArgumentTupleVector &u, const JacobianTupleVector &jac,
+                 RangeType *s, double *dtEst )
+  {
+    ++calls[ 1 ];
+    for( std::size_t qp = 0; qp < quad.nop(); ++qp )
+    {
+      for( int r = 0; r < dimRange; ++r )
+        s[ qp ][ r ] = -decay_ * u[ qp ][ argument() ][ r ];
+      dtEst[ qp ] = 0.0;
+    }
+  }
+
+  template< class FaceQuadrature, class ArgumentTupleVector >
+  void numericalFluxes ( const IntersectionType &intersection, double time,
+                         const FaceQuadrature &inside, const FaceQuadrature &outside,
+                         const ArgumentTupleVector &uLeft, const ArgumentTupleVector &uRight,
+                         RangeType *gLeft, RangeType *gRight, double *waveSpeed )
+  {
+    ++calls[ 2 ];
+    for( std::size_t qp = 0; qp < inside.nop(); ++qp )
+    {
+      const double vn = velocity_ * intersection.integrationOuterNormal( inside.localPoint( qp ) );
+      const auto &upwind = (vn > 0 ? uLeft[ qp ][ argument() ] : uRight[ qp ][ argument() ]);
+      for( int r = 0; r < dimRange; ++r )
+        gLeft[ qp ][ r ] = gRight[ qp ][ r ] = vn * upwind[ r ];
+      waveSpeed[ qp ] = std::abs( vn );
+    }
+  }
+
+  template< class FaceQuadrature, class ArgumentTupleVector >
+  void boundaryFluxes ( const IntersectionType &intersection, double time,
+                        const FaceQuadrature &quad, const ArgumentTupleVector &uLeft,
+                        RangeType *gLeft, double *waveSpeed )
+  {
+    ++calls[ 3 ];
+    for( std::size_t qp = 0; qp < quad.nop(); ++qp )
+    {
+      const double vn = velocity_ * intersection.integrationOuterNormal( quad.localPoint( qp ) );
+      for( int r = 0; r < dimRange; ++r )
+        gLeft[ qp ][ r ] = vn * (vn > 0 ? uLeft[ qp ][ argument() ][ r ] : 1.0);
+      waveSpeed[ qp ] = std::abs( vn );
+    }
+  }
+
+  // number of calls to analyticalFluxes, sources, numericalFluxes and boundaryFluxes
+  std::array< std::size_t, 4 > calls = {{ 0, 0, 0, 0 }};
+};
+
+
+
+// compare the point-wise and the batched model for the given pass configuration
+int check ( const DiscreteFunctionType &uh, const Dune::ParameterTree &parameter, const std::string &name )
+{
+  Dune::FieldVector< double, 2 > velocity;
+  velocity[ 0 ] = 0.75;
+  velocity[ 1 ] = 1.25;
+  ModelType pointWiseModel( velocity );
+  BatchedAdvectionModel batchedModel( velocity );
+  StartPassType startPass;
+
+  const DiscreteFunctionSpaceType &space = uh.space();
+  Dune::Fem::LocalDGPass< ModelType, StartPassType, advection >
+    pointWisePass( pointWiseModel, startPass, space, -1, -1, true, Dune::Fem::parameterReader( parameter ) );
+  Dune::Fem::LocalDGPass< BatchedAdvectionModel, StartPassType, advection >
+    batchedPass( batchedModel, startPass, space, -1, -1, true, Dune::Fem::parameterReader( parameter ) );
+
+  DiscreteFunctionType reference( "reference", space ), wh( "w", space );
+  pointWisePass( uh, reference );
+  batchedPass( uh, wh );
+
+  int errors = Dune::Fem::compareInterior( reference, wh, "batched model differs from the point-wise model (" + name + ")" );
+  if( std::any_of( batchedModel.calls.begin(), batchedModel.calls.end(), [] ( std::size_t n ) { return n == 0; } ) )
+  {
+    std::cerr << "Error: batched methods not called (" << name << ")." << std::endl;
+    ++errors;
+  }
+
+  const double dtRef = pointWisePass.timeStepEstimate(), dt = batchedPass.timeStepEstimate();
+  if( std::abs( dt - dtRef ) > 1e-10*dtRef )
+  {
+    std::cerr << "Error: batched time step estimate " << dt << " differs from " << dtRef << " (" << name << ")." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  const Dune::FieldVector< double, 2 > upper( 1.0 );
+  const std::array< int, 2 > cells = {{ 8, 8 }};
+  GridType grid( upper, cells, std::bitset< 2 >(), 1 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  DiscreteFunctionType uh( "u", space );
+  // some non-smooth initial data
+  Dune::Fem::fillNonSmooth( uh, 5.0, -2.0, 0.25, 0.5*M_PI );
+  space.communicate( uh );
+
+  Dune::ParameterTree elementWise, faceCentric;
+  elementWise[ "fem.localdg.facecentric" ] = "false";
+  faceCentric[ "fem.localdg.facecentric" ] = "true";
+
+  int errors = 0;
+  errors += check( uh, elementWise, "element-wise" );
+  errors += check( uh, faceCentric, "face-centric" );
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
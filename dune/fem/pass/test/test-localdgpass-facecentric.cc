@@ -0,0 +1,109 @@
+#include <config.h>
+
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/pass/common/pass.hh>
+#include <dune/fem/pass/localdg/pass.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+#include "advectionmodel.hh"
+
+typedef Dune::YaspGrid< 2 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 2 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+enum { u, advection };
+
+typedef Dune::Fem::StartPass< DiscreteFunctionType, u > StartPassType;
+typedef Dune::Fem::AdvectionModel< DiscreteFunctionSpaceType, u > ModelType;
+typedef Dune::Fem::LocalDGPass< ModelType, StartPassType, advection > PassType;
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  const Dune::FieldVector< double, 2 > upper( 1.0 );
+  const std::array< int, 2 > cells = {{ 16, 16 }};
+  GridType grid( upper, cells, std::bitset< 2 >(), 1 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  DiscreteFunctionType uh( "u", space );
+  // some non-smooth initial data
+  Dune::Fem::fillNonSmooth( uh, 7.0, 3.0, 0.5 );
+  space.communicate( uh );
+
+  Dune::FieldVector< double, 2 > velocity;
+  velocity[ 0 ] = 1.0;
+  velocity[ 1 ] = -0.5;
+  ModelType model( velocity );
+  StartPassType startPass;
+
+  Dune::ParameterTree elementWiseParameter, faceCentricParameter;
+  elementWiseParameter[ "fem.localdg.facecentric" ] = "false";
+  faceCentricParameter[ "fem.localdg.facecentric" ] = "true";
+
+  int errors = 0;
+
+  // reference: element-wise evaluation
+  PassType elementWise( model, startPass, space, -1, -1, true, Dune::Fem::parameterReader( elementWiseParameter ) );
+  DiscreteFunctionType reference( "reference", space );
+  elementWise( uh, reference );
+
+  // face-centric evaluation (face list covering all elements)
+  PassType faceCentric( model, startPass, space, -1, -1, true, Dune::Fem::parameterReader( faceCentricParameter ) );
+  if( !faceCentric.faceCentric() )
+    DUNE_THROW( Dune::InvalidStateException, "LocalDGPass does not use the face-centric mode." );
+  DiscreteFunctionType wh( "w", space );
+  for( int i = 0; i < 2; ++i )
+  {
+    faceCentric( uh, wh );
+    errors += Dune::Fem::compareInterior( reference, wh, "face-centric evaluation differs from the element-wise result" );
+  }
+
+  const double dtRef = elementWise.timeStepEstimate(), dt = faceCentric.timeStepEstimate();
+  if( std::abs( dt - dtRef ) > 1e-10*dtRef )
+  {
+    std::cerr << "Error: face-centric time step estimate " << dt << " differs from " << dtRef << "." << std::endl;
+    ++errors;
+  }
+
+  // face-centric evaluation as thread pass: the first application evaluates
+  // the faces while visiting the elements, the following ones use a face
+  // list restricted to the visited elements
+  PassType threadPass( model, startPass, space, -1, -1, false, Dune::Fem::parameterReader( faceCentricParameter ) );
+  for( int i = 0; i < 2; ++i )
+  {
+    // thread passes neither clear nor communicate the destination
+    wh.clear();
+    threadPass( uh, wh );
+    errors += Dune::Fem::compareInterior( reference, wh, "face-centric thread pass (application " + std::to_string( i ) + ") differs from the element-wise result" );
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,112 @@
+#include <config.h>
+
+#include <array>
+#include <bitset>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/pass/common/pass.hh>
+#include <dune/fem/pass/localdg/pass.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+#include "advectionmodel.hh"
+
+typedef Dune::YaspGrid< 2 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+enum { u, first, second };
+
+typedef Dune::Fem::StartPass< DiscreteFunctionType, u > StartPassType;
+typedef Dune::Fem::AdvectionModel< DiscreteFunctionSpaceType, u > FirstModelType;
+typedef Dune::Fem::LocalDGPass< FirstModelType, StartPassType, first > FirstPassType;
+typedef Dune::Fem::AdvectionModel< DiscreteFunctionSpaceType, first > SecondModelType;
+typedef Dune::Fem::LocalDGPass< SecondModelType, FirstPassType, second > SecondPassType;
+
+static_assert( SecondPassType::fusable, "Consecutive LocalDGPasses on the same grid part must be fusable." );
+
+
+// apply the two-pass chain with and without fusion and compare the results
+int check ( const DiscreteFunctionType &uh, const Dune::ParameterTree &parameter, const std::string &name )
+{
+  Dune::FieldVector< double, 2 > velocity1, velocity2;
+  velocity1[ 0 ] = 1.0;
+  velocity1[ 1 ] = 0.25;
+  velocity2[ 0 ] = -0.5;
+  velocity2[ 1 ] = 1.0;
+  FirstModelType firstModel( velocity1 );
+  SecondModelType secondModel( velocity2, 0.1 );
+
+  const DiscreteFunctionSpaceType &space = uh.space();
+  StartPassType startPass;
+  FirstPassType firstPass( firstModel, startPass, space, -1, -1, true, Dune::Fem::parameterReader( parameter ) );
+  SecondPassType secondPass( secondModel, firstPass, space, -1, -1, true, Dune::Fem::parameterReader( parameter ) );
+
+  DiscreteFunctionType reference( "reference", space ), wh( "w", space );
+  secondPass.fuseWithPrevious( false );
+  secondPass( uh, reference );
+
+  secondPass.fuseWithPrevious( true );
+  // a face-centric pass reads the whole argument in prepare and is never fused
+  if( secondPass.fusedWithPrevious() == secondPass.faceCentric() )
+  {
+    std::cerr << "Error: wrong fusion state (" << name << ")." << std::endl;
+    return 1;
+  }
+
+  // apply twice to check the reuse of the internal data
+  int errors = 0;
+  for( int i = 0; i < 2; ++i )
+  {
+    secondPass( uh, wh );
+    errors += Dune::Fem::compareInterior( reference, wh, "fused result differs from the unfused one (" + name + ")" );
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  // in parallel runs, the elements next to overlap elements are computed after the communication
+  const Dune::FieldVector< double, 2 > upper( 1.0 );
+  const std::array< int, 2 > cells = {{ 16, 16 }};
+  GridType grid( upper, cells, std::bitset< 2 >(), 1 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  DiscreteFunctionType uh( "u", space );
+  // some non-smooth initial data
+  Dune::Fem::fillNonSmooth( uh, 4.0, 9.0, 0.5 );
+  space.communicate( uh );
+
+  Dune::ParameterTree elementWise, faceCentric;
+  elementWise[ "fem.localdg.facecentric" ] = "false";
+  faceCentric[ "fem.localdg.facecentric" ] = "true";
+
+  int errors = 0;
+  errors += check( uh, elementWise, "element-wise" );
+  errors += check( uh, faceCentric, "face-centric" );
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
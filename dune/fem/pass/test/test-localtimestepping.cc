@@ -0,0 +1,209 @@
+#include <config.h>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/operator/common/spaceoperatorif.hh>
+#include <dune/fem/pass/common/pass.hh>
+#include <dune/fem/pass/localdg/pass.hh>
+#include <dune/fem/solver/localtimestepclasses.hh>
+#include <dune/fem/solver/rungekutta/localtimestepping.hh>
+#include <dune/fem/solver/timeprovider.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+#include "advectionmodel.hh"
+
+typedef Dune::YaspGrid< 2 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 2 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+enum { u, advection };
+
+typedef Dune::Fem::StartPass< DiscreteFunctionType, u > StartPassType;
+typedef Dune::Fem::AdvectionModel< DiscreteFunctionSpaceType, u > ModelType;
+typedef Dune::Fem::LocalDGPass< ModelType, StartPassType, advection > PassType;
+
+struct InitialData
+  : public Dune::Fem::Function< FunctionSpaceType, InitialData >
+{
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &v ) const
+  {
+    v[ 0 ] = std::sin( 2.0*M_PI*x[ 0 ] ) * std::cos( M_PI*x[ 1 ] );
+    v[ 1 ] = x[ 0 ]*x[ 1 ];
+  }
+};
+
+// assignment of elements to time step classes and the sub step schedule
+int checkClasses ()
+{
+  Dune::ParameterTree parameter;
+  parameter[ "fem.ode.lts.maxlevel" ] = "4";
+  Dune::Fem::LocalTimeStepClasses classes( Dune::Fem::parameterReader( parameter ) );
+
+  // element 3 is marked to take the finest step, element 5 has no estimate
+  classes.resize( 6 );
+  const double estimates[] = { 1.0, 2.5, 4.1, 3.0, 100.0 };
+  for( int i = 0; i < 5; ++i )
+    classes.provideEstimate( i, estimates[ i ] );
+  classes.provideEstimate( 1, 2.2 );
+  classes.setFinest( 3 );
+  classes.computeClasses( Dune::Fem::MPIManager::comm() );
+
+  int errors = 0;
+  const int expected[] = { 0, 1, 2, 0, 4, 4 };
+  for( int i = 0; i < 6; ++i )
+  {
+    if( classes.elementClass( i ) != expected[ i ] )
+    {
+      std::cerr << "Error: element " << i << " assigned to class " << classes.elementClass( i )
+                << " instead of " << expected[ i ] << "." << std::endl;
+      ++errors;
+    }
+  }
+
+  if( (classes.level() != 4) || (classes.subSteps() != 16) || (classes.minTimeStepEstimate() != 1.0) || (classes.timeStepEstimate() != 16.0) )
+  {
+    std::cerr << "Error: wrong number of levels or macro time step estimate." << std::endl;
+    ++errors;
+  }
+
+  // in sub step 4 the classes 0, 1 and 2 are active, only class 0 completes its step
+  classes.beginSubStep( 4, 0.5 );
+  const bool active[] = { true, true, true, true, false, false };
+  const bool completes[] = { true, false, false, true, false, false };
+  for( int i = 0; i < 6; ++i )
+  {
+    if( (classes.active( i ) != active[ i ]) || (classes.completes( i, 4 ) != completes[ i ]) )
+    {
+      std::cerr << "Error: wrong schedule for element " << i << " in sub step 4." << std::endl;
+      ++errors;
+    }
+  }
+  if( (classes.weight( 2 ) != 2.0) || (classes.weight( 1, 4 ) != 1.0) )
+  {
+    std::cerr << "Error: wrong time step weights in sub step 4." << std::endl;
+    ++errors;
+  }
+  classes.disable();
+  if( !classes.active( 5 ) || (classes.weight( 5 ) != 1.0) )
+  {
+    std::cerr << "Error: elements have to be active and unweighted without sub stepping." << std::endl;
+    ++errors;
+  }
+
+  // the marks are cleared with the estimates
+  classes.resetEstimates();
+  classes.provideEstimate( 3, 16.0 );
+  classes.computeClasses( Dune::Fem::MPIManager::comm() );
+  if( classes.elementClass( 3 ) != 0 || classes.level() != 0 )
+  {
+    std::cerr << "Error: a single estimate has to result in a single class." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  int errors = checkClasses();
+
+  const Dune::FieldVector< double, 2 > upper( 1.0 );
+  const std::array< int, 2 > cells = {{ 16, 16 }};
+  GridType grid( upper, cells, std::bitset< 2 >(), 1 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  DiscreteFunctionType uh( "u", space ), reference( "reference", space ), update( "update", space );
+  interpolate( gridFunctionAdapter( InitialData(), gridPart, 2 ), uh );
+  reference.assign( uh );
+
+  Dune::FieldVector< double, 2 > velocity;
+  velocity[ 0 ] = 1.0;
+  velocity[ 1 ] = -0.5;
+  ModelType model( velocity );
+  StartPassType startPass;
+
+  // reference: forward Euler with the global time step
+  PassType globalPass( model, startPass, space );
+
+  // local time stepping: on a uniform mesh all elements belong to class 0
+  Dune::Fem::LocalTimeStepClasses classes;
+  PassType *localPass = new PassType( model, startPass, space );
+  localPass->setLocalTimeStepping( classes );
+  Dune::Fem::SpaceOperatorWrapper< PassType > op( localPass );
+
+  Dune::Fem::TimeProvider<> tp( 0.0, gridPart.comm() );
+  DuneODE::LocalTimeSteppingEulerSolver< DiscreteFunctionType > solver( op, tp, classes );
+  solver.initialize( uh );
+  tp.init();
+
+  if( classes.level() != 0 )
+  {
+    std::cerr << "Error: " << classes.level() << " levels on a uniform mesh." << std::endl;
+    ++errors;
+  }
+
+  for( int step = 0; step < 3; ++step )
+  {
+    const double dt = tp.deltaT();
+
+    globalPass.setTime( tp.time() );
+    globalPass( reference, update );
+    const double dtGlobal = globalPass.timeStepEstimate();
+    reference.axpy( dt, update );
+
+    solver.solve( uh );
+
+    // both use the same time step estimate
+    if( std::abs( dt - dtGlobal ) > 1e-12*dtGlobal )
+    {
+      std::cerr << "Error: local time stepping used the step " << dt << " instead of " << dtGlobal << "." << std::endl;
+      ++errors;
+    }
+
+    double error = 0;
+    for( std::size_t i = 0; i < std::size_t( uh.size() ); ++i )
+      error = std::max( error, std::abs( uh.leakPointer()[ i ] - reference.leakPointer()[ i ] ) );
+    if( error > 1e-10 )
+    {
+      std::cerr << "Error: local time stepping differs from forward Euler in step " << step << " (error = " << error << ")." << std::endl;
+      ++errors;
+    }
+
+    tp.next();
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,220 @@
+#ifndef DUNE_FEM_SOLVER_LOCALTIMESTEPCLASSES_HH
+#define DUNE_FEM_SOLVER_LOCALTIMESTEPCLASSES_HH
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <dune/fem/io/parameter.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // LocalTimeStepClasses
+    // --------------------
+
+    /** \class   LocalTimeStepClasses
+     *  \ingroup ODESolver
+     *  \brief   assignment of elements to power-of-two time step classes
+     *
+     *  Elements are identified by their codim 0 index. The spatial
+     *  discretization (e.g. LocalDGPass) reports element-wise time step
+     *  estimates \f$\Delta t_E\f$ and element \f$E\f$ is assigned to the class
+     *  \f[ k_E = \min\Bigl( K, \Bigl\lfloor \log_2 \frac{\Delta t_E}{\Delta t_{\min}} \Bigr\rfloor \Bigr). \f]
+     *  The number of levels \f$K\f$ is bounded by the parameter
+     *  <b>fem.ode.lts.maxlevel</b> (default 4). Elements marked by setFinest,
+     *  e.g., elements bordering another process, are assigned to class 0.
+     *
+     *  A macro step \f$\Delta t = 2^K \Delta t_0\f$ is split into \f$2^K\f$
+     *  sub steps. In sub step \f$s\f$ all classes \f$k\f$ with
+     *  \f$s \bmod 2^k = 0\f$ are active and an element of class \f$k\f$
+     *  completes its step of size \f$2^k \Delta t_0\f$ at the end of sub step
+     *  \f$s\f$ if \f$(s+1) \bmod 2^k = 0\f$.
+     *
+     *  \note The object is shared between the ODE solver, which controls the
+     *        sub steps, and the operator, which provides the estimates and
+     *        weights its contributions accordingly.
+     */
+    class LocalTimeStepClasses
+    {
+      typedef LocalTimeStepClasses ThisType;
+
+    public:
+      explicit LocalTimeStepClasses ( const ParameterReader &parameter = Parameter::container() )
+        : maxLevel_( std::max( 0, parameter.getValue< int >( "fem.ode.lts.maxlevel", 4 ) ) )
+      {}
+
+      LocalTimeStepClasses ( const ThisType & ) = delete;
+      ThisType &operator= ( const ThisType & ) = delete;
+
+      /** \name methods used by the spatial discretization
+       *  \{
+       */
+
+      //! adjust size to the number of elements, new elements get class 0
+      void resize ( std::size_t size )
+      {
+        estimates_.resize( size, std::numeric_limits< double >::max() );
+        classes_.resize( size, 0 );
+        finest_.resize( size, 0 );
+      }
+
+      //! reset time step estimates and marks of all elements
+      void resetEstimates ()
+      {
+        std::fill( estimates_.begin(), estimates_.end(), std::numeric_limits< double >::max() );
+        std::fill( finest_.begin(), finest_.end(), 0 );
+      }
+
+      //! reset time step estimate and mark of an element
+      void resetEstimate ( std::size_t index )
+      {
+        assert( index < estimates_.size() );
+        estimates_[ index ] = std::numeric_limits< double >::max();
+        finest_[ index ] = 0;
+      }
+
+      //! assign an element to class 0, regardless of its estimate
+      void setFinest ( std::size_t index )
+      {
+        assert( index < finest_.size() );
+        finest_[ index ] = 1;
+      }
+
+      //! provide time step estimate for an element
+      void provideEstimate ( std::size_t index, double dt )
+      {
+        assert( index < estimates_.size() );
+        estimates_[ index ] = std::min( estimates_[ index ], dt );
+      }
+
+      //! return true if sub stepping is in progress
+      bool enabled () const { return enabled_; }
+
+      //! return true if the element is updated in the current sub step
+      bool active ( std::size_t index ) const
+      {
+        return !enabled_ || (elementClass( index ) <= activeLevel_);
+      }
+
+      //! return weight (i.e. time step) for volume contributions of an element
+      double weight ( std::size_t index ) const
+      {
+        return enabled_ ? deltaT( elementClass( index ) ) : 1.0;
+      }
+
+      //! return weight (i.e. time step) for a face between two elements
+      double weight ( std::size_t inside, std::size_t outside ) const
+      {
+        return enabled_ ? deltaT( std::min( elementClass( inside ), elementClass( outside ) ) ) : 1.0;
+      }
+
+      /** \}
+       *  \name methods used by the ODE solver
+       *  \{
+       */
+
+      /** \brief compute classes from the element estimates (collective)
+       *
+       *  \param[in]  comm  communication of the grid part the elements belong to
+       */
+      template< class Communication >
+      void computeClasses ( const Communication &comm )
+      {
+        double minDt = std::numeric_limits< double >::max();
+        for( const double dt : estimates_ )
+          minDt = std::min( minDt, dt );
+        minDt_ = comm.min( minDt );
+
+        int level = 0;
+        for( std::size_t i = 0; i < estimates_.size(); ++i )
+        {
+          classes_[ i ] = maxLevel_;
+          if( estimates_[ i ] < std::numeric_limits< double >::max() )
+          {
+            const double ratio = estimates_[ i ] / minDt_;
+            classes_[ i ] = std::min( maxLevel_, static_cast< int >( std::floor( std::log2( ratio ) ) ) );
+            level = std::max( level, classes_[ i ] );
+          }
+        }
+        level_ = comm.max( level );
+
+        // elements without estimate use the coarsest step
+        for( std::size_t i = 0; i < classes_.size(); ++i )
+          classes_[ i ] = (finest_[ i ] ? 0 : std::min( classes_[ i ], level_ ));
+      }
+
+      //! number of levels, i.e., a macro step consists of 2^level() sub steps
+      int level () const { return level_; }
+
+      //! number of sub steps within one macro step
+      int subSteps () const { return 1 << level_; }
+
+      //! smallest element time step estimate
+      double minTimeStepEstimate () const { return minDt_; }
+
+      //! macro time step estimate
+      double timeStepEstimate () const
+      {
+        return (minDt_ < std::numeric_limits< double >::max()) ? minDt_ * subSteps() : minDt_;
+      }
+
+      //! start sub step with given number and smallest time step
+      void beginSubStep ( int subStep, double deltaT0 )
+      {
+        assert( (subStep >= 0) && (subStep < subSteps()) );
+        activeLevel_ = 0;
+        while( (activeLevel_ < level_) && ((subStep >> activeLevel_) & 1) == 0 )
+          ++activeLevel_;
+        deltaT0_ = deltaT0;
+        enabled_ = true;
+      }
+
+      //! return true if element completes its step at the end of given sub step
+      bool completes ( std::size_t index, int subStep ) const
+      {
+        return ((subStep + 1) % (1 << elementClass( index ))) == 0;
+      }
+
+      //! stop sub stepping, the operator works as usual again
+      void disable () { enabled_ = false; }
+
+      /** \} */
+
+      //! return class of an element
+      int elementClass ( std::size_t index ) const
+      {
+        assert( index < classes_.size() );
+        return classes_[ index ];
+      }
+
+      //! time step of class k in the current macro step
+      double deltaT ( int k ) const { return deltaT0_ * static_cast< double >( 1 << k ); }
+
+    protected:
+      const int maxLevel_;
+
+      std::vector< double > estimates_;
+      std::vector< int > classes_;
+      std::vector< char > finest_;
+
+      double minDt_ = std::numeric_limits< double >::max();
+      int level_ = 0;
+
+      int activeLevel_ = 0;
+      double deltaT0_ = 0.0;
+      bool enabled_ = false;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_SOLVER_LOCALTIMESTEPCLASSES_HH
@@ -4,16 +4,22 @@
 #include <cassert>
 #include <cmath>
 
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 
+#include <dune/common/exceptions.hh>
+#include <dune/common/typetraits.hh>
+
 #include <dune/fem/solver/parameter.hh>
 #include <dune/fem/io/parameter.hh>
 #include <dune/fem/operator/common/operator.hh>
 #include <dune/fem/operator/common/differentiableoperator.hh>
+#include <dune/fem/operator/common/automaticdifferenceoperator.hh>
 
 namespace Dune
 {
@@ -135,6 +141,46 @@ namespace Dune
 
 
 
+    namespace Impl
+    {
+
+      // SupportsPreconditioner
+      // ----------------------
+
+      // does the linear inverse operator provide bind( jacobian, preconditioner )?
+      template< class LInvOp, class JOp, class Precond, class = void >
+      struct SupportsPreconditioner
+        : std::false_type
+      {};
+
+      template< class LInvOp, class JOp, class Precond >
+      struct SupportsPreconditioner< LInvOp, JOp, Precond, void_t< decltype( std::declval< LInvOp & >().bind( std::declval< const JOp & >(), std::declval< const Precond & >() ) ) > >
+        : std::true_type
+      {};
+
+
+
+      // bindPreconditioner
+      // ------------------
+
+      // bind linear inverse operator together with a preconditioner
+      template< class LInvOp, class JOp, class Precond >
+      inline void bindPreconditioner ( LInvOp &jInv, const JOp &jOp, const Precond &p, std::true_type )
+      {
+        jInv.bind( jOp, p );
+      }
+
+      // unreachable: setPreconditioner does not compile for such linear inverse operators
+      template< class LInvOp, class JOp, class Precond >
+      inline void bindPreconditioner ( LInvOp &jInv, const JOp &jOp, const Precond &p, std::false_type )
+      {
+        jInv.bind( jOp );
+      }
+
+    } // namespace Impl
+
+
+
     // NewtonInverseOperator
     // ---------------------
 
@@ -174,6 +220,12 @@ namespace Dune
 
       typedef std::function< bool ( const RangeFunctionType &w, const RangeFunctionType &dw, double residualNorm ) > ErrorMeasureType;
 
+      //! type of (optional) preconditioner passed to the linear inverse operator
+      typedef Operator< DomainFunctionType, RangeFunctionType > PreconditionerType;
+
+      //! callback to update the preconditioner for the current Newton iterate
+      typedef std::function< void ( const RangeFunctionType &w ) > PreconditionerUpdateType;
+
       /** constructor
        *
        *  \param[in]  jInv       linear inverse operator (will be move constructed)
@@ -294,6 +346,35 @@ namespace Dune
 
       void setErrorMeasure ( ErrorMeasureType finished ) { finished_ = std::move( finished ); }
 
+      /** \brief set a preconditioner for the linear solves
+       *
+       *  This is mainly meant for Jacobian-free Newton-Krylov (JFNK) methods,
+       *  where the Jacobian is only available as an on-the-fly operator
+       *  (e.g., AutomaticDifferenceLinearOperator) and a cheap assembled
+       *  approximation can be used for preconditioning.
+       *
+       *  \param[in]  preconditioner  preconditioner to use (not copied)
+       *  \param[in]  update          callback invoked with the current iterate
+       *                              before each linear solve (optional)
+       *
+       *  \note The linear inverse operator has to provide
+       *        bind( jacobian, preconditioner ).
+       */
+      void setPreconditioner ( const PreconditionerType &preconditioner,
+                               PreconditionerUpdateType update = PreconditionerUpdateType() )
+      {
+        static_assert( Impl::SupportsPreconditioner< LinearInverseOperatorType, JacobianOperatorType, PreconditionerType >::value,
+                       "NewtonInverseOperator: linear inverse operator does not support external preconditioning" );
+        preconditioner_ = &preconditioner;
+        updatePreconditioner_ = std::move( update );
+      }
+
+      void unsetPreconditioner ()
+      {
+        preconditioner_ = nullptr;
+        updatePreconditioner_ = PreconditionerUpdateType();
+      }
+
       void bind ( const OperatorType &op ) { op_ = &op; }
 
       void unbind () { op_ = nullptr; }
@@ -392,9 +473,31 @@ namespace Dune
       mutable int stepCompleted_;
       NewtonParameter::LineSearchMethod lsMethod_;
       ErrorMeasureType finished_;
+
+      const PreconditionerType *preconditioner_ = nullptr;
+      PreconditionerUpdateType updatePreconditioner_;
     };
 
 
+
+    // JacobianFreeNewtonInverseOperator
+    // ---------------------------------
+
+    /** \brief Jacobian-free Newton-Krylov (JFNK) solver
+     *
+     *  The Jacobian is never assembled; the linear solver applies it through
+     *  finite differences of the operator (see AutomaticDifferenceLinearOperator
+     *  for the choice of the difference parameter). The operator to invert has
+     *  to be derived from AutomaticDifferenceOperator.
+     *
+     *  \tparam  DiscreteFunction  type of discrete function
+     *  \tparam  LInvOp            matrix-free linear inverse operator (e.g., KrylovInverseOperator)
+     */
+    template< class DiscreteFunction, class LInvOp >
+    using JacobianFreeNewtonInverseOperator
+      = NewtonInverseOperator< AutomaticDifferenceLinearOperator< DiscreteFunction >, LInvOp >;
+
+
     // Implementation of NewtonInverseOperator
     // ---------------------------------------
 
@@ -428,7 +531,14 @@ namespace Dune
         // David: With this factor, the tolerance of CGInverseOp is the absolute
         //        rather than the relative error
         //        (see also dune-fem/dune/fem/solver/krylovinverseoperators.hh)
-        jInv_.bind( jOp );
+        if( preconditioner_ )
+        {
+          if( updatePreconditioner_ )
+            updatePreconditioner_( w );
+          Impl::bindPreconditioner( jInv_, jOp, *preconditioner_, Impl::SupportsPreconditioner< LinearInverseOperatorType, JacobianOperatorType, PreconditionerType >() );
+        }
+        else
+          jInv_.bind( jOp );
         jInv_.setMaxIterations( maxLinearIterations_ - linearIterations_ );
 
         dw.clear();
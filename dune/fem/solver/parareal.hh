@@ -0,0 +1,361 @@
+#ifndef DUNE_FEM_SOLVER_PARAREAL_HH
+#define DUNE_FEM_SOLVER_PARAREAL_HH
+
+//- system includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+//- Dune includes
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/io/streams/standardstreams.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/solver/odesolverinterface.hh>
+#include <dune/fem/solver/timeprovider.hh>
+
+namespace DuneODE
+{
+
+  /** \addtogroup ODESolver
+   *  \{
+   */
+
+  // PararealCommunicators
+  // ---------------------
+
+  /** \brief split of the world communicator into space and time communicators
+   *
+   *  The ranks of MPIManager::comm() are grouped into blocks of
+   *  \c spaceSize consecutive ranks. Each block forms a space communicator
+   *  (on which the grid of one time slice has to be created) and ranks with
+   *  the same position within their block form a time communicator.
+   *
+   *  \note The world size has to be a multiple of \c spaceSize.
+   */
+  struct PararealCommunicators
+  {
+    typedef Dune::MPIHelper::MPICommunicator MPICommunicatorType;
+
+    explicit PararealCommunicators ( int spaceSize )
+      : space_( Dune::MPIHelper::getCommunicator() ),
+        time_( Dune::MPIHelper::getCommunicator() )
+    {
+      const int rank = Dune::Fem::MPIManager::rank();
+      const int size = Dune::Fem::MPIManager::size();
+      if( (spaceSize <= 0) || (size % spaceSize != 0) )
+        DUNE_THROW( Dune::InvalidStateException, "PararealCommunicators: number of ranks (" << size << ") is not a multiple of the space size (" << spaceSize << ")." );
+
+#if HAVE_MPI
+      MPI_Comm_split( Dune::MPIHelper::getCommunicator(), rank / spaceSize, rank, &space_ );
+      MPI_Comm_split( Dune::MPIHelper::getCommunicator(), rank % spaceSize, rank, &time_ );
+#else // #if HAVE_MPI
+      assert( (rank == 0) && (size == 1) );
+#endif // #else // #if HAVE_MPI
+    }
+
+    PararealCommunicators ( const PararealCommunicators & ) = delete;
+    PararealCommunicators &operator= ( const PararealCommunicators & ) = delete;
+
+    ~PararealCommunicators ()
+    {
+#if HAVE_MPI
+      MPI_Comm_free( &space_ );
+      MPI_Comm_free( &time_ );
+#endif // #if HAVE_MPI
+    }
+
+    //! communicator of the spatial partition of one time slice
+    MPICommunicatorType space () const { return space_; }
+
+    //! communicator connecting the time slices
+    MPICommunicatorType time () const { return time_; }
+
+  protected:
+    MPICommunicatorType space_, time_;
+  };
+
+
+
+  // PararealSolver
+  // --------------
+
+  /** \brief Parareal driver for parallel in time integration
+   *
+   *  The time interval \f$[t_0, T]\f$ is split into \f$P\f$ slices, one for
+   *  each rank of the time communicator. Slice \f$p\f$ is integrated by a
+   *  coarse propagator \f$G\f$ and a fine propagator \f$F\f$, both given by
+   *  an OdeSolverInterface together with the TimeProvider it uses, and the
+   *  start values \f$\lambda_p\f$ are corrected by
+   *  \f[ \lambda_{p+1}^{k+1} = G( \lambda_p^{k+1} ) + F( \lambda_p^k ) - G( \lambda_p^k ). \f]
+   *  While the fine propagators run concurrently, the (cheap) coarse
+   *  correction is pipelined through the time slices. States are exchanged
+   *  between neighboring slices by serializing the discrete function into a
+   *  Dune::Fem::StandardOutStream.
+   *
+   *  The following parameters are used:
+   *  - <b>fem.ode.parareal.coarsesteps</b> number of coarse steps per slice (default 1)
+   *  - <b>fem.ode.parareal.finesteps</b> number of fine steps per slice (default 10)
+   *  - <b>fem.ode.parareal.iterations</b> maximal number of iterations (default: number of slices)
+   *  - <b>fem.ode.parareal.tolerance</b> tolerance for the maximal change of the start values (default 1e-8)
+   *
+   *  \note Both propagators are run with fixed time steps, i.e., they must not
+   *        invalidate or choose their time steps themselves. The discrete
+   *        functions of all slices have to be distributed identically, which
+   *        holds if every slice creates the same grid on a space communicator
+   *        of PararealCommunicators.
+   *
+   *  \note The time providers of both propagators have to be constructed on
+   *        the space communicator, e.g.,
+   *        \code
+   *        Dune::CollectiveCommunication< MPI_Comm > spaceComm( comms.space() );
+   *        Dune::Fem::TimeProvider< Dune::CollectiveCommunication< MPI_Comm > > coarseTp( spaceComm );
+   *        \endcode
+   *        Their time step reduction is collective; on the world communicator
+   *        it would deadlock the pipelined coarse sweep. The constructor checks
+   *        this.
+   */
+  template< class DestinationImp,
+            class CollectiveCommunication = typename Dune::Fem::MPIManager::CollectiveCommunication >
+  class PararealSolver
+  {
+    typedef PararealSolver< DestinationImp, CollectiveCommunication > ThisType;
+
+  public:
+    typedef DestinationImp DestinationType;
+    typedef OdeSolverInterface< DestinationType > OdeSolverType;
+    typedef Dune::Fem::TimeProvider< CollectiveCommunication > TimeProviderType;
+
+    typedef typename OdeSolverType::MonitorType MonitorType;
+
+    typedef Dune::MPIHelper::MPICommunicator MPICommunicatorType;
+    typedef Dune::CollectiveCommunication< MPICommunicatorType > TimeCommunicationType;
+
+    /** \brief constructor
+     *
+     *  \param[in]  coarse      coarse ODE solver
+     *  \param[in]  coarseTp    time provider used by the coarse solver
+     *  \param[in]  fine        fine ODE solver
+     *  \param[in]  fineTp      time provider used by the fine solver
+     *  \param[in]  timeComm    communicator connecting the time slices
+     *  \param[in]  parameter   parameter reader
+     */
+    PararealSolver ( OdeSolverType &coarse, TimeProviderType &coarseTp,
+                     OdeSolverType &fine, TimeProviderType &fineTp,
+                     MPICommunicatorType timeComm,
+                     const Dune::Fem::ParameterReader &parameter = Dune::Fem::Parameter::container() )
+      : coarse_( coarse ), coarseTp_( coarseTp ),
+        fine_( fine ), fineTp_( fineTp ),
+        mpiComm_( timeComm ), timeComm_( timeComm ),
+        coarseSteps_( parameter.getValidValue< int >( "fem.ode.parareal.coarsesteps", 1, [] ( int n ) { return n > 0; } ) ),
+        fineSteps_( parameter.getValidValue< int >( "fem.ode.parareal.finesteps", 10, [] ( int n ) { return n > 0; } ) ),
+        maxIterations_( parameter.getValidValue< int >( "fem.ode.parareal.iterations", timeComm_.size(), [] ( int n ) { return n >= 0; } ) ),
+        tolerance_( parameter.getValue< double >( "fem.ode.parareal.tolerance", 1e-8 ) ),
+        verbose_( parameter.verbose() ),
+        iterations_( 0 )
+    {
+      checkTimeProvider( coarseTp_, "coarse" );
+      checkTimeProvider( fineTp_, "fine" );
+    }
+
+    PararealSolver ( const ThisType & ) = delete;
+    ThisType &operator= ( const ThisType & ) = delete;
+
+    /** \brief integrate from startTime to endTime
+     *
+     *  \param[in]     startTime  start of the time interval
+     *  \param[in]     endTime    end of the time interval
+     *  \param[inout]  u          on entry the initial value (only used on the
+     *                            first slice), on exit the solution at the end
+     *                            of the slice owned by this rank
+     */
+    void solve ( double startTime, double endTime, DestinationType &u )
+    {
+      const int slice = timeComm_.rank();
+      const int slices = timeComm_.size();
+
+      const double sliceLength = (endTime - startTime) / slices;
+      sliceStart_ = startTime + slice * sliceLength;
+      sliceEnd_ = (slice+1 < slices ? startTime + (slice+1) * sliceLength : endTime);
+
+      DestinationType lambda( "parareal.lambda", u.space() );
+      DestinationType gOld( "parareal.gold", u.space() );
+      DestinationType fOld( "parareal.fold", u.space() );
+      DestinationType tmp( "parareal.tmp", u.space() );
+
+      // initial coarse prediction
+      if( slice == 0 )
+        lambda.assign( u );
+      else
+        receive( slice-1, lambda );
+
+      propagate( coarse_, coarseTp_, coarseSteps_, lambda, gOld );
+      if( slice+1 < slices )
+        send( slice+1, gOld );
+      u.assign( gOld );
+
+      // the first k slices are exact after k iterations
+      iterations_ = 0;
+      for( ; iterations_ < std::min( maxIterations_, slices ); ++iterations_ )
+      {
+        // fine propagation of the current start values (concurrently)
+        propagate( fine_, fineTp_, fineSteps_, lambda, fOld );
+
+        // pipelined coarse correction
+        if( slice > 0 )
+          receive( slice-1, lambda );
+
+        propagate( coarse_, coarseTp_, coarseSteps_, lambda, tmp );
+        gOld -= tmp;
+        fOld -= gOld;
+        gOld.assign( tmp );
+
+        // fOld now holds the new value at the end of this slice
+        tmp.assign( fOld );
+        tmp -= u;
+        const double localChange = std::sqrt( tmp.normSquaredDofs() );
+        u.assign( fOld );
+
+        // send before the reduction, the next slice is waiting for it
+        if( slice+1 < slices )
+          send( slice+1, u );
+
+        const double change = timeComm_.max( localChange );
+
+        if( verbose_ )
+          std::cout << "Parareal iteration " << iterations_ << ": change = " << change << std::endl;
+
+        if( change <= tolerance_ )
+        {
+          ++iterations_;
+          break;
+        }
+      }
+    }
+
+    //! number of iterations performed in the last call to solve
+    int iterations () const { return iterations_; }
+
+    //! start of the time slice owned by this rank
+    double sliceStartTime () const { return sliceStart_; }
+
+    //! end of the time slice owned by this rank
+    double sliceEndTime () const { return sliceEnd_; }
+
+    void description ( std::ostream &out ) const
+    {
+      out << "Parareal, slices: " << timeComm_.size() << ", coarse: ";
+      coarse_.description( out );
+      out << ", fine: ";
+      fine_.description( out );
+    }
+
+  protected:
+    // the time provider must not couple different time slices (collective on all ranks)
+    void checkTimeProvider ( const TimeProviderType &tp, const char *name ) const
+    {
+      const int slice = timeComm_.rank();
+      const int minSlice = tp.comm().min( slice );
+      const int maxSlice = tp.comm().max( slice );
+      if( (minSlice != slice) || (maxSlice != slice) )
+        DUNE_THROW( Dune::InvalidStateException, "PararealSolver: " << name << " time provider has to use the space communicator." );
+    }
+
+    // integrate the slice with the given solver starting from u0
+    void propagate ( OdeSolverType &solver, TimeProviderType &tp, int steps,
+                     const DestinationType &u0, DestinationType &u )
+    {
+      const double dt = (sliceEnd_ - sliceStart_) / steps;
+
+      u.assign( u0 );
+      tp.restore( sliceStart_, 0 );
+      tp.init( dt / tp.factor() );
+      solver.initialize( u );
+
+      MonitorType monitor;
+      for( int i = 0; i < steps; ++i )
+      {
+        solver.solve( u, monitor );
+        if( !tp.timeStepValid() )
+          DUNE_THROW( Dune::InvalidStateException, "PararealSolver: ODE solver rejected a fixed time step." );
+        tp.next( dt / tp.factor() );
+      }
+    }
+
+    void send ( int dest, const DestinationType &u ) const
+    {
+#if HAVE_MPI
+      std::ostringstream buffer;
+      Dune::Fem::StandardOutStream out( buffer );
+      u.write( out );
+      out.flush();
+
+      const std::string data = buffer.str();
+      unsigned long long size = data.size();
+      MPI_Send( &size, 1, MPI_UNSIGNED_LONG_LONG, dest, tag, mpiComm_ );
+      // MPI counts are int, so large states are sent in chunks
+      for( std::size_t pos = 0; pos < data.size(); pos += chunkSize )
+      {
+        const int count = static_cast< int >( std::min( data.size() - pos, std::size_t( chunkSize ) ) );
+        MPI_Send( const_cast< char * >( data.data() + pos ), count, MPI_CHAR, dest, tag, mpiComm_ );
+      }
+#else // #if HAVE_MPI
+      DUNE_THROW( Dune::InvalidStateException, "PararealSolver: sending states requires MPI." );
+#endif // #else // #if HAVE_MPI
+    }
+
+    void receive ( int source, DestinationType &u ) const
+    {
+#if HAVE_MPI
+      unsigned long long size = 0;
+      MPI_Recv( &size, 1, MPI_UNSIGNED_LONG_LONG, source, tag, mpiComm_, MPI_STATUS_IGNORE );
+
+      std::string data( static_cast< std::size_t >( size ), '\0' );
+      for( std::size_t pos = 0; pos < data.size(); pos += chunkSize )
+      {
+        const int count = static_cast< int >( std::min( data.size() - pos, std::size_t( chunkSize ) ) );
+        MPI_Recv( &data[ pos ], count, MPI_CHAR, source, tag, mpiComm_, MPI_STATUS_IGNORE );
+      }
+
+      std::istringstream buffer( data );
+      Dune::Fem::StandardInStream in( buffer );
+      u.read( in );
+#else // #if HAVE_MPI
+      DUNE_THROW( Dune::InvalidStateException, "PararealSolver: receiving states requires MPI." );
+#endif // #else // #if HAVE_MPI
+    }
+
+    static const int tag = 1217;
+    static const std::size_t chunkSize = std::size_t( 1 ) << 30;
+
+    OdeSolverType &coarse_;
+    TimeProviderType &coarseTp_;
+    OdeSolverType &fine_;
+    TimeProviderType &fineTp_;
+
+    MPICommunicatorType mpiComm_;
+    TimeCommunicationType timeComm_;
+
+    const int coarseSteps_;
+    const int fineSteps_;
+    const int maxIterations_;
+    const double tolerance_;
+    const bool verbose_;
+
+    double sliceStart_ = 0.0;
+    double sliceEnd_ = 0.0;
+    int iterations_;
+  };
+
+  /** \} **/
+
+} // namespace DuneODE
+
+#endif // #ifndef DUNE_FEM_SOLVER_PARAREAL_HH
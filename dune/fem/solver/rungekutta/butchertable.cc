@@ -96,6 +96,182 @@ namespace DuneODE
 
 
 
+  //////////////////////////////////////////////////////
+  //
+  //  Explicit Embedded Butcher Tables
+  //
+  //////////////////////////////////////////////////////
+
+  // heunEulerButcherTable (order 2(1))
+  // ----------------------------------
+
+  EmbeddedButcherTable< double > heunEulerButcherTable ()
+  {
+    static const double A[] = {0.0, 0.0,
+                               1.0, 0.0};
+    static const double b[] = {0.5, 0.5};
+    static const double bHat[] = {1.0, 0.0};
+    static const double c[] = {0.0, 1.0};
+
+    return EmbeddedButcherTable< double >( 2, 2, 1, A, b, c, bHat );
+  }
+
+
+  // bogackiShampineButcherTable (order 3(2))
+  // ----------------------------------------
+
+  // P. Bogacki, L.F. Shampine: A 3(2) pair of Runge-Kutta formulas (1989)
+  EmbeddedButcherTable< double > bogackiShampineButcherTable ()
+  {
+    static const double A[] = {0.0,   0.0,   0.0,   0.0,
+                               0.5,   0.0,   0.0,   0.0,
+                               0.0,   0.75,  0.0,   0.0,
+                               2./9., 1./3., 4./9., 0.0};
+    static const double b[] = {2./9., 1./3., 4./9., 0.0};
+    static const double bHat[] = {7./24., 0.25, 1./3., 0.125};
+    static const double c[] = {0.0, 0.5, 0.75, 1.0};
+
+    return EmbeddedButcherTable< double >( 4, 3, 2, A, b, c, bHat );
+  }
+
+
+  // dormandPrinceButcherTable (order 5(4))
+  // --------------------------------------
+
+  // J.R. Dormand, P.J. Prince: A family of embedded Runge-Kutta formulae (1980)
+  EmbeddedButcherTable< double > dormandPrinceButcherTable ()
+  {
+    static const double A[] =
+      {0.0,             0.0,             0.0,             0.0,          0.0,              0.0,       0.0,
+       1.0/5.0,         0.0,             0.0,             0.0,          0.0,              0.0,       0.0,
+       3.0/40.0,        9.0/40.0,        0.0,             0.0,          0.0,              0.0,       0.0,
+       44.0/45.0,       -56.0/15.0,      32.0/9.0,        0.0,          0.0,              0.0,       0.0,
+       19372.0/6561.0,  -25360.0/2187.0, 64448.0/6561.0,  -212.0/729.0, 0.0,              0.0,       0.0,
+       9017.0/3168.0,   -355.0/33.0,     46732.0/5247.0,  49.0/176.0,   -5103.0/18656.0,  0.0,       0.0,
+       35.0/384.0,      0.0,             500.0/1113.0,    125.0/192.0,  -2187.0/6784.0,   11.0/84.0, 0.0
+      };
+    static const double b[] =
+      {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0, 0.0};
+    static const double bHat[] =
+      {5179.0/57600.0, 0.0, 7571.0/16695.0, 393.0/640.0, -92097.0/339200.0, 187.0/2100.0, 1.0/40.0};
+    static const double c[] =
+      {0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0, 8.0/9.0, 1.0, 1.0};
+
+    return EmbeddedButcherTable< double >( 7, 5, 4, A, b, c, bHat );
+  }
+
+
+
+
+  //////////////////////////////////////////////////////
+  //
+  //  Explicit Low-Storage Butcher Tables
+  //
+  //////////////////////////////////////////////////////
+
+  // tvd2LowStorageButcherTable (Heun in Shu-Osher form)
+  // ---------------------------------------------------
+
+  LowStorageButcherTable< double > tvd2LowStorageButcherTable ()
+  {
+    static const double A[] = {1.0, 0.0, 1.0, 1.0, 0.0,
+                               0.5, 0.5, 0.5, 1.0, 0.0};
+    static const double c[] = {0.0, 1.0};
+
+    return LowStorageButcherTable< double >( LowStorageButcherTable< double >::ketcheson2S, 2, 2, A, c );
+  }
+
+
+  // tvd3LowStorageButcherTable (SSPRK(3,3) in Shu-Osher form)
+  // ---------------------------------------------------------
+
+  LowStorageButcherTable< double > tvd3LowStorageButcherTable ()
+  {
+    static const double A[] = {1.0,    0.0,    1.0,    1.0, 0.0,
+                               0.25,   0.75,   0.25,   1.0, 0.0,
+                               2./3.,  1./3.,  2./3.,  1.0, 0.0};
+    static const double c[] = {0.0, 1.0, 0.5};
+
+    return LowStorageButcherTable< double >( LowStorageButcherTable< double >::ketcheson2S, 3, 3, A, c );
+  }
+
+
+  // williamson3LowStorageButcherTable
+  // ---------------------------------
+
+  // J.H. Williamson: Low-storage Runge-Kutta schemes (1980)
+  LowStorageButcherTable< double > williamson3LowStorageButcherTable ()
+  {
+    static const double A[] = {0.0,          1./3.,   0.0, 0.0, 0.0,
+                               -5./9.,       15./16., 0.0, 0.0, 0.0,
+                               -153./128.,   8./15.,  0.0, 0.0, 0.0};
+    static const double c[] = {0.0, 1./3., 3./4.};
+
+    return LowStorageButcherTable< double >( LowStorageButcherTable< double >::williamson2N, 3, 3, A, c );
+  }
+
+
+  // carpenterKennedy4LowStorageButcherTable
+  // ---------------------------------------
+
+  // M.H. Carpenter, C.A. Kennedy: Fourth-order 2N-storage Runge-Kutta schemes (1994)
+  LowStorageButcherTable< double > carpenterKennedy4LowStorageButcherTable ()
+  {
+    static const double A[] =
+      {0.0,                                   1432997174477.0/9575080441755.0,  0.0, 0.0, 0.0,
+       -567301805773.0/1357537059087.0,       5161836677717.0/13612068292357.0, 0.0, 0.0, 0.0,
+       -2404267990393.0/2016746695238.0,      1720146321549.0/2090206949498.0,  0.0, 0.0, 0.0,
+       -3550918686646.0/2091501179385.0,      3134564353537.0/4481467310338.0,  0.0, 0.0, 0.0,
+       -1275806237668.0/842570457699.0,       2277821191437.0/14882151754819.0, 0.0, 0.0, 0.0};
+    static const double c[] =
+      {0.0, 1432997174477.0/9575080441755.0, 2526269341429.0/6820363962896.0,
+       2006345519317.0/3224310063776.0, 2802321613138.0/2924317926251.0};
+
+    return LowStorageButcherTable< double >( LowStorageButcherTable< double >::williamson2N, 5, 4, A, c );
+  }
+
+
+  // ssp43LowStorageButcherTable
+  // ---------------------------
+
+  // D.I. Ketcheson: Highly efficient strong stability preserving Runge-Kutta methods
+  // with low-storage implementations (2008), SSPRK(4,3) with SSP coefficient 2
+  LowStorageButcherTable< double > ssp43LowStorageButcherTable ()
+  {
+    static const double A[] = {1.0,   0.0,   0.5,   1.0, 0.0,
+                               1.0,   0.0,   0.5,   1.0, 0.0,
+                               1./3., 2./3., 1./6., 1.0, 0.0,
+                               1.0,   0.0,   0.5,   1.0, 0.0};
+    static const double c[] = {0.0, 0.5, 1.0, 0.5};
+
+    return LowStorageButcherTable< double >( LowStorageButcherTable< double >::ketcheson2S, 4, 3, A, c );
+  }
+
+
+  // ssp104LowStorageButcherTable
+  // ----------------------------
+
+  // D.I. Ketcheson: Highly efficient strong stability preserving Runge-Kutta methods
+  // with low-storage implementations (2008), SSPRK(10,4) with SSP coefficient 6
+  LowStorageButcherTable< double > ssp104LowStorageButcherTable ()
+  {
+    static const double A[] = {1.0,   0.0,   1./6.,  1.0,  0.0,
+                               1.0,   0.0,   1./6.,  1.0,  0.0,
+                               1.0,   0.0,   1./6.,  1.0,  0.0,
+                               1.0,   0.0,   1./6.,  1.0,  0.0,
+                               0.4,   0.6,   1./15., -0.5, 0.9,
+                               1.0,   0.0,   1./6.,  1.0,  0.0,
+                               1.0,   0.0,   1./6.,  1.0,  0.0,
+                               1.0,   0.0,   1./6.,  1.0,  0.0,
+                               1.0,   0.0,   1./6.,  1.0,  0.0,
+                               0.6,   1.0,   0.1,    1.0,  0.0};
+    static const double c[] = {0.0, 1./6., 1./3., 0.5, 2./3., 1./3., 0.5, 2./3., 5./6., 1.0};
+
+    return LowStorageButcherTable< double >( LowStorageButcherTable< double >::ketcheson2S, 10, 4, A, c );
+  }
+
+
+
   //////////////////////////////////////////////////////
   //
   //  Implicit Butcher Tables
@@ -54,6 +54,103 @@ namespace DuneODE
 
 
 
+  // EmbeddedButcherTable
+  // --------------------
+
+  /** \brief Butcher table of an embedded Runge-Kutta pair
+   *
+   *  In addition to the weights \f$b\f$ of the scheme of order order(),
+   *  the weights \f$\hat{b}\f$ of the embedded scheme of order
+   *  embeddedOrder() are provided. Their difference yields an estimate
+   *  for the local error.
+   */
+  template< class Field >
+  class EmbeddedButcherTable : public SimpleButcherTable< Field >
+  {
+    typedef EmbeddedButcherTable< Field > This;
+    typedef SimpleButcherTable< Field > Base;
+
+  public:
+    typedef Field FieldType;
+
+    EmbeddedButcherTable ( int stages, int order, int embeddedOrder, const FieldType *a, const FieldType *b, const FieldType *c, const FieldType *bHat )
+    : Base( stages, order, a, b, c ),
+      embeddedOrder_( embeddedOrder ),
+      bHat_( bHat )
+    {}
+
+    Dune::DynamicVector< FieldType > bHat () const { return Base::makeVector( stages_, bHat_ ); }
+
+    int embeddedOrder () const { return embeddedOrder_; }
+
+  private:
+    using Base::stages_;
+    int embeddedOrder_;
+    const FieldType *bHat_;
+  };
+
+
+
+  // LowStorageButcherTable
+  // ----------------------
+
+  /** \brief coefficients of an explicit low-storage Runge-Kutta scheme
+   *
+   *  Two formulations are supported; besides the solution \f$U\f$ and the
+   *  operator evaluation \f$L\f$ they need only one additional register
+   *  \f$S\f$. In stage \f$i\f$ the operator is evaluated at time
+   *  \f$t + c_i \Delta t\f$. The coefficients are stored row-wise in
+   *  \c coefficients, 5 entries per stage (unused entries are ignored).
+   *
+   *  - \b williamson2N (Williamson): \f$S = 0\f$ initially and
+   *    \f[ S = a_{i0} S + \Delta t L(U), \qquad U = U + a_{i1} S. \f]
+   *  - \b ketcheson2S (Shu-Osher type, cf. Ketcheson): \f$S = U^n\f$ initially and
+   *    \f[ U = a_{i0} U + a_{i1} S + a_{i2} \Delta t L(U), \qquad S = a_{i3} S + a_{i4} U. \f]
+   */
+  template< class Field >
+  class LowStorageButcherTable
+  {
+    typedef LowStorageButcherTable< Field > This;
+
+  public:
+    typedef Field FieldType;
+
+    enum Type { williamson2N, ketcheson2S };
+
+    static const int numCoefficients = 5;
+
+    LowStorageButcherTable ( Type type, int stages, int order, const FieldType *coefficients, const FieldType *c )
+    : type_( type ), stages_( stages ), order_( order ),
+      coefficients_( coefficients ), c_( c )
+    {}
+
+    Dune::DynamicMatrix< FieldType > coefficients () const
+    {
+      Dune::DynamicMatrix< FieldType > A( stages_, numCoefficients );
+      for( int i = 0; i < stages_; ++i )
+        std::copy( coefficients_ + i*numCoefficients, coefficients_ + (i+1)*numCoefficients, A[ i ].begin() );
+      return A;
+    }
+
+    Dune::DynamicVector< FieldType > c () const
+    {
+      Dune::DynamicVector< FieldType > v( stages_ );
+      std::copy( c_, c_ + stages_, v.begin() );
+      return v;
+    }
+
+    Type type () const { return type_; }
+    int order () const { return order_; }
+    int stages () const { return stages_; }
+
+  protected:
+    Type type_;
+    int stages_, order_;
+    const FieldType *coefficients_, *c_;
+  };
+
+
+
   // explicit butcher tables
   // -----------------------
   SimpleButcherTable< double > explicitEulerButcherTable ();
@@ -62,6 +159,23 @@ namespace DuneODE
   SimpleButcherTable< double > rk4ButcherTable ();
   SimpleButcherTable< double > expl6ButcherTable ();
 
+  // explicit embedded butcher tables
+  // --------------------------------
+
+  EmbeddedButcherTable< double > heunEulerButcherTable ();
+  EmbeddedButcherTable< double > bogackiShampineButcherTable ();
+  EmbeddedButcherTable< double > dormandPrinceButcherTable ();
+
+  // explicit low-storage butcher tables
+  // -----------------------------------
+
+  LowStorageButcherTable< double > tvd2LowStorageButcherTable ();
+  LowStorageButcherTable< double > tvd3LowStorageButcherTable ();
+  LowStorageButcherTable< double > williamson3LowStorageButcherTable ();
+  LowStorageButcherTable< double > carpenterKennedy4LowStorageButcherTable ();
+  LowStorageButcherTable< double > ssp43LowStorageButcherTable ();
+  LowStorageButcherTable< double > ssp104LowStorageButcherTable ();
+
   // implicit butcher tables
   // -----------------------
 
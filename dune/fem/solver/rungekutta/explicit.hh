@@ -2,17 +2,23 @@
 #define DUNE_FEM_SOLVER_RUNGEKUTTA_EXPLICIT_HH
 
 //- system includes
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <limits>
+#include <memory>
 #include <vector>
 #include <cassert>
 
 //- Dune includes
+#include <dune/fem/common/hybrid.hh>
 #include <dune/fem/io/parameter.hh>
 #include <dune/fem/operator/common/spaceoperatorif.hh>
+#include <dune/fem/space/common/slavedofs.hh>
 #include <dune/fem/solver/odesolverinterface.hh>
 #include <dune/fem/solver/timeprovider.hh>
 #include <dune/fem/solver/rungekutta/butchertable.hh>
+#include <dune/fem/solver/rungekutta/timestepcontrol.hh>
 
 namespace DuneODE
 {
@@ -72,6 +78,8 @@ namespace DuneODE
 
     using OdeSolverInterface<DestinationImp> :: solve ;
   protected:
+    typedef LowStorageButcherTable< double > LowStorageButcherTableType;
+
     SimpleButcherTable< double > defaultButcherTables( const int order ) const
     {
       switch( order )
@@ -89,6 +97,45 @@ namespace DuneODE
       }
     }
 
+    LowStorageButcherTableType defaultLowStorageButcherTables( const int order ) const
+    {
+      switch( order )
+      {
+        case 2: return tvd2LowStorageButcherTable();
+        case 3: return tvd3LowStorageButcherTable();
+        case 4: return carpenterKennedy4LowStorageButcherTable();
+
+        default:
+               std::cerr<< "Warning: low-storage ExplicitRungeKutta of order "<< order << " not implemented, using order 4!" << std::endl;
+               return carpenterKennedy4LowStorageButcherTable();
+      }
+    }
+
+    EmbeddedButcherTable< double > defaultEmbeddedButcherTables( const int order ) const
+    {
+      switch( order )
+      {
+        case 2: return heunEulerButcherTable();
+        case 3: return bogackiShampineButcherTable();
+        case 4:
+        case 5: return dormandPrinceButcherTable();
+
+        default:
+               std::cerr<< "Warning: embedded ExplicitRungeKutta of order "<< order << " not implemented, using order 5!" << std::endl;
+               return dormandPrinceButcherTable();
+      }
+    }
+
+    static bool useEmbedded ( const int order, const Dune::Fem::ParameterReader &parameter )
+    {
+      return (order > 1) && (order < 6) && parameter.getValue< bool >( "fem.ode.adaptive", false );
+    }
+
+    static bool useLowStorage ( const int order, const Dune::Fem::ParameterReader &parameter )
+    {
+      return (order > 1) && (order < 5) && parameter.getValue< bool >( "fem.ode.lowstorage", false );
+    }
+
   public:
     /** \brief constructor
       \param[in] op Operator \f$L\f$
@@ -100,25 +147,49 @@ namespace DuneODE
                              TimeProviderBase& tp,
                              const SimpleButcherTable< double >& butcherTable,
                              bool verbose )
-      : A_( butcherTable.A() ),
-        b_( butcherTable.b() ),
-        c_( butcherTable.c() ),
-        Upd(),
-        op_(op),
-        tp_(tp),
-        ord_( butcherTable.order() ),
-        stages_( butcherTable.stages() ),
-        initialized_(false)
+      : ExplicitRungeKuttaSolver( op, tp )
     {
-      assert(ord_>0);
+      setButcherTable( butcherTable );
+    }
 
-      // create update memory
-      for (int i=0; i<stages_; ++i)
-      {
-        Upd.emplace_back( new DestinationType("URK",op_.space()) );
-      }
-      Upd.emplace_back(new DestinationType("Ustep",op_.space()) );
+    /** \brief constructor for embedded schemes with adaptive step size control
+      \param[in] op Operator \f$L\f$
+      \param[in] tp TimeProvider
+      \param[in] bt embedded Butcher table defining the Runge-Kutta scheme
+      \param[in] verbose verbosity
+      \param[in] parameter parameter reader
 
+      \note The time step is chosen by a PIStepSizeControl; the operator's
+             time step estimate multiplied by <b>fem.ode.cflMax</b> (default:
+             1) and the factor of the TimeProvider bounds it. Rejected steps invalidate the time
+             step of the TimeProvider and leave the solution unchanged.
+    */
+    ExplicitRungeKuttaSolver(OperatorType& op,
+                             TimeProviderBase& tp,
+                             const EmbeddedButcherTable< double >& butcherTable,
+                             bool verbose,
+                             const Dune::Fem::ParameterReader &parameter = Dune::Fem::Parameter::container() )
+      : ExplicitRungeKuttaSolver( op, tp )
+    {
+      setButcherTable( butcherTable, parameter );
+    }
+
+    /** \brief constructor for low-storage schemes
+      \param[in] op Operator \f$L\f$
+      \param[in] tp TimeProvider
+      \param[in] bt low-storage Butcher table defining the Runge-Kutta scheme
+      \param[in] verbose verbosity
+
+      \note Independent of the number of stages only two additional
+             discrete functions are allocated.
+    */
+    ExplicitRungeKuttaSolver(OperatorType& op,
+                             TimeProviderBase& tp,
+                             const LowStorageButcherTableType& butcherTable,
+                             bool verbose )
+      : ExplicitRungeKuttaSolver( op, tp )
+    {
+      setButcherTable( butcherTable );
     }
 
     /** \brief constructor
@@ -135,12 +206,30 @@ namespace DuneODE
     {
     }
 
+    /** \brief constructor
+      \param[in] op Operator \f$L\f$
+      \param[in] tp TimeProvider
+      \param[in] pord polynomial order
+      \param[in] parameter parameter reader
+
+      \note If the parameter <b>fem.ode.adaptive</b> is set to true, an
+             embedded scheme with adaptive step size control is used for
+             orders 2 to 5. Otherwise, if <b>fem.ode.lowstorage</b> is set
+             to true, a low-storage scheme is used for orders 2 to 4.
+    */
     ExplicitRungeKuttaSolver(OperatorType& op,
                              TimeProviderBase& tp,
                              const int pord,
                              const Dune::Fem::ParameterReader &parameter = Dune::Fem::Parameter::container() )
-      : ExplicitRungeKuttaSolver( op, tp, pord, true )
-    {}
+      : ExplicitRungeKuttaSolver( op, tp )
+    {
+      if( useEmbedded( pord, parameter ) )
+        setButcherTable( defaultEmbeddedButcherTables( pord ), parameter );
+      else if( useLowStorage( pord, parameter ) )
+        setButcherTable( defaultLowStorageButcherTables( pord ) );
+      else
+        setButcherTable( defaultButcherTables( pord ) );
+    }
 
     //! apply operator once to get dt estimate
     void initialize(const DestinationType& U0)
@@ -176,28 +265,57 @@ namespace DuneODE
       // set new time
       op_.setTime( t );
 
+      // minimal operator estimate of this step
+      cflEstimate_ = std::numeric_limits< double >::max();
+
+      if( lowStorage_ )
+      {
+        solveLowStorage( U0, t, dt );
+        return;
+      }
+
       // Compute Steps
       op_(U0, *(Upd[0]));
 
       // provide operators time step estimate
-      tp_.provideTimeStepEstimate( op_.timeStepEstimate() );
+      provideTimeStepEstimate( op_.timeStepEstimate() );
 
+      // stage argument (the last entry of Upd is not used for a stage)
+      DestinationType& Ustep = *(Upd[stages_]);
       for (int i=1; i<stages_; ++i)
       {
-        (Upd[ord_])->assign(U0);
+        Ustep.assign(U0);
         for (int j=0; j<i ; ++j)
         {
-          (Upd[ord_])->axpy((A_[i][j]*dt), *(Upd[j]));
+          Ustep.axpy((A_[i][j]*dt), *(Upd[j]));
         }
 
         // set new time
         op_.setTime( t + c_[i]*dt );
 
         // apply operator
-        op_( *(Upd[ord_]), *(Upd[i]) );
+        op_( Ustep, *(Upd[i]) );
 
         // provide operators time step estimate
-        tp_.provideTimeStepEstimate( op_.timeStepEstimate() );
+        provideTimeStepEstimate( op_.timeStepEstimate() );
+      }
+
+      if( stepControl_ )
+      {
+        // estimate local error and compute next step size
+        monitor.error_ = errorEstimate( U0, dt );
+        double dtNew = dt;
+        const bool accepted = stepControl_->step( dt, monitor.error_, dtNew );
+        // the error controlled step is an upper bound, since the time provider
+        // scales estimates by its factor; the stability bound is scaled as usual
+        tp_.provideTimeStepUpperBound( dtNew );
+        tp_.provideTimeStepEstimate( cflMax_ * cflEstimate_ );
+        if( ! accepted )
+        {
+          // step is repeated with the new step size, U0 is left unchanged
+          tp_.invalidateTimeStep();
+          return;
+        }
       }
 
       // Perform Update
@@ -209,16 +327,168 @@ namespace DuneODE
 
     void description(std::ostream& out) const
     {
-      out << "ExplRungeKutta, steps: " << ord_
+      out << (lowStorage_ ? "LowStorageExplRungeKutta" : (stepControl_ ? "EmbeddedExplRungeKutta" : "ExplRungeKutta")) << ", steps: " << ord_
           //<< ", cfl: " << this->tp_.factor()
           << "\\\\" <<std::endl;
     }
 
   protected:
-    // Butcher table A,b,c
+    ExplicitRungeKuttaSolver(OperatorType& op,
+                             TimeProviderBase& tp )
+      : Upd(),
+        op_(op),
+        tp_(tp),
+        ord_( 0 ),
+        stages_( 0 ),
+        lowStorage_( false ),
+        lowStorageType_( LowStorageButcherTableType::williamson2N ),
+        initialized_(false)
+    {}
+
+    void setButcherTable ( const SimpleButcherTable< double >& butcherTable )
+    {
+      A_ = butcherTable.A();
+      b_ = butcherTable.b();
+      c_ = butcherTable.c();
+      ord_ = butcherTable.order();
+      stages_ = butcherTable.stages();
+      assert(ord_>0);
+
+      // create update memory
+      for (int i=0; i<stages_; ++i)
+      {
+        Upd.emplace_back( new DestinationType("URK",op_.space()) );
+      }
+      Upd.emplace_back(new DestinationType("Ustep",op_.space()) );
+    }
+
+    void setButcherTable ( const EmbeddedButcherTable< double >& butcherTable,
+                           const Dune::Fem::ParameterReader &parameter = Dune::Fem::Parameter::container() )
+    {
+      setButcherTable( static_cast< const SimpleButcherTable< double >& >( butcherTable ) );
+      bHat_ = butcherTable.bHat();
+      stepControl_.reset( new PIStepSizeControl( std::min( butcherTable.order(), butcherTable.embeddedOrder() ), parameter ) );
+      cflMax_ = parameter.getValue< double >( "fem.ode.cflMax", 1.0 );
+    }
+
+    void setButcherTable ( const LowStorageButcherTableType& butcherTable )
+    {
+      A_ = butcherTable.coefficients();
+      c_ = butcherTable.c();
+      ord_ = butcherTable.order();
+      stages_ = butcherTable.stages();
+      lowStorage_ = true;
+      lowStorageType_ = butcherTable.type();
+      assert(ord_>0);
+
+      // operator evaluation and one additional register
+      Upd.emplace_back( new DestinationType("URK",op_.space()) );
+      Upd.emplace_back( new DestinationType("Ustep",op_.space()) );
+    }
+
+    // with step size control the operator's estimate only bounds the step
+    void provideTimeStepEstimate ( const double estimate )
+    {
+      if( stepControl_ )
+        cflEstimate_ = std::min( cflEstimate_, estimate );
+      else
+        tp_.provideTimeStepEstimate( estimate );
+    }
+
+    // weighted RMS norm of the embedded error estimate (stored in Ustep)
+    double errorEstimate ( const DestinationType& U0, const double dt )
+    {
+      DestinationType& err = *(Upd[stages_]);
+      err.clear();
+      for (int j=0; j<stages_; ++j)
+      {
+        err.axpy( (b_[j] - bHat_[j])*dt, *(Upd[j]) );
+      }
+
+      const double absTol = stepControl_->absoluteTolerance();
+      const double relTol = stepControl_->relativeTolerance();
+
+      typedef typename DestinationType::DiscreteFunctionSpaceType::LocalBlockIndices LocalBlockIndices;
+
+      const auto& u = U0.dofVector();
+      const auto& e = err.dofVector();
+
+      // sum over all components of the master blocks
+      double sums[ 2 ] = { 0.0, 0.0 };
+      for( const auto i : masterDofs( U0.space().slaveDofs() ) )
+      {
+        Hybrid::forEach( LocalBlockIndices(), [ &u, &e, &sums, absTol, relTol, i ] ( auto &&j ) {
+            const double scaled = std::abs( e[ i ][ j ] ) / (absTol + relTol * std::abs( u[ i ][ j ] ));
+            sums[ 0 ] += scaled * scaled;
+            sums[ 1 ] += 1.0;
+          } );
+      }
+
+      // make sum global
+      U0.space().gridPart().comm().sum( sums, 2 );
+      return (sums[ 1 ] > 0) ? std::sqrt( sums[ 0 ] / sums[ 1 ] ) : 0.0;
+    }
+
+    // perform one time step of a low-storage scheme, each stage streams
+    // through the dof vectors only once after the operator evaluation
+    void solveLowStorage ( DestinationType& U0, const double t, const double dt )
+    {
+      DestinationType& L = *(Upd[0]);
+      DestinationType& S = *(Upd[1]);
+
+      if( lowStorageType_ == LowStorageButcherTableType::williamson2N )
+        S.clear();
+      else
+        S.assign( U0 );
+
+      for (int i=0; i<stages_; ++i)
+      {
+        // set new time
+        op_.setTime( t + c_[i]*dt );
+
+        // apply operator
+        op_( U0, L );
+
+        // provide operators time step estimate
+        tp_.provideTimeStepEstimate( op_.timeStepEstimate() );
+
+        const auto& a = A_[ i ];
+        auto uIt = U0.dbegin();
+        auto sIt = S.dbegin();
+        const auto uEnd = U0.dend();
+        auto lIt = L.dbegin();
+        if( lowStorageType_ == LowStorageButcherTableType::williamson2N )
+        {
+          const double a0 = a[ 0 ], a1 = a[ 1 ];
+          for( ; uIt != uEnd; ++uIt, ++sIt, ++lIt )
+          {
+            *sIt = a0 * (*sIt) + dt * (*lIt);
+            *uIt += a1 * (*sIt);
+          }
+        }
+        else
+        {
+          const double a0 = a[ 0 ], a1 = a[ 1 ], a2 = a[ 2 ]*dt, a3 = a[ 3 ], a4 = a[ 4 ];
+          for( ; uIt != uEnd; ++uIt, ++sIt, ++lIt )
+          {
+            *uIt = a0 * (*uIt) + a1 * (*sIt) + a2 * (*lIt);
+            *sIt = a3 * (*sIt) + a4 * (*uIt);
+          }
+        }
+      }
+    }
+
+    // Butcher table A,b,c (for low-storage schemes A holds the coefficients)
     Dune::DynamicMatrix< double > A_;
     Dune::DynamicVector< double > b_;
     Dune::DynamicVector< double > c_;
+    // weights of embedded scheme
+    Dune::DynamicVector< double > bHat_;
+
+    // step size control (only for embedded schemes)
+    std::unique_ptr< PIStepSizeControl > stepControl_;
+    double cflMax_ = 1.0;
+    double cflEstimate_ = std::numeric_limits< double >::max();
 
     // stages of Runge-Kutta solver
     std::vector< std::unique_ptr< DestinationType > > Upd;
@@ -229,9 +499,12 @@ namespace DuneODE
     TimeProviderBase& tp_;
 
     // order of RK solver
-    const int ord_;
+    int ord_;
     // number of stages
-    const int stages_;
+    int stages_;
+    // low-storage scheme and its formulation
+    bool lowStorage_;
+    typename LowStorageButcherTableType::Type lowStorageType_;
     // init flag
     bool initialized_;
   };
@@ -0,0 +1,184 @@
+#ifndef DUNE_FEM_SOLVER_RUNGEKUTTA_LOCALTIMESTEPPING_HH
+#define DUNE_FEM_SOLVER_RUNGEKUTTA_LOCALTIMESTEPPING_HH
+
+//- system includes
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+//- Dune includes
+#include <dune/common/exceptions.hh>
+
+#include <dune/fem/io/parameter.hh>
+#include <dune/fem/operator/common/spaceoperatorif.hh>
+#include <dune/fem/solver/localtimestepclasses.hh>
+#include <dune/fem/solver/odesolverinterface.hh>
+#include <dune/fem/solver/timeprovider.hh>
+
+namespace DuneODE
+{
+
+  /** \addtogroup ODESolver
+   *  \{
+   */
+
+  // LocalTimeSteppingEulerSolver
+  // ----------------------------
+
+  /** \brief explicit multirate (local time stepping) Euler scheme
+   *
+   *  The elements are grouped into power-of-two time step classes by a
+   *  Dune::Fem::LocalTimeStepClasses object and each class is advanced with
+   *  its own time step within one macro step of the Dune::Fem::TimeProvider.
+   *
+   *  The operator has to support local time stepping, i.e., while sub
+   *  stepping is enabled it has to
+   *  - recompute the update (already multiplied by the time step of the
+   *    class) only for active elements, leaving the destination unchanged for
+   *    all other elements,
+   *  - weight face contributions with the time step of the finer element
+   *    and add contributions to inactive neighbors (with the inverse mass
+   *    matrix applied) to their destination.
+   *  Then the fluxes over faces between different classes are accumulated on
+   *  the coarse side, which makes the scheme conservative. The
+   *  Dune::Fem::LocalDGPass does this after a call to setLocalTimeStepping.
+   *
+   *  If the sequence of the grid part changed (e.g., after adaptation), the
+   *  elements are regrouped at the beginning of the next macro step, whose
+   *  size has already been chosen by the TimeProvider. If the new classes
+   *  require a smaller step, the sub steps are repeated with a reduced
+   *  \f$\Delta t_0\f$, such that the time step bound holds.
+   *
+   *  \note The scheme is first order in time.
+   */
+  template< class DestinationImp >
+  class LocalTimeSteppingEulerSolver
+  : public OdeSolverInterface< DestinationImp >
+  {
+    typedef OdeSolverInterface< DestinationImp > BaseType;
+
+  public:
+    typedef DestinationImp DestinationType;
+    typedef Dune::Fem::SpaceOperatorInterface< DestinationImp > OperatorType;
+    typedef typename DestinationType::DiscreteFunctionSpaceType SpaceType;
+
+    typedef typename BaseType::MonitorType MonitorType;
+
+    typedef Dune::Fem::LocalTimeStepClasses LocalTimeStepClassesType;
+
+    using BaseType::solve;
+
+    /** \brief constructor
+      \param[in] op Operator \f$L\f$ supporting local time stepping
+      \param[in] tp TimeProvider
+      \param[in] classes time step classes shared with the operator
+    */
+    LocalTimeSteppingEulerSolver ( OperatorType &op,
+                                   Dune::Fem::TimeProviderBase &tp,
+                                   LocalTimeStepClassesType &classes )
+      : op_( op ),
+        tp_( tp ),
+        classes_( classes ),
+        update_( "LTS::update", op.space() ),
+        initialized_( false )
+    {}
+
+    //! apply operator once to get time step estimates
+    void initialize ( const DestinationType &U0 )
+    {
+      if( !initialized_ )
+      {
+        regroup( U0 );
+        initialized_ = true;
+
+        providedEstimate_ = classes_.timeStepEstimate();
+        tp_.provideTimeStepEstimate( providedEstimate_ );
+      }
+    }
+
+    //! perform one macro step
+    void solve ( DestinationType &U, MonitorType &monitor )
+    {
+      monitor.reset();
+
+      if( !initialized_ )
+        DUNE_THROW( Dune::InvalidStateException, "LocalTimeSteppingEulerSolver wasn't initialized before first call!" );
+
+      // the element indices changed, e.g., due to adaptation
+      if( sequence_ != op_.space().gridPart().sequence() )
+        regroup( U );
+
+      // the macro step was chosen for the estimate provided last; if the
+      // elements were regrouped since, the cycle of sub steps is repeated
+      // such that dt0 respects the new estimate
+      const double estimate = classes_.timeStepEstimate();
+      const int cycles = (estimate < providedEstimate_) ? static_cast< int >( std::ceil( providedEstimate_ / estimate ) ) : 1;
+
+      const double t = tp_.time();
+      const int subSteps = classes_.subSteps();
+      const double dt0 = tp_.deltaT() / (cycles * subSteps);
+
+      const auto &indexSet = op_.space().gridPart().indexSet();
+      for( int c = 0; c < cycles; ++c )
+      {
+        for( int s = 0; s < subSteps; ++s )
+        {
+          classes_.beginSubStep( s, dt0 );
+
+          op_.setTime( t + (c*subSteps + s)*dt0 );
+          op_( U, update_ );
+
+          // update all elements completing their step
+          for( const auto &entity : op_.space() )
+          {
+            if( classes_.completes( indexSet.index( entity ), s ) )
+            {
+              auto uLocal = U.localFunction( entity );
+              uLocal += update_.localFunction( entity );
+            }
+          }
+
+          // the next sub step reads ghost values of the elements updated in this one
+          U.communicate();
+        }
+      }
+      classes_.disable();
+
+      // regroup elements and provide the new macro time step
+      classes_.computeClasses( op_.space().gridPart().comm() );
+      sequence_ = op_.space().gridPart().sequence();
+      providedEstimate_ = classes_.timeStepEstimate();
+      tp_.provideTimeStepEstimate( providedEstimate_ );
+    }
+
+    void description ( std::ostream &out ) const
+    {
+      out << "LocalTimeSteppingEuler, levels: " << classes_.level() << "\\\\" << std::endl;
+    }
+
+  protected:
+    // compute element estimates by a full operator application and regroup the elements
+    void regroup ( const DestinationType &U )
+    {
+      classes_.disable();
+      op_.setTime( tp_.time() );
+      op_( U, update_ );
+      classes_.computeClasses( op_.space().gridPart().comm() );
+      sequence_ = op_.space().gridPart().sequence();
+    }
+
+    OperatorType &op_;
+    Dune::Fem::TimeProviderBase &tp_;
+    LocalTimeStepClassesType &classes_;
+
+    DestinationType update_;
+    bool initialized_;
+    int sequence_ = -1;
+    double providedEstimate_ = 0.0;
+  };
+
+  /** \} **/
+
+} // namespace DuneODE
+
+#endif // #ifndef DUNE_FEM_SOLVER_RUNGEKUTTA_LOCALTIMESTEPPING_HH
@@ -3,6 +3,8 @@
 
 //- system includes
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <memory>
 
 //- dune-common includes
@@ -402,6 +404,83 @@ namespace DuneODE
     double tol_;
   };
 
+
+
+  // PIStepSizeControl
+  // -----------------
+
+  /** \brief PI step size control for embedded Runge-Kutta pairs
+
+      The local error estimate is measured in the weighted RMS norm
+      \f[ \| e \| = \Bigl( \frac{1}{N} \sum_i \Bigl( \frac{e_i}{atol + rtol |u_i|} \Bigr)^2 \Bigr)^{1/2} \f]
+      and a step is accepted if \f$\| e \| \leq 1\f$. The new step size is
+      \f$\Delta t \cdot s \, \| e_n \|^{-\alpha} \| e_{n-1} \|^{\beta}\f$ with
+      \f$\alpha = 0.7 / (q+1)\f$, \f$\beta = 0.4 / (q+1)\f$, where \f$q\f$
+      denotes the lower order of the pair.
+
+      See also:
+        E. Hairer, G. Wanner. Solving Ordinary Differential Equations II, Section IV.2. Springer. 1996
+
+      Parameters: <b>fem.ode.abstol</b>, <b>fem.ode.reltol</b>, <b>fem.ode.safety</b>,
+      <b>fem.ode.minfactor</b>, <b>fem.ode.maxfactor</b>
+   */
+  class PIStepSizeControl
+  {
+    typedef PIStepSizeControl ThisType;
+
+  public:
+    explicit PIStepSizeControl ( int order, const Dune::Fem::ParameterReader &parameter = Dune::Fem::Parameter::container() )
+    : absTol_( parameter.getValue< double >( "fem.ode.abstol", 1e-6 ) ),
+      relTol_( parameter.getValue< double >( "fem.ode.reltol", 1e-4 ) ),
+      safety_( parameter.getValue< double >( "fem.ode.safety", 0.9 ) ),
+      minFactor_( parameter.getValue< double >( "fem.ode.minfactor", 0.2 ) ),
+      maxFactor_( parameter.getValue< double >( "fem.ode.maxfactor", 5.0 ) ),
+      exponent_( 1.0 / (order+1) ),
+      alpha_( 0.7 * exponent_ ),
+      beta_( 0.4 * exponent_ ),
+      errorOld_( 1e-4 )
+    {}
+
+    double absoluteTolerance () const { return absTol_; }
+    double relativeTolerance () const { return relTol_; }
+
+    /** \brief compute next step size
+     *
+     *  \param[in]   dt     size of the current step
+     *  \param[in]   error  (global) weighted RMS norm of the local error estimate
+     *  \param[out]  dtNew  size of the next step (or the repeated step)
+     *
+     *  \returns true if the current step is accepted
+     */
+    bool step ( double dt, double error, double &dtNew )
+    {
+      if( error <= 1.0 )
+      {
+        double factor = maxFactor_;
+        if( error > 0.0 )
+          factor = safety_ * std::pow( error, -alpha_ ) * std::pow( errorOld_, beta_ );
+        dtNew = dt * std::min( maxFactor_, std::max( minFactor_, factor ) );
+        errorOld_ = std::max( error, 1e-4 );
+        return true;
+      }
+      else
+      {
+        // error is not finite or too large: reduce step without PI memory
+        double factor = minFactor_;
+        if( error < std::numeric_limits< double >::max() )
+          factor = std::max( minFactor_, safety_ * std::pow( error, -exponent_ ) );
+        dtNew = dt * std::min( 1.0, factor );
+        return false;
+      }
+    }
+
+  protected:
+    const double absTol_, relTol_;
+    const double safety_, minFactor_, maxFactor_;
+    const double exponent_, alpha_, beta_;
+    double errorOld_;
+  };
+
 } // namespace DuneODE
 
 #endif // #ifndef DUNE_FEM_SOLVER_RUNGEKUTTA_TIMESTEPCONTROL_HH
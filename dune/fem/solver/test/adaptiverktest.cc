@@ -0,0 +1,195 @@
+// ****************************************
+//
+// Solve the decay equations du_i/dt = -lambda_i u_i
+// with embedded Runge-Kutta pairs and PI step size control
+//
+// ****************************************
+
+#include <config.h>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/operator/common/spaceoperatorif.hh>
+#include <dune/fem/solver/rungekutta/explicit.hh>
+#include <dune/fem/solver/timeprovider.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::YaspGrid< 1 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 1, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 0 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+double lambda ( std::size_t i, std::size_t n ) { return 1.0 + 9.0 * double( i ) / double( n-1 ); }
+
+class DecayOperator
+  : public Dune::Fem::SpaceOperatorInterface< DiscreteFunctionType >
+{
+public:
+  explicit DecayOperator ( const DiscreteFunctionSpaceType &space ) : space_( space ) {}
+
+  void operator() ( const DiscreteFunctionType &u, DiscreteFunctionType &w ) const
+  {
+    const std::size_t n = u.size();
+    for( std::size_t i = 0; i < n; ++i )
+      w.leakPointer()[ i ] = -lambda( i, n ) * u.leakPointer()[ i ];
+  }
+
+  const DiscreteFunctionSpaceType &space () const { return space_; }
+
+  void setTime ( const double time ) {}
+
+  // the stability bound does not restrict the step
+  double timeStepEstimate () const { return 1e10; }
+
+private:
+  const DiscreteFunctionSpaceType &space_;
+};
+
+struct Result
+{
+  std::vector< double > steps;
+  std::vector< bool > accepted;
+  bool unchangedOnRejection = true;
+  double time = 0;
+  double error = 0;
+};
+
+// integrate from u = 1 with initial step dt0 (multiplied by the factor of the time provider)
+Result integrate ( const DiscreteFunctionSpaceType &space, const Dune::ParameterTree &parameterTree,
+                   double dt0, double endTime, int maxSteps )
+{
+  const auto parameter = Dune::Fem::parameterReader( parameterTree );
+
+  DecayOperator op( space );
+  DiscreteFunctionType u( "u", space ), uOld( "uOld", space );
+  const std::size_t n = u.size();
+  std::fill( u.leakPointer(), u.leakPointer() + n, 1.0 );
+
+  Dune::Fem::TimeProvider<> tp( space.gridPart().comm(), parameter );
+  DuneODE::ExplicitRungeKuttaSolver< DiscreteFunctionType > solver( op, tp, 3, parameter );
+  solver.initialize( u );
+
+  Result result;
+  for( tp.init( dt0 ); (tp.time() < endTime) && (int( result.steps.size() ) < maxSteps); tp.next() )
+  {
+    result.steps.push_back( tp.deltaT() );
+    uOld.assign( u );
+    solver.solve( u );
+    result.accepted.push_back( tp.timeStepValid() );
+
+    if( !tp.timeStepValid() )
+    {
+      for( std::size_t i = 0; i < n; ++i )
+        result.unchangedOnRejection &= (u.leakPointer()[ i ] == uOld.leakPointer()[ i ]);
+    }
+  }
+
+  result.time = tp.time();
+  for( std::size_t i = 0; i < n; ++i )
+    result.error = std::max( result.error, std::abs( u.leakPointer()[ i ] - std::exp( -lambda( i, n ) * result.time ) ) );
+  return result;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  // the dofs are coupled by the error norm only, but the exact solution depends on the dof index
+  if( Dune::Fem::MPIManager::size() > 1 )
+    return 0;
+
+  const Dune::FieldVector< double, 1 > upper( 1.0 );
+  const std::array< int, 1 > cells = {{ 16 }};
+  GridType grid( upper, cells, std::bitset< 1 >(), 0 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  Dune::ParameterTree parameter;
+  parameter[ "fem.ode.adaptive" ] = "true";
+  parameter[ "fem.ode.abstol" ] = "1e-8";
+  parameter[ "fem.ode.reltol" ] = "1e-6";
+
+  int errors = 0;
+
+  // a far too large initial step is rejected and reduced, the solution is left unchanged
+  const Result large = integrate( space, parameter, 1.0, 1.0, 10000 );
+  if( large.accepted.empty() || large.accepted[ 0 ] )
+  {
+    std::cerr << "Error: the initial step of size 1 was not rejected." << std::endl;
+    ++errors;
+  }
+  else if( large.steps[ 1 ] >= large.steps[ 0 ] )
+  {
+    std::cerr << "Error: the rejected step was not reduced (" << large.steps[ 1 ] << ")." << std::endl;
+    ++errors;
+  }
+  if( !large.unchangedOnRejection )
+  {
+    std::cerr << "Error: a rejected step changed the solution." << std::endl;
+    ++errors;
+  }
+  if( (large.time < 1.0) || (large.error > 1e-4) )
+  {
+    std::cerr << "Error: wrong solution at time " << large.time << " (error = " << large.error << ")." << std::endl;
+    ++errors;
+  }
+
+  // a tiny initial step is accepted and increased
+  const Result small = integrate( space, parameter, 1e-5, 1.0, 4 );
+  for( std::size_t k = 0; k+1 < small.steps.size(); ++k )
+  {
+    if( !small.accepted[ k ] || (small.steps[ k+1 ] <= small.steps[ k ]) )
+    {
+      std::cerr << "Error: step " << k << " of size " << small.steps[ k ] << " was rejected or not increased." << std::endl;
+      ++errors;
+    }
+  }
+
+  // the error controlled step does not depend on the factor of the time provider
+  Dune::ParameterTree scaledParameter( parameter );
+  scaledParameter[ "fem.timeprovider.factor" ] = "0.5";
+  const Result scaled = integrate( space, scaledParameter, 2e-5, 1.0, 4 );
+  if( scaled.steps.size() != small.steps.size() )
+  {
+    std::cerr << "Error: " << scaled.steps.size() << " steps with factor 0.5 instead of " << small.steps.size() << "." << std::endl;
+    ++errors;
+  }
+  else
+  {
+    for( std::size_t k = 0; k < small.steps.size(); ++k )
+    {
+      if( std::abs( scaled.steps[ k ] - small.steps[ k ] ) > 1e-12 * small.steps[ k ] )
+      {
+        std::cerr << "Error: step " << k << " has size " << scaled.steps[ k ] << " with factor 0.5 instead of " << small.steps[ k ] << "." << std::endl;
+        ++errors;
+      }
+    }
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,212 @@
+#include <config.h>
+
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/operator/common/automaticdifferenceoperator.hh>
+#include <dune/fem/operator/common/operator.hh>
+#include <dune/fem/solver/krylovinverseoperators.hh>
+#include <dune/fem/solver/newtoninverseoperator.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::YaspGrid< 1 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 1, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 0 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+typedef Dune::Fem::KrylovInverseOperator< DiscreteFunctionType > LinearInverseOperatorType;
+typedef Dune::Fem::JacobianFreeNewtonInverseOperator< DiscreteFunctionType, LinearInverseOperatorType > NewtonOperatorType;
+
+// strongly varying reaction coefficient, such that a diagonal preconditioner pays off
+double coefficient ( std::size_t i, std::size_t n ) { return std::pow( 1000.0, double( i ) / double( n-1 ) ); }
+
+double exact ( std::size_t i, std::size_t n ) { return std::sin( M_PI * (i + 0.5) / n ); }
+
+// F(u)_i = c_i u_i + (2 u_i - u_{i-1} - u_{i+1}) + u_i^3 - b_i with b chosen such that F(exact) = 0
+struct NonlinearOperator
+  : public Dune::Fem::AutomaticDifferenceOperator< DiscreteFunctionType >
+{
+  typedef Dune::Fem::AutomaticDifferenceOperator< DiscreteFunctionType > BaseType;
+
+  NonlinearOperator ( std::size_t n, const Dune::Fem::ParameterReader &parameter )
+    : BaseType( parameter ), n_( n ), rhs_( n, 0.0 )
+  {
+    std::vector< double > u( n );
+    for( std::size_t i = 0; i < n; ++i )
+      u[ i ] = exact( i, n );
+    apply( u.data(), rhs_.data() );
+  }
+
+  virtual void operator() ( const DiscreteFunctionType &u, DiscreteFunctionType &w ) const
+  {
+    apply( u.leakPointer(), w.leakPointer() );
+    for( std::size_t i = 0; i < n_; ++i )
+      w.leakPointer()[ i ] -= rhs_[ i ];
+  }
+
+private:
+  void apply ( const double *u, double *w ) const
+  {
+    for( std::size_t i = 0; i < n_; ++i )
+    {
+      const double left = (i > 0 ? u[ i-1 ] : 0.0);
+      const double right = (i+1 < n_ ? u[ i+1 ] : 0.0);
+      w[ i ] = coefficient( i, n_ ) * u[ i ] + (2.0*u[ i ] - left - right) + u[ i ]*u[ i ]*u[ i ];
+    }
+  }
+
+  std::size_t n_;
+  std::vector< double > rhs_;
+};
+
+// inverse of the diagonal of the Jacobian, updated with the Newton iterate
+struct DiagonalPreconditioner
+  : public Dune::Fem::Operator< DiscreteFunctionType, DiscreteFunctionType >
+{
+  explicit DiagonalPreconditioner ( std::size_t n ) : diagonal_( n, 1.0 ) {}
+
+  void update ( const DiscreteFunctionType &u )
+  {
+    const std::size_t n = diagonal_.size();
+    for( std::size_t i = 0; i < n; ++i )
+      diagonal_[ i ] = coefficient( i, n ) + 2.0 + 3.0*u.leakPointer()[ i ]*u.leakPointer()[ i ];
+    ++updates_;
+  }
+
+  virtual void operator() ( const DiscreteFunctionType &u, DiscreteFunctionType &w ) const
+  {
+    for( std::size_t i = 0; i < diagonal_.size(); ++i )
+      w.leakPointer()[ i ] = u.leakPointer()[ i ] / diagonal_[ i ];
+  }
+
+  int updates () const { return updates_; }
+
+private:
+  std::vector< double > diagonal_;
+  int updates_ = 0;
+};
+
+// solve F(u) = 0 starting from u = 0 and compare to the exact solution
+int solve ( NewtonOperatorType &newton, const NonlinearOperator &op, DiscreteFunctionType &u, const char *name )
+{
+  const std::size_t n = u.size();
+  DiscreteFunctionType zero( "zero", u.space() );
+  zero.clear();
+  u.clear();
+
+  newton.bind( op );
+  newton( zero, u );
+  newton.unbind();
+
+  int errors = 0;
+  if( !newton.converged() )
+  {
+    std::cerr << "Error: Newton method " << name << " did not converge." << std::endl;
+    return ++errors;
+  }
+
+  double error = 0;
+  for( std::size_t i = 0; i < n; ++i )
+    error = std::max( error, std::abs( u.leakPointer()[ i ] - exact( i, n ) ) );
+  if( error > 1e-6 )
+  {
+    std::cerr << "Error: wrong solution " << name << " (error = " << error << ")." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  // the operator couples the dofs in their storage order, so run serially only
+  if( Dune::Fem::MPIManager::size() > 1 )
+    return 0;
+
+  const Dune::FieldVector< double, 1 > upper( 1.0 );
+  const std::array< int, 1 > cells = {{ 64 }};
+  GridType grid( upper, cells, std::bitset< 1 >(), 0 );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+  DiscreteFunctionType u( "u", space );
+
+  Dune::ParameterTree parameterTree;
+  parameterTree[ "fem.solver.newton.tolerance" ] = "1e-10";
+  parameterTree[ "fem.solver.newton.linreduction" ] = "1e-8";
+  parameterTree[ "fem.solver.newton.linabstol" ] = "1e-12";
+  parameterTree[ "fem.solver.newton.maxiterations" ] = "20";
+  parameterTree[ "fem.solver.newton.maxlineariterations" ] = "100000";
+  parameterTree[ "fem.solver.krylovmethod" ] = "gmres";
+  const auto parameter = Dune::Fem::parameterReader( parameterTree );
+
+  const std::size_t n = u.size();
+  NonlinearOperator op( n, parameter );
+  NewtonOperatorType newton( parameter );
+
+  int errors = 0;
+
+  // Jacobian-free Newton-Krylov without preconditioner
+  errors += solve( newton, op, u, "without preconditioner" );
+  const int plainIterations = newton.iterations();
+  const int plainLinearIterations = newton.linearIterations();
+
+  // with a diagonal preconditioner updated in every Newton step
+  DiagonalPreconditioner preconditioner( n );
+  newton.setPreconditioner( preconditioner, [ &preconditioner ] ( const DiscreteFunctionType &w ) { preconditioner.update( w ); } );
+  errors += solve( newton, op, u, "with preconditioner" );
+
+  if( preconditioner.updates() != newton.iterations() )
+  {
+    std::cerr << "Error: preconditioner updated " << preconditioner.updates() << " times in "
+              << newton.iterations() << " Newton iterations." << std::endl;
+    ++errors;
+  }
+  if( newton.iterations() > plainIterations + 1 )
+  {
+    std::cerr << "Error: preconditioning increased the Newton iterations from "
+              << plainIterations << " to " << newton.iterations() << "." << std::endl;
+    ++errors;
+  }
+  if( newton.linearIterations() >= plainLinearIterations )
+  {
+    std::cerr << "Error: preconditioning did not reduce the linear iterations ("
+              << newton.linearIterations() << " instead of " << plainLinearIterations << ")." << std::endl;
+    ++errors;
+  }
+
+  // removing the preconditioner restores the plain solve
+  newton.unsetPreconditioner();
+  const int updates = preconditioner.updates();
+  errors += solve( newton, op, u, "after removing the preconditioner" );
+  if( preconditioner.updates() != updates )
+  {
+    std::cerr << "Error: preconditioner updated after it was removed." << std::endl;
+    ++errors;
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
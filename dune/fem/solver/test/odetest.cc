@@ -325,6 +325,17 @@ struct SimpleFactory
   }
 };
 
+template <class OdeSolver>
+struct LowStorageFactory
+{
+  typedef OdeSolver  OdeSolverType;
+  template <class SpaceOperatorType, class TimeProvider>
+  OdeSolverType* create( SpaceOperatorType& op, TimeProvider& tp, const int order )
+  {
+    return new OdeSolverType( op, tp, (order > 3 ? DuneODE::ssp104LowStorageButcherTable() : DuneODE::ssp43LowStorageButcherTable()), false );
+  }
+};
+
 template <class SpaceOperator, template <class,class,class> class Solver >
 struct ImplicitRKFactory
 {
@@ -372,6 +383,13 @@ int main( int argc, char **argv )
     solve( SimpleFactory< OdeSolverType >(), verbose );
   }
 
+  // explicit low-storage RungeKutta (dune expl)
+  {
+    std::cout << "Dune-fem explicit low-storage rungekutta" << std::endl;
+    typedef DuneODE::ExplicitRungeKuttaSolver<DestinationType> OdeSolverType;
+    solve( LowStorageFactory< OdeSolverType >(), verbose );
+  }
+
   // implicit RungeKutta (dune impl)
   {
     std::cout << "Dune-fem implicit rungekutta" << std::endl;
@@ -0,0 +1,169 @@
+// ****************************************
+//
+// Solve the decay equations du_i/dt = -lambda_i u_i
+// in parallel in time with the Parareal method
+//
+// ****************************************
+
+#include <config.h>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/operator/common/spaceoperatorif.hh>
+#include <dune/fem/solver/parareal.hh>
+#include <dune/fem/solver/rungekutta/explicit.hh>
+#include <dune/fem/solver/timeprovider.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::CollectiveCommunication< Dune::MPIHelper::MPICommunicator > CommunicationType;
+
+typedef Dune::YaspGrid< 1 > GridType;
+typedef Dune::Fem::LeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 1, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 0 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+
+typedef Dune::Fem::TimeProvider< CommunicationType > TimeProviderType;
+typedef DuneODE::ExplicitRungeKuttaSolver< DiscreteFunctionType > OdeSolverType;
+typedef DuneODE::PararealSolver< DiscreteFunctionType, CommunicationType > PararealSolverType;
+
+double lambda ( std::size_t i, std::size_t n ) { return 1.0 + 3.0 * double( i ) / double( n-1 ); }
+
+class DecayOperator
+  : public Dune::Fem::SpaceOperatorInterface< DiscreteFunctionType >
+{
+public:
+  explicit DecayOperator ( const DiscreteFunctionSpaceType &space ) : space_( space ) {}
+
+  void operator() ( const DiscreteFunctionType &u, DiscreteFunctionType &w ) const
+  {
+    const std::size_t n = u.size();
+    for( std::size_t i = 0; i < n; ++i )
+      w.leakPointer()[ i ] = -lambda( i, n ) * u.leakPointer()[ i ];
+  }
+
+  const DiscreteFunctionSpaceType &space () const { return space_; }
+
+  void setTime ( const double time ) {}
+
+  double timeStepEstimate () const { return 1e10; }
+
+private:
+  const DiscreteFunctionSpaceType &space_;
+};
+
+double maxDifference ( const DiscreteFunctionType &a, const DiscreteFunctionType &b )
+{
+  double difference = 0;
+  for( std::size_t i = 0; i < std::size_t( a.size() ); ++i )
+    difference = std::max( difference, std::abs( a.leakPointer()[ i ] - b.leakPointer()[ i ] ) );
+  return difference;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  // one rank per time slice
+  DuneODE::PararealCommunicators comms( 1 );
+  const CommunicationType spaceComm( comms.space() ), timeComm( comms.time() );
+  const int slice = timeComm.rank();
+  const int slices = timeComm.size();
+
+  const Dune::FieldVector< double, 1 > upper( 1.0 );
+  const std::array< int, 1 > cells = {{ 8 }};
+  GridType grid( upper, cells, std::bitset< 1 >(), 0, spaceComm );
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+  DecayOperator op( space );
+
+  const double startTime = 0.0, endTime = 1.0;
+  const int fineSteps = 20;
+
+  Dune::ParameterTree parameter;
+  parameter[ "fem.ode.parareal.coarsesteps" ] = "2";
+  parameter[ "fem.ode.parareal.finesteps" ] = std::to_string( fineSteps );
+  parameter[ "fem.ode.parareal.tolerance" ] = "0";
+
+  // coarse: explicit Euler, fine: classical Runge-Kutta method
+  TimeProviderType coarseTp( spaceComm ), fineTp( spaceComm );
+  OdeSolverType coarse( op, coarseTp, 1, false ), fine( op, fineTp, 4, false );
+  PararealSolverType parareal( coarse, coarseTp, fine, fineTp, comms.time(), Dune::Fem::parameterReader( parameter ) );
+
+  DiscreteFunctionType u( "u", space );
+  std::fill( u.leakPointer(), u.leakPointer() + u.size(), 1.0 );
+  parareal.solve( startTime, endTime, u );
+
+  int errors = 0;
+
+  // without tolerance, all slices are iterated
+  if( parareal.iterations() != slices )
+  {
+    std::cerr << "Error: " << parareal.iterations() << " Parareal iterations instead of " << slices << "." << std::endl;
+    ++errors;
+  }
+
+  const double sliceLength = (endTime - startTime) / slices;
+  if( (std::abs( parareal.sliceStartTime() - slice*sliceLength ) > 1e-12) || (std::abs( parareal.sliceEndTime() - (slice+1)*sliceLength ) > 1e-12) )
+  {
+    std::cerr << "Error: wrong time slice [" << parareal.sliceStartTime() << ", " << parareal.sliceEndTime() << "] on rank " << slice << "." << std::endl;
+    ++errors;
+  }
+
+  // after as many iterations as slices, the result is the serial fine solution
+  DiscreteFunctionType reference( "reference", space );
+  std::fill( reference.leakPointer(), reference.leakPointer() + reference.size(), 1.0 );
+  TimeProviderType referenceTp( spaceComm );
+  OdeSolverType referenceSolver( op, referenceTp, 4, false );
+  const double dt = sliceLength / fineSteps;
+  referenceSolver.initialize( reference );
+  referenceTp.init( dt );
+  for( int i = 0; i < (slice+1)*fineSteps; ++i, referenceTp.next( dt ) )
+    referenceSolver.solve( reference );
+
+  const double difference = maxDifference( u, reference );
+  if( difference > 1e-12 )
+  {
+    std::cerr << "Error: Parareal solution differs from the fine solution on slice " << slice << " (difference = " << difference << ")." << std::endl;
+    ++errors;
+  }
+
+  // and approximates the exact solution
+  DiscreteFunctionType exact( "exact", space );
+  for( std::size_t i = 0; i < std::size_t( exact.size() ); ++i )
+    exact.leakPointer()[ i ] = std::exp( -lambda( i, exact.size() ) * parareal.sliceEndTime() );
+  const double error = maxDifference( u, exact );
+  if( error > 1e-6 )
+  {
+    std::cerr << "Error: wrong Parareal solution on slice " << slice << " (error = " << error << ")." << std::endl;
+    ++errors;
+  }
+
+  return (timeComm.max( errors ) > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -534,6 +534,9 @@ namespace Dune
         return cfl_;
       }
 
+      /** \brief return the collective communication used to agree on the time step */
+      const CollectiveCommunicationType &comm () const { return comm_; }
+
     protected:
       using BaseType::advance;
       using BaseType::initTimeStepEstimate;
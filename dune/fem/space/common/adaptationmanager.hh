@@ -2,10 +2,14 @@
 #define DUNE_FEM_ADAPTATIONMANAGER_HH
 
 //- system includes
+#include <algorithm>
 #include <string>
+#include <tuple>
+#include <vector>
 
 //- local includes
 #include <dune/common/timer.hh>
+#include <dune/common/typeutilities.hh>
 #include <dune/fem/space/common/dofmanager.hh>
 #include <dune/fem/operator/common/objpointer.hh>
 
@@ -18,6 +22,7 @@
 #include <dune/fem/space/common/adaptcallbackhandle.hh>
 #include <dune/fem/io/parameter.hh>
 #include <dune/fem/io/file/persistencemanager.hh>
+#include <dune/fem/misc/threads/parallelfor.hh>
 #include <dune/fem/misc/threads/threadmanager.hh>
 
 #include <dune/fem/space/common/dataprojection/dataprojection.hh>
@@ -45,6 +50,19 @@ namespace Dune
        - 2 == callback: only AlbertaGrid and ALUGrid
        .
 
+      For the generic method, the local restriction and prolongation can
+      be run in parallel by setting
+       \parametername \c fem.adaptation.threaded \n
+                      collect all father/son pairs first and apply the
+                      restriction/prolongation operator to them using
+                      the threads of the ThreadManager;
+                      defaults to false \n
+      The threaded version is only used if all degrees of freedom of the
+      restriction/prolongation operator are attached to elements (see
+      RestrictProlongDefault::elementLocalDofs); otherwise the data is
+      projected serially.
+      The grid modification itself is always done serially.
+
       \remarks
       The Interface of Adaptation Manager is described by the class
       AdaptationManagerInterface.
@@ -202,6 +220,26 @@ namespace Dune
     AdaptationMethodType adaptationMethod_;
   };
 
+  namespace Impl
+  {
+
+    // restriction and prolongation on different fathers may only run concurrently,
+    // if the operator guarantees that they do not share degrees of freedom
+    template< class RestProlOperator >
+    inline auto elementLocalDofs ( const RestProlOperator &rpOp, PriorityTag< 1 > )
+      -> decltype( rpOp.elementLocalDofs() )
+    {
+      return rpOp.elementLocalDofs();
+    }
+
+    template< class RestProlOperator >
+    inline bool elementLocalDofs ( const RestProlOperator &, PriorityTag< 0 > )
+    {
+      return false;
+    }
+
+  } // namespace Impl
+
   /*! \brief This class manages the adaptation process.
    If the method adapt is called, then the grid is adapted and also
    all the data belonging to the given dof manager will be rearranged
@@ -296,8 +334,17 @@ namespace Dune
       dm_( DofManagerType::instance( grid_ ) ),
       rpOp_( rpOp ),
       adaptTime_( 0.0 ),
-      wasChanged_( false )
-    {}
+      wasChanged_( false ),
+      threaded_( parameter.getValue< bool >( "fem.adaptation.threaded", false ) )
+    {
+      if( threaded_ && !Impl::elementLocalDofs( rpOp, PriorityTag< 1 >() ) )
+      {
+        threaded_ = false;
+        if( Parameter::verbose() )
+          std::cout << "AdaptationManager: the restriction/prolongation operator does not report element local dofs, "
+                    << "fem.adaptation.threaded is ignored." << std::endl;
+      }
+    }
 
     //! destructor
     virtual ~AdaptationManagerBase () {}
@@ -325,6 +372,9 @@ namespace Dune
       // get stopwatch
       Dune::Timer timer;
 
+      // the grid is modified from here on
+      dm_.preModification();
+
       const bool supportsCallback = Capabilities :: supportsCallbackAdaptation< GridType > :: v;
       CallAdaptationMethod< ThisType, GridType, supportsCallback >
         :: adapt(*this,grid_,dm_,rpOp_,this->adaptationMethod_);
@@ -403,6 +453,18 @@ namespace Dune
           dm_.resizeForRestrict();
 
           // now project all data to fathers
+          if( threaded_ )
+          {
+            LocalPairCollector collector;
+            MacroIterator endit  = macroView.template end<0,pitype>  ();
+            for(MacroIterator it = macroView.template begin<0,pitype>();
+                it != endit; ++it )
+            {
+              hierarchicRestrict( *it , collector );
+            }
+            applyThreaded( collector, true );
+          }
+          else
           {
             // get macro iterator
             MacroIterator endit  = macroView.template end<0,pitype>  ();
@@ -436,10 +498,23 @@ namespace Dune
 
         // make run through grid to project data
         MacroIterator endit  = macroView.template end<0,pitype>  ();
-        for(MacroIterator it = macroView.template begin<0,pitype>();
-            it != endit; ++it )
+        if( threaded_ )
+        {
+          LocalPairCollector collector;
+          for(MacroIterator it = macroView.template begin<0,pitype>();
+              it != endit; ++it )
+          {
+            hierarchicProlong( *it , collector );
+          }
+          applyThreaded( collector, false );
+        }
+        else
         {
-          hierarchicProlong( *it , rpOp_ );
+          for(MacroIterator it = macroView.template begin<0,pitype>();
+              it != endit; ++it )
+          {
+            hierarchicProlong( *it , rpOp_ );
+          }
         }
       }
 
@@ -456,6 +531,94 @@ namespace Dune
     }
 
   private:
+    typedef typename GridType::template Codim< 0 >::Entity ElementType;
+
+    //! records father/son pairs instead of restricting or prolonging data
+    struct LocalPairCollector
+    {
+      void restrictLocal ( const ElementType &father, const ElementType &son, bool initialize )
+      {
+        pairs.emplace_back( father, son, initialize );
+      }
+
+      void prolongLocal ( const ElementType &father, const ElementType &son, bool initialize )
+      {
+        pairs.emplace_back( father, son, initialize );
+      }
+
+      std::vector< std::tuple< ElementType, ElementType, bool > > pairs;
+    };
+
+    //! contiguous range of collected pairs processed by one thread
+    struct LocalPairTask
+    {
+      int level;
+      std::size_t begin, end;
+    };
+
+    /** \brief apply the restriction (prolongation) operator to collected pairs
+     *
+     *  For the restriction, all sons of one father form a task, which is
+     *  processed sequentially (the first son initializes the father). For the
+     *  prolongation, each pair forms a task. Tasks are processed level by
+     *  level (fine to coarse for the restriction, coarse to fine for the
+     *  prolongation) and tasks on the same level are distributed over the
+     *  threads of the ThreadManager. All threads share the operator.
+     *
+     *  \note Different fathers (sons) on the same level must not share
+     *        degrees of freedom and the operator has to allow concurrent calls
+     *        on them. Therefore, this is only used if the operator reports
+     *        elementLocalDofs(), e.g., RestrictProlongDefault (which holds its
+     *        local functions per thread) for discontinuous spaces but not for
+     *        Lagrange spaces.
+     */
+    void applyThreaded ( const LocalPairCollector &collector, bool restriction ) const
+    {
+      const auto &pairs = collector.pairs;
+
+      std::vector< LocalPairTask > tasks;
+      for( std::size_t i = 0; i < pairs.size(); ++i )
+      {
+        const ElementType &father = std::get< 0 >( pairs[ i ] );
+        const ElementType &son = std::get< 1 >( pairs[ i ] );
+        if( !restriction || std::get< 2 >( pairs[ i ] ) || tasks.empty() )
+          tasks.push_back( LocalPairTask{ restriction ? father.level() : son.level(), i, i+1 } );
+        else
+          tasks.back().end = i+1;
+      }
+      std::stable_sort( tasks.begin(), tasks.end(), [ restriction ] ( const LocalPairTask &a, const LocalPairTask &b ) {
+          return (restriction ? a.level > b.level : a.level < b.level);
+        } );
+
+      for( std::size_t first = 0; first < tasks.size(); )
+      {
+        std::size_t last = first+1;
+        while( (last < tasks.size()) && (tasks[ last ].level == tasks[ first ].level) )
+          ++last;
+
+        // process the first task serially, e.g., to set up quadrature caches
+        applyTask( rpOp_, pairs, tasks[ first ], restriction );
+
+        parallelFor( first+1, last, 16, [ this, &pairs, &tasks, restriction ] ( std::size_t i ) {
+            applyTask( rpOp_, pairs, tasks[ i ], restriction );
+          } );
+
+        first = last;
+      }
+    }
+
+    template< class Pairs >
+    static void applyTask ( RestProlOperatorImp &op, const Pairs &pairs, const LocalPairTask &task, bool restriction )
+    {
+      for( std::size_t i = task.begin; i < task.end; ++i )
+      {
+        if( restriction )
+          op.restrictLocal( std::get< 0 >( pairs[ i ] ), std::get< 1 >( pairs[ i ] ), std::get< 2 >( pairs[ i ] ) );
+        else
+          op.prolongLocal( std::get< 0 >( pairs[ i ] ), std::get< 1 >( pairs[ i ] ), std::get< 2 >( pairs[ i ] ) );
+      }
+    }
+
     //! make hierarchic walk trough for restriction
     template <class EntityType, class RestrictOperatorType  >
     bool hierarchicRestrict ( const EntityType& entity, RestrictOperatorType & restop ) const
@@ -566,6 +729,9 @@ namespace Dune
 
     //! flag for restriction
     mutable bool wasChanged_;
+
+    //! apply restriction/prolongation in parallel
+    bool threaded_;
   };
 
   //! factory class to create adaptation manager reference counter
@@ -633,7 +799,7 @@ namespace Dune
     **/
     AdaptationManager ( GridType &grid, RestProlOperatorImp &rpOp, int balanceCounter, const ParameterReader &parameter = Parameter::container() )
       : BaseType(grid,rpOp, parameter)
-      , Base2Type( grid, rpOp )
+      , Base2Type( grid, rpOp, parameter )
       , referenceCounter_( ProviderType :: getObject( &grid ) )
       , balanceStep_( parameter.getValue< int >( "fem.loadbalancing.step", 1 ) )
       , balanceCounter_( balanceCounter )
@@ -663,7 +829,7 @@ namespace Dune
     **/
     AdaptationManager ( GridType &grid, RestProlOperatorImp &rpOp, const ParameterReader &parameter = Parameter::container() )
       : BaseType(grid,rpOp, parameter)
-      , Base2Type( grid, rpOp )
+      , Base2Type( grid, rpOp, parameter )
       , referenceCounter_( ProviderType :: getObject( &grid ) )
       , balanceStep_( parameter.getValue< int >( "fem.loadbalancing.step", 1 ) )
       , balanceCounter_( 0 )
@@ -825,6 +991,9 @@ namespace Dune
 
         Dune::Timer timer;
 
+        // the dofs are modified from here on
+        dofManager().preModification();
+
         DataProjectionWrapper wrapper( dataProjection_, dofManager() );
         space().adapt( wrapper );
 
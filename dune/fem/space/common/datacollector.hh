@@ -732,6 +732,7 @@ namespace Dune
         df_.getLocalDofs( entity, ldv );
         for( const DofType &dof : ldv )
           str.write( dof );
+        dm_.addPackedBytes( ldv.size() * sizeof( DofType ) );
       }
 
     protected:
@@ -820,6 +821,7 @@ namespace Dune
         for( DofType &dof : ldv )
           str.read( dof );
         df_.setLocalDofs( entity, ldv );
+        dm_.addUnpackedBytes( ldv.size() * sizeof( DofType ) );
       }
 
     protected:
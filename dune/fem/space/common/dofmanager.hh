@@ -1,9 +1,16 @@
 #ifndef DUNE_FEM_DOFMANAGER_HH
 #define DUNE_FEM_DOFMANAGER_HH
 
+#include <algorithm>
 #include <cassert>
-#include <string>
+#include <cstddef>
+#include <exception>
+#include <functional>
 #include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/stdstreams.hh>
@@ -17,10 +24,12 @@
 #include <dune/fem/io/parameter.hh>
 #include <dune/fem/io/streams/standardstreams.hh>
 #include <dune/fem/misc/gridobjectstreams.hh>
+#include <dune/fem/misc/threads/parallelfor.hh>
 #include <dune/fem/misc/threads/threadmanager.hh>
 #include <dune/fem/space/common/datacollector.hh>
 #include <dune/fem/space/common/restrictprolonginterface.hh>
 #include <dune/fem/space/mapper/dofmapper.hh>
+#include <dune/fem/storage/arraymemorypool.hh>
 #include <dune/fem/storage/dynamicarray.hh>
 #include <dune/fem/storage/singletonlist.hh>
 
@@ -288,6 +297,113 @@ namespace Dune
     };
 
 
+    /////////////////////////////////////////////////////////////
+    //
+    // DofCompressPlan
+    //
+    /////////////////////////////////////////////////////////////
+    /** \brief data movement of a dof compression for one mapper
+
+        The block moves and the pairs of old and new indices of the holes are
+        read from the mapper once and can then be applied to all dof storages
+        using this mapper.
+    */
+    class DofCompressPlan
+    {
+    public:
+      struct Block
+      {
+        //! offsets of the block before and after the compression
+        int oldOffSet, newOffSet;
+        //! number of entries to move to the front (0 if the block stays)
+        int moveSize;
+        //! pairs (oldIndex, newIndex) of entries to copy into holes
+        std::vector< std::pair< int, int > > holes;
+        //! true if old and new indices overlap, i.e., the copies have to be done out of place
+        bool gather;
+      };
+
+      template< class MapperType >
+      DofCompressPlan ( const MapperType &mapper, const int oldSize )
+      {
+        const int numBlocks = mapper.numBlocks();
+        blocks_.resize( numBlocks );
+        for( int block = 0; block < numBlocks; ++block )
+        {
+          Block &b = blocks_[ block ];
+          b.oldOffSet = mapper.oldOffSet( block );
+          b.newOffSet = mapper.offSet( block );
+
+          // here we should have at least the same offsets
+          assert( b.newOffSet <= b.oldOffSet );
+
+          // for last section upperBound is size
+          const int upperBound = (block == numBlocks - 1) ? oldSize : mapper.oldOffSet( block + 1 );
+          b.moveSize = (b.newOffSet < b.oldOffSet) ? upperBound - b.oldOffSet : 0;
+
+          // only close holes for consecutive mappers
+          if( mapper.consecutive() )
+          {
+            const int holes = mapper.numberOfHoles( block );
+            b.holes.resize( holes );
+            for( int i = 0; i < holes; ++i )
+              b.holes[ i ] = std::make_pair( int( mapper.oldIndex( i, block ) ), int( mapper.newIndex( i, block ) ) );
+          }
+
+          // closing holes moves entries from behind the new size only, but
+          // renumbering index sets (see CodimIndexSet::renumber) may permute
+          b.gather = false;
+          if( !b.holes.empty() )
+          {
+            int maxIndex = 0;
+            for( const auto &hole : b.holes )
+              maxIndex = std::max( maxIndex, std::max( hole.first, hole.second ) );
+            std::vector< bool > isTarget( maxIndex+1, false );
+            for( const auto &hole : b.holes )
+              isTarget[ hole.second ] = true;
+            for( const auto &hole : b.holes )
+              b.gather |= isTarget[ hole.first ];
+          }
+        }
+      }
+
+      const std::vector< Block > &blocks () const { return blocks_; }
+
+    protected:
+      std::vector< Block > blocks_;
+    };
+
+    /** \brief cache of DofCompressPlan objects, one per mapper and array size */
+    class DofCompressPlanCache
+    {
+      typedef std::pair< const void *, int > KeyType;
+
+    public:
+      //! return plan for mapper and old array size, compute it if necessary
+      template< class MapperType >
+      const DofCompressPlan &plan ( const MapperType &mapper, const int oldSize )
+      {
+        const KeyType key( &mapper, oldSize );
+        auto it = plans_.find( key );
+        if( it == plans_.end() )
+          it = plans_.emplace( key, DofCompressPlan( mapper, oldSize ) ).first;
+        return it->second;
+      }
+
+      //! return precomputed plan for mapper and old array size
+      template< class MapperType >
+      const DofCompressPlan &plan ( const MapperType &mapper, const int oldSize ) const
+      {
+        auto it = plans_.find( KeyType( &mapper, oldSize ) );
+        assert( it != plans_.end() );
+        return it->second;
+      }
+
+    protected:
+      std::map< KeyType, DofCompressPlan > plans_;
+    };
+
+
     /** \brief Interface class for a dof storage object that can be managed
         (resized and compressed) by the DofManager
     */
@@ -307,6 +423,25 @@ namespace Dune
       virtual void reserve (int newSize) = 0;
       //! compressed the underlying dof vector
       virtual void dofCompress () = 0;
+
+      /** \brief store the data movement needed by dofCompress in the cache
+          \note This method is called in single thread mode for all storages
+                before any of them is compressed.
+      */
+      virtual void prepareDofCompress ( DofCompressPlanCache &plans ) {}
+
+      /** \brief compress the underlying dof vector using the prepared plans
+          \param  plans     plans filled by prepareDofCompress
+          \param  threaded  if true, copies may be distributed over threads
+      */
+      virtual void dofCompress ( const DofCompressPlanCache &plans, const bool threaded ) { dofCompress(); }
+
+      /** \brief return true if dofCompress( plans, threaded ) may run
+                  concurrently with the compression of other storages
+          \note The default is false, i.e., the storage is compressed on the
+                calling thread while no other storage is compressed.
+      */
+      virtual bool threadSafeDofCompress () const { return false; }
       //! return size of mem used by MemObject
       virtual size_t usedMemorySize() const = 0;
     };
@@ -428,6 +563,21 @@ namespace Dune
 
       //! copy the dof from the rear section of the vector to the holes
       void dofCompress ()
+      {
+        DofCompressPlanCache plans;
+        prepareDofCompress( plans );
+        dofCompress( plans, false );
+      }
+
+      //! compute the data movement for the mapper (shared with other storages)
+      void prepareDofCompress ( DofCompressPlanCache &plans )
+      {
+        if( dataCompressionEnabled_ )
+          plans.plan( mapper(), array_.size() );
+      }
+
+      //! copy the dof from the rear section of the vector to the holes
+      void dofCompress ( const DofCompressPlanCache &plans, const bool threaded )
       {
         // get current size
         const int nSize = mapper().size();
@@ -435,36 +585,45 @@ namespace Dune
         // if data is non-temporary do data compression
         if( dataCompressionEnabled_ )
         {
-          // get old size (which we still have in array)
-          const int oldSize = array_.size();
-
           // NOTE: new size can also be larger than old size
           // e.g. during loadBalancing when ghosts where
           // introduced before compressing the index set
 
           // begin with block zero since closing of holes
           // has to be done anyway if the mapper is consecutive
-          const int numBlocks = mapper().numBlocks();
-          for( int block = 0; block < numBlocks; ++block )
+          const DofCompressPlan &plan = plans.plan( mapper(), array_.size() );
+          for( const DofCompressPlan::Block &block : plan.blocks() )
           {
             // move memory
-            moveToFront( oldSize, block );
+            if( block.moveSize > 0 )
+              SpecialArrayFeatures< DofArrayType >
+                :: memMoveForward( array_, block.moveSize, block.oldOffSet, block.newOffSet );
 
-            // only close holes for consecutive mappers
-            if( mapper().consecutive () )
+            const std::size_t holes = block.holes.size();
+            const int threads = (threaded && (holes > 1024)) ? ThreadManager::maxThreads() : 1;
+            if( block.gather )
             {
-              // run over all holes and copy array vules to new place
-              const int holes = mapper().numberOfHoles( block );
-              for( int i = 0; i < holes; ++i )
-              {
-                const int oldIndex = mapper().oldIndex( i, block );
-                const int newIndex = mapper().newIndex( i, block );
-
-                assert( newIndex < nSize );
-                // implements array_[ newIndex ] = array_[ oldIndex ] ;
-                SpecialArrayFeatures< DofArrayType > :: assign( array_, newIndex, oldIndex );
-              }
+              // copy entries behind the end of the array first
+              const int end = array_.size();
+              array_.resize( end + holes );
+              parallelFor( 0, holes, 256, [ this, &block, end ] ( std::size_t i ) {
+                  SpecialArrayFeatures< DofArrayType > :: assign( array_, end + i, block.holes[ i ].first );
+                }, threads );
+              parallelFor( 0, holes, 256, [ this, &block, end, nSize ] ( std::size_t i ) {
+                  assert( block.holes[ i ].second < nSize );
+                  SpecialArrayFeatures< DofArrayType > :: assign( array_, block.holes[ i ].second, end + i );
+                }, threads );
+              array_.resize( end );
+              continue;
             }
+
+            // run over all holes and copy array values to new place,
+            // the holes are distinct from the entries copied into them
+            parallelFor( 0, holes, 256, [ this, &block, nSize ] ( std::size_t i ) {
+                assert( block.holes[ i ].second < nSize );
+                // implements array_[ newIndex ] = array_[ oldIndex ] ;
+                SpecialArrayFeatures< DofArrayType > :: assign( array_, block.holes[ i ].second, block.holes[ i ].first );
+              }, threads );
           }
         }
 
@@ -472,6 +631,9 @@ namespace Dune
         array_.resize( nSize );
       }
 
+      //! the storage only modifies its own array
+      bool threadSafeDofCompress () const { return true; }
+
       //! return used memory size
       size_t usedMemorySize() const
       {
@@ -571,35 +733,6 @@ namespace Dune
       void resizeAndMoveToRear ()
       {
       }
-
-      //! move block to front again
-      void moveToFront ( const int oldSize, const int block )
-      {
-        // get insertion point from block
-        const int oldOffSet = mapper().oldOffSet( block );
-
-        // get new off set
-        const int newOffSet = mapper().offSet( block );
-
-        // here we should have at least the same offsets
-        assert( newOffSet <= oldOffSet );
-
-        // only if block is not starting from zero
-        if( newOffSet < oldOffSet )
-        {
-          // get number of blocks
-          const int numBlocks = mapper().numBlocks();
-
-          // for last section upperBound is size
-          const int upperBound
-            = (block == numBlocks - 1) ? oldSize : mapper().oldOffSet( block + 1 );
-          const int blockSize = upperBound - oldOffSet;
-
-          // move block forward
-          SpecialArrayFeatures< DofArrayType >
-            :: memMoveForward( array_, blockSize, oldOffSet, newOffSet );
-        }
-      }
     };
 
     /*! A ManagedDofStorage holds the memory for one DiscreteFunction. */
@@ -907,6 +1040,12 @@ namespace Dune
 
       //! memory over estimation factor for re-allocation
       double memoryFactor_;
+
+      //! bytes of dof data packed and unpacked by the data collectors
+      std::size_t packedBytes_ = 0, unpackedBytes_ = 0;
+
+      //! callbacks invoked before the grid or the dof storage is modified (with their owners)
+      std::vector< std::pair< const void *, std::function< void () > > > preModificationCallbacks_;
       //**********************************************************
       //**********************************************************
       //! Constructor
@@ -924,6 +1063,19 @@ namespace Dune
         if( std::abs( memoryFactor_ - 1.1 ) > 1e-12 )
           if( Parameter::verbose() && (grid_.comm().rank() == 0) )
             std::cout << "Created DofManager with memory factor " << memoryFactor_ << "." << std::endl;
+
+        // setup memory pool for large dof arrays (disabled by default) once for all DofManagers
+        ArrayMemoryPool &pool = ArrayMemoryPool::instance();
+        if( !pool.configured() )
+        {
+          const bool memoryPool = Parameter::getValue< bool >( "fem.dofmanager.memorypool", false );
+          const bool hugePages = Parameter::getValue< bool >( "fem.dofmanager.hugepages", false );
+          const bool firstTouch = Parameter::getValue< bool >( "fem.dofmanager.firsttouch", false );
+          // maximal size of retained blocks in MB
+          const double poolSize = memoryPool ? Parameter::getValidValue( "fem.dofmanager.memorypoolsize", double( 1024 ),
+              [] ( double value ) { return value >= 0.0; } ) : 0.0;
+          pool.configure( std::size_t( poolSize * 1024 * 1024 ), hugePages, firstTouch );
+        }
       }
 
       //! Desctructor, removes all MemObjects and IndexSetObjects
@@ -1004,6 +1156,14 @@ namespace Dune
         return ! insertIndices_.empty();
       }
 
+      /** \brief free the blocks retained by the memory pool for dof arrays
+          \note  Retained blocks are reused by later adaptation cycles; see ArrayMemoryPool.
+      */
+      void releasePooledMemory ()
+      {
+        ArrayMemoryPool::instance().release();
+      }
+
       /** \brief return used memory size of all MemObjects in bytes. */
       size_t usedMemorySize () const
       {
@@ -1013,11 +1173,60 @@ namespace Dune
         return used;
       }
 
+      /** \brief bytes of dof data packed into the load balancing messages
+       *         since the last call of resetMigratedBytes */
+      std::size_t packedBytes () const { return packedBytes_; }
+
+      /** \brief bytes of dof data unpacked from the load balancing messages
+       *         since the last call of resetMigratedBytes */
+      std::size_t unpackedBytes () const { return unpackedBytes_; }
+
+      //! called by the local data inliners for each element packed
+      void addPackedBytes ( std::size_t bytes ) { packedBytes_ += bytes; }
+
+      //! called by the local data xtractors for each element unpacked
+      void addUnpackedBytes ( std::size_t bytes ) { unpackedBytes_ += bytes; }
+
+      //! reset the counters of packed and unpacked bytes
+      void resetMigratedBytes () { packedBytes_ = unpackedBytes_ = 0; }
+
+      /** \brief register a callback invoked before the grid or the dof storage is modified
+       *
+       *  The callbacks are invoked by preModification, which is called by
+       *  AdaptationManager and LoadBalancer before the grid is adapted or
+       *  load balanced and by resize and compress. Objects reading the grid
+       *  or managed dofs on a background thread (e.g., asynchronous output
+       *  in DataOutput) use this to finish reading first.
+       *
+       *  \param[in]  owner     key to remove the callback again
+       *  \param[in]  callback  function to call
+       */
+      void addPreModificationCallback ( const void *owner, std::function< void () > callback )
+      {
+        preModificationCallbacks_.emplace_back( owner, std::move( callback ) );
+      }
+
+      //! remove all callbacks registered by the given owner
+      void removePreModificationCallback ( const void *owner )
+      {
+        preModificationCallbacks_.erase( std::remove_if( preModificationCallbacks_.begin(), preModificationCallbacks_.end(),
+                                                         [ owner ] ( const auto &callback ) { return (callback.first == owner); } ),
+                                         preModificationCallbacks_.end() );
+      }
+
+      //! invoke all callbacks registered by addPreModificationCallback
+      void preModification () const
+      {
+        for( const auto &callback : preModificationCallbacks_ )
+          callback.second();
+      }
+
       /** \brief resize memory before data restriction
           during grid adaptation is done.
       */
       void resizeForRestrict ()
       {
+        preModification();
         resizeMemory();
       }
 
@@ -1043,6 +1252,7 @@ namespace Dune
       */
       void resize()
       {
+        preModification();
         for(auto indexSetPtr : indexList_)
           indexSetPtr->resize();
         resizeMemory();
@@ -1098,6 +1308,8 @@ namespace Dune
       */
       void compress()
       {
+        preModification();
+
         // mark next sequence
         incrementSequenceNumber ();
 
@@ -1106,14 +1318,32 @@ namespace Dune
           // reset compressed so the next time compress of index set is called
           indexSetPtr->compress();
 
-        // compress all data now
+        // compute data movement once for each mapper
+        DofCompressPlanCache plans;
         for(auto memObjectPtr : memList_)
-          // if correponding index was not compressed yet, this is called in
-          // the MemObject dofCompress, if index has not changes, nothing happens
-          // if IndexSet actual needs  no compress, nothing happens to the
-          // data either
-          // also data is resized, which means the vector is getting shorter
-          memObjectPtr->dofCompress ();
+          memObjectPtr->prepareDofCompress( plans );
+
+        // compress all data now
+        // if IndexSet actual needs no compress, nothing happens to the
+        // data either, also data is resized, which means the vector is
+        // getting shorter
+        std::vector< ManagedDofStorageInterface * > threadSafe;
+        const int threads = availableThreads();
+        for( auto memObjectPtr : memList_ )
+        {
+          // storages that did not opt in are compressed one after the other
+          if( memObjectPtr->threadSafeDofCompress() )
+            threadSafe.push_back( memObjectPtr );
+          else
+            memObjectPtr->dofCompress( plans, threads > 1 );
+        }
+
+        // distribute the storages over the threads if there are enough of
+        // them, otherwise the copies within each storage are distributed
+        const bool threadedStorages = (threads > 1) && (threadSafe.size() >= std::size_t( threads ));
+        parallelFor( 0, threadSafe.size(), 1, [ &threadSafe, &plans, threads, threadedStorages ] ( std::size_t i ) {
+            threadSafe[ i ]->dofCompress( plans, (threads > 1) && !threadedStorages );
+          }, threadedStorages ? threads : 1 );
       }
 
       //! communicate new sequence number
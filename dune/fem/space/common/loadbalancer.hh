@@ -1,6 +1,7 @@
 #ifndef DUNE_FEM_LOADBALANCER_HH
 #define DUNE_FEM_LOADBALANCER_HH
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <set>
@@ -55,10 +56,63 @@ namespace Dune
       }
     };
 
+    /** \brief statistics of the last call to LoadBalancer::loadBalance
+     *
+     *  Imbalances are given as the ratio of the maximum and the mean over all
+     *  ranks. The migrated bytes are the bytes of dof data packed and
+     *  unpacked by the data collectors of the DofManager.
+     */
+    struct LoadBalanceStatistics
+    {
+      //! true if the grid's load balancing was called
+      bool balanced = false;
+      //! time for the load balancing (including data migration)
+      double time = 0.0;
+      //! bytes of dof data that left their rank (sum over all ranks)
+      double bytesMoved = 0.0;
+      //! bytes of dof data that arrived on their new rank (sum over all ranks)
+      double bytesReceived = 0.0;
+      //! imbalance of the measured compute time per step (1 if not measured)
+      double computeImbalance = 1.0;
+      //! imbalance of the dof memory before and after load balancing
+      double imbalanceBefore = 1.0;
+      double imbalanceAfter = 1.0;
+      //! compute time saved within the horizon and estimated migration time
+      double projectedGain = 0.0;
+      double projectedCost = 0.0;
+    };
+
+    inline std::ostream &operator<< ( std::ostream &out, const LoadBalanceStatistics &stats )
+    {
+      out << "LoadBalancer: " << (stats.balanced ? "balanced" : "skipped")
+          << ", compute imbalance = " << stats.computeImbalance
+          << ", projected gain = " << stats.projectedGain << "s"
+          << ", projected cost = " << stats.projectedCost << "s";
+      if( stats.balanced )
+        out << ", time = " << stats.time << "s"
+            << ", bytes moved = " << stats.bytesMoved << " (received " << stats.bytesReceived << ")"
+            << ", dof imbalance = " << stats.imbalanceBefore << " -> " << stats.imbalanceAfter;
+      return out;
+    }
+
     /*! \brief This class manages the adaptation process.
      If the method adapt is called, then the grid is adapted and also
      all the data belonging to the given dof manager will be rearranged
      for data set where it is necessary to keep the data.
+
+     If the compute time of each time step is reported by addComputeTime,
+     the load balancing is only carried out if it pays off, i.e., if the
+     compute time saved within the next steps exceeds the estimated time for
+     migrating the dof data. The following parameters are used:
+     \code
+       # number of steps the balanced partition is expected to be used,
+       # 0 disables the cost model, i.e., load balancing is always done
+       fem.loadbalancing.horizon: 0 # default value
+
+       # initial estimate for the migration bandwidth in bytes per second,
+       # replaced by the measured bandwidth after the first load balancing
+       fem.loadbalancing.bandwidth: 1e9 # default value
+     \endcode
      */
     template <class GridType>
     class LoadBalancer
@@ -85,24 +139,28 @@ namespace Dune
     protected:
       /** \brief constructor of LoadBalancer **/
       template< class RestrictProlongOperator >
-      LoadBalancer ( GridType &grid, RestrictProlongOperator &rpOp )
+      LoadBalancer ( GridType &grid, RestrictProlongOperator &rpOp, const ParameterReader &parameter = Parameter::container() )
       : grid_( grid ),
         dm_ ( DofManagerType::instance( grid_ ) ),
         localList_(),
         collList_(),
         commList_(rpOp),
-        balanceTime_( 0.0 )
+        balanceTime_( 0.0 ),
+        horizon_( parameter.getValue< int >( "fem.loadbalancing.horizon", 0 ) ),
+        bandwidth_( parameter.getValidValue( "fem.loadbalancing.bandwidth", double( 1e9 ), [] ( double v ) { return v > 0.0; } ) )
       {
         rpOp.addToLoadBalancer( *this );
       }
 
-      explicit LoadBalancer ( GridType &grid )
+      explicit LoadBalancer ( GridType &grid, const ParameterReader &parameter = Parameter::container() )
       : grid_( grid ),
         dm_ ( DofManagerType::instance( grid_ ) ),
         localList_(),
         collList_(),
         commList_(),
-        balanceTime_( 0.0 )
+        balanceTime_( 0.0 ),
+        horizon_( parameter.getValue< int >( "fem.loadbalancing.horizon", 0 ) ),
+        bandwidth_( parameter.getValidValue( "fem.loadbalancing.bandwidth", double( 1e9 ), [] ( double v ) { return v > 0.0; } ) )
       {}
 
     public:
@@ -152,11 +210,51 @@ namespace Dune
         // make sure this is only called in single thread mode
         assert( Fem :: ThreadManager :: singleThreadMode() );
 
+        const auto &comm = grid_.comm();
+        const int size = comm.size();
+
+        // the grid and the dofs are modified from here on
+        dm_.preModification();
+
+        LoadBalanceStatistics stats;
+
+        // dof memory on this rank before load balancing
+        const double bytes = dm_.usedMemorySize();
+        stats.imbalanceBefore = imbalance( comm.max( bytes ), comm.sum( bytes ) / size );
+
+        // cost model: only balance if the gain within the horizon exceeds the migration cost
+        if( (horizon_ > 0) && (comm.min( computeSteps_ ) > 0) )
+        {
+          const double time = computeTime_ / computeSteps_;
+          const double maxTime = comm.max( time );
+          const double meanTime = comm.sum( time ) / size;
+          stats.computeImbalance = imbalance( maxTime, meanTime );
+          stats.projectedGain = horizon_ * (maxTime - meanTime);
+
+          // data an overloaded rank has to send to reach the mean load
+          const double leaving = (time > meanTime) ? bytes * (1.0 - meanTime / time) : 0.0;
+          stats.projectedCost = comm.max( leaving ) / bandwidth_;
+
+          if( stats.projectedGain <= stats.projectedCost )
+          {
+            statistics_ = stats;
+            if( Parameter::verbose() && (comm.rank() == 0) )
+              std::cout << statistics_ << std::endl;
+
+            // only restore data consistency
+            communicate();
+            return false;
+          }
+        }
+
         // get stopwatch
         Dune::Timer timer ;
 
         bool changed = false;
 
+        // count the dof data actually sent and received
+        dm_.resetMigratedBytes();
+
         try {
           // call grids load balance, only implemented in ALUGrid right now
           changed = grid_.loadBalance( dm_ );
@@ -173,9 +271,49 @@ namespace Dune
         // restore data consistency
         communicate();
 
+        // statistics and measured migration bandwidth
+        const double bytesAfter = dm_.usedMemorySize();
+        const double sent = dm_.packedBytes();
+        const double received = dm_.unpackedBytes();
+        stats.balanced = true;
+        stats.time = comm.max( balanceTime_ );
+        stats.bytesMoved = comm.sum( sent );
+        stats.bytesReceived = comm.sum( received );
+        stats.imbalanceAfter = imbalance( comm.max( bytesAfter ), comm.sum( bytesAfter ) / size );
+
+        // the slowest rank determines the bandwidth
+        const double maxMoved = comm.max( std::max( sent, received ) );
+        if( (maxMoved > 0.0) && (stats.time > 0.0) )
+          bandwidth_ = maxMoved / stats.time;
+
+        statistics_ = stats;
+        if( Parameter::verbose() && (comm.rank() == 0) )
+          std::cout << statistics_ << std::endl;
+
+        // start new measurement for the new partition
+        computeTime_ = 0.0;
+        computeSteps_ = 0;
+
         return changed;
       }
 
+      /** \brief report the compute time of this rank for one time step
+       *
+       *  The average over all steps since the last load balancing is used by
+       *  the cost model (see fem.loadbalancing.horizon).
+       */
+      void addComputeTime ( double time )
+      {
+        computeTime_ += time;
+        ++computeSteps_;
+      }
+
+      //! return statistics of the last load balancing
+      const LoadBalanceStatistics &statistics () const
+      {
+        return statistics_;
+      }
+
       /** @copydoc LoadBalancerInterface::loadBalanceTime */
       virtual double loadBalanceTime() const
       {
@@ -253,6 +391,11 @@ namespace Dune
       }
 
     protected:
+      static double imbalance ( double max, double mean )
+      {
+        return (mean > 0.0) ? max / mean : 1.0;
+      }
+
       //! corresponding grid
       GridType & grid_;
 
@@ -270,6 +413,14 @@ namespace Dune
 
       // time for last load balance call
       double balanceTime_;
+
+      // cost model
+      const int horizon_;
+      double bandwidth_;
+      double computeTime_ = 0.0;
+      int computeSteps_ = 0;
+
+      LoadBalanceStatistics statistics_;
     };
 
     /** @} end documentation group */
@@ -0,0 +1,192 @@
+#ifndef DUNE_FEM_SPACE_COMMON_LOCALRESTRICTPROLONGMATRIX_HH
+#define DUNE_FEM_SPACE_COMMON_LOCALRESTRICTPROLONGMATRIX_HH
+
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <dune/geometry/type.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    /** @addtogroup RestrictProlongImpl
+        @{
+    **/
+
+    // LocalRestrictProlongMatrix
+    // --------------------------
+
+    /** \brief dense matrix mapping local dofs of a son to local dofs of its
+     *         father (or vice versa)
+     *
+     *  The local dofs are gathered into a contiguous buffer and the matrix is
+     *  applied row by row, four rows at a time.
+     */
+    template< class Field >
+    class LocalRestrictProlongMatrix
+    {
+    public:
+      typedef Field FieldType;
+
+      LocalRestrictProlongMatrix () = default;
+
+      LocalRestrictProlongMatrix ( int rows, int cols )
+        : rows_( rows ), cols_( cols ), values_( rows*cols, FieldType( 0 ) )
+      {}
+
+      int rows () const { return rows_; }
+      int cols () const { return cols_; }
+
+      FieldType &operator() ( int i, int j ) { assert( (i < rows_) && (j < cols_) ); return values_[ i*cols_ + j ]; }
+      const FieldType &operator() ( int i, int j ) const { assert( (i < rows_) && (j < cols_) ); return values_[ i*cols_ + j ]; }
+
+      /** \brief compute \f$y_i = \alpha \sum_j A_{ij} x_j\f$ (or add it to \f$y_i\f$)
+       *
+       *  \param[in]   alpha  scaling factor
+       *  \param[in]   x      local dof vector with cols() entries
+       *  \param[out]  y      local dof vector with rows() entries
+       *  \param[in]   add    add to y instead of overwriting it
+       */
+      template< class X, class Y >
+      void apply ( const FieldType &alpha, const X &x, Y &y, bool add = false ) const
+      {
+        x_.resize( cols_ );
+        for( int j = 0; j < cols_; ++j )
+          x_[ j ] = x[ j ];
+
+        int i = 0;
+        for( ; i+4 <= rows_; i += 4 )
+        {
+          const FieldType *a0 = &values_[ i*cols_ ];
+          const FieldType *a1 = a0 + cols_, *a2 = a1 + cols_, *a3 = a2 + cols_;
+          FieldType y0( 0 ), y1( 0 ), y2( 0 ), y3( 0 );
+          for( int j = 0; j < cols_; ++j )
+          {
+            y0 += a0[ j ] * x_[ j ];
+            y1 += a1[ j ] * x_[ j ];
+            y2 += a2[ j ] * x_[ j ];
+            y3 += a3[ j ] * x_[ j ];
+          }
+          store( y, i, alpha*y0, add );
+          store( y, i+1, alpha*y1, add );
+          store( y, i+2, alpha*y2, add );
+          store( y, i+3, alpha*y3, add );
+        }
+        for( ; i < rows_; ++i )
+        {
+          const FieldType *a = &values_[ i*cols_ ];
+          FieldType yi( 0 );
+          for( int j = 0; j < cols_; ++j )
+            yi += a[ j ] * x_[ j ];
+          store( y, i, alpha*yi, add );
+        }
+      }
+
+    private:
+      template< class Y >
+      static void store ( Y &y, int i, const FieldType &value, bool add )
+      {
+        if( add )
+          y[ i ] += value;
+        else
+          y[ i ] = value;
+      }
+
+      int rows_ = 0, cols_ = 0;
+      std::vector< FieldType > values_;
+      mutable std::vector< FieldType > x_;
+    };
+
+
+
+    // LocalRestrictProlongMatrixCache
+    // -------------------------------
+
+    /** \brief cache for data of local restriction and prolongation operators
+     *
+     *  For refinement rules that do not depend on the element, the local
+     *  restriction and prolongation (and the change of polynomial order) are
+     *  linear maps that only depend on the geometry types of father and son,
+     *  the position of the son within the father (i.e., the corners of
+     *  geometryInFather) and the local basis function sets, which are
+     *  identified by their size.
+     *
+     *  \note The cache is not thread safe. RestrictProlongDefault keeps one
+     *        copy of the local operators (and hence of the cache) per thread.
+     */
+    template< class Value, class ctype >
+    class LocalRestrictProlongMatrixCache
+    {
+      typedef std::tuple< unsigned int, int, unsigned int, int, int, int, std::vector< ctype > > KeyType;
+
+    public:
+      typedef Value ValueType;
+
+      /** \brief find the cached value or create it
+       *
+       *  \param[in]  fatherType        geometry type of the father
+       *  \param[in]  sonType           geometry type of the son
+       *  \param[in]  geometryInFather  geometry of the son within the father
+       *  \param[in]  rows              size of the destination basis function set
+       *  \param[in]  cols              size of the source basis function set
+       *  \param[in]  init              functor filling a new value
+       */
+      template< class LocalGeometry, class Init >
+      const ValueType &get ( const GeometryType &fatherType, const GeometryType &sonType, const LocalGeometry &geometryInFather,
+                             int rows, int cols, Init &&init )
+      {
+        std::vector< ctype > corners;
+        corners.reserve( geometryInFather.corners() * LocalGeometry::coorddimension );
+        for( int i = 0; i < geometryInFather.corners(); ++i )
+        {
+          const auto corner = geometryInFather.corner( i );
+          for( int k = 0; k < LocalGeometry::coorddimension; ++k )
+            corners.push_back( corner[ k ] );
+        }
+        return get( KeyType( fatherType.id(), fatherType.dim(), sonType.id(), sonType.dim(), rows, cols, std::move( corners ) ),
+                    std::forward< Init >( init ) );
+      }
+
+      /** \brief find the cached value (not depending on a son) or create it */
+      template< class Init >
+      const ValueType &get ( const GeometryType &type, int rows, int cols, Init &&init )
+      {
+        return get( KeyType( type.id(), type.dim(), type.id(), type.dim(), rows, cols, std::vector< ctype >() ), std::forward< Init >( init ) );
+      }
+
+      //! remove all cached values
+      void clear () { values_.clear(); }
+
+      //! number of cached values
+      std::size_t size () const { return values_.size(); }
+
+    private:
+      template< class Init >
+      const ValueType &get ( KeyType &&key, Init &&init )
+      {
+        auto it = values_.find( key );
+        if( it == values_.end() )
+        {
+          ValueType value;
+          init( value );
+          it = values_.emplace( std::move( key ), std::move( value ) ).first;
+        }
+        return it->second;
+      }
+
+      std::map< KeyType, ValueType > values_;
+    };
+
+    ///@}
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_SPACE_COMMON_LOCALRESTRICTPROLONGMATRIX_HH
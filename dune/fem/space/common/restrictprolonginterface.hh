@@ -5,9 +5,15 @@
 #include <dune/common/bartonnackmanifcheck.hh>
 #include <dune/grid/common/capabilities.hh>
 
+//- system includes
+#include <cassert>
+#include <memory>
+#include <vector>
+
 //- local includes
 #include <dune/fem/function/localfunction/const.hh>
 #include <dune/fem/function/localfunction/temporary.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
 #include <dune/fem/space/common/localrestrictprolong.hh>
 
 namespace Dune
@@ -187,10 +193,13 @@ namespace Dune
       typedef DefaultLocalRestrictProlong< DiscreteFunctionSpaceType > LocalRestrictProlongType;
 
       explicit RestrictProlongDefault ( DiscreteFunctionType &discreteFunction )
-      : discreteFunction_( discreteFunction ),
-        constLf_( discreteFunction ),
-        localRP_( discreteFunction_.space() )
+      : discreteFunction_( discreteFunction )
       {
+        // one local function and local operator per thread, so that fathers
+        // not sharing dofs can be restricted (prolonged) concurrently
+        for( int thread = 0; thread < ThreadManager::maxThreads(); ++thread )
+          local_.emplace_back( new LocalData( discreteFunction_ ) );
+
         // enable dof compression for this discrete function
         discreteFunction_.enableDofCompression();
       }
@@ -208,7 +217,8 @@ namespace Dune
        */
       void setFatherChildWeight ( const DomainFieldType &weight ) const
       {
-        localRP_.setFatherChildWeight( weight );
+        for( const auto &local : local_ )
+          local->localRP.setFatherChildWeight( weight );
       }
 
       //! restrict data to father
@@ -233,10 +243,11 @@ namespace Dune
                            const LocalGeometry &geometryInFather,
                            bool initialize ) const
       {
-        constLf_.init( son );
+        LocalData &local = localData();
+        local.constLf.init( son );
         LocalFunctionType lfFather = discreteFunction_.localFunction( father );
 
-        localRP_.restrictLocal( lfFather, constLf_, geometryInFather, initialize );
+        local.localRP.restrictLocal( lfFather, local.constLf, geometryInFather, initialize );
       }
 
       //! prolong data to children
@@ -261,17 +272,18 @@ namespace Dune
                           const LocalGeometry &geometryInFather,
                           bool initialize ) const
       {
-        constLf_.init( father );
+        LocalData &local = localData();
+        local.constLf.init( father );
         LocalFunctionType lfSon = discreteFunction_.localFunction( son );
 
-        localRP_.prolongLocal( constLf_, lfSon, geometryInFather, initialize );
+        local.localRP.prolongLocal( local.constLf, lfSon, geometryInFather, initialize );
       }
 
       //! add discrete function to communicator with given unpack operation
       template< class Communicator, class Operation >
       void addToList ( Communicator &comm, const Operation& op)
       {
-        if( localRP_.needCommunication() )
+        if( local_[ 0 ]->localRP.needCommunication() )
           comm.addToList( discreteFunction_, op );
       }
 
@@ -279,7 +291,7 @@ namespace Dune
       template< class Communicator >
       void addToList ( Communicator &comm  )
       {
-        if( localRP_.needCommunication() )
+        if( local_[ 0 ]->localRP.needCommunication() )
           comm.addToList( discreteFunction_ );
       }
 
@@ -287,7 +299,7 @@ namespace Dune
       template< class Communicator >
       void removeFromList ( Communicator &comm )
       {
-        if( localRP_.needCommunication() )
+        if( local_[ 0 ]->localRP.needCommunication() )
           comm.removeFromList( discreteFunction_ );
       }
 
@@ -298,10 +310,42 @@ namespace Dune
         lb.addToLoadBalancer( discreteFunction_ );
       }
 
+      /** \brief return true, if all degrees of freedom are attached to elements
+       *
+       *  In this case, restriction and prolongation on different fathers
+       *  never write to the same degrees of freedom and may be called
+       *  concurrently by the threads of the ThreadManager.
+       */
+      bool elementLocalDofs () const
+      {
+        const auto &blockMapper = discreteFunction_.space().blockMapper();
+        for( int codim = 1; codim <= GridPartType::dimension; ++codim )
+        {
+          if( blockMapper.contains( codim ) )
+            return false;
+        }
+        return true;
+      }
+
     protected:
+      struct LocalData
+      {
+        explicit LocalData ( DiscreteFunctionType &discreteFunction )
+          : constLf( discreteFunction ), localRP( discreteFunction.space() )
+        {}
+
+        LocalFunctionType constLf;
+        LocalRestrictProlongType localRP;
+      };
+
+      LocalData &localData () const
+      {
+        assert( ThreadManager::thread() < static_cast< int >( local_.size() ) );
+        return *local_[ ThreadManager::thread() ];
+      }
+
       DiscreteFunctionType &discreteFunction_;
-      mutable LocalFunctionType constLf_;
-      mutable LocalRestrictProlongType localRP_;
+      std::vector< std::unique_ptr< LocalData > > local_;
     };
     ///@}
 
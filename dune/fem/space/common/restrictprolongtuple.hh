@@ -49,6 +49,7 @@ namespace Dune
 
       template< int i > struct AddToList;
       template< int i > struct AddToLoadBalancer;
+      template< int i > struct ElementLocalDofs;
       template< int i > struct ProlongLocal;
       template< int i > struct RestrictLocal;
       template< int i > struct SetFatherChildWeight;
@@ -132,6 +133,14 @@ namespace Dune
         Dune::Fem::ForLoop< AddToLoadBalancer, 0, sizeof...( Tail ) >::apply( loadBalancer, tuple_ );
       }
 
+      /** \copydoc Dune::Fem::RestrictProlongDefault::elementLocalDofs */
+      bool elementLocalDofs () const
+      {
+        bool local = true;
+        Dune::Fem::ForLoop< ElementLocalDofs, 0, sizeof...( Tail ) >::apply( local, tuple_ );
+        return local;
+      }
+
       /** \} */
 
     private:
@@ -178,6 +187,21 @@ namespace Dune
 
 
 
+    // RestrictProlongTuple< Head, Tail... >::ElementLocalDofs
+    // -------------------------------------------------------
+
+    template< class Head, class... Tail >
+    template< int i >
+    struct RestrictProlongTuple< Head, Tail... >::ElementLocalDofs
+    {
+      static void apply ( bool &local, const std::tuple< Head, Tail... > &tuple )
+      {
+        local = local && std::get< i >( tuple ).elementLocalDofs();
+      }
+    };
+
+
+
     // RestrictProlongTuple< Head, Tail... >::ProlongLocal
     // ---------------------------------------------------
 
@@ -1,11 +1,19 @@
 #ifndef DUNE_FEM_SPACE_DISCONTINUOUSGALERKIN_LOCALRESTRICTPROLONG_HH_
 #define DUNE_FEM_SPACE_DISCONTINUOUSGALERKIN_LOCALRESTRICTPROLONG_HH_
 
+// C++ includes
+#include <algorithm>
+#include <vector>
+
+// dune-common includes
+#include <dune/common/dynmatrix.hh>
+
 // dune-fem includes
 #include <dune/fem/function/localfunction/temporary.hh>
 #include <dune/fem/quadrature/cachingquadrature.hh>
 #include <dune/fem/space/common/adaptationmanager.hh>
 #include <dune/fem/space/common/localrestrictprolong.hh>
+#include <dune/fem/space/common/localrestrictprolongmatrix.hh>
 
 // local includes
 #include "declaration.hh"
@@ -26,6 +34,14 @@ namespace Dune
     // DiscontinuousGalerkinLocalRestrictProlong
     // -----------------------------------------
 
+    /** \brief local L2 projection between father and son for discontinuous spaces
+     *
+     *  The projections only depend on the position of the son within the
+     *  father and the local basis function sets. Therefore, they are
+     *  computed once as dense matrices and cached. If the mass matrix has to
+     *  be inverted (applyInverse), this only holds for affine geometries; for
+     *  other geometries the projection is computed by quadrature each time.
+     */
     template< class DiscreteFunctionSpace, bool applyInverse >
     class DiscontinuousGalerkinLocalRestrictProlong
     {
@@ -44,6 +60,16 @@ namespace Dune
 
       typedef LocalMassMatrix< DiscreteFunctionSpaceType, QuadratureType > LocalMassMatrixType;
 
+    private:
+      struct Matrices
+      {
+        LocalRestrictProlongMatrix< RangeFieldType > restriction, prolongation;
+      };
+
+      typedef LocalRestrictProlongMatrixCache< Matrices, typename GridPartType::GridType::ctype > MatrixCacheType;
+
+    public:
+
       DiscontinuousGalerkinLocalRestrictProlong ( const DiscreteFunctionSpaceType& space )
       : localMassMatrix_( space, space.order() * 2 ),
         weight_( -1 ),
@@ -65,6 +91,15 @@ namespace Dune
 
         assert( weight > 0.0 );
 
+        if( cacheable( lfFather.entity(), lfSon.entity() ) )
+        {
+          // for affine geometries, the ratio of the integration elements is the volume ratio
+          const Matrices &m = matrices( lfFather, lfSon, geometryInFather );
+          m.restriction.apply( applyInverse ? lfSon.entity().geometry().volume() / lfFather.entity().geometry().volume() : weight,
+                               lfSon, lfFather, !initialize );
+          return;
+        }
+
         if( initialize )
           lfFather.clear();
 
@@ -116,6 +151,12 @@ namespace Dune
       void prolongLocal ( const LFFather &lfFather, LFSon &lfSon,
                           const LocalGeometry &geometryInFather, bool initialize ) const
       {
+        if( cacheable( lfFather.entity(), lfSon.entity() ) )
+        {
+          matrices( lfFather, lfSon, geometryInFather ).prolongation.apply( RangeFieldType( 1 ), lfFather, lfSon );
+          return;
+        }
+
         lfSon.clear();
 
         typedef typename LFSon :: EntityType  EntityType ;
@@ -152,9 +193,90 @@ namespace Dune
       bool needCommunication () const { return true; }
 
     protected:
+      template< class Entity >
+      static bool cacheable ( const Entity &father, const Entity &son )
+      {
+        return !applyInverse || (father.geometry().affine() && son.geometry().affine());
+      }
+
+      template< class LFFather, class LFSon, class LocalGeometry >
+      const Matrices &matrices ( const LFFather &lfFather, const LFSon &lfSon, const LocalGeometry &geometryInFather ) const
+      {
+        const auto &fatherSet = lfFather.basisFunctionSet();
+        const auto &sonSet = lfSon.basisFunctionSet();
+        const int fatherSize = fatherSet.size();
+        const int sonSize = sonSet.size();
+
+        return matrixCache_.get( lfFather.entity().type(), lfSon.entity().type(), geometryInFather, fatherSize, sonSize, [ & ] ( Matrices &m ) {
+            std::vector< RangeType > phiFather( fatherSize ), phiSon( sonSize );
+
+            // B_ij = int_son phi^father_i phi^son_j on the reference element
+            DynamicMatrix< RangeFieldType > B( fatherSize, sonSize, RangeFieldType( 0 ) );
+            QuadratureType quad( lfSon.entity(), 2*std::max( lfFather.order(), lfSon.order() )+1 );
+            for( const auto qp : quad )
+            {
+              fatherSet.evaluateAll( geometryInFather.global( qp.position() ), phiFather );
+              sonSet.evaluateAll( qp, phiSon );
+              for( int i = 0; i < fatherSize; ++i )
+                for( int j = 0; j < sonSize; ++j )
+                  B[ i ][ j ] += qp.weight() * (phiFather[ i ] * phiSon[ j ]);
+            }
+
+            DynamicMatrix< RangeFieldType > fatherMassInv( fatherSize, fatherSize, RangeFieldType( 0 ) );
+            DynamicMatrix< RangeFieldType > sonMassInv( sonSize, sonSize, RangeFieldType( 0 ) );
+            if( applyInverse )
+            {
+              referenceMassMatrix( lfFather.entity(), fatherSet, lfFather.order(), fatherMassInv );
+              referenceMassMatrix( lfSon.entity(), sonSet, lfSon.order(), sonMassInv );
+              fatherMassInv.invert();
+              sonMassInv.invert();
+            }
+
+            m.restriction = LocalRestrictProlongMatrix< RangeFieldType >( fatherSize, sonSize );
+            for( int i = 0; i < fatherSize; ++i )
+              for( int j = 0; j < sonSize; ++j )
+              {
+                if( applyInverse )
+                  for( int k = 0; k < fatherSize; ++k )
+                    m.restriction( i, j ) += fatherMassInv[ i ][ k ] * B[ k ][ j ];
+                else
+                  m.restriction( i, j ) = B[ i ][ j ];
+              }
+
+            m.prolongation = LocalRestrictProlongMatrix< RangeFieldType >( sonSize, fatherSize );
+            for( int j = 0; j < sonSize; ++j )
+              for( int i = 0; i < fatherSize; ++i )
+              {
+                if( applyInverse )
+                  for( int k = 0; k < sonSize; ++k )
+                    m.prolongation( j, i ) += sonMassInv[ j ][ k ] * B[ i ][ k ];
+                else
+                  m.prolongation( j, i ) = B[ i ][ j ];
+              }
+          } );
+      }
+
+      // mass matrix of the basis functions on the reference element
+      template< class Entity, class BasisFunctionSet >
+      static void referenceMassMatrix ( const Entity &entity, const BasisFunctionSet &basisSet, int order,
+                                        DynamicMatrix< RangeFieldType > &mass )
+      {
+        const int size = basisSet.size();
+        std::vector< RangeType > phi( size );
+        QuadratureType quad( entity, 2*order );
+        for( const auto qp : quad )
+        {
+          basisSet.evaluateAll( qp, phi );
+          for( int i = 0; i < size; ++i )
+            for( int j = 0; j < size; ++j )
+              mass[ i ][ j ] += qp.weight() * (phi[ i ] * phi[ j ]);
+        }
+      }
+
       LocalMassMatrixType localMassMatrix_;
       DomainFieldType weight_;
       mutable TemporaryLocalFunction< DiscreteFunctionSpace > temp_;
+      mutable MatrixCacheType matrixCache_;
     };
 
 
@@ -3,6 +3,8 @@
 
 // C++ includes
 #include <map>
+#include <memory>
+#include <vector>
 
 // dune-geometry includes
 #include <dune/geometry/referenceelements.hh>
@@ -10,6 +12,7 @@
 
 // dune-fem includes
 #include <dune/fem/gridpart/leafgridpart.hh>
+#include <dune/fem/space/common/localrestrictprolongmatrix.hh>
 
 // local includes
 #include "lagrangepoints.hh"
@@ -21,6 +24,12 @@ namespace Dune
   namespace Fem
   {
 
+    /** \brief local restriction and prolongation for Lagrange spaces
+     *
+     *  The evaluations of the basis functions in the Lagrange points are
+     *  cached as dense matrices for each position of the son within the
+     *  father.
+     */
     template< class G, int ord >
     struct LagrangeLocalRestrictProlong
     {
@@ -37,17 +46,18 @@ namespace Dune
       typedef typename LagrangePointSetType::template Codim< 0 >::SubEntityIteratorType
         EntityDofIterator;
 
-      typedef std::map< const GeometryType, const LagrangePointSetType * > LagrangePointSetMapType;
+      typedef std::map< const GeometryType, std::unique_ptr< const LagrangePointSetType > > LagrangePointSetMapType;
 
-    public:
-      ~LagrangeLocalRestrictProlong ()
+      // local father dofs (in the son) and basis function evaluations
+      struct LocalMatrix
       {
-        typedef typename LagrangePointSetMapType::iterator Iterator;
-        const Iterator end = lagrangePointSet_.end();
-        for( Iterator it = lagrangePointSet_.begin(); it != end; ++it )
-          delete it->second;
-      }
+        std::vector< int > rows;
+        LocalRestrictProlongMatrix< ctype > matrix;
+      };
+
+      typedef LocalRestrictProlongMatrixCache< LocalMatrix, ctype > MatrixCacheType;
 
+    public:
       template< class DomainField >
       void setFatherChildWeight ( const DomainField &weight ) {}
 
@@ -59,24 +69,44 @@ namespace Dune
       {
         static const int dimRange = LFSon::dimRange;
 
-        const auto &refSon = Dune::ReferenceElements< ctype, dimension >::general( lfSon.entity().type() );
-
-        const LagrangePointSetType &pointSet = lagrangePointSet( lfFather.entity() );
-
-        const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
-        for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
-        {
-          const unsigned int dof = *sit;
-          const DomainVector &pointInFather = pointSet.point( dof );
-          const DomainVector pointInSon = geometryInFather.local( pointInFather );
-          if( refSon.checkInside( pointInSon ) )
-          {
-            typename LFSon::RangeType phi;
-            lfSon.evaluate( pointInSon, phi );
-            for( int coordinate = 0; coordinate < dimRange; ++coordinate )
-              lfFather[ dimRange * dof + coordinate ] = phi[ coordinate ];
-          }
-        }
+        const auto &sonSet = lfSon.basisFunctionSet();
+        const int sonSize = sonSet.size();
+
+        const LocalMatrix &local = restrictionCache_.get( lfFather.entity().type(), lfSon.entity().type(), geometryInFather, lfFather.size(), sonSize, [ & ] ( LocalMatrix &m ) {
+            const auto &refSon = Dune::ReferenceElements< ctype, dimension >::general( lfSon.entity().type() );
+
+            const LagrangePointSetType &pointSet = lagrangePointSet( lfFather.entity() );
+
+            std::vector< DomainVector > points;
+            const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
+            for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
+            {
+              const unsigned int dof = *sit;
+              const DomainVector &pointInFather = pointSet.point( dof );
+              const DomainVector pointInSon = geometryInFather.local( pointInFather );
+              if( refSon.checkInside( pointInSon ) )
+              {
+                points.push_back( pointInSon );
+                for( int coordinate = 0; coordinate < dimRange; ++coordinate )
+                  m.rows.push_back( dimRange * dof + coordinate );
+              }
+            }
+
+            m.matrix = LocalRestrictProlongMatrix< ctype >( m.rows.size(), sonSize );
+            std::vector< typename LFSon::RangeType > phi( sonSize );
+            for( std::size_t p = 0; p < points.size(); ++p )
+            {
+              sonSet.evaluateAll( points[ p ], phi );
+              for( int j = 0; j < sonSize; ++j )
+                for( int coordinate = 0; coordinate < dimRange; ++coordinate )
+                  m.matrix( dimRange * p + coordinate, j ) = phi[ j ][ coordinate ];
+            }
+          } );
+
+        values_.resize( local.rows.size() );
+        local.matrix.apply( ctype( 1 ), lfSon, values_ );
+        for( std::size_t i = 0; i < local.rows.size(); ++i )
+          lfFather[ local.rows[ i ] ] = values_[ i ];
       }
 
       template< class LFFather, class LFSon, class LocalGeometry >
@@ -86,20 +116,27 @@ namespace Dune
       {
         static const int dimRange = LFFather::dimRange;
 
-        const LagrangePointSetType &pointSet = lagrangePointSet( lfSon.entity() );
-
-        const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
-        for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
-        {
-          const unsigned int dof = *sit;
-          const DomainVector &pointInSon = pointSet.point( dof );
-          const DomainVector pointInFather = geometryInFather.global( pointInSon );
-
-          typename LFFather::RangeType phi;
-          lfFather.evaluate( pointInFather, phi );
-          for( int coordinate = 0; coordinate < dimRange; ++coordinate )
-            lfSon[ dimRange * dof + coordinate ] = phi[ coordinate ];
-        }
+        const auto &fatherSet = lfFather.basisFunctionSet();
+        const int fatherSize = fatherSet.size();
+
+        const LocalMatrix &local = prolongationCache_.get( lfFather.entity().type(), lfSon.entity().type(), geometryInFather, lfSon.size(), fatherSize, [ & ] ( LocalMatrix &m ) {
+            const LagrangePointSetType &pointSet = lagrangePointSet( lfSon.entity() );
+
+            m.matrix = LocalRestrictProlongMatrix< ctype >( lfSon.size(), fatherSize );
+            std::vector< typename LFFather::RangeType > phi( fatherSize );
+            const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
+            for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
+            {
+              const unsigned int dof = *sit;
+              const DomainVector &pointInSon = pointSet.point( dof );
+              fatherSet.evaluateAll( geometryInFather.global( pointInSon ), phi );
+              for( int j = 0; j < fatherSize; ++j )
+                for( int coordinate = 0; coordinate < dimRange; ++coordinate )
+                  m.matrix( dimRange * dof + coordinate, j ) = phi[ j ][ coordinate ];
+            }
+          } );
+
+        local.matrix.apply( ctype( 1 ), lfFather, lfSon );
       }
 
       bool needCommunication () const { return true; }
@@ -116,13 +153,15 @@ namespace Dune
         typedef typename LagrangePointSetMapType::iterator Iterator;
         Iterator it = lagrangePointSet_.find( type );
         if( it == lagrangePointSet_.end() )
-          it = lagrangePointSet_.insert( it, std::make_pair( type, new LagrangePointSetType( type, ord ) ) );
-        assert( it->second != 0 );
+          it = lagrangePointSet_.emplace_hint( it, type, std::unique_ptr< const LagrangePointSetType >( new LagrangePointSetType( type, ord ) ) );
+        assert( it->second );
         return *(it->second);
       }
 
     private:
       mutable LagrangePointSetMapType lagrangePointSet_;
+      mutable MatrixCacheType restrictionCache_, prolongationCache_;
+      mutable std::vector< ctype > values_;
     };
 
   } // namespace Fem
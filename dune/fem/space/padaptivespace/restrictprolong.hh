@@ -1,9 +1,12 @@
 #ifndef DUNE_FEM_SPACE_PADAPTIVE_RESTRICTPROLONG_HH
 #define DUNE_FEM_SPACE_PADAPTIVE_RESTRICTPROLONG_HH
 
+#include <vector>
+
 #include <dune/geometry/referenceelements.hh>
 
 #include <dune/fem/function/localfunction/localfunction.hh>
+#include <dune/fem/space/common/localrestrictprolongmatrix.hh>
 #include <dune/fem/space/lagrange/lagrangepoints.hh>
 
 
@@ -16,6 +19,14 @@ namespace Dune
     // PLagrangeLocalRestrictProlong
     // -----------------------------
 
+    /** \brief local restriction, prolongation and change of polynomial order
+     *         for p-adaptive Lagrange spaces
+     *
+     *  The evaluations of the basis functions in the Lagrange points are
+     *  cached as dense matrices for each position of the son within the
+     *  father and each pair of polynomial orders (identified by the sizes of
+     *  the local basis function sets).
+     */
     template< class G, class LagrangePointSetProvider >
     struct PLagrangeLocalRestrictProlong
     {
@@ -35,6 +46,15 @@ namespace Dune
       typedef typename LagrangePointSet::template Codim< 0 >::SubEntityIteratorType
         EntityDofIterator;
 
+      // local destination dofs and basis function evaluations
+      struct LocalMatrix
+      {
+        std::vector< int > rows;
+        LocalRestrictProlongMatrix< ctype > matrix;
+      };
+
+      typedef LocalRestrictProlongMatrixCache< LocalMatrix, ctype > MatrixCacheType;
+
     public:
       PLagrangeLocalRestrictProlong ( const LagrangePointSetProvider &lpsProvider )
       : lpsProvider_( lpsProvider )
@@ -52,24 +72,33 @@ namespace Dune
         const Entity &father = lfFather.entity();
         const Entity &son = lfSon.entity();
 
-        auto refSon = referenceElement< ctype, dimension >( son.type() );
-
-        const LagrangePointSet &pointSet = lagrangePointSet( father );
-
-        const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
-        for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
-        {
-          const unsigned int dof = *sit;
-          const DomainVector &pointInFather = pointSet.point( dof );
-          const DomainVector pointInSon = geometryInFather.local( pointInFather );
-          if( refSon.checkInside( pointInSon ) )
-          {
-            typename LFSon::RangeType phi;
-            lfSon.evaluate( pointInSon, phi );
-            for( int coordinate = 0; coordinate < dimRange; ++coordinate )
-              lfFather[ dimRange * dof + coordinate ] = phi[ coordinate ];
-          }
-        }
+        const auto &sonSet = lfSon.basisFunctionSet();
+        const int sonSize = sonSet.size();
+
+        const LocalMatrix &local = restrictionCache_.get( father.type(), son.type(), geometryInFather, lfFather.size(), sonSize, [ & ] ( LocalMatrix &m ) {
+            auto refSon = referenceElement< ctype, dimension >( son.type() );
+
+            const LagrangePointSet &pointSet = lagrangePointSet( father );
+
+            std::vector< DomainVector > points;
+            const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
+            for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
+            {
+              const unsigned int dof = *sit;
+              const DomainVector &pointInFather = pointSet.point( dof );
+              const DomainVector pointInSon = geometryInFather.local( pointInFather );
+              if( refSon.checkInside( pointInSon ) )
+              {
+                points.push_back( pointInSon );
+                for( int coordinate = 0; coordinate < dimRange; ++coordinate )
+                  m.rows.push_back( dimRange * dof + coordinate );
+              }
+            }
+
+            evaluate( sonSet, points, dimRange, m.matrix );
+          } );
+
+        apply( local, lfSon, lfFather );
       }
 
 
@@ -81,23 +110,25 @@ namespace Dune
 
         const Entity &son = lfSon.entity();
 
-        const LagrangePointSet &pointSet = lagrangePointSet( son );
+        const auto &fatherSet = lfFather.basisFunctionSet();
 
-        const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
-        for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
-        {
-          const unsigned int dof = *sit;
-          const DomainVector &pointInSon = pointSet.point( dof );
-          const DomainVector pointInFather = geometryInFather.global( pointInSon );
-
-          typename LFFather::RangeType phi;
-          lfFather.evaluate( pointInFather, phi );
-          for( int coordinate = 0; coordinate < dimRange; ++coordinate )
-          {
-            const int idx = dimRange * dof + coordinate  ;
-            lfSon[ idx ] = phi[ coordinate ];
-          }
-        }
+        const LocalMatrix &local = prolongationCache_.get( lfFather.entity().type(), son.type(), geometryInFather, lfSon.size(), fatherSet.size(), [ & ] ( LocalMatrix &m ) {
+            const LagrangePointSet &pointSet = lagrangePointSet( son );
+
+            std::vector< DomainVector > points;
+            const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
+            for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
+            {
+              const unsigned int dof = *sit;
+              points.push_back( geometryInFather.global( pointSet.point( dof ) ) );
+              for( int coordinate = 0; coordinate < dimRange; ++coordinate )
+                m.rows.push_back( dimRange * dof + coordinate );
+            }
+
+            evaluate( fatherSet, points, dimRange, m.matrix );
+          } );
+
+        apply( local, lfFather, lfSon );
       }
 
       template< class ArgLocal, class DestLocal >
@@ -108,22 +139,26 @@ namespace Dune
 
         const Entity &entity = destLocal.entity();
 
-        const LagrangePointSet &pointSet = lagrangePointSet( entity );
+        const auto &argSet = argLocal.basisFunctionSet();
 
-        const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
-        for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
-        {
-          const unsigned int dof = *sit;
-          const DomainVector &localPoint = pointSet.point( dof );
-
-          typename ArgLocal::RangeType phi;
-          argLocal.evaluate( localPoint, phi );
-          for( int coordinate = 0; coordinate < dimRange; ++coordinate )
-          {
-            const int idx = dimRange * dof + coordinate  ;
-            destLocal[ idx ] = phi[ coordinate ];
-          }
-        }
+        // order raising or lowering matrix
+        const LocalMatrix &local = interpolationCache_.get( entity.type(), destLocal.size(), argSet.size(), [ & ] ( LocalMatrix &m ) {
+            const LagrangePointSet &pointSet = lagrangePointSet( entity );
+
+            std::vector< DomainVector > points;
+            const EntityDofIterator send = pointSet.template endSubEntity< 0 >( 0 );
+            for( EntityDofIterator sit = pointSet.template beginSubEntity< 0 >( 0 ); sit != send; ++sit )
+            {
+              const unsigned int dof = *sit;
+              points.push_back( pointSet.point( dof ) );
+              for( int coordinate = 0; coordinate < dimRange; ++coordinate )
+                m.rows.push_back( dimRange * dof + coordinate );
+            }
+
+            evaluate( argSet, points, dimRange, m.matrix );
+          } );
+
+        apply( local, argLocal, destLocal );
       }
 
       bool needCommunication () const { return false; }
@@ -134,7 +169,35 @@ namespace Dune
       }
 
     protected:
+      // matrix of the basis functions evaluated in the given points
+      template< class BasisFunctionSet >
+      static void evaluate ( const BasisFunctionSet &basisSet, const std::vector< DomainVector > &points, int dimRange,
+                             LocalRestrictProlongMatrix< ctype > &matrix )
+      {
+        const int size = basisSet.size();
+        matrix = LocalRestrictProlongMatrix< ctype >( dimRange * points.size(), size );
+        std::vector< typename BasisFunctionSet::RangeType > phi( size );
+        for( std::size_t p = 0; p < points.size(); ++p )
+        {
+          basisSet.evaluateAll( points[ p ], phi );
+          for( int j = 0; j < size; ++j )
+            for( int coordinate = 0; coordinate < dimRange; ++coordinate )
+              matrix( dimRange * p + coordinate, j ) = phi[ j ][ coordinate ];
+        }
+      }
+
+      template< class X, class Y >
+      void apply ( const LocalMatrix &local, const X &x, Y &y ) const
+      {
+        values_.resize( local.rows.size() );
+        local.matrix.apply( ctype( 1 ), x, values_ );
+        for( std::size_t i = 0; i < local.rows.size(); ++i )
+          y[ local.rows[ i ] ] = values_[ i ];
+      }
+
       const LagrangePointSetProvider& lpsProvider_;
+      mutable MatrixCacheType restrictionCache_, prolongationCache_, interpolationCache_;
+      mutable std::vector< ctype > values_;
     };
 
   } // namespace Fem
@@ -0,0 +1,172 @@
+#include <config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
+#include <dune/fem/space/common/adaptationmanager.hh>
+#include <dune/fem/space/common/dofmanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/common/restrictprolongtuple.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+#include <dune/fem/storage/dynamicarray.hh>
+
+typedef Dune::GridSelector::GridType GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< GridType::ctype, double, GridType::dimensionworld, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+typedef DiscreteFunctionSpaceType::BlockMapperType BlockMapperType;
+
+// a linear function, represented exactly before and after the refinement
+struct LinearFunction
+  : public Dune::Fem::Function< FunctionSpaceType, LinearFunction >
+{
+  explicit LinearFunction ( int k ) : k_( k ) {}
+
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u = k_;
+    for( int i = 0; i < FunctionSpaceType::dimDomain; ++i )
+      u[ 0 ] += (k_ + i + 1) * x[ i ];
+  }
+
+private:
+  int k_;
+};
+
+// a storage that did not opt in to the threaded compression: it records
+// whether it is compressed concurrently to another storage
+struct SerialStorage
+  : public Dune::Fem::ManagedDofStorage< GridType, BlockMapperType, Dune::Fem::DynamicArray< double > >
+{
+  typedef Dune::Fem::ManagedDofStorage< GridType, BlockMapperType, Dune::Fem::DynamicArray< double > > BaseType;
+
+  SerialStorage ( const GridType &grid, const BlockMapperType &mapper, const std::string &name )
+    : BaseType( grid, mapper, name )
+  {
+    this->enableDofCompression();
+  }
+
+  using BaseType::dofCompress;
+
+  void dofCompress ( const Dune::Fem::DofCompressPlanCache &plans, const bool threaded )
+  {
+    if( !Dune::Fem::ThreadManager::singleThreadMode() || (active++ > 0) )
+      ++concurrent;
+    BaseType::dofCompress( plans, threaded );
+    --active;
+    ++calls;
+  }
+
+  bool threadSafeDofCompress () const { return false; }
+
+  static std::atomic< int > active, concurrent, calls;
+};
+
+std::atomic< int > SerialStorage::active( 0 );
+std::atomic< int > SerialStorage::concurrent( 0 );
+std::atomic< int > SerialStorage::calls( 0 );
+
+// compare the discrete function to the linear function in the element centers
+int check ( const DiscreteFunctionType &uh, int k, const std::string &when )
+{
+  const LinearFunction f( k );
+  double error = 0;
+  for( const auto &entity : elements( uh.gridPart() ) )
+  {
+    const auto geometry = entity.geometry();
+    const auto x = geometry.center();
+    FunctionSpaceType::RangeType u, uExact;
+    uh.localFunction( entity ).evaluate( geometry.local( x ), u );
+    f.evaluate( x, uExact );
+    error = std::max( error, std::abs( u[ 0 ] - uExact[ 0 ] ) );
+  }
+
+  if( error < 1e-10 )
+    return 0;
+  std::cerr << "Error: wrong values of '" << uh.name() << "' " << when << " (error = " << error << ")." << std::endl;
+  return 1;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  Dune::GridPtr< GridType > gridPtr( std::to_string( GridType::dimension ) + "dgrid.dgf" );
+  GridType &grid = *gridPtr;
+  GridPartType gridPart( grid );
+  DiscreteFunctionSpaceType space( gridPart );
+
+  // more storages than threads (usually), so the storages are distributed over the threads
+  DiscreteFunctionType u0( "u0", space ), u1( "u1", space ), u2( "u2", space ), u3( "u3", space );
+  DiscreteFunctionType u4( "u4", space ), u5( "u5", space ), u6( "u6", space ), u7( "u7", space );
+  DiscreteFunctionType *u[] = { &u0, &u1, &u2, &u3, &u4, &u5, &u6, &u7 };
+  for( int k = 0; k < 8; ++k )
+    interpolate( gridFunctionAdapter( LinearFunction( k ), gridPart, 1 ), *u[ k ] );
+
+  SerialStorage serial1( grid, space.blockMapper(), "serial1" );
+  SerialStorage serial2( grid, space.blockMapper(), "serial2" );
+
+  typedef Dune::Fem::RestrictProlongDefaultTuple< DiscreteFunctionType, DiscreteFunctionType, DiscreteFunctionType, DiscreteFunctionType,
+                                                  DiscreteFunctionType, DiscreteFunctionType, DiscreteFunctionType, DiscreteFunctionType > RestrictProlongType;
+  RestrictProlongType rp( u0, u1, u2, u3, u4, u5, u6, u7 );
+  Dune::Fem::AdaptationManager< GridType, RestrictProlongType > adaptationManager( grid, rp );
+
+  int errors = 0;
+  for( int step = 0; step < 2; ++step )
+  {
+    // refine all elements: all old leaf indices become holes
+    for( const auto &entity : elements( gridPart ) )
+      grid.mark( 1, entity );
+    adaptationManager.adapt();
+
+    const std::string when = "after refinement " + std::to_string( step );
+    for( int k = 0; k < 8; ++k )
+      errors += check( *u[ k ], k, when );
+
+    if( (serial1.size() != space.blockMapper().size()) || (serial2.size() != space.blockMapper().size()) )
+    {
+      std::cerr << "Error: wrong size of the serial storages " << when << "." << std::endl;
+      ++errors;
+    }
+  }
+
+  if( SerialStorage::calls == 0 )
+  {
+    std::cerr << "Error: serial storages not compressed." << std::endl;
+    ++errors;
+  }
+  if( SerialStorage::concurrent > 0 )
+  {
+    std::cerr << "Error: storages without threadSafeDofCompress compressed concurrently." << std::endl;
+    ++errors;
+  }
+
+  // compressing the storages directly gives the same result
+  Dune::Fem::DofManager< GridType >::instance( grid ).compress();
+  for( int k = 0; k < 8; ++k )
+    errors += check( *u[ k ], k, "after an additional compress" );
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
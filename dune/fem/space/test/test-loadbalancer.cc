@@ -0,0 +1,178 @@
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+
+#include <dune/alugrid/grid.hh>
+#include <dune/alugrid/dgf.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/adaptationmanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/common/restrictprolonginterface.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+
+typedef Dune::ALUGrid< 2, 2, Dune::cube, Dune::nonconforming > GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DiscreteFunctionSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DiscreteFunctionSpaceType > DiscreteFunctionType;
+typedef Dune::Fem::RestrictProlongDefault< DiscreteFunctionType > RestrictProlongType;
+typedef Dune::Fem::AdaptationManager< GridType, RestrictProlongType > AdaptationManagerType;
+
+// a linear function, migrated exactly with the dofs
+struct LinearFunction
+  : public Dune::Fem::Function< FunctionSpaceType, LinearFunction >
+{
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u = 2.0 - x[ 0 ] + 4.0*x[ 1 ];
+  }
+};
+
+const char *unitSquare
+   = "DGF\n\n"
+     "INTERVAL\n"
+     "0 0\n"
+     "1 1\n"
+     "16 16\n"
+     "#\n";
+
+int checkValues ( const DiscreteFunctionType &uh, const std::string &when )
+{
+  const LinearFunction f;
+  double error = 0;
+  for( const auto &element : elements( uh.gridPart(), Dune::Partitions::interior ) )
+  {
+    const auto geometry = element.geometry();
+    FunctionSpaceType::RangeType u, uExact;
+    uh.localFunction( element ).evaluate( geometry.local( geometry.center() ), u );
+    f.evaluate( geometry.center(), uExact );
+    error = std::max( error, std::abs( u[ 0 ] - uExact[ 0 ] ) );
+  }
+
+  if( error < 1e-10 )
+    return 0;
+  std::cerr << "Error: wrong values " << when << " (error = " << error << ")." << std::endl;
+  return 1;
+}
+
+// the cost model uses the given horizon and (initial) bandwidth
+Dune::Fem::ParameterReader parameter ( Dune::ParameterTree &tree, int horizon, double bandwidth )
+{
+  tree[ "fem.loadbalancing.horizon" ] = std::to_string( horizon );
+  tree[ "fem.loadbalancing.bandwidth" ] = std::to_string( bandwidth );
+  return Dune::Fem::parameterReader( tree );
+}
+
+bool close ( double a, double b )
+{
+  return std::abs( a - b ) <= 1e-10 * std::max( std::abs( a ), std::abs( b ) );
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  // the macro grid is read on rank 0, i.e., the load is as unbalanced as possible
+  std::istringstream dgf( unitSquare );
+  Dune::GridPtr< GridType > gridPtr( dgf );
+  GridType &grid = *gridPtr;
+  GridPartType gridPart( grid );
+  const auto &comm = grid.comm();
+  const int size = comm.size();
+
+  DiscreteFunctionSpaceType space( gridPart );
+  DiscreteFunctionType uh( "uh", space );
+  interpolate( gridFunctionAdapter( LinearFunction(), gridPart, 1 ), uh );
+  RestrictProlongType rp( uh );
+
+  // rank 0 needs a second per step, all others nothing
+  const double time = (comm.rank() == 0 ? 1.0 : 0.0);
+  const double meanTime = 1.0 / size;
+
+  int errors = 0;
+
+  // a low bandwidth makes the migration too expensive
+  {
+    Dune::ParameterTree tree;
+    AdaptationManagerType manager( grid, rp, parameter( tree, 10, 1.0 ) );
+    manager.addComputeTime( time );
+
+    const int numElements = gridPart.indexSet().size( 0 );
+    const double bytes = Dune::Fem::DofManager< GridType >::instance( grid ).usedMemorySize();
+    if( manager.loadBalance() || manager.statistics().balanced || (gridPart.indexSet().size( 0 ) != numElements) )
+    {
+      std::cerr << "Error: load balancing not skipped despite its cost." << std::endl;
+      ++errors;
+    }
+
+    const Dune::Fem::LoadBalanceStatistics &stats = manager.statistics();
+    const double cost = comm.max( comm.rank() == 0 ? bytes * (1.0 - meanTime) : 0.0 );
+    if( !close( stats.projectedGain, 10.0 * (1.0 - meanTime) ) || !close( stats.projectedCost, cost ) || !close( stats.computeImbalance, size ) )
+    {
+      std::cerr << "Error: wrong cost model (" << stats << ")." << std::endl;
+      ++errors;
+    }
+    errors += checkValues( uh, "after skipped load balancing" );
+  }
+
+  // with a high bandwidth, the migration pays off if there are several ranks
+  {
+    Dune::ParameterTree tree;
+    AdaptationManagerType manager( grid, rp, parameter( tree, 10, 1e12 ) );
+    manager.addComputeTime( time );
+    manager.loadBalance();
+
+    const Dune::Fem::LoadBalanceStatistics &stats = manager.statistics();
+    if( stats.balanced != (size > 1) )
+    {
+      std::cerr << "Error: load balancing " << (stats.balanced ? "done" : "skipped") << " on " << size << " ranks." << std::endl;
+      ++errors;
+    }
+    if( stats.balanced && ((stats.bytesMoved <= 0.0) || (stats.bytesMoved != stats.bytesReceived) || (stats.imbalanceAfter >= stats.imbalanceBefore)) )
+    {
+      std::cerr << "Error: wrong statistics of the load balancing (" << stats << ")." << std::endl;
+      ++errors;
+    }
+    errors += checkValues( uh, "after load balancing" );
+  }
+
+  // without horizon, the load balancing is always done
+  {
+    AdaptationManagerType manager( grid, rp );
+    manager.loadBalance();
+
+    const Dune::Fem::LoadBalanceStatistics &stats = manager.statistics();
+    if( !stats.balanced || (stats.projectedGain != 0.0) || (stats.projectedCost != 0.0) )
+    {
+      std::cerr << "Error: load balancing without cost model (" << stats << ")." << std::endl;
+      ++errors;
+    }
+    errors += checkValues( uh, "after second load balancing" );
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
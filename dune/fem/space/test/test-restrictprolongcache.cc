@@ -0,0 +1,200 @@
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/type.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+
+#include <dune/alugrid/grid.hh>
+#include <dune/alugrid/dgf.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/space/common/adaptationmanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/common/localrestrictprolongmatrix.hh>
+#include <dune/fem/space/common/restrictprolongtuple.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+#include <dune/fem/space/lagrange.hh>
+
+typedef Dune::ALUGrid< 2, 2, Dune::cube, Dune::nonconforming > GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 2 > DGSpaceType;
+typedef Dune::Fem::LagrangeDiscreteFunctionSpace< FunctionSpaceType, GridPartType, 2 > LagrangeSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DGSpaceType > DGFunctionType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< LagrangeSpaceType > LagrangeFunctionType;
+
+// a quadratic function, represented exactly by both spaces on all levels
+struct QuadraticFunction
+  : public Dune::Fem::Function< FunctionSpaceType, QuadraticFunction >
+{
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u = 1.0 + x[ 0 ] - 2.0*x[ 1 ] + x[ 0 ]*x[ 1 ] + x[ 0 ]*x[ 0 ];
+  }
+};
+
+// the lower left quarter of a reference element, given by its corners
+struct LowerLeftQuarter
+{
+  static const int coorddimension = 2;
+  typedef Dune::FieldVector< double, 2 > GlobalCoordinate;
+
+  explicit LowerLeftQuarter ( const Dune::GeometryType &type ) : type_( type ) {}
+
+  int corners () const { return (type_.isSimplex() ? 3 : 4); }
+
+  GlobalCoordinate corner ( int i ) const
+  {
+    GlobalCoordinate x( 0 );
+    if( type_.isSimplex() )
+      x[ i-1 ] = (i > 0 ? 0.5 : 0.0);
+    else
+    {
+      x[ 0 ] = 0.5*(i % 2);
+      x[ 1 ] = 0.5*(i / 2);
+    }
+    return x;
+  }
+
+private:
+  Dune::GeometryType type_;
+};
+
+// the cache identifies the values by the geometry types of father and son,
+// the position of the son and the sizes
+int checkCacheKeys ()
+{
+  Dune::Fem::LocalRestrictProlongMatrixCache< int, double > cache;
+  int created = 0;
+  auto get = [ &cache, &created ] ( const Dune::GeometryType &father, const Dune::GeometryType &son, const LowerLeftQuarter &geometry, int rows ) {
+      return cache.get( father, son, geometry, rows, 3, [ &created ] ( int &value ) { value = ++created; } );
+    };
+
+  const Dune::GeometryType triangle = Dune::GeometryTypes::triangle;
+  const Dune::GeometryType quadrilateral = Dune::GeometryTypes::quadrilateral;
+  const LowerLeftQuarter inTriangle( triangle );
+
+  int errors = 0;
+  const int first = get( triangle, triangle, inTriangle, 3 );
+  if( (get( triangle, triangle, inTriangle, 3 ) != first) || (created != 1) )
+  {
+    std::cerr << "Error: cached value not reused." << std::endl;
+    ++errors;
+  }
+
+  // same son type and corners, but a different father
+  if( (get( quadrilateral, triangle, inTriangle, 3 ) == first) || (created != 2) )
+  {
+    std::cerr << "Error: cached value shared by different father geometry types." << std::endl;
+    ++errors;
+  }
+
+  // a different son position and different sizes
+  get( quadrilateral, quadrilateral, LowerLeftQuarter( quadrilateral ), 3 );
+  get( triangle, triangle, inTriangle, 6 );
+  cache.get( triangle, 3, 3, [ &created ] ( int &value ) { value = ++created; } );
+  if( (created != 5) || (cache.size() != 5) )
+  {
+    std::cerr << "Error: " << cache.size() << " cached values instead of 5." << std::endl;
+    ++errors;
+  }
+
+  cache.clear();
+  if( cache.size() != 0 )
+  {
+    std::cerr << "Error: cache not empty after clear." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+const char *unitSquare
+   = "DGF\n\n"
+     "INTERVAL\n"
+     "0 0\n"
+     "1 1\n"
+     "4 4\n"
+     "#\n";
+
+template< class DiscreteFunction >
+int checkValues ( const DiscreteFunction &uh, const std::string &when )
+{
+  const QuadraticFunction f;
+  double error = 0;
+  for( const auto &element : elements( uh.gridPart(), Dune::Partitions::interior ) )
+  {
+    const auto geometry = element.geometry();
+    for( int i = 0; i <= geometry.corners(); ++i )
+    {
+      const auto x = (i < geometry.corners() ? geometry.corner( i ) : geometry.center());
+      FunctionSpaceType::RangeType u, uExact;
+      uh.localFunction( element ).evaluate( geometry.local( x ), u );
+      f.evaluate( x, uExact );
+      error = std::max( error, std::abs( u[ 0 ] - uExact[ 0 ] ) );
+    }
+  }
+
+  if( error < 1e-10 )
+    return 0;
+  std::cerr << "Error: wrong values of '" << uh.name() << "' " << when << " (error = " << error << ")." << std::endl;
+  return 1;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  int errors = checkCacheKeys();
+
+  std::istringstream dgf( unitSquare );
+  Dune::GridPtr< GridType > gridPtr( dgf );
+  GridType &grid = *gridPtr;
+  grid.loadBalance();
+  GridPartType gridPart( grid );
+
+  DGSpaceType dgSpace( gridPart );
+  LagrangeSpaceType lagrangeSpace( gridPart );
+  DGFunctionType uh( "uh", dgSpace );
+  LagrangeFunctionType vh( "vh", lagrangeSpace );
+  interpolate( gridFunctionAdapter( QuadraticFunction(), gridPart, 2 ), uh );
+  interpolate( gridFunctionAdapter( QuadraticFunction(), gridPart, 2 ), vh );
+
+  // refine everything twice, then coarsen everything twice; all children use
+  // the cached matrices after the first father has been processed
+  typedef Dune::Fem::RestrictProlongDefaultTuple< DGFunctionType, LagrangeFunctionType > RestrictProlongType;
+  RestrictProlongType rp( uh, vh );
+  Dune::Fem::AdaptationManager< GridType, RestrictProlongType > manager( grid, rp );
+  for( int step = 0; step < 4; ++step )
+  {
+    for( const auto &element : elements( gridPart, Dune::Partitions::interior ) )
+      grid.mark( (step < 2 ? 1 : -1), element );
+    manager.adapt();
+
+    const std::string when = "after step " + std::to_string( step );
+    errors += checkValues( uh, when ) + checkValues( vh, when );
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
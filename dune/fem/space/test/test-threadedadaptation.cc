@@ -0,0 +1,190 @@
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+
+#include <dune/alugrid/grid.hh>
+#include <dune/alugrid/dgf.hh>
+
+#include <dune/fem/function/adaptivefunction.hh>
+#include <dune/fem/function/common/function.hh>
+#include <dune/fem/function/common/gridfunctionadapter.hh>
+#include <dune/fem/gridpart/adaptiveleafgridpart.hh>
+#include <dune/fem/io/parameter/parametertree.hh>
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
+#include <dune/fem/space/common/adaptationmanager.hh>
+#include <dune/fem/space/common/functionspace.hh>
+#include <dune/fem/space/common/interpolate.hh>
+#include <dune/fem/space/common/restrictprolonginterface.hh>
+#include <dune/fem/space/common/restrictprolongtuple.hh>
+#include <dune/fem/space/discontinuousgalerkin.hh>
+#include <dune/fem/space/lagrange.hh>
+
+typedef Dune::ALUGrid< 2, 2, Dune::simplex, Dune::conforming > GridType;
+typedef Dune::Fem::AdaptiveLeafGridPart< GridType > GridPartType;
+typedef Dune::Fem::FunctionSpace< double, double, 2, 1 > FunctionSpaceType;
+typedef Dune::Fem::DiscontinuousGalerkinSpace< FunctionSpaceType, GridPartType, 1 > DGSpaceType;
+typedef Dune::Fem::LagrangeDiscreteFunctionSpace< FunctionSpaceType, GridPartType, 1 > LagrangeSpaceType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< DGSpaceType > DGFunctionType;
+typedef Dune::Fem::AdaptiveDiscreteFunction< LagrangeSpaceType > LagrangeFunctionType;
+
+// a linear function, represented exactly on all levels
+struct LinearFunction
+  : public Dune::Fem::Function< FunctionSpaceType, LinearFunction >
+{
+  void evaluate ( const FunctionSpaceType::DomainType &x, FunctionSpaceType::RangeType &u ) const
+  {
+    u = 0.5 + 3.0*x[ 0 ] + x[ 1 ];
+  }
+};
+
+// the default operator, made non-copyable and counting its calls per thread
+struct CountingRestrictProlong
+  : public Dune::Fem::RestrictProlongDefault< DGFunctionType >
+{
+  typedef Dune::Fem::RestrictProlongDefault< DGFunctionType > BaseType;
+
+  explicit CountingRestrictProlong ( DGFunctionType &uh )
+    : BaseType( uh ), calls( Dune::Fem::ThreadManager::maxThreads(), 0 )
+  {}
+
+  CountingRestrictProlong ( const CountingRestrictProlong & ) = delete;
+
+  template< class Entity >
+  void restrictLocal ( const Entity &father, const Entity &son, bool initialize ) const
+  {
+    ++calls[ Dune::Fem::ThreadManager::thread() ];
+    BaseType::restrictLocal( father, son, initialize );
+  }
+
+  template< class Entity >
+  void prolongLocal ( const Entity &father, const Entity &son, bool initialize ) const
+  {
+    ++calls[ Dune::Fem::ThreadManager::thread() ];
+    BaseType::prolongLocal( father, son, initialize );
+  }
+
+  mutable std::vector< long > calls;
+};
+
+const char *unitSquare
+   = "DGF\n\n"
+     "INTERVAL\n"
+     "0 0\n"
+     "1 1\n"
+     "8 8\n"
+     "#\n"
+     "SIMPLEX\n"
+     "#\n";
+
+template< class DiscreteFunction >
+int checkValues ( const DiscreteFunction &uh, const std::string &when )
+{
+  const LinearFunction f;
+  double error = 0;
+  for( const auto &element : elements( uh.gridPart(), Dune::Partitions::interior ) )
+  {
+    const auto geometry = element.geometry();
+    for( int i = 0; i < geometry.corners(); ++i )
+    {
+      FunctionSpaceType::RangeType u, uExact;
+      uh.localFunction( element ).evaluate( geometry.local( geometry.corner( i ) ), u );
+      f.evaluate( geometry.corner( i ), uExact );
+      error = std::max( error, std::abs( u[ 0 ] - uExact[ 0 ] ) );
+    }
+  }
+
+  if( error < 1e-10 )
+    return 0;
+  std::cerr << "Error: wrong values of '" << uh.name() << "' " << when << " (error = " << error << ")." << std::endl;
+  return 1;
+}
+
+// refine everything twice, then coarsen everything twice
+template< class RestrictProlong, class Check >
+int adapt ( GridType &grid, GridPartType &gridPart, RestrictProlong &rp, Check check, const std::string &name )
+{
+  Dune::ParameterTree tree;
+  tree[ "fem.adaptation.threaded" ] = "true";
+  tree[ "fem.loadbalancing.step" ] = "0";
+  Dune::Fem::AdaptationManager< GridType, RestrictProlong > manager( grid, rp, Dune::Fem::parameterReader( tree ) );
+
+  int errors = 0;
+  for( int step = 0; step < 4; ++step )
+  {
+    for( const auto &element : elements( gridPart, Dune::Partitions::interior ) )
+      grid.mark( (step < 2 ? 1 : -1), element );
+    manager.adapt();
+    errors += check( name + ", step " + std::to_string( step ) );
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  std::istringstream dgf( unitSquare );
+  Dune::GridPtr< GridType > gridPtr( dgf );
+  GridType &grid = *gridPtr;
+  grid.loadBalance();
+  GridPartType gridPart( grid );
+
+  DGSpaceType dgSpace( gridPart );
+  LagrangeSpaceType lagrangeSpace( gridPart );
+  DGFunctionType uh( "uh", dgSpace ), wh( "wh", dgSpace );
+  LagrangeFunctionType vh( "vh", lagrangeSpace );
+
+  int errors = 0;
+
+  // a non-copyable operator with element local dofs is shared by all threads
+  static_assert( !std::is_copy_constructible< CountingRestrictProlong >::value, "CountingRestrictProlong must not be copyable" );
+  {
+    interpolate( gridFunctionAdapter( LinearFunction(), gridPart, 1 ), uh );
+    CountingRestrictProlong rp( uh );
+    errors += adapt( grid, gridPart, rp, [ &uh ] ( const std::string &when ) { return checkValues( uh, when ); }, "threaded" );
+    if( std::accumulate( rp.calls.begin(), rp.calls.end(), 0l ) == 0 )
+    {
+      std::cerr << "Error: restriction/prolongation operator not called." << std::endl;
+      ++errors;
+    }
+    const long threads = std::count_if( rp.calls.begin(), rp.calls.end(), [] ( long n ) { return n > 0; } );
+    std::cout << "restriction/prolongation distributed over " << threads << " of " << rp.calls.size() << " threads" << std::endl;
+  }
+
+  // with Lagrange dofs, the data is projected serially
+  {
+    typedef Dune::Fem::RestrictProlongDefaultTuple< DGFunctionType, LagrangeFunctionType > RestrictProlongType;
+    interpolate( gridFunctionAdapter( LinearFunction(), gridPart, 1 ), wh );
+    interpolate( gridFunctionAdapter( LinearFunction(), gridPart, 1 ), vh );
+    RestrictProlongType rp( wh, vh );
+    if( rp.elementLocalDofs() )
+    {
+      std::cerr << "Error: Lagrange dofs reported as element local." << std::endl;
+      ++errors;
+    }
+    errors += adapt( grid, gridPart, rp, [ &wh, &vh ] ( const std::string &when ) { return checkValues( wh, when ) + checkValues( vh, when ); }, "serial fallback" );
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,340 @@
+#ifndef DUNE_FEM_STORAGE_ARRAYMEMORYPOOL_HH
+#define DUNE_FEM_STORAGE_ARRAYMEMORYPOOL_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <dune/common/visibility.hh>
+
+#include <dune/fem/misc/threads/parallelfor.hh>
+#include <dune/fem/misc/threads/threadmanager.hh>
+
+namespace Dune
+{
+
+  namespace Fem
+  {
+
+    // ArrayMemoryPool
+    // ---------------
+
+    /** \class ArrayMemoryPool
+     *  \ingroup DofManager
+     *  \brief memory for large arrays
+     *
+     *  When enabled, large blocks requested by PODArrayAllocator and
+     *  StandardArrayAllocator (i.e., the dof vectors of DynamicArray based
+     *  discrete functions, of any value type) are served by this pool:
+     *  - blocks are page aligned; on request, blocks of at least
+     *    minHugePageBlockSize bytes are aligned to and advised to be backed by
+     *    transparent huge pages (smaller blocks would waste too much memory),
+     *  - fresh blocks are first touched (and POD arrays are copied on
+     *    reallocation) by the threads of the ThreadManager, each one touching the part of the
+     *    array given by the current partition (see setPartition), so that
+     *    each page is placed on the NUMA node of the thread owning the
+     *    corresponding dofs,
+     *  - freed blocks may be retained and reused, e.g., across adaptation
+     *    cycles, up to a given number of bytes.
+     *
+     *  The pool is disabled by default; the DofManager configures it from the
+     *  parameters <b>fem.dofmanager.memorypool</b>,
+     *  <b>fem.dofmanager.memorypoolsize</b>, <b>fem.dofmanager.hugepages</b>
+     *  and <b>fem.dofmanager.firsttouch</b> when the first DofManager is
+     *  created.
+     *
+     *  \note All methods are thread safe.
+     */
+    class ArrayMemoryPool
+    {
+      typedef ArrayMemoryPool ThisType;
+
+      ArrayMemoryPool () = default;
+
+    public:
+      //! blocks smaller than this are left to malloc
+      static const std::size_t minBlockSize = std::size_t( 1 ) << 16;
+      //! blocks smaller than this are never backed by huge pages
+      static const std::size_t minHugePageBlockSize = std::size_t( 1 ) << 24;
+
+      ArrayMemoryPool ( const ThisType & ) = delete;
+      ThisType &operator= ( const ThisType & ) = delete;
+
+      DUNE_EXPORT static ThisType &instance ()
+      {
+        // never destroyed, arrays might be freed during static destruction
+        static ThisType *pool = new ThisType;
+        return *pool;
+      }
+
+      /** \brief configure the pool
+       *
+       *  \param[in]  retain      maximal number of bytes kept in freed blocks
+       *  \param[in]  hugePages   advise the use of transparent huge pages
+       *  \param[in]  firstTouch  first touch new blocks by all threads
+       */
+      void configure ( std::size_t retain, bool hugePages, bool firstTouch )
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        maxRetained_ = retain;
+        hugePages_ = hugePages;
+        firstTouch_ = firstTouch;
+        enabled_ = (retain > 0) || hugePages || firstTouch;
+        configured_ = true;
+        shrink( maxRetained_ );
+      }
+
+      //! return true if configure has been called
+      bool configured () const { return configured_; }
+
+      /** \brief set the partition used for first touch and copy
+       *
+       *  Thread t touches the part [ bounds[ t ], bounds[ t+1 ] ) of each
+       *  block, given relative to the block size. The ThreadIterator sets the
+       *  partition of the element indices into its thread parts here. If no
+       *  (or no matching) partition is set, the blocks are split into equal
+       *  parts.
+       *
+       *  \param[in]  bounds  increasing relative bounds, starting with 0 and
+       *                      ending with 1 (size: maxThreads + 1)
+       */
+      void setPartition ( std::vector< double > bounds )
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        partition_ = std::move( bounds );
+      }
+
+      //! return true if a block of given size is allocated by the pool
+      bool manages ( std::size_t bytes ) const
+      {
+        return enabled_ && (bytes >= minBlockSize);
+      }
+
+      //! return true if the pointer was allocated by the pool
+      bool owns ( const void *p ) const
+      {
+        if( (p == nullptr) || (live_ == 0) )
+          return false;
+        std::lock_guard< std::mutex > guard( mutex_ );
+        return (blocks_.find( const_cast< void * >( p ) ) != blocks_.end());
+      }
+
+      //! allocate a block of at least the given size
+      void *allocate ( std::size_t bytes )
+      {
+        const std::size_t size = roundUp( bytes );
+        {
+          std::lock_guard< std::mutex > guard( mutex_ );
+
+          // reuse a retained block, wasting at most half of it
+          auto it = free_.lower_bound( size );
+          if( (it != free_.end()) && (it->first <= 2*size) )
+          {
+            void *p = it->second;
+            retained_ -= it->first;
+            blocks_[ p ] = it->first;
+            free_.erase( it );
+            ++live_;
+            return p;
+          }
+        }
+
+        void *p = nullptr;
+        if( posix_memalign( &p, alignment( size ), size ) != 0 )
+          throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if( useHugePages( size ) )
+          madvise( p, size, MADV_HUGEPAGE );
+#endif
+        if( firstTouch_ )
+          touch( static_cast< char * >( p ), size );
+
+        std::lock_guard< std::mutex > guard( mutex_ );
+        blocks_[ p ] = size;
+        ++live_;
+        return p;
+      }
+
+      /** \brief free a block
+       *  \returns false, if the block was not allocated by the pool
+       */
+      bool deallocate ( void *p )
+      {
+        if( (p == nullptr) || (live_ == 0) )
+          return false;
+
+        std::lock_guard< std::mutex > guard( mutex_ );
+        auto it = blocks_.find( p );
+        if( it == blocks_.end() )
+          return false;
+
+        const std::size_t size = it->second;
+        blocks_.erase( it );
+        --live_;
+
+        if( size <= maxRetained_ )
+        {
+          free_.emplace( size, p );
+          retained_ += size;
+          shrink( maxRetained_ );
+        }
+        else
+          std::free( p );
+        return true;
+      }
+
+      /** \brief move the contents of a block (from the pool or malloc) into a
+       *         new block of the pool
+       */
+      void *reallocate ( void *p, std::size_t oldBytes, std::size_t bytes )
+      {
+        char *q = static_cast< char * >( allocate( bytes ) );
+        copy( q, static_cast< const char * >( p ), std::min( oldBytes, bytes ) );
+        if( !deallocate( p ) )
+          std::free( p );
+        return q;
+      }
+
+      //! free all retained blocks
+      void release ()
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        shrink( 0 );
+      }
+
+      //! number of bytes held in retained blocks
+      std::size_t retainedBytes () const
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        return retained_;
+      }
+
+    protected:
+      bool useHugePages ( std::size_t bytes ) const
+      {
+        return hugePages_ && (bytes >= minHugePageBlockSize);
+      }
+
+      std::size_t alignment ( std::size_t bytes ) const
+      {
+        return (useHugePages( bytes ) ? std::size_t( hugePageSize ) : std::size_t( pageSize ));
+      }
+
+      std::size_t roundUp ( std::size_t bytes ) const
+      {
+        const std::size_t align = alignment( bytes );
+        return ((bytes + align - 1) / align) * align;
+      }
+
+      // free retained blocks (largest first) until at most maxBytes are held
+      void shrink ( std::size_t maxBytes )
+      {
+        while( (retained_ > maxBytes) && !free_.empty() )
+        {
+          auto it = std::prev( free_.end() );
+          retained_ -= it->first;
+          std::free( it->second );
+          free_.erase( it );
+        }
+      }
+
+      // page aligned bounds of the part of each thread
+      std::vector< std::size_t > bounds ( std::size_t size, std::size_t threads ) const
+      {
+        std::vector< double > partition;
+        {
+          std::lock_guard< std::mutex > guard( mutex_ );
+          partition = partition_;
+        }
+
+        const std::size_t pages = (size + pageSize - 1) / pageSize;
+        std::vector< std::size_t > bounds( threads+1, pages );
+        for( std::size_t t = 0; t < threads; ++t )
+        {
+          const double bound = (partition.size() == threads+1 ? partition[ t ] : double( t ) / double( threads ));
+          bounds[ t ] = std::min( static_cast< std::size_t >( bound * pages + 0.5 ), pages );
+        }
+        bounds[ 0 ] = 0;
+        for( std::size_t t = 1; t <= threads; ++t )
+          bounds[ t ] = std::max( bounds[ t ], bounds[ t-1 ] );
+        for( std::size_t &bound : bounds )
+          bound = std::min( bound * pageSize, size );
+        return bounds;
+      }
+
+      // touch the part of each thread (the same parts as in copy)
+      void touch ( char *p, std::size_t size ) const
+      {
+        apply( size, [ p ] ( std::size_t begin, std::size_t end ) {
+            for( std::size_t i = begin; i < end; i += pageSize )
+              p[ i ] = 0;
+          } );
+      }
+
+      void copy ( char *dest, const char *src, std::size_t size ) const
+      {
+        apply( size, [ dest, src ] ( std::size_t begin, std::size_t end ) {
+            std::memcpy( dest + begin, src + begin, end - begin );
+          } );
+      }
+
+      // call f( begin, end ) for the part of each thread of the ThreadManager
+      // (nested calls run serially)
+      template< class F >
+      void apply ( std::size_t size, F f ) const
+      {
+        const int threads = availableThreads();
+        if( threads > 1 )
+        {
+          const std::vector< std::size_t > bounds = this->bounds( size, threads );
+          std::vector< char > done( threads, 0 );
+          parallelRun( threads, [ &bounds, &done, &f ] () {
+              const int thread = ThreadManager::thread();
+              f( bounds[ thread ], bounds[ thread+1 ] );
+              done[ thread ] = 1;
+            } );
+
+          // the runtime might have started less threads
+          for( int thread = 0; thread < threads; ++thread )
+            if( !done[ thread ] )
+              f( bounds[ thread ], bounds[ thread+1 ] );
+          return;
+        }
+        f( std::size_t( 0 ), size );
+      }
+
+      static const std::size_t hugePageSize = std::size_t( 1 ) << 21;
+      static const std::size_t pageSize = 4096;
+
+      mutable std::mutex mutex_;
+      std::unordered_map< void *, std::size_t > blocks_;
+      std::multimap< std::size_t, void * > free_;
+      std::atomic< std::size_t > live_ = { 0 };
+      std::size_t retained_ = 0;
+
+      std::size_t maxRetained_ = 0;
+      bool hugePages_ = false;
+      bool firstTouch_ = false;
+      std::atomic< bool > enabled_ = { false };
+      std::atomic< bool > configured_ = { false };
+      std::vector< double > partition_;
+    };
+
+  } // namespace Fem
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_FEM_STORAGE_ARRAYMEMORYPOOL_HH
@@ -13,6 +13,8 @@
 #include <dune/common/densevector.hh>
 #include <dune/common/ftraits.hh>
 
+#include <dune/fem/storage/arraymemorypool.hh>
+
 namespace Dune
 {
 
@@ -22,6 +24,7 @@ namespace Dune
   template< class K > class StaticArray;
 
   //! oriented to the STL Allocator funtionality
+  //! (large blocks are taken from the ArrayMemoryPool, if enabled)
   template <typename T>
   class StandardArrayAllocator
     : public std::allocator< T >
@@ -33,12 +36,37 @@ namespace Dune
 
     pointer allocate( size_type n )
     {
-      return new T[ n ];
+      ArrayMemoryPool &pool = ArrayMemoryPool::instance();
+      if( !pool.manages( n * sizeof(T) ) )
+        return new T[ n ];
+
+      // construct the objects in place, like new T[ n ] does
+      pointer p = static_cast< pointer > (pool.allocate( n * sizeof(T) ));
+      size_type i = 0;
+      try
+      {
+        for( ; i < n; ++i )
+          new (p + i) T;
+      }
+      catch( ... )
+      {
+        destroy( p, i );
+        pool.deallocate( p );
+        throw;
+      }
+      return p;
     }
 
     void deallocate( pointer p, size_type n )
     {
-      delete [] p;
+      ArrayMemoryPool &pool = ArrayMemoryPool::instance();
+      if( pool.owns( p ) )
+      {
+        destroy( p, n );
+        pool.deallocate( p );
+      }
+      else
+        delete [] p;
     }
 
     pointer reallocate ( pointer oldMem, size_type oldSize, size_type n )
@@ -50,10 +78,18 @@ namespace Dune
       deallocate( oldMem, oldSize );
       return p;
     }
+
+  protected:
+    static void destroy ( pointer p, size_type n )
+    {
+      for( size_type i = 0; i < n; ++i )
+        p[ i ].~T();
+    }
   };
 
   //! allocator for simple structures like int, double and float
   //! using the C malloc, free and realloc
+  //! (large blocks are taken from the ArrayMemoryPool, if enabled)
   template <typename T>
   class PODArrayAllocator : public std::allocator< T >
   {
@@ -69,6 +105,10 @@ namespace Dune
     //! allocate array of nmemb objects of type T
     pointer allocate( size_type n )
     {
+      ArrayMemoryPool &pool = ArrayMemoryPool::instance();
+      if( pool.manages( n * sizeof(value_type) ) )
+        return static_cast< pointer > (pool.allocate( n * sizeof(value_type) ));
+
       pointer p = static_cast< pointer > (std::malloc(n * sizeof(value_type)));
       assert(p);
       return p;
@@ -78,13 +118,18 @@ namespace Dune
     void deallocate( pointer p, size_type n )
     {
       assert(p);
-      std::free(p);
+      if( !ArrayMemoryPool::instance().deallocate( p ) )
+        std::free(p);
     }
 
     //! allocate array of nmemb objects of type T
     pointer reallocate (pointer oldMem, size_type oldSize , size_type n)
     {
       assert(oldMem);
+      ArrayMemoryPool &pool = ArrayMemoryPool::instance();
+      if( pool.manages( n * sizeof(value_type) ) || pool.owns( oldMem ) )
+        return static_cast< pointer > (pool.reallocate( oldMem, oldSize * sizeof(value_type), n * sizeof(value_type) ));
+
       pointer p = static_cast< pointer > (std::realloc(oldMem , n*sizeof(value_type)));
       assert(p);
       return p;
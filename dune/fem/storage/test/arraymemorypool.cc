@@ -0,0 +1,143 @@
+#include <config.h>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/fem/misc/mpimanager.hh>
+#include <dune/fem/storage/arraymemorypool.hh>
+#include <dune/fem/storage/dynamicarray.hh>
+
+// a value type counting its living instances
+struct Counted
+{
+  Counted () { ++alive; }
+  Counted ( const Counted &other ) : value( other.value ) { ++alive; }
+  ~Counted () { --alive; }
+
+  Counted &operator= ( const Counted & ) = default;
+
+  double value = 1.0;
+
+  static long alive;
+};
+
+long Counted::alive = 0;
+
+// fill a large array, grow it and check that it lives in the pool and keeps its values
+template< class Array, class Value >
+int checkArray ( const std::string &name, Value value )
+{
+  Dune::Fem::ArrayMemoryPool &pool = Dune::Fem::ArrayMemoryPool::instance();
+  const std::size_t size = 4 * Dune::Fem::ArrayMemoryPool::minBlockSize / sizeof( typename Array::value_type );
+
+  int errors = 0;
+  const void *block = nullptr;
+  {
+    Array array( size );
+    for( std::size_t i = 0; i < size; ++i )
+      array[ i ] = value( i );
+    block = array.data();
+    if( !pool.owns( block ) )
+    {
+      std::cerr << "Error: " << name << " not allocated by the memory pool." << std::endl;
+      ++errors;
+    }
+
+    array.resize( 3*size );
+    for( std::size_t i = 0; i < size; ++i )
+    {
+      if( array[ i ] == value( i ) )
+        continue;
+      std::cerr << "Error: " << name << " lost entry " << i << " on reallocation." << std::endl;
+      ++errors;
+      break;
+    }
+    if( !pool.owns( array.data() ) || pool.owns( block ) )
+    {
+      std::cerr << "Error: " << name << " not reallocated by the memory pool." << std::endl;
+      ++errors;
+    }
+  }
+
+  // the first block was retained and is reused
+  Array array( size );
+  if( array.data() != block )
+  {
+    std::cerr << "Error: retained block not reused for " << name << "." << std::endl;
+    ++errors;
+  }
+
+  // small arrays are left to the allocator
+  Array small( 8 );
+  if( pool.owns( small.data() ) )
+  {
+    std::cerr << "Error: small " << name << " allocated by the memory pool." << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::Fem::MPIManager::initialize( argc, argv );
+
+  Dune::Fem::ArrayMemoryPool &pool = Dune::Fem::ArrayMemoryPool::instance();
+  pool.configure( std::size_t( 1 ) << 26, false, true );
+
+  int errors = 0;
+  errors += checkArray< Dune::Fem::DynamicArray< double > >( "DynamicArray< double >", [] ( std::size_t i ) { return double( i ); } );
+  errors += checkArray< Dune::Fem::DynamicArray< Dune::FieldVector< double, 3 > > >( "DynamicArray< FieldVector >",
+                                                                                     [] ( std::size_t i ) { return Dune::FieldVector< double, 3 >( double( i ) ); } );
+
+  // non-POD values are constructed and destroyed in the pooled blocks
+  {
+    Dune::Fem::DynamicArray< Counted > array( 2 * Dune::Fem::ArrayMemoryPool::minBlockSize / sizeof( Counted ) );
+    if( !pool.owns( array.data() ) )
+    {
+      std::cerr << "Error: DynamicArray< Counted > not allocated by the memory pool." << std::endl;
+      ++errors;
+    }
+    if( (Counted::alive != long( array.capacity() )) || (array[ array.size()-1 ].value != 1.0) )
+    {
+      std::cerr << "Error: values of DynamicArray< Counted > not constructed." << std::endl;
+      ++errors;
+    }
+    array.resize( 2*array.size() );
+    if( Counted::alive != long( array.capacity() ) )
+    {
+      std::cerr << "Error: " << Counted::alive << " values of DynamicArray< Counted > alive instead of " << array.capacity() << "." << std::endl;
+      ++errors;
+    }
+  }
+  if( Counted::alive != 0 )
+  {
+    std::cerr << "Error: " << Counted::alive << " values of DynamicArray< Counted > not destroyed." << std::endl;
+    ++errors;
+  }
+
+  // retained blocks are freed on release
+  if( pool.retainedBytes() == 0 )
+  {
+    std::cerr << "Error: no blocks retained." << std::endl;
+    ++errors;
+  }
+  pool.release();
+  if( pool.retainedBytes() != 0 )
+  {
+    std::cerr << "Error: " << pool.retainedBytes() << " bytes retained after release." << std::endl;
+    ++errors;
+  }
+
+  return (errors > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}